@@ -129,6 +129,14 @@ future<> unset_server_snapshot(http_context& ctx) {
     return ctx.http_server.set_routes([&ctx] (routes& r) { unset_snapshot(ctx, r); });
 }
 
+future<> set_server_view_builder(http_context& ctx, sharded<db::view::view_builder>& vb) {
+    return ctx.http_server.set_routes([&ctx, &vb] (routes& r) { set_view_builder(ctx, r, vb); });
+}
+
+future<> unset_server_view_builder(http_context& ctx) {
+    return ctx.http_server.set_routes([&ctx] (routes& r) { unset_view_builder(ctx, r); });
+}
+
 future<> set_server_snitch(http_context& ctx) {
     return register_api(ctx, "endpoint_snitch_info", "The endpoint snitch info API", set_endpoint_snitch);
 }
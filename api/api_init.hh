@@ -43,6 +43,7 @@ class shared_token_metadata;
 namespace cql_transport { class controller; }
 class thrift_controller;
 namespace db { class snapshot_ctl; }
+namespace db::view { class view_builder; }
 namespace netw { class messaging_service; }
 class repair_service;
 
@@ -78,6 +79,8 @@ future<> set_rpc_controller(http_context& ctx, thrift_controller& ctl);
 future<> unset_rpc_controller(http_context& ctx);
 future<> set_server_snapshot(http_context& ctx, sharded<db::snapshot_ctl>& snap_ctl);
 future<> unset_server_snapshot(http_context& ctx);
+future<> set_server_view_builder(http_context& ctx, sharded<db::view::view_builder>& vb);
+future<> unset_server_view_builder(http_context& ctx);
 future<> set_server_gossip(http_context& ctx);
 future<> set_server_load_sstable(http_context& ctx);
 future<> set_server_messaging_service(http_context& ctx, sharded<netw::messaging_service>& ms);
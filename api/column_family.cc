@@ -766,6 +766,34 @@ void set_column_family(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(0);
     });
 
+    cf::get_cache_profile.set(r, [&ctx] (std::unique_ptr<request> req) {
+        auto uuid = get_uuid(req->param["name"], ctx.db.local());
+        return ctx.db.map_reduce0([uuid] (database& db) {
+            return db.find_column_family(uuid).get_row_cache().get_profile();
+        }, cache_profile(), [] (cache_profile a, const cache_profile& b) {
+            a += b;
+            return a;
+        }).then([] (const cache_profile& profile) {
+            std::vector<cf::cache_profile_bucket> res;
+            auto add = [&res] (int64_t max_partition_size, const cache_profile::bucket& b) {
+                cf::cache_profile_bucket r;
+                r.max_partition_size = max_partition_size;
+                r.resident_bytes = b.resident_bytes;
+                r.resident_partitions = b.resident_partitions;
+                r.hits = b.hits;
+                r.misses = b.misses;
+                r.evictions = b.evictions;
+                r.mean_eviction_age = b.mean_eviction_age().count();
+                res.push_back(std::move(r));
+            };
+            add(-1, profile.unknown_size);
+            for (unsigned i = 0; i < cache_profile::bucket_count; ++i) {
+                add(cache_profile::bucket_max_size(i), profile.buckets[i]);
+            }
+            return make_ready_future<json::json_return_type>(res);
+        });
+    });
+
     cf::get_row_cache_hit_out_of_range.set(r, [] (std::unique_ptr<request> req) {
         //TBD
         unimplemented();
@@ -47,6 +47,7 @@
 #include "database.hh"
 #include "db/extensions.hh"
 #include "db/snapshot-ctl.hh"
+#include "db/view/view_builder.hh"
 #include "transport/controller.hh"
 #include "thrift/controller.hh"
 #include "locator/token_metadata.hh"
@@ -1296,4 +1297,29 @@ void unset_snapshot(http_context& ctx, routes& r) {
     ss::scrub.unset(r);
 }
 
+void set_view_builder(http_context& ctx, routes& r, sharded<db::view::view_builder>& vb) {
+    ss::view_build_progress.set(r, [&ctx, &vb] (std::unique_ptr<request> req) {
+        auto keyspace = validate_keyspace(ctx, req->param);
+        auto view = req->param["view"];
+        return vb.local().get_build_progress(keyspace, view).then([] (std::vector<db::view::view_builder::view_build_progress> progress) {
+            std::vector<ss::view_build_progress> res;
+            res.reserve(progress.size());
+            for (auto& p : progress) {
+                ss::view_build_progress vbp;
+                vbp.shard = p.shard;
+                vbp.first_token = p.first_token.to_sstring();
+                vbp.next_token = p.next_token ? p.next_token->to_sstring() : "";
+                vbp.fraction_built = p.fraction_built;
+                vbp.eta = p.eta ? p.eta->count() : -1;
+                res.push_back(std::move(vbp));
+            }
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+}
+
+void unset_view_builder(http_context& ctx, routes& r) {
+    ss::view_build_progress.unset(r);
+}
+
 }
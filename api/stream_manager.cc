@@ -68,10 +68,15 @@ static void set_files(const std::map<sstring, streaming::progress_info>& from,
 }
 
 static hs::stream_state get_state(
-        streaming::stream_result_future& result_future) {
+        streaming::stream_result_future& result_future, const streaming::stream_bytes& sbytes) {
     hs::stream_state state;
     state.description = result_future.description;
     state.plan_id = result_future.plan_id.to_sstring();
+    state.bytes_sent = sbytes.bytes_sent;
+    state.bytes_received = sbytes.bytes_received;
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(lowres_clock::now() - result_future.start_time()).count();
+    state.outgoing_throughput = elapsed > 0 ? sbytes.bytes_sent / elapsed : 0;
+    state.incoming_throughput = elapsed > 0 ? sbytes.bytes_received / elapsed : 0;
     for (auto info : result_future.get_coordinator().get()->get_all_session_info()) {
         hs::stream_info si;
         si.peer = boost::lexical_cast<std::string>(info.peer);
@@ -94,14 +99,22 @@ void set_stream_manager(http_context& ctx, routes& r) {
                     return sm.update_all_progress_info();
                 }).then([] {
                     return streaming::get_stream_manager().map_reduce0([](streaming::stream_manager& stream) {
-                        std::vector<hs::stream_state> res;
+                        std::vector<shared_ptr<streaming::stream_result_future>> plans;
                         for (auto i : stream.get_initiated_streams()) {
-                            res.push_back(get_state(*i.second.get()));
+                            plans.push_back(i.second);
                         }
                         for (auto i : stream.get_receiving_streams()) {
-                            res.push_back(get_state(*i.second.get()));
+                            plans.push_back(i.second);
                         }
-                        return res;
+                        return do_with(std::move(plans), std::vector<hs::stream_state>(), [&stream] (auto& plans, auto& res) {
+                            return do_for_each(plans, [&stream, &res] (shared_ptr<streaming::stream_result_future>& plan) {
+                                return stream.get_progress_on_all_shards(plan->plan_id).then([&res, plan] (streaming::stream_bytes sbytes) {
+                                    res.push_back(get_state(*plan, sbytes));
+                                });
+                            }).then([&res] {
+                                return std::move(res);
+                            });
+                        });
                     }, std::vector<hs::stream_state>(),concat<hs::stream_state>).
                     then([](const std::vector<hs::stream_state>& res) {
                         return make_ready_future<json::json_return_type>(res);
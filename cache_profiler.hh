@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <unordered_map>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "dht/token.hh"
+#include "seastarx.hh"
+
+// Cache statistics of a single table, split by partition size.
+//
+// All values are estimates extrapolated from a sample of partitions,
+// see cache_profiler.
+struct cache_profile {
+    // Bucket 0 holds partitions smaller than 1KiB, bucket i > 0 holds
+    // partitions of size in [1KiB * 4^(i-1), 1KiB * 4^i), the last bucket
+    // is unbounded.
+    static constexpr unsigned bucket_count = 10;
+
+    struct bucket {
+        uint64_t resident_bytes = 0;
+        uint64_t resident_partitions = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        // Sum of the time evicted partitions spent in cache.
+        std::chrono::milliseconds total_eviction_age{0};
+
+        std::chrono::milliseconds mean_eviction_age() const {
+            return evictions ? total_eviction_age / evictions : std::chrono::milliseconds(0);
+        }
+
+        bucket& operator+=(const bucket& o) {
+            resident_bytes += o.resident_bytes;
+            resident_partitions += o.resident_partitions;
+            hits += o.hits;
+            misses += o.misses;
+            evictions += o.evictions;
+            total_eviction_age += o.total_eviction_age;
+            return *this;
+        }
+    };
+
+    std::array<bucket, bucket_count> buckets;
+    // Partitions whose size was not measured yet. Partitions are measured
+    // when read from cache, so this accounts for partitions which were
+    // populated but never hit since, and misses of partitions never seen before.
+    bucket unknown_size;
+
+    cache_profile& operator+=(const cache_profile& o) {
+        for (unsigned i = 0; i < bucket_count; ++i) {
+            buckets[i] += o.buckets[i];
+        }
+        unknown_size += o.unknown_size;
+        return *this;
+    }
+
+    static unsigned bucket_of(size_t bytes) noexcept {
+        if (bytes < 1024) {
+            return 0;
+        }
+        auto kib = bytes / 1024;
+        return std::min<unsigned>(1 + (63 - __builtin_clzll(kib)) / 2, bucket_count - 1);
+    }
+
+    // Exclusive upper bound of partition size in the given bucket,
+    // std::numeric_limits<int64_t>::max() for the last bucket.
+    static int64_t bucket_max_size(unsigned bucket) noexcept {
+        if (bucket == bucket_count - 1) {
+            return std::numeric_limits<int64_t>::max();
+        }
+        return int64_t(1024) << (2 * bucket);
+    }
+};
+
+// Samples cache behaviour of a subset of partitions of a table.
+//
+// A partition is sampled if its token hashes into the sampled fraction of
+// the hash space, so the same partitions are followed through their
+// population, hits and eviction. Their sizes are measured when they are
+// read from cache, at most once per remeasure_period.
+class cache_profiler {
+public:
+    // One in 2^sample_shift partitions is sampled.
+    static constexpr unsigned sample_shift = 6;
+    // Caps the memory used for samples of a single table.
+    static constexpr size_t max_samples = 64 * 1024;
+    // Samples of partitions which left the cache are kept so that their
+    // misses are attributed to their size. Once there are more of them
+    // than this, they are all forgotten.
+    static constexpr size_t max_non_resident_samples = max_samples / 4;
+    static constexpr auto remeasure_period = std::chrono::seconds(10);
+    using clock = seastar::lowres_clock;
+private:
+    struct sample {
+        size_t bytes = 0;
+        clock::time_point populated;
+        clock::time_point measured;
+        bool resident = false;
+        bool size_known = false;
+        // Left the cache, counted in _non_resident.
+        bool left = false;
+    };
+    std::unordered_map<int64_t, sample> _samples;
+    size_t _non_resident = 0;
+    // Sampled counts, scaled up by profile().
+    cache_profile _counters;
+private:
+    cache_profile::bucket& bucket_for(const sample& s) noexcept {
+        return s.size_known ? _counters.buckets[cache_profile::bucket_of(s.bytes)] : _counters.unknown_size;
+    }
+
+    // Not to be called from eviction, as it may allocate.
+    sample* get_or_create(dht::token t) noexcept {
+        auto it = _samples.find(t.raw());
+        if (it != _samples.end()) {
+            return &it->second;
+        }
+        if (_non_resident > max_non_resident_samples) {
+            forget_non_resident();
+        }
+        if (_samples.size() >= max_samples) {
+            return nullptr;
+        }
+        try {
+            return &_samples[t.raw()];
+        } catch (...) {
+            // Failing to sample is not a reason to fail the read.
+            return nullptr;
+        }
+    }
+
+    void forget_non_resident() noexcept {
+        for (auto it = _samples.begin(); it != _samples.end();) {
+            if (it->second.resident) {
+                ++it;
+            } else {
+                it = _samples.erase(it);
+            }
+        }
+        _non_resident = 0;
+    }
+
+    void on_leave(std::unordered_map<int64_t, sample>::iterator it) noexcept {
+        it->second.resident = false;
+        if (_samples.size() >= max_samples) {
+            _samples.erase(it);
+        } else {
+            it->second.left = true;
+            ++_non_resident;
+        }
+    }
+
+    void on_enter(sample& s, clock::time_point now) noexcept {
+        if (s.left) {
+            s.left = false;
+            --_non_resident;
+        }
+        s.resident = true;
+        s.populated = now;
+    }
+public:
+    static bool is_sampled(dht::token t) noexcept {
+        // Tokens of some partitioners are not hashes, so mix the bits first.
+        return (uint64_t(t.raw()) * 0x9e3779b97f4a7c15ull) >> (64 - sample_shift) == 0;
+    }
+
+    // Called when a sampled partition is inserted into cache.
+    void on_insert(dht::token t) noexcept {
+        if (auto* s = get_or_create(t)) {
+            on_enter(*s, clock::now());
+        }
+    }
+
+    // Called when a sampled partition is read from cache.
+    // measure() returns the current memory footprint of the partition.
+    template <typename Measure>
+    void on_hit(dht::token t, Measure&& measure) {
+        auto* s = get_or_create(t);
+        if (!s) {
+            return;
+        }
+        auto now = clock::now();
+        if (!s->resident) {
+            // Populated before sampling started.
+            on_enter(*s, now);
+        }
+        if (!s->size_known || now - s->measured >= remeasure_period) {
+            s->bytes = measure();
+            s->size_known = true;
+            s->measured = now;
+        }
+        ++bucket_for(*s).hits;
+    }
+
+    // Called when a sampled partition is missing in cache.
+    void on_miss(dht::token t) noexcept {
+        auto it = _samples.find(t.raw());
+        if (it == _samples.end()) {
+            ++_counters.unknown_size.misses;
+        } else {
+            ++bucket_for(it->second).misses;
+        }
+    }
+
+    // Called when a sampled partition is evicted from cache.
+    void on_eviction(dht::token t) noexcept {
+        auto it = _samples.find(t.raw());
+        if (it == _samples.end() || !it->second.resident) {
+            return;
+        }
+        auto& b = bucket_for(it->second);
+        ++b.evictions;
+        b.total_eviction_age += std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - it->second.populated);
+        on_leave(it);
+    }
+
+    // Called when a sampled partition is removed from cache for reasons
+    // other than eviction, e.g. invalidation.
+    void on_removal(dht::token t) noexcept {
+        auto it = _samples.find(t.raw());
+        if (it != _samples.end() && it->second.resident) {
+            on_leave(it);
+        }
+    }
+
+    // Returns statistics extrapolated to all partitions of the table.
+    cache_profile profile() const {
+        cache_profile ret = _counters;
+        for (auto&& [token, s] : _samples) {
+            if (s.resident) {
+                auto& b = s.size_known ? ret.buckets[cache_profile::bucket_of(s.bytes)] : ret.unknown_size;
+                b.resident_bytes += s.bytes;
+                ++b.resident_partitions;
+            }
+        }
+        auto scale = [] (cache_profile::bucket& b) {
+            b.resident_bytes <<= sample_shift;
+            b.resident_partitions <<= sample_shift;
+            b.hits <<= sample_shift;
+            b.misses <<= sample_shift;
+            b.evictions <<= sample_shift;
+            b.total_eviction_age *= 1 << sample_shift;
+        };
+        for (auto& b : ret.buckets) {
+            scale(b);
+        }
+        scale(ret.unknown_size);
+        return ret;
+    }
+};
@@ -25,8 +25,8 @@
 #include "exceptions/exceptions.hh"
 #include "utils/rjson.hh"
 
-caching_options::caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled) {
+caching_options::caching_options(sstring k, sstring r, bool enabled, bool frequency_admission)
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _frequency_admission(frequency_admission) {
     if ((k != "ALL") && (k != "NONE")) {
         throw exceptions::configuration_exception("Invalid key value: " + k); 
     }
@@ -53,6 +53,9 @@ caching_options::to_map() const {
     if (!_enabled) {
         res.insert({"enabled", "false"});
     }
+    if (_frequency_admission) {
+        res.insert({"admission", "FREQUENT"});
+    }
     return res;
 }
 
@@ -71,6 +74,7 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
     sstring k = default_key;
     sstring r = default_row;
     bool e = true;
+    bool f = false;
 
     for (auto& p : map) {
         if (p.first == "keys") {
@@ -79,11 +83,17 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
             r = p.second;
         } else if (p.first == "enabled") {
             e = p.second == "true";
+        } else if (p.first == "admission") {
+            if (p.second == "FREQUENT") {
+                f = true;
+            } else if (p.second != "ALL") {
+                throw exceptions::configuration_exception("Invalid admission value: " + p.second);
+            }
         } else {
             throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
         }
     }
-    return caching_options(k, r, e);
+    return caching_options(k, r, e, f);
 }
 
 caching_options
@@ -94,7 +104,7 @@ caching_options::from_sstring(const sstring& str) {
 bool
 caching_options::operator==(const caching_options& other) const {
     return _key_cache == other._key_cache && _row_cache == other._row_cache
-        && _enabled == other._enabled;
+        && _enabled == other._enabled && _frequency_admission == other._frequency_admission;
 }
 
 bool
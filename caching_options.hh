@@ -38,7 +38,10 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // When set, partitions missing in cache are only populated
+    // if they are read frequently enough, see row_cache::should_admit().
+    bool _frequency_admission = false;
+    caching_options(sstring k, sstring r, bool enabled, bool frequency_admission = false);
 
     friend class schema;
     caching_options();
@@ -47,6 +50,10 @@ class caching_options {
         return _enabled;
     }
 
+    bool frequency_admission() const {
+        return _frequency_admission;
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -61,6 +61,9 @@ class compaction_strategy {
 
     compaction_descriptor get_major_compaction_job(column_family& cf, std::vector<shared_sstable> candidates);
 
+    // Return a job purging droppable tombstones, if any sstable has enough of them.
+    compaction_descriptor get_tombstone_purge_job(column_family& cf, std::vector<shared_sstable> candidates);
+
     // Some strategies may look at the compacted and resulting sstables to
     // get some useful information for subsequent compactions.
     void notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added);
@@ -405,6 +405,7 @@ scylla_tests = set([
     'test/boost/cql_query_like_test',
     'test/boost/cql_query_group_test',
     'test/boost/cql_functions_test',
+    'test/boost/cql_frame_compression_test',
     'test/boost/crc_test',
     'test/boost/data_listeners_test',
     'test/boost/database_test',
@@ -418,12 +419,14 @@ scylla_tests = set([
     'test/boost/filtering_test',
     'test/boost/flat_mutation_reader_test',
     'test/boost/flush_queue_test',
+    'test/boost/frequency_sketch_test',
     'test/boost/fragmented_temporary_buffer_test',
     'test/boost/frozen_mutation_test',
     'test/boost/gossip_test',
     'test/boost/gossiping_property_file_snitch_test',
     'test/boost/hash_test',
     'test/boost/hashers_test',
+    'test/boost/hints_test',
     'test/boost/idl_test',
     'test/boost/input_stream_test',
     'test/boost/json_cql_query_test',
@@ -459,6 +462,7 @@ scylla_tests = set([
     'test/boost/query_processor_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/repair_hash_sketch_test',
     'test/boost/reusable_buffer_test',
     'test/boost/restrictions_test',
     'test/boost/role_manager_test',
@@ -483,6 +487,7 @@ scylla_tests = set([
     'test/boost/sstable_move_test',
     'test/boost/statement_restrictions_test',
     'test/boost/storage_proxy_test',
+    'test/boost/stream_transfer_task_test',
     'test/boost/top_k_test',
     'test/boost/transport_test',
     'test/boost/types_test',
@@ -494,6 +499,7 @@ scylla_tests = set([
     'test/boost/view_schema_test',
     'test/boost/view_schema_pkey_test',
     'test/boost/view_schema_ckey_test',
+    'test/boost/view_update_batch_test',
     'test/boost/vint_serialization_test',
     'test/boost/virtual_reader_test',
     'test/boost/virtual_table_mutation_source_test',
@@ -502,6 +508,7 @@ scylla_tests = set([
     'test/boost/btree_test',
     'test/boost/radix_tree_test',
     'test/boost/double_decker_test',
+    'test/boost/radix_decker_test',
     'test/boost/stall_free_test',
     'test/boost/raft_address_map_test',
     'test/boost/raft_sys_table_storage_test',
@@ -547,6 +554,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_range_tombstones',
 ])
 
 raft_tests = set([
@@ -554,6 +562,7 @@ raft_tests = set([
     'test/raft/randomized_nemesis_test',
     'test/raft/fsm_test',
     'test/raft/etcd_test',
+    'test/raft/replication_bench',
 ])
 
 apps = set([
@@ -720,11 +729,13 @@ scylla_core = (['database.cc',
                 'sstables/sstable_directory.cc',
                 'sstables/random_access_reader.cc',
                 'sstables/metadata_collector.cc',
+                'sstables/repair_digest.cc',
                 'sstables/writer.cc',
                 'transport/cql_protocol_extension.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
                 'transport/server.cc',
+                'transport/frame_compression.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
                 'cdc/cdc_partitioner.cc',
@@ -857,6 +868,7 @@ scylla_core = (['database.cc',
                 'db/hints/manager.cc',
                 'db/hints/resource_manager.cc',
                 'db/hints/host_filter.cc',
+                'db/hints/hints_coalescer.cc',
                 'db/config.cc',
                 'db/extensions.cc',
                 'db/heat_load_balance.cc',
@@ -929,6 +941,7 @@ scylla_core = (['database.cc',
                 'streaming/stream_request.cc',
                 'streaming/stream_summary.cc',
                 'streaming/stream_transfer_task.cc',
+                'streaming/stream_sstable_files.cc',
                 'streaming/stream_receive_task.cc',
                 'streaming/stream_plan.cc',
                 'streaming/progress_info.cc',
@@ -1145,6 +1158,7 @@ pure_boost_tests = set([
     'test/boost/dynamic_bitset_test',
     'test/boost/enum_option_test',
     'test/boost/enum_set_test',
+    'test/boost/frequency_sketch_test',
     'test/boost/hashers_test',
     'test/boost/idl_test',
     'test/boost/json_test',
@@ -1156,8 +1170,10 @@ pure_boost_tests = set([
     'test/boost/observable_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/repair_hash_sketch_test',
     'test/boost/serialization_test',
     'test/boost/small_vector_test',
+    'test/boost/stream_transfer_task_test',
     'test/boost/top_k_test',
     'test/boost/vint_serialization_test',
     'test/boost/bptree_test',
@@ -1253,6 +1269,7 @@ deps['test/raft/replication_test'] = ['test/raft/replication_test.cc'] + scylla_
 deps['test/raft/randomized_nemesis_test'] = ['test/raft/randomized_nemesis_test.cc'] + scylla_raft_dependencies
 deps['test/raft/fsm_test'] =  ['test/raft/fsm_test.cc', 'test/lib/log.cc'] + scylla_raft_dependencies
 deps['test/raft/etcd_test'] =  ['test/raft/etcd_test.cc', 'test/lib/log.cc'] + scylla_raft_dependencies
+deps['test/raft/replication_bench'] = ['test/raft/replication_bench.cc'] + scylla_raft_dependencies
 
 deps['utils/gz/gen_crc_combine_table'] = ['utils/gz/gen_crc_combine_table.cc']
 
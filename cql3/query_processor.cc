@@ -375,6 +375,13 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, se
                             _cql_stats.secondary_index_reads,
                             sm::description("Counts the total number of CQL read requests performed using secondary indexes.")),
 
+                    // local_index_single_pass_reads total count is also included in secondary_index_reads
+                    sm::make_derive(
+                            "local_index_single_pass_reads",
+                            _cql_stats.local_index_single_pass_reads,
+                            sm::description("Counts the total number of CQL read requests using local secondary indexes, "
+                                    "where replicas looked up the index and read the base rows in a single pass.")),
+
                     // secondary_index_rows_read total count is also included in all cql rows read
                     sm::make_derive(
                             "secondary_index_rows_read",
@@ -150,6 +150,9 @@ void cf_prop_defs::validate(const database& db, const schema::extensions_map& sc
     if (auto caching_options = get_caching_options(); caching_options && !caching_options->enabled() && !db.features().cluster_supports_per_table_caching()) {
         throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'enabled':false\" unless whole cluster supports it");
     }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->frequency_admission() && !db.features().cluster_supports_cache_frequency_admission()) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'admission':'FREQUENT'\" unless whole cluster supports it");
+    }
 
     auto cdc_options = get_cdc_options(schema_extensions);
     if (cdc_options && cdc_options->enabled() && !db.features().cluster_supports_cdc()) {
@@ -310,11 +310,7 @@ select_statement::do_execute(service::storage_proxy& proxy,
 
     validate_for_read(cl);
 
-    uint64_t limit = get_limit(options);
-    auto now = gc_clock::now();
-
-    const bool restrictions_need_filtering = _restrictions->need_filtering();
-    _stats.filtered_reads += restrictions_need_filtering;
+    _stats.filtered_reads += _restrictions->need_filtering();
 
     const source_selector src_sel = state.get_client_state().is_internal()
             ? source_selector::INTERNAL : source_selector::USER;
@@ -325,6 +321,23 @@ select_statement::do_execute(service::storage_proxy& proxy,
     _stats.select_partition_range_scan += _range_scan;
     _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
 
+    return do_execute_query(proxy, state, options, std::nullopt);
+}
+
+future<shared_ptr<cql_transport::messages::result_message>>
+select_statement::do_execute_query(service::storage_proxy& proxy,
+                          service::query_state& state,
+                          const query_options& options,
+                          std::optional<query::local_index_lookup> index_lookup) const
+{
+    uint64_t limit = get_limit(options);
+    auto now = gc_clock::now();
+
+    // Each replica reads the rows its own copy of a local index points to,
+    // so rows whose indexed value changed on another replica have to be
+    // filtered after reconciliation.
+    const bool restrictions_need_filtering = _restrictions->need_filtering() || index_lookup;
+
     auto slice = make_partition_slice(options);
     auto command = ::make_lw_shared<query::read_command>(
             _schema->id(),
@@ -338,6 +351,7 @@ select_statement::do_execute(service::storage_proxy& proxy,
             utils::UUID(),
             query::is_first_page::no,
             options.get_timestamp(state));
+    command->index_lookup = std::move(index_lookup);
 
     int32_t page_size = options.get_page_size();
 
@@ -862,6 +876,15 @@ indexed_table_select_statement::prepare(database& db,
     sstring index_table_name = im.name() + "_index";
     schema_ptr view_schema = db.find_schema(schema->ks_name(), index_table_name);
 
+    // Queries using a local index may be filtered on the indexed column, see do_execute_query().
+    if (im.local()) {
+        for (auto&& [cdef, restriction] : restrictions->get_non_pk_restriction()) {
+            if (index_opt->depends_on(*cdef) && !selection->has_column(*cdef)) {
+                selection->add_column_for_post_processing(*cdef);
+            }
+        }
+    }
+
     return ::make_shared<cql3::statements::indexed_table_select_statement>(
             schema,
             bound_terms,
@@ -1015,6 +1038,15 @@ indexed_table_select_statement::do_execute(service::storage_proxy& proxy,
 
     assert(_restrictions->uses_secondary_indexing());
 
+    // A local index lives on the same replicas as the base partition, so
+    // the replicas can look it up and read the matching base rows in one
+    // pass, instead of us reading the posting list first.
+    if (auto index_lookup = get_local_index_lookup(proxy, options)) {
+        tracing::trace(state.get_trace_state(), "Reading rows found in local index {} in a single pass", _index.metadata().name());
+        ++_stats.local_index_single_pass_reads;
+        return do_execute_query(proxy, state, options, std::move(index_lookup));
+    }
+
     _stats.unpaged_select_queries(_ks_sel) += options.get_page_size() <= 0;
 
     // Secondary index search has two steps: 1. use the index table to find a
@@ -1125,6 +1157,20 @@ indexed_table_select_statement::do_execute(service::storage_proxy& proxy,
     }
 }
 
+std::optional<query::local_index_lookup>
+indexed_table_select_statement::get_local_index_lookup(service::storage_proxy& proxy, const query_options& options) const {
+    if (!_index.metadata().local() || !proxy.features().cluster_supports_local_index_single_pass()) {
+        return std::nullopt;
+    }
+    // The replica resolves the lookup for a single base partition at a time.
+    auto partition_ranges = _get_partition_ranges_for_posting_list(options);
+    if (partition_ranges.size() != 1 || !query::is_single_partition(partition_ranges.front())) {
+        return std::nullopt;
+    }
+    auto slice = _get_partition_slice_for_posting_list(options);
+    return query::local_index_lookup{_view_schema->id(), slice.default_row_ranges()};
+}
+
 dht::partition_range_vector indexed_table_select_statement::get_partition_ranges_for_local_index_posting_list(const query_options& options) const {
     return _restrictions->get_partition_key_ranges(options);
 }
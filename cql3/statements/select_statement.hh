@@ -108,6 +108,10 @@ class select_statement : public cql_statement {
 protected :
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(service::storage_proxy& proxy,
         service::query_state& state, const query_options& options) const;
+    // Reads the selected rows directly from the table. If index_lookup is
+    // set, the replicas only read the rows found in the given local index.
+    future<::shared_ptr<cql_transport::messages::result_message>> do_execute_query(service::storage_proxy& proxy,
+        service::query_state& state, const query_options& options, std::optional<query::local_index_lookup> index_lookup) const;
     friend class select_statement_executor;
 public:
     select_statement(schema_ptr schema,
@@ -230,6 +234,8 @@ class indexed_table_select_statement : public select_statement {
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(service::storage_proxy& proxy,
             service::query_state& state, const query_options& options) const override;
 
+    std::optional<query::local_index_lookup> get_local_index_lookup(service::storage_proxy& proxy, const query_options& options) const;
+
     lw_shared_ptr<const service::pager::paging_state> generate_view_paging_state_from_base_query_results(lw_shared_ptr<const service::pager::paging_state> paging_state,
             const foreign_ptr<lw_shared_ptr<query::result>>& results, service::storage_proxy& proxy, service::query_state& state, const query_options& options) const;
 
@@ -52,6 +52,8 @@
 #include "message/messaging_service.hh"
 #include "cell_locking.hh"
 #include "view_info.hh"
+#include "partition_slice_builder.hh"
+#include "query-result-reader.hh"
 #include "db/schema_tables.hh"
 #include "sstables/compaction_manager.hh"
 #include "gms/feature_service.hh"
@@ -315,7 +317,7 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _cfg(cfg)
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.virtual_dirty_soft_limit(), default_scheduling_group())
-    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.virtual_dirty_soft_limit(), dbcfg.statement_scheduling_group)
+    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.virtual_dirty_soft_limit(), dbcfg.statement_scheduling_group, cfg.memtable_flush_concurrency())
     , _dbcfg(dbcfg)
     , _memtable_controller(make_flush_controller(_cfg, dbcfg.memtable_scheduling_group, service::get_local_memtable_flush_priority(), [this, limit = float(_dirty_memory_manager.throttle_threshold())] {
         auto backlog = (_dirty_memory_manager.virtual_dirty_memory()) / limit;
@@ -444,6 +446,16 @@ dirty_memory_manager::setup_collectd(sstring namestr) {
 
         sm::make_gauge(namestr +"_virtual_dirty_bytes", [this] { return virtual_dirty_memory(); },
                        sm::description("Holds the size of used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
+
+        sm::make_gauge(namestr + "_flushes_in_progress", [this] { return flushes_in_progress(); },
+                       sm::description("Holds the number of sstable writers currently writing memtables of this group to disk.")),
+
+        sm::make_derive(namestr + "_blocked_writes", [this] { return _stats.blocked_writes; },
+                       sm::description("Counts writes which had to wait because dirty memory reached its limit.")),
+
+        sm::make_derive(namestr + "_blocked_writes_time_us", [this] { return _stats.blocked_writes_time.count(); },
+                       sm::description("Total time in microseconds writes spent waiting because dirty memory reached its limit. "
+                                       "A growing value means memtable flushes don't keep up with the write rate.")),
     });
 }
 
@@ -478,6 +490,10 @@ database::setup_metrics() {
         sm::make_gauge("pending_flushes_bytes", _cf_stats.pending_memtables_flushes_bytes,
                        sm::description("Holds the current number of bytes in memtables that are currently being flushed to sstables. "
                                        "High value in this metric may be an indication of storage being a bottleneck.")),
+
+        sm::make_derive("split_flushes", _cf_stats.split_memtables_flushes_count,
+                       sm::description("Counts memtable flushes which were split into token ranges written in parallel.")),
+
         sm::make_gauge("failed_flushes", _cf_stats.failed_memtables_flushes_count,
                        sm::description("Holds the number of failed memtable flushes. "
                                        "High value in this metric may indicate a permanent failure to flush a memtable.")),
@@ -507,6 +523,9 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_derive("clustering_key_filter_skipped_sstables", _cf_stats.sstables_skipped_by_clustering_key_filter,
+                       sm::description("Counts sstables skipped by single-row reads because their bloom filter of clustering keys did not contain the row.")),
+
         sm::make_derive("dropped_view_updates", _cf_stats.dropped_view_updates,
                        sm::description("Counts the number of view updates that have been dropped due to cluster overload. ")),
 
@@ -701,6 +720,17 @@ database::setup_metrics() {
 
         sm::make_total_operations("total_view_updates_failed_remote", _cf_stats.total_view_updates_failed_remote,
                 sm::description("Total number of view updates generated for tables and failed to be sent to remote replicas.")),
+
+        sm::make_total_operations("total_view_update_batches", _cf_stats.total_view_update_batches,
+                sm::description("Total number of batched messages carrying view updates to remote replicas.")),
+
+        sm::make_total_operations("total_view_updates_batched", _cf_stats.total_view_updates_batched,
+                sm::description("Total number of view updates sent to remote replicas within batches. "
+                    "Divided by total_view_update_batches gives the average number of updates per message.")),
+
+        sm::make_total_operations("total_view_update_reads_skipped", _cf_stats.total_view_update_reads_skipped,
+                sm::description("Total number of base writes for which view updates were generated without reading the base partition, "
+                    "because it was known not to exist.")),
     });
     if (this_shard_id() == 0) {
         _metrics.add_group("database", {
@@ -1121,6 +1151,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _config.enable_dangerous_direct_import_of_cassandra_counters;
     cfg.compaction_enforce_min_threshold = _config.compaction_enforce_min_threshold;
     cfg.dirty_memory_manager = _config.dirty_memory_manager;
+    cfg.memtable_flush_split_threshold = size_t(db_config.memtable_flush_split_threshold_in_mb()) << 20;
     cfg.streaming_read_concurrency_semaphore = _config.streaming_read_concurrency_semaphore;
     cfg.compaction_concurrency_semaphore = _config.compaction_concurrency_semaphore;
     cfg.cf_stats = _config.cf_stats;
@@ -1398,6 +1429,30 @@ compare_atomic_cell_for_merge(atomic_cell_view left, atomic_cell_view right) {
 future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>>
 database::query(schema_ptr s, const query::read_command& cmd, query::result_options opts, const dht::partition_range_vector& ranges,
                 tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+    if (cmd.index_lookup) {
+        // Whether the index lookup has to go on depends on the rows found,
+        // so digest-only reads need them too, to compute the same digest
+        // as the replica the data is read from.
+        const bool only_digest = opts.request == query::result_request::only_digest;
+        const auto lookup_opts = only_digest ? query::result_options{query::result_request::result_and_digest, opts.digest_algo} : opts;
+        return query_with_local_index_lookup<lw_shared_ptr<query::result>>(std::move(s), cmd, ranges, std::move(trace_state), timeout, false,
+                [this, lookup_opts] (schema_ptr s, const query::read_command& base_cmd, const dht::partition_range_vector& ranges,
+                        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+            return query(std::move(s), base_cmd, lookup_opts, ranges, std::move(trace_state), timeout).then(
+                    [] (std::tuple<lw_shared_ptr<query::result>, cache_temperature> res) {
+                auto& result = std::get<0>(res);
+                uint64_t row_count = result->row_count() ? *result->row_count() : std::get<1>(query::result_view(*result).count_partitions_and_rows());
+                return std::tuple(std::move(res), row_count);
+            });
+        }, [] (lw_shared_ptr<query::result>& result) {
+            result->set_short_read(query::short_read::yes);
+        }).then([only_digest] (std::tuple<lw_shared_ptr<query::result>, cache_temperature> res) {
+            if (only_digest) {
+                std::get<0>(res) = make_lw_shared<query::result>(std::get<0>(res)->without_rows());
+            }
+            return res;
+        });
+    }
     column_family& cf = find_column_family(cmd.cf_id);
     auto& semaphore = get_reader_concurrency_semaphore();
     auto class_config = query::query_class_config{.semaphore = semaphore, .max_memory_for_unlimited_query = *cmd.max_result_size};
@@ -1427,6 +1482,21 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
 future<std::tuple<reconcilable_result, cache_temperature>>
 database::query_mutations(schema_ptr s, const query::read_command& cmd, const dht::partition_range& range,
                           tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+    if (cmd.index_lookup) {
+        return do_with(dht::partition_range_vector{range}, [this, s = std::move(s), &cmd, trace_state = std::move(trace_state), timeout] (const dht::partition_range_vector& ranges) mutable {
+            return query_with_local_index_lookup<reconcilable_result>(std::move(s), cmd, ranges, std::move(trace_state), timeout, true,
+                    [this] (schema_ptr s, const query::read_command& base_cmd, const dht::partition_range_vector& ranges,
+                            tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+                return query_mutations(std::move(s), base_cmd, ranges.front(), std::move(trace_state), timeout).then(
+                        [] (std::tuple<reconcilable_result, cache_temperature> res) {
+                    uint64_t row_count = std::get<0>(res).row_count();
+                    return std::tuple(std::move(res), row_count);
+                });
+            }, [] (reconcilable_result& result) {
+                result.set_short_read(query::short_read::yes);
+            });
+        });
+    }
     const auto short_read_allwoed = query::short_read(cmd.slice.options.contains<query::partition_slice::option::allow_short_read>());
   return get_result_memory_limiter().new_mutation_read(*cmd.max_result_size, short_read_allwoed).then(
           [&, s = std::move(s), trace_state = std::move(trace_state), timeout] (query::result_memory_accounter accounter) {
@@ -1456,6 +1526,236 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
   });
 }
 
+// Whether the clustering key of a local index view is the indexed value
+// followed by the base clustering key, in the same order. Index entries for
+// a single value are then ordered like the base rows they point to.
+static bool local_index_follows_base_order(const schema& base, const schema& view) {
+    if (view.clustering_key_size() != base.clustering_key_size() + 1) {
+        return false;
+    }
+    for (const column_definition& base_col : base.clustering_key_columns()) {
+        const column_definition* view_col = view.view_info()->view_column(base_col);
+        if (!view_col || !view_col->is_clustering_key() || view_col->id != base_col.id + 1 || view_col->type != base_col.type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Translates the clustering ranges of a base read to the ranges of the
+// local index view holding entries for a single indexed value. Returns
+// std::nullopt if the index ranges don't select a single indexed value.
+static std::optional<query::clustering_row_ranges> local_index_ranges_for(const schema& view, const query::clustering_row_ranges& index_ranges,
+        const query::clustering_row_ranges& base_ranges) {
+    std::optional<bytes> value;
+    for (auto& r : index_ranges) {
+        if (!r.start() || !r.end()) {
+            return std::nullopt;
+        }
+        for (auto* b : {&*r.start(), &*r.end()}) {
+            if (b->value().is_empty(view)) {
+                return std::nullopt;
+            }
+            auto v = to_bytes(*b->value().begin(view));
+            if (value && *value != v) {
+                return std::nullopt;
+            }
+            value = std::move(v);
+        }
+    }
+    if (!value) {
+        return std::nullopt;
+    }
+    auto view_bound = [&] (const std::optional<query::clustering_range::bound>& b) {
+        std::vector<bytes> components{*value};
+        if (b) {
+            for (auto c : b->value().components()) {
+                components.emplace_back(to_bytes(c));
+            }
+        }
+        return query::clustering_range::bound(clustering_key_prefix::from_exploded(view, components), !b || b->is_inclusive());
+    };
+    query::clustering_row_ranges ranges;
+    ranges.reserve(base_ranges.size());
+    for (auto& r : base_ranges) {
+        ranges.emplace_back(view_bound(r.start()), view_bound(r.end()));
+    }
+    return ranges;
+}
+
+// Returns the key of the base row an entry of a local index view points to.
+static clustering_key local_index_base_key(const schema& base, const schema& view, const clustering_key& view_ck) {
+    std::vector<managed_bytes_view> components;
+    components.reserve(base.clustering_key_size());
+    for (const column_definition& base_col : base.clustering_key_columns()) {
+        const column_definition* view_col = view.view_info()->view_column(base_col);
+        if (!view_col || !view_col->is_clustering_key()) {
+            throw std::runtime_error(format("Base clustering key column {} is not a clustering key column of local index {}.{}",
+                    base_col.name_as_text(), view.ks_name(), view.cf_name()));
+        }
+        components.push_back(view_ck.get_component(view, view_col->id));
+    }
+    return clustering_key::from_range(std::move(components));
+}
+
+future<database::local_index_lookup_result>
+database::resolve_local_index_lookup(schema_ptr s, const query::read_command& cmd, const dht::partition_range_vector& ranges,
+        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout, bool with_deleted_entries) {
+    const auto& lookup = *cmd.index_lookup;
+    if (ranges.size() != 1 || !ranges.front().is_singular()) {
+        throw std::runtime_error(format("Local index lookup is only supported for single partition reads, got {}", ranges));
+    }
+    const auto& key = ranges.front().start()->value().as_decorated_key().key();
+    const auto& base_ranges = cmd.slice.row_ranges(*s, key);
+    const bool reversed = cmd.slice.options.contains<query::partition_slice::option::reversed>();
+
+    // The index view has the same partition key as the base table, so the
+    // index partition is owned by this shard too.
+    auto view_schema = find_schema(lookup.view_id);
+
+    // When the entries of the looked up value follow the base clustering
+    // order, read only those within the ranges of the command, which paging
+    // trims to start after the last row returned, and only as many as the
+    // page can hold. Otherwise, each page has to read all of them.
+    auto row_limit = query::row_limit::max;
+    std::optional<query::clustering_row_ranges> view_ranges;
+    if (local_index_follows_base_order(*s, *view_schema)) {
+        view_ranges = local_index_ranges_for(*view_schema, lookup.ranges, base_ranges);
+    }
+    if (view_ranges && cmd.slice.options.contains<query::partition_slice::option::allow_short_read>()) {
+        row_limit = query::row_limit(std::min(cmd.get_row_limit(), cmd.slice.partition_row_limit()));
+    }
+    auto view_slice_builder = partition_slice_builder(*view_schema);
+    view_slice_builder.with_ranges(view_ranges ? std::move(*view_ranges) : lookup.ranges)
+            .with_no_static_columns()
+            .with_no_regular_columns();
+    if (reversed && view_ranges) {
+        view_slice_builder.with_option<query::partition_slice::option::reversed>();
+    }
+    auto view_slice = view_slice_builder.build();
+    auto view_cmd = make_lw_shared<query::read_command>(view_schema->id(), view_schema->version(), std::move(view_slice),
+            *cmd.max_result_size, row_limit, query::partition_limit(1), cmd.timestamp, std::nullopt,
+            utils::UUID(), query::is_first_page::no, cmd.read_timestamp);
+    std::vector<clustering_key> keys;
+    uint64_t live_entries = 0;
+    bool has_range_deletions = false;
+    if (with_deleted_entries) {
+        // Replicas may disagree on the indexed value of a row. For the
+        // newest version of the row to win reconciliation, a replica which
+        // deleted the entry of a row for the looked up value returns the
+        // row as well.
+        auto [view_result, hit_rate] = co_await query_mutations(view_schema, *view_cmd, ranges.front(), trace_state, timeout);
+        live_entries = view_result.row_count();
+        for (auto& p : view_result.partitions()) {
+            auto m = p.mut().unfreeze(view_schema);
+            has_range_deletions |= bool(m.partition().partition_tombstone()) || !m.partition().row_tombstones().empty();
+            for (const rows_entry& e : m.partition().clustered_rows()) {
+                keys.push_back(local_index_base_key(*s, *view_schema, e.key()));
+            }
+        }
+        // Mutations are in the clustering order of the view, whichever
+        // order it was read in.
+        if (reversed && view_ranges) {
+            std::reverse(keys.begin(), keys.end());
+        }
+    } else {
+        auto [view_result, hit_rate] = co_await query(view_schema, *view_cmd, query::result_options::only_result(), ranges, trace_state, timeout);
+
+        struct index_entries_visitor : public query::result_visitor {
+            const schema& base_schema;
+            const schema& view_schema;
+            std::vector<clustering_key> keys;
+
+            void accept_new_row(const clustering_key& view_ck, const query::result_row_view& static_row, const query::result_row_view& row) {
+                keys.push_back(local_index_base_key(base_schema, view_schema, view_ck));
+            }
+            using query::result_visitor::accept_new_row;
+        };
+        index_entries_visitor visitor{{}, *s, *view_schema, {}};
+        query::result_view::consume(*view_result, view_cmd->slice, visitor);
+        keys = std::move(visitor.keys);
+        live_entries = keys.size();
+    }
+    tracing::trace(trace_state, "Found {} entries in local index {}.{}", keys.size(), view_schema->ks_name(), view_schema->cf_name());
+
+    local_index_lookup_result result;
+    if (has_range_deletions) {
+        // Which base rows the deleted entries pointed to is unknown, so
+        // read all those of the command.
+        auto base_cmd = make_lw_shared<query::read_command>(cmd);
+        base_cmd->index_lookup = std::nullopt;
+        base_cmd->query_uuid = utils::UUID();
+        base_cmd->is_first_page = query::is_first_page::yes;
+        result.cmd = std::move(base_cmd);
+        co_return result;
+    }
+    // Entries read in base order end with the last one the limit let in.
+    if (live_entries >= static_cast<uint64_t>(row_limit)) {
+        result.last_key = keys.back();
+    }
+
+    // Index entries are ordered by the indexed value first, so restore the
+    // base clustering order and drop keys listed more than once.
+    std::sort(keys.begin(), keys.end(), clustering_key::less_compare(*s));
+    keys.erase(std::unique(keys.begin(), keys.end(), clustering_key::equality(*s)), keys.end());
+
+    // Only keep the rows which the command would read anyway, in case its
+    // ranges were trimmed by paging.
+    auto cmp = clustering_key_prefix::prefix_equal_tri_compare(*s);
+    query::clustering_row_ranges row_ranges;
+    for (auto& ck : keys) {
+        if (boost::algorithm::any_of(base_ranges, [&] (const query::clustering_range& r) { return r.contains(ck, cmp); })) {
+            row_ranges.push_back(query::clustering_range::make_singular(std::move(ck)));
+        }
+    }
+    if (reversed) {
+        std::reverse(row_ranges.begin(), row_ranges.end());
+    }
+    if (s->clustering_key_size() == 0 && !row_ranges.empty()) {
+        row_ranges = query::clustering_row_ranges{query::clustering_range::make_open_ended_both_sides()};
+    }
+
+    auto base_cmd = make_lw_shared<query::read_command>(cmd);
+    base_cmd->index_lookup = std::nullopt;
+    base_cmd->slice.clear_ranges();
+    base_cmd->slice._row_ranges = std::move(row_ranges);
+    // The ranges depend on the index contents, so a querier saved for this
+    // read could not be resumed by the next page.
+    base_cmd->query_uuid = utils::UUID();
+    base_cmd->is_first_page = query::is_first_page::yes;
+    result.cmd = std::move(base_cmd);
+    co_return result;
+}
+
+template <typename Result, typename Query, typename MarkShortRead>
+future<std::tuple<Result, cache_temperature>>
+database::query_with_local_index_lookup(schema_ptr s, const query::read_command& cmd, const dht::partition_range_vector& ranges,
+        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout, bool with_deleted_entries,
+        Query query, MarkShortRead mark_short_read) {
+    const auto& key = ranges.front().start()->value().as_decorated_key().key();
+    const bool reversed = cmd.slice.options.contains<query::partition_slice::option::reversed>();
+    auto lookup_cmd = make_lw_shared<query::read_command>(cmd);
+    for (;;) {
+        auto lookup = co_await resolve_local_index_lookup(s, *lookup_cmd, ranges, trace_state, timeout, with_deleted_entries);
+        auto [res, row_count] = co_await query(s, *lookup.cmd, ranges, trace_state, timeout);
+        if (!lookup.last_key || row_count >= cmd.get_row_limit()) {
+            co_return std::move(res);
+        }
+        // The index read stopped at the page size, but some of the entries
+        // it found had no matching base row. Rows past the last entry may
+        // still exist, so tell the pager to continue, or if no row was
+        // found at all, look further, as a short read must not be empty.
+        if (row_count > 0) {
+            mark_short_read(std::get<0>(res));
+            co_return std::move(res);
+        }
+        auto next_ranges = lookup_cmd->slice.row_ranges(*s, key);
+        query::trim_clustering_row_ranges_to(*s, next_ranges, *lookup.last_key, reversed);
+        lookup_cmd->slice.clear_ranges();
+        lookup_cmd->slice._row_ranges = std::move(next_ranges);
+    }
+}
+
 std::unordered_set<sstring> database::get_initial_tokens() {
     std::unordered_set<sstring> tokens;
     sstring tokens_string = get_config().initial_token();
@@ -1669,12 +1969,25 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
 }
 
 future<> dirty_memory_manager::flush_one(memtable_list& mtlist, flush_permit&& permit) {
+    ++_flushes_in_flight;
     return mtlist.seal_active_memtable(std::move(permit)).handle_exception([this, schema = mtlist.back()->schema()] (std::exception_ptr ep) {
         dblog.error("Failed to flush memtable, {}:{} - {}", schema->ks_name(), schema->cf_name(), ep);
         return make_exception_future<>(ep);
+    }).finally([this] {
+        --_flushes_in_flight;
+        _flush_completed.broadcast();
     });
 }
 
+future<> dirty_memory_manager::wait_for_flush_completion() {
+    if (!_flushes_in_flight) {
+        // Nothing in flight will release memory, so all we can do is back
+        // off to avoid OOMing with flush continuations.
+        return sleep(1ms);
+    }
+    return _flush_completed.wait();
+}
+
 future<> dirty_memory_manager::flush_when_needed() {
     if (!_db) {
         return make_ready_future<>();
@@ -1707,8 +2020,16 @@ future<> dirty_memory_manager::flush_when_needed() {
                 if (!candidate_memtable.region().evictable_occupancy()) {
                     // Soft pressure, but nothing to flush. It could be due to fsync, memtable_to_cache lagging,
                     // or candidate_memtable failed to flush.
-                    // Back off to avoid OOMing with flush continuations.
-                    return sleep(1ms);
+                    // Back off until a flush completes, to avoid OOMing with flush continuations.
+                    return this->wait_for_flush_completion();
+                }
+
+                // With other flushes already in flight, pressure may abate once they are done, so
+                // don't start another one for a small memtable, which would only produce a tiny
+                // sstable.
+                if (this->flushes_in_progress() > 1
+                        && candidate_memtable.region().evictable_occupancy().total_space() < this->soft_limit_threshold() / _max_concurrent_flushes) {
+                    return this->wait_for_flush_completion();
                 }
 
                 // Do not wait. The semaphore will protect us against a concurrent flush. But we
@@ -1738,7 +2059,7 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
     data_listeners().on_write(m_schema, m);
 
   return cf.run_async([this, &m, m_schema = std::move(m_schema), h = std::move(h), &cf, timeout]() mutable {
-    return cf.dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h), &cf]() mutable {
+    return cf.get_dirty_memory_manager().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h), &cf]() mutable {
         cf.apply(m, m_schema, std::move(h));
     }, timeout);
   });
@@ -1746,7 +2067,7 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
 
 future<> database::apply_in_memory(const mutation& m, column_family& cf, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
   return cf.run_async([this, &m, h = std::move(h), &cf, timeout]() mutable {
-    return cf.dirty_memory_region_group().run_when_memory_available([this, &m, &cf, h = std::move(h)]() mutable {
+    return cf.get_dirty_memory_manager().run_when_memory_available([this, &m, &cf, h = std::move(h)]() mutable {
         cf.apply(m, std::move(h));
     }, timeout);
   });
@@ -56,6 +56,7 @@
 #include "compaction_strategy.hh"
 #include "utils/estimated_histogram.hh"
 #include "sstables/sstable_set.hh"
+#include "sstables/types.hh"
 #include <seastar/core/metrics_registration.hh>
 #include "tracing/trace_state.hh"
 #include "db/view/view_stats.hh"
@@ -285,6 +286,7 @@ struct cf_stats {
     int64_t pending_memtables_flushes_count = 0;
     int64_t pending_memtables_flushes_bytes = 0;
     int64_t failed_memtables_flushes_count = 0;
+    int64_t split_memtables_flushes_count = 0;
 
     // number of time the clustering filter was executed
     int64_t clustering_filter_count = 0;
@@ -294,6 +296,8 @@ struct cf_stats {
     int64_t clustering_filter_fast_path_count = 0;
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
+    // sstables skipped by their bloom filter of clustering keys
+    int64_t sstables_skipped_by_clustering_key_filter = 0;
 
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
@@ -306,6 +310,12 @@ struct cf_stats {
     uint64_t total_view_updates_pushed_remote = 0;
     uint64_t total_view_updates_failed_local = 0;
     uint64_t total_view_updates_failed_remote = 0;
+    // How many view update batches were sent and how many updates they carried
+    uint64_t total_view_update_batches = 0;
+    uint64_t total_view_updates_batched = 0;
+    // How many times the read-before-write of view update generation was
+    // skipped because the base partition was known not to exist
+    uint64_t total_view_update_reads_skipped = 0;
 };
 
 class table;
@@ -359,6 +369,9 @@ class table : public enable_lw_shared_from_this<table> {
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
         ::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
+        // Memtables larger than this are flushed by parallel writers, one per token range.
+        // Zero disables splitting.
+        size_t memtable_flush_split_threshold = 0;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
         reader_concurrency_semaphore* compaction_concurrency_semaphore;
         ::cf_stats* cf_stats = nullptr;
@@ -412,11 +425,6 @@ class table : public enable_lw_shared_from_this<table> {
     // have not been deleted yet, so must not GC any tombstones in other sstables
     // that may delete data in these sstables:
     std::vector<sstables::shared_sstable> _sstables_compacted_but_not_deleted;
-    // sstables that have been opened but not loaded yet, that's because refresh
-    // needs to load all opened sstables atomically, and now, we open a sstable
-    // in all shards at the same time, which makes it hard to store all sstables
-    // we need to load later on for all shards.
-    std::vector<sstables::shared_sstable> _sstables_opened_but_not_loaded;
     // sstables that should not be compacted (e.g. because they need to be used
     // to generate view updates later)
     std::unordered_map<uint64_t, sstables::shared_sstable> _sstables_staging;
@@ -586,6 +594,26 @@ class table : public enable_lw_shared_from_this<table> {
                                         tracing::trace_state_ptr trace_state,
                                         streamed_mutation::forwarding fwd,
                                         mutation_reader::forwarding fwd_mr) const;
+    // Like make_sstable_reader(), for a single partition, which is read in
+    // reverse clustering order, in the format of make_reversing_reader().
+    flat_mutation_reader make_reversed_sstable_reader(schema_ptr schema,
+                                        reader_permit permit,
+                                        lw_shared_ptr<sstables::sstable_set> sstables,
+                                        const dht::partition_range& range,
+                                        const query::partition_slice& slice,
+                                        const io_priority_class& pc,
+                                        tracing::trace_state_ptr trace_state,
+                                        query::max_result_size max_size) const;
+    // Like make_reader(), for a single partition, which is read in reverse
+    // clustering order, in the format of make_reversing_reader(), by each of
+    // the memtables, the cache and the sstables.
+    flat_mutation_reader make_reversed_reader(schema_ptr schema,
+            reader_permit permit,
+            const dht::partition_range& range,
+            const query::partition_slice& slice,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state,
+            query::max_result_size max_size) const;
 
     lw_shared_ptr<sstables::sstable_set> make_maintenance_sstable_set() const;
     lw_shared_ptr<sstables::sstable_set> make_compound_sstable_set();
@@ -605,6 +633,10 @@ class table : public enable_lw_shared_from_this<table> {
         return _config.dirty_memory_manager->region_group();
     }
 
+    ::dirty_memory_manager& get_dirty_memory_manager() const {
+        return *_config.dirty_memory_manager;
+    }
+
     // Used for asynchronous operations that may defer and need to guarantee that the column
     // family will be alive until their termination
     template<typename Func, typename Futurator = futurize<std::result_of_t<Func()>>, typename... Args>
@@ -673,8 +705,9 @@ class table : public enable_lw_shared_from_this<table> {
     //    reader and a _bounded_ amount of writes which arrive later.
     //  - Does not populate the cache
     // Requires ranges to be sorted and disjoint.
+    // The excluded sstables are left out of the table's sstables.
     flat_mutation_reader make_streaming_reader(schema_ptr schema,
-            const dht::partition_range_vector& ranges) const;
+            const dht::partition_range_vector& ranges, const std::vector<sstables::shared_sstable>& excluded = {}) const;
 
     // Single range overload.
     flat_mutation_reader make_streaming_reader(schema_ptr schema, const dht::partition_range& range,
@@ -697,6 +730,11 @@ class table : public enable_lw_shared_from_this<table> {
     mutation_source as_mutation_source() const;
     mutation_source as_mutation_source_excluding(std::vector<sstables::shared_sstable>& sst) const;
 
+    // Returns the source to serve a query of `range` with `slice` from, and
+    // whether it emits the partitions of a reversed slice in reverse already.
+    std::pair<mutation_source, query::reader_is_reversed> as_query_source(const dht::partition_range& range,
+            const query::partition_slice& slice, query::max_result_size max_size) const;
+
     void set_virtual_reader(mutation_source virtual_reader) {
         _virtual_reader = std::move(virtual_reader);
     }
@@ -849,6 +887,12 @@ class table : public enable_lw_shared_from_this<table> {
     lw_shared_ptr<const sstable_list> get_sstables_including_compacted_undeleted() const;
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
+    // Returns the sum of the repair digests of the sstables for the buckets of
+    // the ring with the given number of bits which overlap the range, sorted by
+    // bucket index, see sstables::repair_digest_builder. Returns std::nullopt
+    // if some data in the range is not covered by a digest. The digests are
+    // read from the sstables on demand.
+    future<std::optional<utils::chunked_vector<sstables::repair_digest_bucket>>> get_repair_digest(const dht::token_range& range, uint32_t bucket_bits) const;
     // Return all sstables but those that are off-strategy like the ones in maintenance set and staging dir.
     std::vector<sstables::shared_sstable> in_strategy_sstables() const;
     size_t sstables_count() const;
@@ -1013,6 +1057,10 @@ class table : public enable_lw_shared_from_this<table> {
             tracing::trace_state_ptr tr_state,
             gc_clock::time_point now) const;
 
+    // Returns true if neither the memtables nor the bloom filters of the
+    // sstables know of the given partition.
+    bool partition_definitely_absent(const dht::decorated_key& key) const;
+
     mutable row_locker _row_locker;
     future<row_locker::lock_holder> local_base_lock(
             const schema_ptr& s,
@@ -1380,6 +1428,28 @@ class database {
     Future update_write_metrics(Future&& f);
     void update_write_metrics_for_timed_out_write();
     future<> create_keyspace(const lw_shared_ptr<keyspace_metadata>&, bool is_bootstrap, system_keyspace system);
+
+    struct local_index_lookup_result {
+        // A copy of the command, restricted to the base rows found
+        lw_shared_ptr<query::read_command> cmd;
+        // Set if the index read stopped at the row limit of the command,
+        // to the last base row found.
+        std::optional<clustering_key> last_key;
+    };
+    // Looks up the local index of cmd.index_lookup, starting at the
+    // clustering ranges of cmd and reading at most as many entries as its
+    // page can hold. With with_deleted_entries, the base rows of deleted
+    // entries are read as well, for reconciliation.
+    future<local_index_lookup_result> resolve_local_index_lookup(schema_ptr s, const query::read_command& cmd,
+            const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout,
+            bool with_deleted_entries);
+    // Runs query for the base rows found by resolve_local_index_lookup(),
+    // looking further when none of them exists, and using mark_short_read
+    // when fewer rows than the page can hold exist.
+    template <typename Result, typename Query, typename MarkShortRead>
+    future<std::tuple<Result, cache_temperature>> query_with_local_index_lookup(schema_ptr s, const query::read_command& cmd,
+            const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout,
+            bool with_deleted_entries, Query query, MarkShortRead mark_short_read);
 public:
     static utils::UUID empty_version;
 
@@ -715,6 +715,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , replace_address_first_boot(this, "replace_address_first_boot", value_status::Used, "", "Like replace_address option, but if the node has been bootstrapped successfully it will be ignored. Same as -Dcassandra.replace_address_first_boot.")
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, false, "Set true to use enable repair based node operations instead of streaming based")
+    , streaming_parallel_streams_per_shard(this, "streaming_parallel_streams_per_shard", liveness::LiveUpdate, value_status::Used, 2,
+        "The number of concurrent streams each shard may send a table's ranges to a peer over, each covering a part of the ranges and written by its own sstable writers on the peer. Each stream holds its own reader on the sender and its own writers on the receiver")
     , wait_for_hint_replay_before_repair(this, "wait_for_hint_replay_before_repair", liveness::LiveUpdate, value_status::Used, true, "If set to true, the cluster will first wait until the cluster sends its hints towards the nodes participating in repair before proceeding with the repair itself. This reduces the amount of data needed to be transferred during repair.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
@@ -733,8 +735,19 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , abort_on_lsa_bad_alloc(this, "abort_on_lsa_bad_alloc", value_status::Used, false, "Abort when allocation in LSA region fails")
     , murmur3_partitioner_ignore_msb_bits(this, "murmur3_partitioner_ignore_msb_bits", value_status::Used, 12, "Number of most siginificant token bits to ignore in murmur3 partitioner; increase for very large clusters")
     , virtual_dirty_soft_limit(this, "virtual_dirty_soft_limit", value_status::Used, 0.6, "Soft limit of virtual dirty memory expressed as a portion of the hard limit")
+    , memtable_flush_concurrency(this, "memtable_flush_concurrency", value_status::Used, 2,
+        "Maximum number of sstable writers flushing user memtables at the same time, per shard. Higher values let flushes keep up with write bursts to many tables, "
+        "at the cost of memory being released later. Writers share the I/O share of the memtable flush controller.")
+    , memtable_flush_split_threshold_in_mb(this, "memtable_flush_split_threshold_in_mb", value_status::Used, 64,
+        "Memtables larger than this are flushed by several writers in parallel, each writing a token range, if memtable_flush_concurrency allows. Set to zero to disable")
     , sstable_summary_ratio(this, "sstable_summary_ratio", value_status::Used, 0.0005, "Enforces that 1 byte of summary is written for every N (2000 by default) "
         "bytes written to data file. Value must be between 0 and 1.")
+    , enable_sstable_clustering_key_filter(this, "enable_sstable_clustering_key_filter", value_status::Used, false,
+        "Write sstables with a bloom filter of their clustering keys, which lets single-row reads skip sstables which do not contain the row. "
+        "The filter takes about as much memory per row as the partition bloom filter takes per partition.")
+    , sstable_clustering_key_filter_memory_ratio(this, "sstable_clustering_key_filter_memory_ratio", value_status::Used, 0.05,
+        "The fraction of each shard's memory the clustering key filters of open sstables may take. "
+        "The filters of sstables opened beyond that are not loaded, and reads of those sstables go without them.")
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
     , enable_deprecated_partitioners(this, "enable_deprecated_partitioners", value_status::Used, false, "Enable the byteordered and random partitioners. These partitioners are deprecated and will be removed in a future version.")
     , enable_keyspace_column_family_metrics(this, "enable_keyspace_column_family_metrics", value_status::Used, false, "Enable per keyspace and per column family metrics reporting")
@@ -744,6 +757,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_building_concurrency(this, "view_building_concurrency", liveness::LiveUpdate, value_status::Used, 4,
+        "The number of batches of base rows each shard may concurrently generate and propagate view updates for, while building views")
+    , view_update_batch_size_in_kb(this, "view_update_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 128,
+        "View updates generated by a base write and headed to the same view replica are sent in batches of up to this size. Set to zero to send every view update separately")
+    , hint_replay_batch_size_in_kb(this, "hint_replay_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 256,
+        "Hints replayed towards a node which is still their replica are sent in batches of up to this size. Set to zero to send every hint separately")
+    , enable_hint_coalescing(this, "enable_hint_coalescing", liveness::LiveUpdate, value_status::Used, false,
+        "Merge the hints of a segment which belong to the same partition before replaying them, so that data overwritten while the node was down is sent only once. Hints of counter tables are never merged")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Used, true, "Enable SSTables 'md' format to be used as the default file format")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
@@ -280,6 +280,7 @@ class config : public utils::config_file {
     named_value<sstring> replace_address_first_boot;
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
+    named_value<uint32_t> streaming_parallel_streams_per_shard;
     named_value<bool> wait_for_hint_replay_before_repair;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
@@ -298,7 +299,11 @@ class config : public utils::config_file {
     named_value<bool> abort_on_lsa_bad_alloc;
     named_value<unsigned> murmur3_partitioner_ignore_msb_bits;
     named_value<double> virtual_dirty_soft_limit;
+    named_value<uint32_t> memtable_flush_concurrency;
+    named_value<uint32_t> memtable_flush_split_threshold_in_mb;
     named_value<double> sstable_summary_ratio;
+    named_value<bool> enable_sstable_clustering_key_filter;
+    named_value<double> sstable_clustering_key_filter_memory_ratio;
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
     named_value<bool> enable_keyspace_column_family_metrics;
@@ -306,6 +311,10 @@ class config : public utils::config_file {
     named_value<bool> enable_sstable_key_validation;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<uint32_t> view_building_concurrency;
+    named_value<uint32_t> view_update_batch_size_in_kb;
+    named_value<uint32_t> hint_replay_batch_size_in_kb;
+    named_value<bool> enable_hint_coalescing;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_sstables_md_format;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <optional>
+
+#include "frozen_mutation.hh"
+#include "db/commitlog/replay_position.hh"
+
+namespace db {
+namespace hints {
+
+// Hints read from a segment which are sent to their destination in a single message.
+//
+// The batch is accounted to the replay position of its first hint: if sending it fails,
+// the segment has to be replayed again from that position for none of its hints to be lost.
+class hints_batch {
+    std::vector<frozen_mutation> _mutations;
+    size_t _size = 0;
+    std::optional<db::replay_position> _first_rp;
+
+public:
+    void add(frozen_mutation fm, db::replay_position rp) {
+        if (!_first_rp) {
+            _first_rp = rp;
+        }
+        _size += fm.representation().size();
+        _mutations.push_back(std::move(fm));
+    }
+
+    bool empty() const noexcept {
+        return _mutations.empty();
+    }
+
+    // Size of the serialized hints in the batch.
+    size_t size_bytes() const noexcept {
+        return _size;
+    }
+
+    // Replay position of the first hint added to the batch, disengaged if the batch is empty.
+    const std::optional<db::replay_position>& first_rp() const noexcept {
+        return _first_rp;
+    }
+
+    // Hands over the hints of the batch, which is empty again afterwards.
+    std::vector<frozen_mutation> release() noexcept {
+        _size = 0;
+        _first_rp.reset();
+        return std::exchange(_mutations, {});
+    }
+};
+
+} // namespace hints
+} // namespace db
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "db/hints/hints_coalescer.hh"
+
+namespace db {
+namespace hints {
+
+hints_coalescer::add_result hints_coalescer::add(const frozen_mutation_and_schema& m, db::replay_position rp) {
+    if (!can_coalesce(*m.s)) {
+        return add_result::rejected;
+    }
+
+    auto mut = m.fm.unfreeze(m.s);
+    // Merging never takes more memory than keeping the mutations apart, so this is an upper bound.
+    _memory_usage += sizeof(coalesced_partition) + mut.decorated_key().external_memory_usage() + mut.partition().external_memory_usage(*m.s);
+
+    auto& table = _tables.try_emplace(m.s->id(), dht::decorated_key::less_comparator(m.s)).first->second;
+    auto it = table.find(mut.decorated_key());
+    if (it == table.end()) {
+        auto dk = mut.decorated_key();
+        table.emplace(std::move(dk), coalesced_partition{std::move(mut), rp});
+        return add_result::added;
+    }
+
+    // Hints are converted to the current schema of their table when read, which may change
+    // while the segment is being read.
+    auto& merged = it->second.m;
+    if (merged.schema()->version() != mut.schema()->version()) {
+        merged.upgrade(mut.schema());
+    }
+    merged.apply(std::move(mut));
+    return add_result::merged;
+}
+
+std::vector<hints_coalescer::coalesced_partition> hints_coalescer::release() {
+    std::vector<coalesced_partition> ret;
+    auto tables = std::exchange(_tables, {});
+    _memory_usage = 0;
+    for (auto& [id, table] : tables) {
+        for (auto& [dk, p] : table) {
+            ret.push_back(std::move(p));
+        }
+    }
+    return ret;
+}
+
+} // namespace hints
+} // namespace db
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "mutation.hh"
+#include "frozen_mutation.hh"
+#include "db/commitlog/replay_position.hh"
+#include "utils/UUID.hh"
+
+namespace db {
+namespace hints {
+
+// Merges the hints read from a segment per partition, so that a partition written many times
+// is sent once, with the newest data of each cell.
+class hints_coalescer {
+public:
+    struct coalesced_partition {
+        mutation m;
+        // Replay position of the first hint merged into m.
+        db::replay_position first_rp;
+    };
+
+    enum class add_result {
+        // The hint cannot be merged and has to be sent on its own.
+        rejected,
+        // The hint is the first one of its partition.
+        added,
+        // The hint was merged into an earlier hint of its partition.
+        merged,
+    };
+
+private:
+    using table_partitions = std::map<dht::decorated_key, coalesced_partition, dht::decorated_key::less_comparator>;
+
+    std::unordered_map<utils::UUID, table_partitions> _tables;
+    size_t _memory_usage = 0;
+
+public:
+    // Counter updates are not idempotent, merging them would change their result.
+    static bool can_coalesce(const schema& s) noexcept {
+        return !s.is_counter();
+    }
+
+    // Merges the hint into the hints of its partition added before. Writes are merged
+    // with mutation::apply(), the cell with the highest timestamp wins.
+    add_result add(const frozen_mutation_and_schema& m, db::replay_position rp);
+
+    bool empty() const noexcept {
+        return _tables.empty();
+    }
+
+    // Memory used by the merged mutations, counting each added hint in full.
+    size_t memory_usage() const noexcept {
+        return _memory_usage;
+    }
+
+    // Hands over the merged mutations, the coalescer is empty again afterwards.
+    std::vector<coalesced_partition> release();
+};
+
+} // namespace hints
+} // namespace db
@@ -21,6 +21,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <seastar/core/future.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/gate.hh>
@@ -71,6 +72,8 @@ manager::~manager() {
 void manager::register_metrics(const sstring& group_name) {
     namespace sm = seastar::metrics;
 
+    _metrics_group_name = group_name;
+
     _metrics.add_group(group_name, {
         sm::make_gauge("size_of_hints_in_progress", _stats.size_of_hints_in_progress,
                         sm::description("Size of hinted mutations that are scheduled to be written.")),
@@ -87,6 +90,12 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_derive("sent", _stats.sent,
                         sm::description("Number of sent hints.")),
 
+        sm::make_derive("sent_batches", _stats.sent_batches,
+                        sm::description("Number of batches of hints sent to nodes which are still their replicas.")),
+
+        sm::make_derive("coalesced", _stats.coalesced,
+                        sm::description("Number of hints merged into an earlier hint of the same partition before being sent.")),
+
         sm::make_derive("discarded", _stats.discarded,
                         sm::description("Number of hints that were discarded during sending (too old, schema changed, etc.).")),
 
@@ -654,6 +663,9 @@ manager::end_point_hints_manager::sender::sender(const sender& other, end_point_
 
 
 future<> manager::end_point_hints_manager::sender::stop(drain should_drain) noexcept {
+    // Unregister the metrics right away, the endpoint manager may be replaced by a new one for the
+    // same destination before this one is destroyed.
+    _metrics.clear();
     return seastar::async([this, should_drain] {
         set_stopping();
         _stopped.get();
@@ -778,10 +790,42 @@ void manager::end_point_hints_manager::sender::dismiss_all_segment_waiters(std::
     }
 }
 
+void manager::end_point_hints_manager::sender::register_metrics() {
+    namespace sm = seastar::metrics;
+
+    if (_shard_manager._metrics_group_name.empty()) {
+        return;
+    }
+
+    // A sender may be started again for the same destination, the metrics must not be registered twice.
+    _metrics.clear();
+    auto endpoint_label = sm::label("endpoint");
+    _metrics.add_group(_shard_manager._metrics_group_name, {
+        sm::make_gauge("pending_segments", [this] { return _segments_to_replay.size(); },
+                        sm::description("Number of hints segments waiting to be replayed towards the endpoint."),
+                        {endpoint_label(format("{}", end_point_key()))}),
+
+        sm::make_gauge("replay_eta_seconds", [this] { return replay_eta().count(); },
+                        sm::description("Estimated time to replay the pending hints segments towards the endpoint, at the pace the previous segments were replayed. Negative if not known yet."),
+                        {endpoint_label(format("{}", end_point_key()))}),
+    });
+}
+
+std::chrono::duration<double> manager::end_point_hints_manager::sender::replay_eta() const noexcept {
+    if (!have_segments()) {
+        return std::chrono::duration<double>(0);
+    }
+    if (_avg_segment_replay_time.count() == 0) {
+        return std::chrono::duration<double>(-1);
+    }
+    return _avg_segment_replay_time * _segments_to_replay.size();
+}
+
 void manager::end_point_hints_manager::sender::start() {
     seastar::thread_attributes attr;
 
     attr.sched_group = _hints_cpu_sched_group;
+    register_metrics();
     _stopped = seastar::async(std::move(attr), [this] {
         manager_logger.trace("ep_manager({})::sender: started", end_point_key());
         while (!stopping()) {
@@ -811,45 +855,69 @@ future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_muta
     return do_send_one_mutation(std::move(m), natural_endpoints);
 }
 
+std::optional<frozen_mutation_and_schema> manager::end_point_hints_manager::sender::decode_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer& buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    try {
+        auto m = get_mutation(ctx_ptr, buf);
+        gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+        // The hint is too old - drop it.
+        //
+        // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
+        // (last_modification - manager::hints_timer_period) old.
+        if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+            return std::nullopt;
+        }
+        return m;
+
+    // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+    } catch (no_such_column_family& e) {
+        manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+        ++shard_stats().discarded;
+    } catch (no_such_keyspace& e) {
+        manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+        ++shard_stats().discarded;
+    } catch (no_column_mapping& e) {
+        manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+        ++shard_stats().discarded;
+    } catch (...) {
+        manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+        ctx_ptr->on_hint_send_failure(rp);
+    }
+    return std::nullopt;
+}
+
 future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
     ctx_ptr->last_attempted_rp = rp;
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
-        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
-        (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
-            try {
-                auto m = this->get_mutation(ctx_ptr, buf);
-                gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
-
-                // The hint is too old - drop it.
-                //
-                // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
-                // (last_modification - manager::hints_timer_period) old.
-                if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
-                    return make_ready_future<>();
-                }
+    auto m = decode_hint(ctx_ptr, buf, rp, secs_since_file_mod, fname);
+    if (!m) {
+        return make_ready_future<>();
+    }
 
-                return this->send_one_mutation(std::move(m)).then([this, rp, ctx_ptr] {
-                    ++this->shard_stats().sent;
-                }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
-                    manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
-                    ctx_ptr->on_hint_send_failure(rp);
-                });
+    if (_db.get_config().enable_hint_coalescing() && hints_coalescer::can_coalesce(*m->s)) {
+        return coalesce_hint(std::move(ctx_ptr), std::move(*m), rp);
+    }
+    return send_decoded_hint(std::move(ctx_ptr), std::move(*m), rp);
+}
 
-            // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
-            } catch (no_such_column_family& e) {
-                manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_such_keyspace& e) {
-                manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_column_mapping& e) {
-                manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
-                ++this->shard_stats().discarded;
-            } catch (...) {
-                manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+future<> manager::end_point_hints_manager::sender::send_decoded_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp) {
+    // Hints for which the destination is no longer a replica have to be sent to all current replicas
+    // and cannot be batched.
+    if (batching_enabled() && is_replica_of(m)) {
+        return add_to_batch(std::move(ctx_ptr), std::move(m), rp);
+    }
+
+    auto size = m.fm.representation().size();
+    return _resource_manager.get_send_units_for(size).then([this, m = std::move(m), rp, ctx_ptr] (auto units) mutable {
+        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+        (void)with_gate(ctx_ptr->file_send_gate, [this, m = std::move(m), rp, ctx_ptr] () mutable {
+            return futurize_invoke([this, &m] {
+                return this->send_one_mutation(std::move(m));
+            }).then([this] {
+                ++this->shard_stats().sent;
+            }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
+                manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
                 ctx_ptr->on_hint_send_failure(rp);
-            }
-            return make_ready_future<>();
+            });
         }).finally([units = std::move(units), ctx_ptr] {});
     }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
         manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", eptr);
@@ -857,6 +925,95 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
     });
 }
 
+future<> manager::end_point_hints_manager::sender::coalesce_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp) {
+    switch (ctx_ptr->coalescer.add(m, rp)) {
+    case hints_coalescer::add_result::rejected:
+        return send_decoded_hint(std::move(ctx_ptr), std::move(m), rp);
+    case hints_coalescer::add_result::merged:
+        ++shard_stats().coalesced;
+        break;
+    case hints_coalescer::add_result::added:
+        break;
+    }
+
+    if (ctx_ptr->coalescer.memory_usage() < max_coalesced_hints_size) {
+        return make_ready_future<>();
+    }
+    return send_coalesced(std::move(ctx_ptr));
+}
+
+future<> manager::end_point_hints_manager::sender::send_coalesced(lw_shared_ptr<send_one_file_ctx> ctx_ptr) {
+    for (auto& p : ctx_ptr->coalescer.release()) {
+        auto s = p.m.schema();
+        co_await send_decoded_hint(ctx_ptr, frozen_mutation_and_schema{freeze(p.m), std::move(s)}, p.first_rp);
+    }
+}
+
+bool manager::end_point_hints_manager::sender::batching_enabled() const noexcept {
+    return _db.features().cluster_supports_hint_mutation_batches() && _db.get_config().hint_replay_batch_size_in_kb() > 0;
+}
+
+bool manager::end_point_hints_manager::sender::is_replica_of(const frozen_mutation_and_schema& m) const noexcept {
+    try {
+        auto& rs = _db.find_keyspace(m.s->ks_name()).get_replication_strategy();
+        auto natural_endpoints = rs.get_natural_endpoints(dht::get_token(*m.s, m.fm.key()));
+        return boost::range::find(natural_endpoints, end_point_key()) != natural_endpoints.end();
+    } catch (...) {
+        // Let the regular path deal with it.
+        return false;
+    }
+}
+
+future<> manager::end_point_hints_manager::sender::add_to_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp) {
+    ctx_ptr->batch.add(std::move(m.fm), rp);
+    if (ctx_ptr->batch.size_bytes() < _db.get_config().hint_replay_batch_size_in_kb() * 1024) {
+        return make_ready_future<>();
+    }
+    return send_batch(std::move(ctx_ptr));
+}
+
+future<> manager::end_point_hints_manager::sender::send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr) {
+    if (ctx_ptr->batch.empty()) {
+        return make_ready_future<>();
+    }
+    auto size = ctx_ptr->batch.size_bytes();
+    auto rp = *ctx_ptr->batch.first_rp();
+    auto fms = ctx_ptr->batch.release();
+
+    return _resource_manager.get_send_units_for(size).then([this, fms = std::move(fms), rp, ctx_ptr] (auto units) mutable {
+        return get_units(_batch_limiter, 1).then([this, fms = std::move(fms), rp, ctx_ptr, units = std::move(units)] (auto batch_units) mutable {
+            // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+            (void)with_gate(ctx_ptr->file_send_gate, [this, fms = std::move(fms), rp, ctx_ptr] () mutable {
+                auto nr_hints = fms.size();
+                return _proxy.send_hint_batch_to_endpoint(std::move(fms), end_point_key()).then([this, nr_hints] (db::view::update_backlog backlog) {
+                    shard_stats().sent += nr_hints;
+                    ++shard_stats().sent_batches;
+                    adjust_batch_concurrency(backlog);
+                }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
+                    manager_logger.trace("send_batch(): failed to send to {}: {}", end_point_key(), eptr);
+                    ctx_ptr->on_hint_send_failure(rp);
+                });
+            }).finally([units = std::move(units), batch_units = std::move(batch_units), ctx_ptr] {});
+        });
+    }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
+        manager_logger.trace("send_batch(): Hmmm. Something bad had happend: {}", eptr);
+        ctx_ptr->on_hint_send_failure(rp);
+    });
+}
+
+void manager::end_point_hints_manager::sender::adjust_batch_concurrency(const db::view::update_backlog& backlog) noexcept {
+    // Hints add to the view updates the destination has to apply, so back off as its backlog grows,
+    // down to a single batch at a time.
+    auto relative_size = std::clamp(backlog.relative_size(), 0.0f, 1.0f);
+    size_t target = std::max<size_t>(1, std::lround(max_batches_in_flight * (1 - relative_size)));
+    if (target > _batch_concurrency) {
+        _batch_limiter.signal(target - _batch_concurrency);
+    } else if (target < _batch_concurrency) {
+        _batch_limiter.consume(_batch_concurrency - target);
+    }
+    _batch_concurrency = target;
+}
+
 void manager::end_point_hints_manager::sender::send_one_file_ctx::on_hint_send_failure(db::replay_position rp) noexcept {
     segment_replay_failed = true;
     if (!first_failed_rp || rp < *first_failed_rp) {
@@ -899,6 +1056,10 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // send out what is left to be merged or batched, even after an error the hints read so far are good
+    send_coalesced(ctx_ptr).get();
+    send_batch(ctx_ptr).get();
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
@@ -941,10 +1102,13 @@ void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
 
     try {
         while (replay_allowed() && have_segments() && can_send()) {
+            auto start = clock::now();
             if (!send_one_file(*_segments_to_replay.begin())) {
                 sending_succeeded = false;
                 break;
             }
+            std::chrono::duration<double> replay_time = clock::now() - start;
+            _avg_segment_replay_time = _avg_segment_replay_time.count() == 0 ? replay_time : 0.8 * _avg_segment_replay_time + 0.2 * replay_time;
             _segments_to_replay.pop_front();
             ++replayed_segments_count;
             ++_total_replayed_segments_count;
@@ -41,6 +41,9 @@
 #include "utils/loading_shared_values.hh"
 #include "db/hints/resource_manager.hh"
 #include "db/hints/host_filter.hh"
+#include "db/hints/hints_batch.hh"
+#include "db/hints/hints_coalescer.hh"
+#include "db/view/view_update_backlog.hh"
 
 class fragmented_temporary_buffer;
 
@@ -88,6 +91,8 @@ class manager : public service::endpoint_lifecycle_subscriber {
         uint64_t errors = 0;
         uint64_t dropped = 0;
         uint64_t sent = 0;
+        uint64_t sent_batches = 0;
+        uint64_t coalesced = 0;
         uint64_t discarded = 0;
         uint64_t corrupted_files = 0;
     };
@@ -135,6 +140,10 @@ class manager : public service::endpoint_lifecycle_subscriber {
                 std::optional<db::replay_position> first_failed_rp;
                 std::optional<db::replay_position> last_attempted_rp;
                 bool segment_replay_failed = false;
+                // Hints collected to be sent together, see send_batch().
+                hints_batch batch;
+                // Hints merged per partition, see coalesce_hint().
+                hints_coalescer coalescer;
 
                 void on_hint_send_failure(db::replay_position rp) noexcept;
             };
@@ -157,6 +166,18 @@ class manager : public service::endpoint_lifecycle_subscriber {
             gms::gossiper& _gossiper;
             seastar::shared_mutex& _file_update_mutex;
             uint64_t _total_replayed_segments_count = 0;
+            // Moving average of the time it took to replay a segment, used to estimate
+            // how long replaying the remaining ones will take.
+            std::chrono::duration<double> _avg_segment_replay_time{0};
+
+            // Batches sent concurrently are limited to _batch_concurrency, which shrinks
+            // when the destination reports a growing view update backlog.
+            static constexpr size_t max_batches_in_flight = 8;
+            // Memory the merged hints may take before they are sent out.
+            static constexpr size_t max_coalesced_hints_size = 4 * 1024 * 1024;
+            size_t _batch_concurrency = max_batches_in_flight;
+            seastar::semaphore _batch_limiter{max_batches_in_flight};
+            seastar::metrics::metric_groups _metrics;
 
             struct segment_waiter {
                 const uint64_t target_segment_count;
@@ -260,6 +281,59 @@ class manager : public service::endpoint_lifecycle_subscriber {
             /// \return future that resolves when next hint may be sent
             future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
 
+            /// \brief Restore the mutation of a hint unless it should be discarded.
+            ///
+            /// Hints that are too old or whose table is gone are counted as discarded, failures to decode
+            /// are reported via \ref send_one_file_ctx::on_hint_send_failure().
+            ///
+            /// \return The mutation of the hint, or a disengaged optional if there is nothing to send.
+            std::optional<frozen_mutation_and_schema> decode_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer& buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            /// \brief Send a decoded hint, either in a batch or on its own.
+            /// \return future that resolves when next hint may be sent
+            future<> send_decoded_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp);
+
+            /// \brief Merge a hint into the hints of the same partition read before from the current file.
+            ///
+            /// The merged mutations are sent once the whole file was read, or when the memory they take exceeds
+            /// max_coalesced_hints_size. Sending a merged mutation is accounted to the replay position of the first
+            /// hint merged into it, so that all of them are sent again if it fails.
+            ///
+            /// \return future that resolves when next hint may be sent
+            future<> coalesce_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp);
+
+            /// \brief Send the mutations merged by coalesce_hint() so far.
+            future<> send_coalesced(lw_shared_ptr<send_one_file_ctx> ctx_ptr);
+
+            /// \brief Check if hints may be sent to the destination in batches.
+            ///
+            /// Requires all nodes to support HINT_MUTATION_BATCH and a non-zero hint_replay_batch_size_in_kb.
+            bool batching_enabled() const noexcept;
+
+            /// \brief Check if the destination is still a replica of the given mutation.
+            bool is_replica_of(const frozen_mutation_and_schema& m) const noexcept;
+
+            /// \brief Add a hint to the batch of the current file and send the batch once it is full.
+            /// \return future that resolves when next hint may be sent
+            future<> add_to_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, frozen_mutation_and_schema m, db::replay_position rp);
+
+            /// \brief Send the hints batched so far in the background.
+            ///
+            /// A failure is accounted to the replay position of the first hint in the batch, so that the whole
+            /// batch is sent again on the next attempt.
+            ///
+            /// \return future that resolves when the next batch may be collected
+            future<> send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr);
+
+            /// \brief Adjust the number of batches sent concurrently to the view update backlog of the destination.
+            void adjust_batch_concurrency(const db::view::update_backlog& backlog) noexcept;
+
+            /// \brief Estimated time to replay the pending segments, negative if unknown.
+            std::chrono::duration<double> replay_eta() const noexcept;
+
+            /// \brief Register the metrics of the destination, replacing the ones registered before.
+            void register_metrics();
+
             /// \brief Send all hint from a single file and delete it after it has been successfully sent.
             /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
             /// iteration from where we left in this one.
@@ -534,6 +608,7 @@ class manager : public service::endpoint_lifecycle_subscriber {
     ep_managers_map_type _ep_managers;
     stats _stats;
     seastar::metrics::metric_groups _metrics;
+    sstring _metrics_group_name;
     std::unordered_set<ep_key_type> _eps_with_pending_hints;
     seastar::named_semaphore _drain_lock = {1, named_semaphore_exception_factory{"drain lock"}};
 
@@ -1835,6 +1835,84 @@ class nodetool_status_table : public memtable_filling_virtual_table {
     }
 };
 
+// Sampled row cache statistics of each table, split by partition size,
+// see cache_profiler. Rows with max_partition_size of -1 describe
+// partitions whose size was not measured yet.
+class cache_profile_table : public memtable_filling_virtual_table {
+public:
+    cache_profile_table() : memtable_filling_virtual_table(build_schema()) {}
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(NAME, "cache_profile");
+        return schema_builder(NAME, "cache_profile", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::partition_key)
+            .with_column("max_partition_size", long_type, column_kind::clustering_key)
+            .with_column("resident_bytes", long_type)
+            .with_column("resident_partitions", long_type)
+            .with_column("hits", long_type)
+            .with_column("misses", long_type)
+            .with_column("evictions", long_type)
+            .with_column("mean_eviction_age_ms", long_type)
+            .with_version(generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink, db::timeout_clock::time_point timeout) override {
+        // Profiles are per-shard, so they have to be gathered from all shards.
+        // Only do that for partitions owned by this shard, other shards produce the rest.
+        std::vector<dht::decorated_key> keys;
+        std::vector<utils::UUID> ids;
+        for (auto&& [id, cf] : _db->get_column_families()) {
+            auto& s = *cf->schema();
+            auto pk = partition_key::from_exploded(*schema(), {
+                data_value(s.ks_name()).serialize_nonnull(),
+                data_value(s.cf_name()).serialize_nonnull(),
+            });
+            auto dk = dht::decorate_key(*schema(), std::move(pk));
+            if (this_shard_owns(dk)) {
+                keys.push_back(std::move(dk));
+                ids.push_back(id);
+            }
+        }
+        auto profiles = co_await service::get_local_storage_proxy().get_db().map_reduce0([&ids] (database& db) {
+            std::vector<cache_profile> ret(ids.size());
+            for (size_t i = 0; i < ids.size(); ++i) {
+                try {
+                    ret[i] = db.find_column_family(ids[i]).get_row_cache().get_profile();
+                } catch (no_such_column_family&) {
+                    // Dropped concurrently
+                }
+            }
+            return ret;
+        }, std::vector<cache_profile>(ids.size()), [] (std::vector<cache_profile> a, const std::vector<cache_profile>& b) {
+            for (size_t i = 0; i < a.size(); ++i) {
+                a[i] += b[i];
+            }
+            return a;
+        });
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            mutation m(schema(), std::move(keys[i]));
+            auto add = [&] (int64_t max_partition_size, const cache_profile::bucket& b) {
+                auto ck = clustering_key::from_single_value(*schema(), data_value(max_partition_size).serialize_nonnull());
+                row& cr = m.partition().clustered_row(*schema(), ck).cells();
+                set_cell(cr, "resident_bytes", int64_t(b.resident_bytes));
+                set_cell(cr, "resident_partitions", int64_t(b.resident_partitions));
+                set_cell(cr, "hits", int64_t(b.hits));
+                set_cell(cr, "misses", int64_t(b.misses));
+                set_cell(cr, "evictions", int64_t(b.evictions));
+                set_cell(cr, "mean_eviction_age_ms", int64_t(b.mean_eviction_age().count()));
+            };
+            add(-1, profiles[i].unknown_size);
+            for (unsigned b = 0; b < cache_profile::bucket_count; ++b) {
+                add(cache_profile::bucket_max_size(b), profiles[i].buckets[b]);
+            }
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
 // Map from table's schema ID to table itself. Helps avoiding accidental duplication.
 static thread_local std::map<utils::UUID, std::unique_ptr<virtual_table>> virtual_tables;
 
@@ -1845,6 +1923,7 @@ void register_virtual_tables() {
 
     // Add built-in virtual tables here.
     add_table(std::make_unique<nodetool_status_table>());
+    add_table(std::make_unique<cache_profile_table>());
 }
 
 std::vector<schema_ptr> all_tables() {
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "seastarx.hh"
+
+namespace db::view {
+
+// Runs the batches of a view build step in the background, allowing up to a
+// given number of them to be in flight at once. Called in the context of a
+// seastar::thread.
+class inflight_batches {
+    seastar::semaphore _slots;
+    seastar::gate _gate;
+    std::exception_ptr _failure;
+public:
+    explicit inflight_batches(size_t concurrency)
+            : _slots(concurrency) {
+    }
+
+    // Waits for a free slot, and starts the batch in the background.
+    //
+    // The batch is started even if an earlier one failed, so that it can release
+    // what it owns, but the failure is thrown afterwards to stop producing batches.
+    void run(noncopyable_function<future<>()> batch) {
+        auto units = get_units(_slots, 1).get0();
+        (void)with_gate(_gate, [this, batch = std::move(batch), units = std::move(units)] () mutable {
+            return futurize_invoke(batch).handle_exception([this] (std::exception_ptr ep) {
+                if (!_failure) {
+                    _failure = std::move(ep);
+                }
+            }).finally([units = std::move(units)] { });
+        });
+        check();
+    }
+
+    // Throws the failure of the first failed batch, if any.
+    void check() const {
+        if (_failure) {
+            std::rethrow_exception(_failure);
+        }
+    }
+
+    // Waits for all batches to complete, ignoring their failures.
+    void close() {
+        if (!_gate.is_closed()) {
+            _gate.close().get();
+        }
+    }
+
+    // Waits for all batches to complete, and throws if any of them failed.
+    void wait() {
+        close();
+        check();
+    }
+};
+
+}
@@ -39,9 +39,11 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
 #include <deque>
 #include <functional>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -60,19 +62,23 @@
 #include "cql3/statements/select_statement.hh"
 #include "cql3/util.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
+#include "db/view/inflight_batches.hh"
 #include "db/view/view.hh"
 #include "db/view/view_builder.hh"
+#include "db/view/view_update_batcher.hh"
 #include "db/view/view_updating_consumer.hh"
 #include "db/system_keyspace_view_types.hh"
 #include "db/system_keyspace.hh"
 #include "db/system_distributed_keyspace.hh"
 #include "frozen_mutation.hh"
 #include "gms/inet_address.hh"
+#include "gms/gossiper.hh"
 #include "keys.hh"
 #include "locator/network_topology_strategy.hh"
 #include "mutation.hh"
 #include "mutation_partition.hh"
 #include "service/migration_manager.hh"
+#include "service/priority_manager.hh"
 #include "service/storage_service.hh"
 #include "service/storage_proxy.hh"
 #include "view_info.hh"
@@ -247,6 +253,10 @@ void stats::register_stats() {
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_remote", view_updates_failed_remote, ms::description("Number of updates (mutations) that failed to be pushed to remote view replicas"),
                     {_cf_label, _ks_label}),
+            ms::make_total_operations("view_update_batches", view_update_batches, ms::description("Number of batched messages carrying updates to remote view replicas"),
+                    {_cf_label, _ks_label}),
+            ms::make_total_operations("view_updates_batched", view_updates_batched, ms::description("Number of updates (mutations) pushed to remote view replicas within batches"),
+                    {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_pushed_local", view_updates_pushed_local, ms::description("Number of updates (mutations) pushed to local view replicas"),
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_local", view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"),
@@ -1189,10 +1199,63 @@ static future<> apply_to_remote_endpoints(gms::inet_address target, inet_address
             allow_hints);
 }
 
+future<> send_view_update_batch(gms::inet_address target, view_update_batch batch,
+        send_view_update_batch_func send_batch, send_view_update_func send_one) {
+    auto fms = boost::copy_range<std::vector<frozen_mutation>>(batch.mutations | boost::adaptors::transformed([] (const frozen_mutation_and_schema& mut) {
+        return mut.fm;
+    }));
+    return send_batch(target, std::move(fms)).then_wrapped(
+            [target, batch = std::move(batch), send_one = std::move(send_one)] (future<>&& f) mutable {
+        if (!f.failed()) {
+            return make_ready_future<>();
+        }
+        vlogger.debug("Failed to send batch of {} view updates to {}, sending them separately: {}", batch.mutations.size(), target, f.get_exception());
+        return do_with(std::move(batch), std::move(send_one), [target] (view_update_batch& batch, send_view_update_func& send_one) {
+            return parallel_for_each(batch.mutations, [target, &send_one] (frozen_mutation_and_schema& mut) {
+                return send_one(target, mut);
+            });
+        });
+    });
+}
+
+static future<> send_view_update_batch(gms::inet_address target, view_update_batch batch, const dht::token& base_token,
+        db::view::stats& stats, cf_stats& cf_stats, service::allow_hints allow_hints, tracing::trace_state_ptr tr_state) {
+    ++stats.view_update_batches;
+    stats.view_updates_batched += batch.mutations.size();
+    ++cf_stats.total_view_update_batches;
+    cf_stats.total_view_updates_batched += batch.mutations.size();
+
+    auto size = batch.mutations.size();
+    tracing::trace(tr_state, "Sending batch of {} view updates to {}; base token = {}", size, target, base_token);
+    auto send_batch = [tr_state] (gms::inet_address target, std::vector<frozen_mutation> fms) {
+        return service::get_local_storage_proxy().send_view_update_batch(target, std::move(fms), tr_state);
+    };
+    auto send_one = [base_token, &stats, &cf_stats, allow_hints, tr_state] (gms::inet_address target, frozen_mutation_and_schema& mut) {
+        auto s = mut.s;
+        auto view_token = dht::get_token(*s, mut.fm.key());
+        return apply_to_remote_endpoints(target, {}, mut, base_token, view_token, allow_hints, tr_state).handle_exception(
+                [s = std::move(s), target, base_token, view_token, &stats, &cf_stats, tr_state] (std::exception_ptr ep) {
+            ++stats.view_updates_failed_remote;
+            ++cf_stats.total_view_updates_failed_remote;
+            tracing::trace(tr_state, "Failed to apply view update for {} and 1 remote endpoints", target);
+            vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
+                    target, s->ks_name(), s->cf_name(), base_token, view_token, ep);
+            return make_exception_future<>(std::move(ep));
+        });
+    };
+    return db::view::send_view_update_batch(target, std::move(batch), std::move(send_batch), std::move(send_one)).then([target, size, tr_state] {
+        tracing::trace(tr_state, "Successfully applied batch of {} view updates for {}", size, target);
+    });
+}
+
 // Take the view mutations generated by generate_view_updates(), which pertain
 // to a modification of a single base partition, and apply them to the
 // appropriate paired replicas. This is done asynchronously - we do not wait
 // for the writes to complete.
+//
+// Updates going to the same live remote replica (and to no pending ones) are
+// coalesced into batches of up to view_update_batch_size_in_kb, each sent as
+// a single message with a single response.
 future<> mutate_MV(
         const dht::token& base_token,
         std::vector<frozen_mutation_and_schema> view_updates,
@@ -1203,14 +1266,31 @@ future<> mutate_MV(
         service::allow_hints allow_hints,
         wait_for_all_updates wait_for_all)
 {
+    auto& proxy = service::get_local_storage_proxy();
+    const size_t max_batch_size = size_t(proxy.get_db().local().get_config().view_update_batch_size_in_kb()) * 1024;
+    const bool use_batches = max_batch_size != 0 && proxy.features().cluster_supports_view_update_batches();
+    view_update_batcher batcher(max_batch_size);
+
     auto fs = std::make_unique<std::vector<future<>>>();
     fs->reserve(view_updates.size());
+
+    auto push_remote_update = [&fs, wait_for_all] (future<> view_update) {
+        if (wait_for_all) {
+            fs->push_back(std::move(view_update));
+        } else {
+            // The update is sent to background in order to preserve availability,
+            // its parallelism is limited by view_update_concurrency_semaphore
+            (void)view_update;
+        }
+    };
+
     for (frozen_mutation_and_schema& mut : view_updates) {
         auto view_token = dht::get_token(*mut.s, mut.fm.key());
         auto& keyspace_name = mut.s->ks_name();
         auto target_endpoint = get_view_natural_endpoint(keyspace_name, base_token, view_token);
         auto remote_endpoints = service::get_local_storage_service().get_token_metadata().pending_endpoints_for(view_token, keyspace_name);
-        auto maybe_account_failure = [s = mut.s, tr_state, &stats, &cf_stats, base_token, view_token, units = pending_view_updates.split(mut.fm.representation().size())] (
+        auto units = pending_view_updates.split(mut.fm.representation().size());
+        auto maybe_account_failure = [s = mut.s, tr_state, &stats, &cf_stats, base_token, view_token] (
                 future<>&& f,
                 gms::inet_address target,
                 bool is_local,
@@ -1267,10 +1347,11 @@ future<> mutate_MV(
             auto mut_ptr = remote_endpoints.empty() ? std::make_unique<frozen_mutation>(std::move(mut.fm)) : std::make_unique<frozen_mutation>(mut.fm);
             tracing::trace(tr_state, "Locally applying view update for {}.{}; base token = {}; view token = {}",
                     mut.s->ks_name(), mut.s->cf_name(), base_token, view_token);
-            future<> local_view_update = service::get_local_storage_proxy().mutate_locally(mut.s, *mut_ptr, std::move(tr_state), db::commitlog::force_sync::no).then_wrapped(
+            future<> local_view_update = service::get_local_storage_proxy().mutate_locally(mut.s, *mut_ptr, tr_state, db::commitlog::force_sync::no).then_wrapped(
                     [&stats,
-                     maybe_account_failure = std::move(maybe_account_failure),
-                     mut_ptr = std::move(mut_ptr)] (future<>&& f) {
+                     maybe_account_failure,
+                     mut_ptr = std::move(mut_ptr),
+                     units = std::move(units)] (future<>&& f) {
                 --stats.writes;
                 return maybe_account_failure(std::move(f), utils::fb_utilities::get_broadcast_address(), true, 0);
             });
@@ -1294,19 +1375,25 @@ future<> mutate_MV(
             size_t updates_pushed_remote = remote_endpoints.size() + 1;
             stats.view_updates_pushed_remote += updates_pushed_remote;
             cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
+            if (use_batches && remote_endpoints.empty() && gms::get_local_gossiper().is_alive(*target_endpoint)) {
+                if (auto full = batcher.add(*target_endpoint, std::move(mut), std::move(units))) {
+                    push_remote_update(send_view_update_batch(*target_endpoint, std::move(*full), base_token, stats, cf_stats, allow_hints, tr_state));
+                }
+                continue;
+            }
             future<> view_update = apply_to_remote_endpoints(*target_endpoint, std::move(remote_endpoints), mut, base_token, view_token, allow_hints, tr_state).then_wrapped(
                     [target_endpoint,
                      updates_pushed_remote,
-                     maybe_account_failure = std::move(maybe_account_failure)] (future<>&& f) mutable {
+                     maybe_account_failure = std::move(maybe_account_failure),
+                     units = std::move(units)] (future<>&& f) mutable {
                 return maybe_account_failure(std::move(f), std::move(*target_endpoint), false, updates_pushed_remote);
             });
-            if (wait_for_all) {
-                fs->push_back(std::move(view_update));
-            } else {
-                // The update is sent to background in order to preserve availability,
-                // its parallelism is limited by view_update_concurrency_semaphore
-                (void)view_update;
-            }
+            push_remote_update(std::move(view_update));
+        }
+    }
+    for (auto&& [target, batch] : batcher.release()) {
+        if (!batch.mutations.empty()) {
+            push_remote_update(send_view_update_batch(target, std::move(batch), base_token, stats, cf_stats, allow_hints, tr_state));
         }
     }
     auto f = seastar::when_all_succeed(fs->begin(), fs->end());
@@ -1459,7 +1546,7 @@ future<> view_builder::initialize_reader_at_current_token(build_step& step) {
             _permit,
             step.prange,
             step.pslice,
-            default_priority_class(),
+            service::get_local_streaming_priority(),
             nullptr,
             streamed_mutation::forwarding::no,
             mutation_reader::forwarding::no);
@@ -1479,6 +1566,7 @@ void view_builder::load_view_status(view_builder::view_build_status status, std:
         _built_views.emplace(status.view->id());
         return;
     }
+    note_build_start(status);
     get_or_create_build_step(status.view->view_info()->base_id()).build_status.emplace_back(std::move(status));
 }
 
@@ -1662,6 +1750,7 @@ future<> view_builder::calculate_shard_build_step(view_builder_init_state& vbi)
 future<> view_builder::add_new_view(view_ptr view, build_step& step) {
     vlogger.info0("Building view {}.{}, starting at token {}", view->ks_name(), view->cf_name(), step.current_token());
     step.build_status.emplace(step.build_status.begin(), view_build_status{view, step.current_token(), std::nullopt});
+    note_build_start(step.build_status.front());
     auto f = this_shard_id() == 0 ? _sys_dist_ks.start_view_build(view->ks_name(), view->cf_name()) : make_ready_future<>();
     return when_all_succeed(
             std::move(f),
@@ -1736,6 +1825,7 @@ void view_builder::on_drop_view(const sstring& ks_name, const sstring& view_name
                 for (auto it = step.build_status.begin(); it != step.build_status.end(); ++it) {
                     if (it->view->cf_name() == view_name) {
                         _built_views.erase(it->view->id());
+                        _build_starts.erase(it->view->id());
                         step.build_status.erase(it);
                         return;
                     }
@@ -1761,7 +1851,11 @@ void view_builder::on_drop_view(const sstring& ks_name, const sstring& view_name
 }
 
 future<> view_builder::do_build_step() {
-    return seastar::async([this] {
+    // Building views competes with the same resources as streaming does,
+    // so let it be throttled alike.
+    seastar::thread_attributes attr;
+    attr.sched_group = _db.get_streaming_scheduling_group();
+    return seastar::async(std::move(attr), [this] {
         exponential_backoff_retry r(1s, 1min);
         while (!_base_to_build_step.empty() && !_as.abort_requested()) {
             auto units = get_units(_sem, 1).get0();
@@ -1825,6 +1919,7 @@ class view_builder::consumer {
 private:
     view_builder& _builder;
     build_step& _step;
+    inflight_batches& _batches;
     built_views _built_views;
     gc_clock::time_point _now;
     std::vector<view_ptr> _views_to_build;
@@ -1840,9 +1935,10 @@ class view_builder::consumer {
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
 public:
-    consumer(view_builder& builder, build_step& step, gc_clock::time_point now)
+    consumer(view_builder& builder, build_step& step, inflight_batches& batches, gc_clock::time_point now)
             : _builder(builder)
             , _step(step)
+            , _batches(batches)
             , _built_views{step}
             , _now(now) {
         if (!step.current_key.key().is_empty(*_step.reader.schema())) {
@@ -1934,11 +2030,15 @@ class view_builder::consumer {
             auto views = with_base_info_snapshot(_views_to_build);
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
-                    std::move(views),
-                    _step.current_token(),
-                    std::move(reader),
-                    _now).get();
+            _batches.run([base = _step.base, views = std::move(views), token = _step.current_token(), reader = std::move(reader), now = _now] () mutable {
+                return base->populate_views(
+                        std::move(views),
+                        std::move(token),
+                        std::move(reader),
+                        now).then([] {
+                    inject_failure("view_builder_populate_views");
+                });
+            });
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -1953,6 +2053,9 @@ class view_builder::consumer {
     // Must be called in a seastar thread.
     built_views consume_end_of_stream() {
         inject_failure("view_builder_consume_end_of_stream");
+        // The progress made by this step, including the views it found to be
+        // built, is only valid once all the rows read have made it to the views.
+        _batches.wait();
         if (vlogger.is_enabled(log_level::debug)) {
             auto view_names = boost::copy_range<std::vector<sstring>>(
                     _views_to_build | boost::adaptors::transformed([](auto v) {
@@ -1976,15 +2079,31 @@ class view_builder::consumer {
 // Called in the context of a seastar::thread.
 void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     gc_clock::time_point now = gc_clock::now();
-    auto consumer = compact_for_query<emit_only_live_rows::yes, view_builder::consumer>(
-            *step.reader.schema(),
-            now,
-            step.pslice,
-            batch_size,
-            query::max_partitions,
-            view_builder::consumer{*this, step, now});
-    consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
-    auto built = step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+    size_t concurrency = std::max(_db.get_config().view_building_concurrency(), 1u);
+    inflight_batches batches(concurrency);
+    // If any of the batches fails, the rows it carried may already be behind
+    // the step's progress, so the whole step has to be redone.
+    auto start_key = step.current_key;
+    auto start_status = step.build_status;
+    auto built = [&] {
+        try {
+            auto consumer = compact_for_query<emit_only_live_rows::yes, view_builder::consumer>(
+                    *step.reader.schema(),
+                    now,
+                    step.pslice,
+                    batch_size * concurrency,
+                    query::max_partitions,
+                    view_builder::consumer{*this, step, batches, now});
+            consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
+            return step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+        } catch (...) {
+            auto ep = std::current_exception();
+            batches.close();
+            step.current_key = std::move(start_key);
+            step.build_status = std::move(start_status);
+            std::rethrow_exception(std::move(ep));
+        }
+    }();
 
     _as.check();
 
@@ -2007,6 +2126,7 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
 
 future<> view_builder::maybe_mark_view_as_built(view_ptr view, dht::token next_token) {
     _built_views.emplace(view->id());
+    _build_starts.erase(view->id());
     vlogger.debug("Shard finished building view {}.{}", view->ks_name(), view->cf_name());
     return container().map_reduce0(
             [view_id = view->id()] (view_builder& builder) {
@@ -2049,6 +2169,49 @@ future<> view_builder::wait_until_built(const sstring& ks_name, const sstring& v
     });
 }
 
+double view_builder::fraction_built(const dht::token& first_token, const std::optional<dht::token>& next_token) {
+    if (!next_token) {
+        return 0;
+    }
+    if (*next_token == first_token) {
+        // The shard walked the whole ring back to where it started.
+        return 1;
+    }
+    uint64_t walked = uint64_t(next_token->raw()) - uint64_t(first_token.raw());
+    return double(walked) / std::pow(2.0, 64);
+}
+
+void view_builder::note_build_start(const view_build_status& status) {
+    _build_starts.insert_or_assign(status.view->id(), build_start{lowres_clock::now(), fraction_built(status.first_token, status.next_token)});
+}
+
+future<std::vector<view_builder::view_build_progress>> view_builder::get_build_progress(const sstring& ks_name, const sstring& view_name) {
+    return container().map_reduce0([ks_name, view_name] (view_builder& builder) {
+        std::vector<view_build_progress> progress;
+        for (auto& [_, step] : builder._base_to_build_step) {
+            for (auto& status : step.build_status) {
+                if (status.view->ks_name() != ks_name || status.view->cf_name() != view_name) {
+                    continue;
+                }
+                auto fraction = fraction_built(status.first_token, status.next_token);
+                std::optional<std::chrono::seconds> eta;
+                auto it = builder._build_starts.find(status.view->id());
+                if (it != builder._build_starts.end() && fraction > it->second.fraction_built) {
+                    // Assume the build goes on at the pace it had since it was started on this shard.
+                    auto elapsed = lowres_clock::now() - it->second.time;
+                    auto remaining = elapsed * ((1 - fraction) / (fraction - it->second.fraction_built));
+                    eta = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+                }
+                progress.push_back(view_build_progress{this_shard_id(), status.first_token, status.next_token, fraction, eta});
+            }
+        }
+        return progress;
+    }, std::vector<view_build_progress>(), [] (std::vector<view_build_progress> all, std::vector<view_build_progress> shard) {
+        std::move(shard.begin(), shard.end(), std::back_inserter(all));
+        return all;
+    });
+}
+
 update_backlog node_update_backlog::add_fetch(unsigned shard, update_backlog backlog) {
     _backlogs[shard].backlog.store(backlog, std::memory_order_relaxed);
     auto now = clock::now();
@@ -71,11 +71,15 @@ namespace db::view {
  *
  * We aim to be resource-conscious. On a given shard, at any given moment, we consume at most
  * from one reader. We also strive for fairness, in that each build step inserts entries for
- * the views of a different base. Each build step reads and generates updates for batch_size rows.
+ * the views of a different base. Each build step reads batch_size rows for each of the
+ * view_building_concurrency batches it may have in flight: the view updates for a batch are
+ * generated and propagated in the background while the reader moves on to the next one.
+ * A step completes, and its progress is recorded, only once all its batches have completed;
+ * a step with a failed batch is redone from where it started. Building runs in the streaming
+ * scheduling group, with the streaming I/O priority.
  *
- * We lack a controller, which could potentially allow us to go faster (to execute multiple steps at
- * the same time, or consume more rows per batch), and also which would apply backpressure, so we
- * could, for example, delay executing a build step.
+ * We lack a controller, which could potentially allow us to go faster, and also which would
+ * apply backpressure, so we could, for example, delay executing a build step.
  *
  * View building is necessarily a sharded process. That means that on restart, if the number of shards
  * has changed, we need to calculate the most conservative token range that has been built, and build
@@ -156,6 +160,16 @@ class view_builder final : public service::migration_listener::only_view_notific
 
     using base_to_build_step_type = std::unordered_map<utils::UUID, build_step>;
 
+    /**
+     * Remembers when this shard started, or resumed, building a view, and which fraction
+     * of the token ring it had already built at that point. Used to estimate the time
+     * remaining until the build completes.
+     */
+    struct build_start final {
+        lowres_clock::time_point time;
+        double fraction_built;
+    };
+
     database& _db;
     db::system_distributed_keyspace& _sys_dist_ks;
     service::migration_notifier& _mnotifier;
@@ -177,6 +191,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     seastar::shared_promise<> _shards_finished_read_promise;
     // Used for testing.
     std::unordered_map<std::pair<sstring, sstring>, seastar::shared_promise<>, utils::tuple_hash> _build_notifiers;
+    std::unordered_map<utils::UUID, build_start> _build_starts;
     stats _stats;
     metrics::metric_groups _metrics;
 
@@ -194,6 +209,20 @@ class view_builder final : public service::migration_listener::only_view_notific
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
 
+    /**
+     * The build progress of a view on a particular shard.
+     */
+    struct view_build_progress final {
+        unsigned shard;
+        dht::token first_token;
+        std::optional<dht::token> next_token;
+        // Fraction of the token ring walked by this shard, between 0 and 1.
+        double fraction_built;
+        // Estimated time until this shard finishes building the view,
+        // unknown until the shard has made some progress.
+        std::optional<std::chrono::seconds> eta;
+    };
+
 public:
     view_builder(database&, db::system_distributed_keyspace&, service::migration_notifier&);
     view_builder(view_builder&&) = delete;
@@ -217,6 +246,18 @@ class view_builder final : public service::migration_listener::only_view_notific
     // For tests
     future<> wait_until_built(const sstring& ks_name, const sstring& view_name);
 
+    /**
+     * Returns the build progress of the given view on each shard still building it.
+     * The result is empty if the view is built, or not known to this node.
+     */
+    future<std::vector<view_build_progress>> get_build_progress(const sstring& ks_name, const sstring& view_name);
+
+    /**
+     * Returns the fraction of the token ring walked by a shard which started building
+     * a view at first_token and has yet to build it from next_token on, between 0 and 1.
+     */
+    static double fraction_built(const dht::token& first_token, const std::optional<dht::token>& next_token);
+
 private:
     build_step& get_or_create_build_step(utils::UUID);
     future<> initialize_reader_at_current_token(build_step&);
@@ -228,6 +269,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> do_build_step();
     void execute(build_step&, exponential_backoff_retry);
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
+    void note_build_start(const view_build_status&);
     void setup_metrics();
 
     struct consumer;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <seastar/core/future.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "db/timeout_clock.hh"
+#include "frozen_mutation.hh"
+#include "gms/inet_address.hh"
+#include "seastarx.hh"
+
+namespace db::view {
+
+// View updates headed to the same remote view replica, sent in one message
+struct view_update_batch {
+    std::vector<frozen_mutation_and_schema> mutations;
+    db::timeout_semaphore_units units;
+    size_t size = 0;
+};
+
+// Coalesces the view updates of a base write into per-replica batches of at
+// most max_batch_size bytes of serialized mutations. A single update larger
+// than that makes a batch of its own.
+class view_update_batcher {
+    size_t _max_batch_size;
+    std::unordered_map<gms::inet_address, view_update_batch> _batches;
+public:
+    explicit view_update_batcher(size_t max_batch_size) noexcept : _max_batch_size(max_batch_size) { }
+
+    // Adds the update to the batch of the target. If the update doesn't fit,
+    // the batch collected so far is returned, to be sent right away, and the
+    // update starts a new one.
+    std::optional<view_update_batch> add(gms::inet_address target, frozen_mutation_and_schema mut, db::timeout_semaphore_units units) {
+        std::optional<view_update_batch> full;
+        auto& batch = _batches[target];
+        size_t size = mut.fm.representation().size();
+        if (!batch.mutations.empty() && batch.size + size > _max_batch_size) {
+            full = std::exchange(batch, {});
+        }
+        batch.size += size;
+        batch.units.adopt(std::move(units));
+        batch.mutations.push_back(std::move(mut));
+        return full;
+    }
+
+    // Hands over the batches which are not full yet.
+    std::unordered_map<gms::inet_address, view_update_batch> release() noexcept {
+        return std::exchange(_batches, {});
+    }
+};
+
+using send_view_update_batch_func = noncopyable_function<future<> (gms::inet_address, std::vector<frozen_mutation>)>;
+using send_view_update_func = noncopyable_function<future<> (gms::inet_address, frozen_mutation_and_schema&)>;
+
+// Sends the batch with send_batch. If that fails, the replica may have applied
+// some of the updates, but re-applying them is harmless, so each update is sent
+// again with send_one, which gets the failing ones hinted. The batch's units
+// are held until all of its updates are done.
+future<> send_view_update_batch(gms::inet_address target, view_update_batch batch,
+        send_view_update_batch_func send_batch, send_view_update_func send_one);
+
+}
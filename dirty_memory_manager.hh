@@ -22,6 +22,7 @@
 #pragma once
 
 #include <boost/intrusive/parent_from_member.hpp>
+#include <chrono>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/metrics_registration.hh>
@@ -85,11 +86,16 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     // memory usage minus bytes that were already written to disk.
     logalloc::region_group _virtual_region_group;
 
-    // We would like to serialize the flushing of memtables. While flushing many memtables
-    // simultaneously can sustain high levels of throughput, the memory is not freed until the
-    // memtable is totally gone. That means that if we have throttled requests, they will stay
-    // throttled for a long time. Even when we have virtual dirty, that only provides a rough
-    // estimate, and we can't release requests that early.
+    // We would like to limit the number of memtables being flushed at the same time. While
+    // flushing many memtables simultaneously can sustain high levels of throughput, the memory is
+    // not freed until the memtable is totally gone. That means that if we have throttled requests,
+    // they will stay throttled for a long time. Even when we have virtual dirty, that only provides
+    // a rough estimate, and we can't release requests that early.
+    //
+    // On the other hand, a single sstable writer often can't keep up with a burst of writes to
+    // many tables, so we allow a small number of concurrent writers. They all run under the
+    // memtable flush I/O priority class, so together they still get the flush controller's share.
+    unsigned _max_concurrent_flushes;
     semaphore _flush_serializer;
     // We will accept a new flush before another one ends, once it is done with the data write.
     // That is so we can keep the disk always busy. But there is still some background work that is
@@ -100,9 +106,13 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     static constexpr unsigned _max_background_work = 20;
     semaphore _background_work_flush_serializer = { _max_background_work };
     condition_variable _should_flush;
+    // Signalled whenever a flush started by flush_one() completes.
+    condition_variable _flush_completed;
+    unsigned _flushes_in_flight = 0;
     int64_t _dirty_bytes_released_pre_accounted = 0;
 
     future<> flush_when_needed();
+    future<> wait_for_flush_completion();
 
     future<> _waiting_flush;
     virtual void start_reclaiming() noexcept override;
@@ -113,6 +123,11 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
 
     unsigned _extraneous_flushes = 0;
 
+    struct stats {
+        uint64_t blocked_writes = 0;
+        std::chrono::microseconds blocked_writes_time{0};
+    } _stats;
+
     seastar::metrics::metric_groups _metrics;
 public:
     void setup_collectd(sstring namestr);
@@ -151,19 +166,27 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     //
     // We then set the soft limit to 80 % of the virtual dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg)
+    //
+    // Concurrent Flushes
+    // ------------------
+    // Up to max_concurrent_flushes memtables may be written to sstables at the same time. Flushes
+    // of large memtables may use the spare ones to split the memtable into token ranges written in
+    // parallel, see try_get_sstable_write_permits().
+    dirty_memory_manager(database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg, unsigned max_concurrent_flushes = 1)
         : logalloc::region_group_reclaimer(threshold / 2, threshold * soft_limit / 2)
         , _real_dirty_reclaimer(threshold)
         , _db(&db)
         , _real_region_group("memtable", _real_dirty_reclaimer, deferred_work_sg)
         , _virtual_region_group("memtable (virtual)", &_real_region_group, *this, deferred_work_sg)
-        , _flush_serializer(1)
+        , _max_concurrent_flushes(std::max(max_concurrent_flushes, 1u))
+        , _flush_serializer(_max_concurrent_flushes)
         , _waiting_flush(flush_when_needed()) {}
 
     dirty_memory_manager() : logalloc::region_group_reclaimer()
         , _db(nullptr)
         , _real_region_group("memtable", _real_dirty_reclaimer)
         , _virtual_region_group("memtable (virtual)", &_real_region_group, *this)
+        , _max_concurrent_flushes(1)
         , _flush_serializer(1)
         , _waiting_flush(make_ready_future<>()) {}
 
@@ -207,6 +230,43 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
         return _virtual_region_group.memory_used();
     }
 
+    // Runs func once dirty memory is below the throttling threshold, and
+    // accounts the time writes spend blocked waiting for that.
+    template <typename Func>
+    futurize_t<std::result_of_t<Func()>> run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout) {
+        auto f = _virtual_region_group.run_when_memory_available(std::forward<Func>(func), timeout);
+        if (f.available()) {
+            return f;
+        }
+        ++_stats.blocked_writes;
+        return f.finally([this, start = std::chrono::steady_clock::now()] {
+            _stats.blocked_writes_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        });
+    }
+
+    unsigned max_concurrent_flushes() const {
+        return _max_concurrent_flushes;
+    }
+
+    unsigned flushes_in_progress() const {
+        return _max_concurrent_flushes - _flush_serializer.available_units();
+    }
+
+    // Grabs up to n sstable write permits which are available right away,
+    // without waiting for other flushes. Used to write a large memtable with
+    // several parallel writers when the disk isn't busy with other flushes.
+    std::vector<sstable_write_permit> try_get_sstable_write_permits(unsigned n) {
+        std::vector<sstable_write_permit> ret;
+        // Spare permits are only taken while no other flush waits for one, so
+        // that a flush of a large memtable can't starve flushes of other tables.
+        // Permits of range writers are released as soon as their range is
+        // written, like the permit of any other flush.
+        while (ret.size() < n && !_flush_serializer.waiters() && _flush_serializer.try_wait(1)) {
+            ret.push_back(sstable_write_permit(semaphore_units<>(_flush_serializer, 1)));
+        }
+        return ret;
+    }
+
     future<> flush_one(memtable_list& cf, flush_permit&& permit);
 
     future<flush_permit> get_flush_permit() {
@@ -330,46 +330,53 @@ distributed_loader::reshape(sharded<sstables::sstable_directory>& dir, sharded<d
 // Loads SSTables into the main directory (or staging) and returns how many were loaded
 future<size_t>
 distributed_loader::make_sstables_available(sstables::sstable_directory& dir, sharded<database>& db,
-        sharded<db::view::view_update_generator>& view_update_generator, fs::path datadir, sstring ks, sstring cf) {
+        sharded<db::view::view_update_generator>& view_update_generator, fs::path datadir, sstring ks, sstring cf, sstables::offstrategy offstrategy) {
 
     auto& table = db.local().find_column_family(ks, cf);
 
-    return do_with(dht::ring_position::max(), dht::ring_position::min(), [&table, &dir, &view_update_generator, datadir = std::move(datadir)] (dht::ring_position& min, dht::ring_position& max) {
-        return dir.do_for_each_sstable([&table, datadir = std::move(datadir), &min, &max] (sstables::shared_sstable sst) {
+    // Kept local rather than in the table, so that sstables from different
+    // directories can be made available concurrently.
+    return do_with(dht::ring_position::max(), dht::ring_position::min(), std::vector<sstables::shared_sstable>(),
+            [&table, &dir, &view_update_generator, datadir = std::move(datadir)] (dht::ring_position& min, dht::ring_position& max, std::vector<sstables::shared_sstable>& opened) {
+        return dir.do_for_each_sstable([&table, datadir = std::move(datadir), &min, &max, &opened] (sstables::shared_sstable sst) {
             min = std::min(dht::ring_position(sst->get_first_decorated_key()), min, dht::ring_position_less_comparator(*table.schema()));
             max = std::max(dht::ring_position(sst->get_last_decorated_key()) , max, dht::ring_position_less_comparator(*table.schema()));
 
             auto gen = table.calculate_generation_for_new_table();
             dblog.trace("Loading {} into {}, new generation {}", sst->get_filename(), datadir.native(), gen);
-            return sst->move_to_new_dir(datadir.native(), gen,  true).then([&table, sst] {
-                table._sstables_opened_but_not_loaded.push_back(std::move(sst));
+            return sst->move_to_new_dir(datadir.native(), gen,  true).then([&opened, sst] {
+                opened.push_back(std::move(sst));
                 return make_ready_future<>();
             });
-        }).then([&table, &min, &max] {
+        }).then([&table, &min, &max, &opened, offstrategy] {
             // nothing loaded
             if (min.is_max() && max.is_min()) {
                 return make_ready_future<>();
             }
 
-            return table.get_row_cache().invalidate(row_cache::external_updater([&table] () noexcept {
-                for (auto& sst : table._sstables_opened_but_not_loaded) {
+            return table.get_row_cache().invalidate(row_cache::external_updater([&table, &opened, offstrategy] () noexcept {
+                for (auto& sst : opened) {
                     try {
-                        table.load_sstable(sst, true);
+                        if (offstrategy) {
+                            sst->set_sstable_level(0);
+                            table.add_maintenance_sstable(sst);
+                        } else {
+                            table.load_sstable(sst, true);
+                        }
                     } catch (...) {
                         dblog.error("Failed to load {}: {}. Aborting.", sst->toc_filename(), std::current_exception());
                         abort();
                     }
                 }
             }), dht::partition_range::make({min, true}, {max, true}));
-        }).then([&view_update_generator, &table] {
-            return parallel_for_each(table._sstables_opened_but_not_loaded, [&view_update_generator, &table] (sstables::shared_sstable& sst) {
+        }).then([&view_update_generator, &table, &opened] {
+            return parallel_for_each(opened, [&view_update_generator, &table] (sstables::shared_sstable& sst) {
                 if (sst->requires_view_building()) {
                     return view_update_generator.local().register_staging_sstable(sst, table.shared_from_this());
                 }
                 return make_ready_future<>();
             });
-        }).then_wrapped([&table] (future<> f) {
-            auto opened = std::exchange(table._sstables_opened_but_not_loaded, {});
+        }).then_wrapped([&opened] (future<> f) {
             if (!f.failed()) {
                 return make_ready_future<size_t>(opened.size());
             } else {
@@ -379,22 +386,23 @@ distributed_loader::make_sstables_available(sstables::sstable_directory& dir, sh
     });
 }
 
-future<>
-distributed_loader::process_upload_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
-        distributed<db::view::view_update_generator>& view_update_generator, sstring ks, sstring cf) {
+static future<size_t>
+process_sstables_in_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+        distributed<db::view::view_update_generator>& view_update_generator, sstring ks, sstring cf, fs::path upload, fs::path table_dir,
+        sstables::sstable_directory::allow_loading_materialized_view allow_mv, sstables::reshape_mode mode, streaming::stream_reason reason,
+        sstables::offstrategy offstrategy) {
     seastar::thread_attributes attr;
     attr.sched_group = db.local().get_streaming_scheduling_group();
 
-    return seastar::async(std::move(attr), [&db, &view_update_generator, &sys_dist_ks, ks = std::move(ks), cf = std::move(cf)] {
+    return seastar::async(std::move(attr), [&db, &view_update_generator, &sys_dist_ks, ks = std::move(ks), cf = std::move(cf), upload = std::move(upload), table_dir = std::move(table_dir), allow_mv, mode, reason, offstrategy] {
         global_column_family_ptr global_table(db, ks, cf);
 
         sharded<sstables::sstable_directory> directory;
-        auto upload = fs::path(global_table->dir()) / "upload";
         directory.start(upload, db.local().get_config().initial_sstable_loading_concurrency(), std::ref(db.local().get_sharded_sst_dir_semaphore()),
             sstables::sstable_directory::need_mutate_level::yes,
             sstables::sstable_directory::lack_of_toc_fatal::no,
             sstables::sstable_directory::enable_dangerous_direct_import_of_cassandra_counters(db.local().get_config().enable_dangerous_direct_import_of_cassandra_counters()),
-            sstables::sstable_directory::allow_loading_materialized_view::no,
+            allow_mv,
             [&global_table] (fs::path dir, int64_t gen, sstables::sstable_version_types v, sstables::sstable_format_types f) {
                 return global_table->make_sstable(dir.native(), gen, v, f, &error_handler_gen_for_upload_dir);
 
@@ -404,8 +412,8 @@ distributed_loader::process_upload_dir(distributed<database>& db, distributed<db
             directory.stop().get();
         });
 
-        lock_table(directory, db, ks, cf).get();
-        process_sstable_dir(directory).get();
+        distributed_loader::lock_table(directory, db, ks, cf).get();
+        distributed_loader::process_sstable_dir(directory).get();
 
         auto generation = highest_generation_seen(directory).get0();
         auto shard_generation_base = generation / smp::count + 1;
@@ -417,7 +425,7 @@ distributed_loader::process_upload_dir(distributed<database>& db, distributed<db
             shard_gen[s].store(shard_generation_base * smp::count + s, std::memory_order_relaxed);
         }
 
-        reshard(directory, db, ks, cf, [&global_table, upload, &shard_gen] (shard_id shard) mutable {
+        distributed_loader::reshard(directory, db, ks, cf, [&global_table, upload, &shard_gen] (shard_id shard) mutable {
             // we need generation calculated by instance of cf at requested shard
             auto gen = shard_gen[shard].fetch_add(smp::count, std::memory_order_relaxed);
 
@@ -426,7 +434,7 @@ distributed_loader::process_upload_dir(distributed<database>& db, distributed<db
                     sstables::sstable::format_types::big, &error_handler_gen_for_upload_dir);
         }).get();
 
-        reshape(directory, db, sstables::reshape_mode::strict, ks, cf, [global_table, upload, &shard_gen] (shard_id shard) {
+        distributed_loader::reshape(directory, db, mode, ks, cf, [global_table, upload, &shard_gen] (shard_id shard) {
             auto gen = shard_gen[shard].fetch_add(smp::count, std::memory_order_relaxed);
             return global_table->make_sstable(upload.native(), gen,
                   global_table->get_sstables_manager().get_highest_supported_format(),
@@ -434,22 +442,44 @@ distributed_loader::process_upload_dir(distributed<database>& db, distributed<db
                   &error_handler_gen_for_upload_dir);
         }).get();
 
-        const bool use_view_update_path = db::view::check_needs_view_update_path(sys_dist_ks.local(), *global_table, streaming::stream_reason::repair).get0();
+        const bool use_view_update_path = db::view::check_needs_view_update_path(sys_dist_ks.local(), *global_table, reason).get0();
 
-        auto datadir = upload.parent_path();
+        auto datadir = table_dir;
         if (use_view_update_path) {
             // Move to staging directory to avoid clashes with future uploads. Unique generation number ensures no collisions.
            datadir /= "staging";
         }
 
-        size_t loaded = directory.map_reduce0([&db, ks, cf, datadir, &view_update_generator] (sstables::sstable_directory& dir) {
-            return make_sstables_available(dir, db, view_update_generator, datadir, ks, cf);
+        size_t loaded = directory.map_reduce0([&db, ks, cf, datadir, &view_update_generator, offstrategy] (sstables::sstable_directory& dir) {
+            return distributed_loader::make_sstables_available(dir, db, view_update_generator, datadir, ks, cf, offstrategy);
         }, size_t(0), std::plus<size_t>()).get0();
 
         dblog.info("Loaded {} SSTables into {}", loaded, datadir.native());
+        return loaded;
     });
 }
 
+future<>
+distributed_loader::process_upload_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+        distributed<db::view::view_update_generator>& view_update_generator, sstring ks, sstring cf) {
+    auto table_dir = fs::path(db.local().find_column_family(ks, cf).dir());
+    auto upload = table_dir / "upload";
+    return process_sstables_in_dir(db, sys_dist_ks, view_update_generator, std::move(ks), std::move(cf), std::move(upload), std::move(table_dir),
+            sstables::sstable_directory::allow_loading_materialized_view::no, sstables::reshape_mode::strict,
+            streaming::stream_reason::repair, sstables::offstrategy::no).discard_result();
+}
+
+future<size_t>
+distributed_loader::process_streamed_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+        distributed<db::view::view_update_generator>& view_update_generator, sstring ks, sstring cf, fs::path dir, streaming::stream_reason reason,
+        sstables::offstrategy offstrategy) {
+    // Views are streamed like any other table. Streamed data is usually
+    // compacted off-strategy later on, so only reshape what is badly shaped.
+    auto table_dir = fs::path(db.local().find_column_family(ks, cf).dir());
+    return process_sstables_in_dir(db, sys_dist_ks, view_update_generator, std::move(ks), std::move(cf), std::move(dir), std::move(table_dir),
+            sstables::sstable_directory::allow_loading_materialized_view::yes, sstables::reshape_mode::relaxed, reason, offstrategy);
+}
+
 future<std::tuple<utils::UUID, std::vector<std::vector<sstables::shared_sstable>>>>
 distributed_loader::get_sstables_from_upload_dir(distributed<database>& db, sstring ks, sstring cf) {
     return seastar::async([&db, ks = std::move(ks), cf = std::move(cf)] {
@@ -494,6 +524,10 @@ future<> distributed_loader::cleanup_column_family_temp_sst_dirs(sstring sstdir)
             if (sstables::sstable::is_temp_dir(dirpath)) {
                 dblog.info("Found temporary sstable directory: {}, removing", dirpath);
                 futures.push_back(io_check([dirpath = std::move(dirpath)] () { return lister::rmdir(dirpath); }));
+            } else if (sstables::sstable::is_streaming_dir(dirpath)) {
+                // Sstables whose streaming was interrupted by a restart.
+                dblog.info("Found sstable streaming directory: {}, removing", dirpath);
+                futures.push_back(io_check([dirpath = std::move(dirpath)] () { return lister::rmdir(dirpath); }));
             }
             return make_ready_future<>();
         }).then([&futures] {
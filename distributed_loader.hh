@@ -31,6 +31,7 @@
 #include <filesystem>
 #include "seastarx.hh"
 #include "sstables/compaction_descriptor.hh"
+#include "streaming/stream_reason.hh"
 
 class database;
 class table;
@@ -69,9 +70,15 @@ class distributed_loader {
 
     static future<size_t> make_sstables_available(sstables::sstable_directory& dir,
             sharded<database>& db, sharded<db::view::view_update_generator>& view_update_generator,
-            std::filesystem::path datadir, sstring ks, sstring cf);
+            std::filesystem::path datadir, sstring ks, sstring cf, sstables::offstrategy offstrategy = sstables::offstrategy::no);
     static future<> process_upload_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
             distributed<db::view::view_update_generator>& view_update_generator, sstring ks_name, sstring cf_name);
+    // Loads the sstables whose files were streamed into dir, like process_upload_dir()
+    // does for the upload directory. Returns the number of sstables loaded.
+    // Off-strategy sstables are added to the maintenance set of the table.
+    static future<size_t> process_streamed_dir(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+            distributed<db::view::view_update_generator>& view_update_generator, sstring ks_name, sstring cf_name,
+            std::filesystem::path dir, streaming::stream_reason reason, sstables::offstrategy offstrategy);
     // Scan sstables under upload directory. Return a vector with smp::count entries.
     // Each entry with index of idx should be accessed on shard idx only.
     // Each entry contains a vector of sstables for this shard.
@@ -809,7 +809,10 @@ make_generating_reader(schema_ptr s, reader_permit permit, std::function<future<
 ///     a warning will be logged. When reaching the hard limit the read will be
 ///     aborted.
 ///
-/// FIXME: reversing should be done in the sstable layer, see #1413.
+/// Single partition queries of tables read the partition in reverse in each
+/// of the memtables, the cache and the sstables instead, and merge the
+/// results, see `table::make_reversed_reader()`. The output of those readers
+/// has the same format as this reader's.
 flat_mutation_reader
 make_reversing_reader(flat_mutation_reader& original, query::max_result_size max_size);
 
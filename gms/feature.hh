@@ -147,6 +147,11 @@ extern const std::string_view CORRECT_IDX_TOKEN_IN_SECONDARY_INDEX;
 extern const std::string_view ALTERNATOR_STREAMS;
 extern const std::string_view RANGE_SCAN_DATA_VARIANT;
 extern const std::string_view CDC_GENERATIONS_V2;
+extern const std::string_view CACHE_FREQUENCY_ADMISSION;
+extern const std::string_view VIEW_UPDATE_BATCHES;
+extern const std::string_view LOCAL_INDEX_SINGLE_PASS;
+extern const std::string_view STREAM_SSTABLE_FILES;
+extern const std::string_view HINT_MUTATION_BATCHES;
 
 }
 
@@ -66,6 +66,11 @@ constexpr std::string_view features::CORRECT_IDX_TOKEN_IN_SECONDARY_INDEX = "COR
 constexpr std::string_view features::ALTERNATOR_STREAMS = "ALTERNATOR_STREAMS";
 constexpr std::string_view features::RANGE_SCAN_DATA_VARIANT = "RANGE_SCAN_DATA_VARIANT";
 constexpr std::string_view features::CDC_GENERATIONS_V2 = "CDC_GENERATIONS_V2";
+constexpr std::string_view features::CACHE_FREQUENCY_ADMISSION = "CACHE_FREQUENCY_ADMISSION";
+constexpr std::string_view features::VIEW_UPDATE_BATCHES = "VIEW_UPDATE_BATCHES";
+constexpr std::string_view features::LOCAL_INDEX_SINGLE_PASS = "LOCAL_INDEX_SINGLE_PASS";
+constexpr std::string_view features::STREAM_SSTABLE_FILES = "STREAM_SSTABLE_FILES";
+constexpr std::string_view features::HINT_MUTATION_BATCHES = "HINT_MUTATION_BATCHES";
 
 static logging::logger logger("features");
 
@@ -91,6 +96,11 @@ feature_service::feature_service(feature_config cfg) : _config(cfg)
         , _alternator_streams_feature(*this, features::ALTERNATOR_STREAMS)
         , _range_scan_data_variant(*this, features::RANGE_SCAN_DATA_VARIANT)
         , _cdc_generations_v2(*this, features::CDC_GENERATIONS_V2)
+        , _cache_frequency_admission_feature(*this, features::CACHE_FREQUENCY_ADMISSION)
+        , _view_update_batches_feature(*this, features::VIEW_UPDATE_BATCHES)
+        , _local_index_single_pass_feature(*this, features::LOCAL_INDEX_SINGLE_PASS)
+        , _stream_sstable_files_feature(*this, features::STREAM_SSTABLE_FILES)
+        , _hint_mutation_batches_feature(*this, features::HINT_MUTATION_BATCHES)
 {}
 
 feature_config feature_config_from_db_config(db::config& cfg, std::set<sstring> disabled) {
@@ -188,6 +198,11 @@ std::set<std::string_view> feature_service::known_feature_set() {
         gms::features::ALTERNATOR_STREAMS,
         gms::features::RANGE_SCAN_DATA_VARIANT,
         gms::features::CDC_GENERATIONS_V2,
+        gms::features::CACHE_FREQUENCY_ADMISSION,
+        gms::features::VIEW_UPDATE_BATCHES,
+        gms::features::LOCAL_INDEX_SINGLE_PASS,
+        gms::features::STREAM_SSTABLE_FILES,
+        gms::features::HINT_MUTATION_BATCHES,
     };
 
     for (const sstring& s : _config._disabled_features) {
@@ -268,6 +283,11 @@ void feature_service::enable(const std::set<std::string_view>& list) {
         std::ref(_alternator_streams_feature),
         std::ref(_range_scan_data_variant),
         std::ref(_cdc_generations_v2),
+        std::ref(_cache_frequency_admission_feature),
+        std::ref(_view_update_batches_feature),
+        std::ref(_local_index_single_pass_feature),
+        std::ref(_stream_sstable_files_feature),
+        std::ref(_hint_mutation_batches_feature),
     })
     {
         if (list.contains(f.name())) {
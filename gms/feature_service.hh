@@ -93,6 +93,11 @@ class feature_service final {
     gms::feature _alternator_streams_feature;
     gms::feature _range_scan_data_variant;
     gms::feature _cdc_generations_v2;
+    gms::feature _cache_frequency_admission_feature;
+    gms::feature _view_update_batches_feature;
+    gms::feature _local_index_single_pass_feature;
+    gms::feature _stream_sstable_files_feature;
+    gms::feature _hint_mutation_batches_feature;
 
 public:
     bool cluster_supports_user_defined_functions() const {
@@ -167,6 +172,26 @@ class feature_service final {
     bool cluster_supports_cdc_generations_v2() const {
         return bool(_cdc_generations_v2);
     }
+
+    bool cluster_supports_cache_frequency_admission() const {
+        return bool(_cache_frequency_admission_feature);
+    }
+
+    bool cluster_supports_view_update_batches() const {
+        return bool(_view_update_batches_feature);
+    }
+
+    bool cluster_supports_local_index_single_pass() const {
+        return bool(_local_index_single_pass_feature);
+    }
+
+    bool cluster_supports_stream_sstable_files() const {
+        return bool(_stream_sstable_files_feature);
+    }
+
+    bool cluster_supports_hint_mutation_batches() const {
+        return bool(_hint_mutation_batches_feature);
+    }
 };
 
 } // namespace gms
@@ -158,6 +158,18 @@ gossiper::gossiper(abort_source& as, feature_service& features, const locator::s
                     return 0;
                 }
             }, sm::description("Heartbeat of the current Node.")),
+        sm::make_derive("rounds", _nr_run,
+            sm::description("Number of completed gossip rounds.")),
+        sm::make_derive("round_time_us", _stats.round_time_us,
+            sm::description("Total time spent in gossip rounds, in microseconds.")),
+        sm::make_derive("apply_state_time_us", _stats.apply_state_time_us,
+            sm::description("Total time spent applying endpoint states received from other nodes, in microseconds.")),
+        sm::make_derive("applied_states", _stats.applied_states,
+            sm::description("Number of endpoint states received from other nodes and applied locally.")),
+        sm::make_derive("stale_states", _stats.stale_states,
+            sm::description("Number of endpoint states received from other nodes and dropped because they were not newer than the local ones.")),
+        sm::make_derive("on_change_notifications", _stats.on_change_notifications,
+            sm::description("Number of application state changes delivered to subscribers.")),
     });
 }
 
@@ -565,6 +577,22 @@ future<> gossiper::send_gossip(gossip_digest_syn message, std::set<inet_address>
 }
 
 
+bool gossiper::is_stale_state(gms::inet_address node, const endpoint_state& remote_state) const {
+    auto es = get_endpoint_state_for_endpoint_ptr(node);
+    if (!es) {
+        return false;
+    }
+    int local_generation = es->get_heart_beat_state().get_generation();
+    int remote_generation = remote_state.get_heart_beat_state().get_generation();
+    if (remote_generation != local_generation) {
+        return remote_generation < local_generation;
+    }
+    // Applying an older state of a live node is a no-op, but it may
+    // still mark a node which is not dead as alive.
+    return get_max_endpoint_state_version(remote_state) <= get_max_endpoint_state_version(*es)
+            && (es->is_alive() || is_dead_state(*es));
+}
+
 // Runs inside seastar::async context
 void gossiper::do_apply_state_locally(gms::inet_address node, const endpoint_state& remote_state, bool listener_notification) {
     // If state does not exist just add it. If it does then add it if the remote generation is greater.
@@ -656,15 +684,24 @@ future<> gossiper::apply_state_locally(std::map<inet_address, endpoint_state> ma
                 logger.trace("Ignoring gossip for {} because it is quarantined", ep);
                 return make_ready_future<>();
             }
+            // Most of the states gossiped by a large cluster are already
+            // known, so drop them before paying for a thread and a lock.
+            if (is_stale_state(ep, map[ep])) {
+                logger.trace("Ignoring gossip for {} because it is not newer than the local state", ep);
+                _stats.stale_states++;
+                return make_ready_future<>();
+            }
           return seastar::with_semaphore(_apply_state_locally_semaphore, 1, [this, &ep, &map] () mutable {
             return seastar::async([this, &ep, &map] () mutable {
                 do_apply_state_locally(ep, map[ep], true);
+                _stats.applied_states++;
             });
           });
         });
-    }).then([start] {
-            logger.debug("apply_state_locally() took {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start).count());
+    }).then([this, start] {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            _stats.apply_state_time_us += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+            logger.debug("apply_state_locally() took {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
     });
 }
 
@@ -880,6 +917,7 @@ future<> gossiper::failure_detector_loop() {
 void gossiper::run() {
    // Run it in the background.
   (void)seastar::with_semaphore(_callback_running, 1, [this] {
+    auto start = std::chrono::steady_clock::now();
     return seastar::async([this, g = this->shared_from_this()] {
             logger.trace("=== Gossip round START");
 
@@ -987,7 +1025,8 @@ void gossiper::run() {
                     }
                 }).get();
             }
-    }).then_wrapped([this] (auto&& f) {
+    }).then_wrapped([this, start] (auto&& f) {
+        _stats.round_time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
         try {
             f.get();
             _nr_run++;
@@ -1109,7 +1148,7 @@ std::set<inet_address> gossiper::get_unreachable_members() {
     return ret;
 }
 
-int gossiper::get_max_endpoint_state_version(endpoint_state state) const noexcept {
+int gossiper::get_max_endpoint_state_version(const endpoint_state& state) const noexcept {
     int max_version = state.get_heart_beat_state().get_heart_beat_version();
     for (auto& entry : state.get_application_state_map()) {
         auto& value = entry.second;
@@ -1713,9 +1752,12 @@ void gossiper::apply_new_states(inet_address addr, endpoint_state& local_state,
     // state indefinitely. Unless the value changes again, we wouldn't retry notifications.
     // Some values are set only once, so listeners would never be re-run.
     // Listeners should decide which failures are non-fatal and swallow them.
+    auto notify = [&] (const application_state& key) noexcept {
+        do_on_change_notifications(addr, key, remote_map.at(key));
+    };
     auto run_listeners = seastar::defer([&] () noexcept {
         for (auto&& key : changed) {
-            do_on_change_notifications(addr, key, remote_map.at(key));
+            notify(key);
         }
     });
 
@@ -1723,8 +1765,11 @@ void gossiper::apply_new_states(inet_address addr, endpoint_state& local_state,
     // Exceptions during replication will cause abort because node's state
     // would be inconsistent across shards. Changes listeners depend on state
     // being replicated to all shards.
-    auto replicate_changes = seastar::defer([&] () noexcept {
+    auto replicate_all = [&] () noexcept {
         replicate(addr, remote_map, changed).get();
+    };
+    auto replicate_changes = seastar::defer([&] () noexcept {
+        replicate_all();
     });
 
     // we need to make two loops here, one to apply, then another to notify,
@@ -1746,6 +1791,18 @@ void gossiper::apply_new_states(inet_address addr, endpoint_state& local_state,
             local_state.add_application_state(remote_key, remote_value);
         }
     }
+
+    // The deferred actions above only cover a failure to apply the states.
+    // Otherwise all the changed states are delivered together here, yielding
+    // between them so that a burst of changes doesn't stall, which must not
+    // be done while an exception is being propagated.
+    replicate_changes.cancel();
+    run_listeners.cancel();
+    replicate_all();
+    for (auto&& key : changed) {
+        notify(key);
+        seastar::thread::maybe_yield();
+    }
 }
 
 // Runs inside seastar::async context
@@ -1757,6 +1814,7 @@ void gossiper::do_before_change_notifications(inet_address addr, const endpoint_
 
 // Runs inside seastar::async context
 void gossiper::do_on_change_notifications(inet_address addr, const application_state& state, const versioned_value& value) {
+    _stats.on_change_notifications++;
     _subscribers.for_each([addr, state, value] (shared_ptr<i_endpoint_state_change_subscriber> subscriber) {
         subscriber->on_change(addr, state, value);
     });
@@ -294,7 +294,7 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
      * @param ep_state
      * @return
      */
-    int get_max_endpoint_state_version(endpoint_state state) const noexcept;
+    int get_max_endpoint_state_version(const endpoint_state& state) const noexcept;
 
 
 private:
@@ -448,6 +448,9 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
     future<> apply_state_locally(std::map<inet_address, endpoint_state> map);
 
 private:
+    // Returns true if applying remote_state of the node would change nothing,
+    // so it can be dropped without taking the endpoint lock.
+    bool is_stale_state(gms::inet_address node, const endpoint_state& remote_state) const;
     void do_apply_state_locally(gms::inet_address node, const endpoint_state& remote_state, bool listener_notification);
     void apply_state_locally_without_listener_notification(std::unordered_map<inet_address, endpoint_state> map);
 
@@ -593,6 +596,14 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
 
     uint64_t _nr_run = 0;
     uint64_t _msg_processing = 0;
+
+    struct stats {
+        uint64_t round_time_us = 0;
+        uint64_t apply_state_time_us = 0;
+        uint64_t applied_states = 0;
+        uint64_t stale_states = 0;
+        uint64_t on_change_notifications = 0;
+    } _stats;
     bool _ms_registered = false;
     bool _gossip_settled = false;
 
@@ -606,6 +617,7 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
     db::config& _cfg;
     gossip_config _gcfg;
     friend class feature;
+    friend class gossiper_test;
     // Get features supported by a particular node
     std::set<sstring> get_supported_features(inet_address endpoint) const;
     // Get features supported by all the nodes this node knows about
@@ -63,6 +63,7 @@ struct get_sync_boundary_response {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    send_sketch_rpc_stream,
 };
 
 enum class repair_stream_cmd : uint8_t {
@@ -86,6 +87,28 @@ struct repair_row_on_wire_with_cmd {
     partition_key_and_mutation_fragments row;
 };
 
+struct repair_hash_sketch_cell {
+    int32_t count;
+    uint64_t key_sum;
+    uint64_t check_sum;
+};
+
+class repair_hash_sketch {
+    std::vector<repair_hash_sketch_cell> cells();
+};
+
+struct repair_reconcile_row_hashes_response {
+    bool decoded;
+    std::vector<repair_hash> follower_only;
+    std::vector<repair_hash> master_only;
+};
+
+struct repair_bucket_digest {
+    uint32_t index;
+    uint64_t fragments;
+    uint64_t sum;
+};
+
 enum class repair_row_level_start_status: uint8_t {
     ok,
     no_such_column_family,
@@ -46,6 +46,11 @@ struct max_result_size {
     uint64_t hard_limit;
 }
 
+struct local_index_lookup {
+    utils::UUID view_id;
+    std::vector<nonwrapping_range<clustering_key_prefix>> ranges;
+};
+
 class read_command {
     utils::UUID cf_id;
     utils::UUID schema_version;
@@ -58,6 +63,7 @@ class read_command {
     query::is_first_page is_first_page [[version 2.2]] = query::is_first_page::no;
     std::optional<query::max_result_size> max_result_size [[version 4.3]] = std::nullopt;
     uint32_t row_limit_high_bits [[version 4.3]] = 0;
+    std::optional<query::local_index_lookup> index_lookup [[version 4.6]] = std::nullopt;
 };
 
 }
@@ -58,4 +58,17 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     end_of_stream,
 };
 
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    component_data,
+    component_end,
+    end_of_stream,
+};
+
+struct stream_sstable_file_chunk {
+    sstring component;
+    bytes data;
+    uint32_t checksum;
+};
+
 }
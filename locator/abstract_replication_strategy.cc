@@ -79,19 +79,22 @@ inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpo
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::do_get_natural_endpoints(const token& search_token, const token_metadata& tm, can_yield can_yield) {
-    const token& key_token = tm.first_token(search_token);
-    auto& cached_endpoints = get_cached_endpoints(tm);
-    auto res = cached_endpoints.find(key_token);
+    auto idx = tm.first_token_index(search_token);
+    auto& cached = get_cached_endpoints(tm)[idx];
 
-    if (res == cached_endpoints.end()) {
+    if (!cached) {
         auto endpoints = calculate_natural_endpoints(search_token, tm, can_yield);
-        cached_endpoints.emplace(key_token, endpoints);
+        // The calculation may have yielded and the cache may have been
+        // invalidated by a lookup on a newer ring meanwhile.
+        if (_last_invalidated_ring_version == tm.get_ring_version()) {
+            _cached_endpoints[idx] = endpoints;
+        }
 
         return endpoints;
     }
 
     ++_cache_hits_count;
-    return res->second;
+    return *cached;
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpoints_without_node_being_replaced(const token& search_token, can_yield can_yield) {
@@ -132,11 +135,12 @@ void abstract_replication_strategy::validate_replication_factor(sstring rf) cons
     }
 }
 
-inline std::unordered_map<token, inet_address_vector_replica_set>&
+inline utils::chunked_vector<std::optional<inet_address_vector_replica_set>>&
 abstract_replication_strategy::get_cached_endpoints(const token_metadata& tm) {
     auto ring_version = tm.get_ring_version();
-    if (_last_invalidated_ring_version != ring_version) {
+    if (_last_invalidated_ring_version != ring_version || _cached_endpoints.size() != tm.sorted_tokens().size()) {
         _cached_endpoints.clear();
+        _cached_endpoints.resize(tm.sorted_tokens().size());
         _last_invalidated_ring_version = ring_version;
     }
 
@@ -24,6 +24,7 @@
 #include <memory>
 #include <functional>
 #include <unordered_map>
+#include <optional>
 #include "gms/inet_address.hh"
 #include "locator/snitch_base.hh"
 #include "dht/i_partitioner.hh"
@@ -31,6 +32,7 @@
 #include "snitch_base.hh"
 #include <seastar/util/bool_class.hh>
 #include "utils/maybe_yield.hh"
+#include "utils/chunked_vector.hh"
 
 // forward declaration since database.hh includes this file
 class keyspace;
@@ -52,12 +54,15 @@ using can_yield = utils::can_yield;
 class abstract_replication_strategy {
 private:
     long _last_invalidated_ring_version = 0;
-    std::unordered_map<token, inet_address_vector_replica_set> _cached_endpoints;
+    // Replica sets of the ring's vnodes, indexed by the position of the
+    // vnode's token in token_metadata::sorted_tokens(). Filled in lazily,
+    // so that a lookup is a binary search over the sorted tokens.
+    utils::chunked_vector<std::optional<inet_address_vector_replica_set>> _cached_endpoints;
     uint64_t _cache_hits_count = 0;
 
     static logging::logger logger;
 
-    std::unordered_map<token, inet_address_vector_replica_set>&
+    utils::chunked_vector<std::optional<inet_address_vector_replica_set>>&
     get_cached_endpoints(const token_metadata& tm);
 protected:
     sstring _ks_name;
@@ -1318,6 +1318,7 @@ int main(int ac, char** av) {
                 view_builder.invoke_on_all([&mm] (db::view::view_builder& vb) { 
                     return vb.start(mm.local());
                 }).get();
+                api::set_server_view_builder(ctx, view_builder).get();
             }
 
             // Truncate `clients' CF - this table should not persist between server restarts.
@@ -1482,6 +1483,12 @@ int main(int ac, char** av) {
                 }
             });
 
+            auto stop_view_builder_api = defer_verbose_shutdown("view builder API", [&ctx, cfg] {
+                if (cfg->view_building()) {
+                    api::unset_server_view_builder(ctx).get();
+                }
+            });
+
             auto stop_redis_service = defer_verbose_shutdown("redis service", [&cfg] {
                 if (cfg->redis_port() || cfg->redis_ssl_port()) {
                     redis.stop().get();
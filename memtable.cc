@@ -241,6 +241,16 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     return i->partition();
 }
 
+bool
+memtable::contains(const dht::decorated_key& key) const {
+    return partitions.find(key, dht::ring_position_comparator(*_schema)) != partitions.end();
+}
+
+bool
+memtable::empty(const dht::partition_range& range) const {
+    return slice(range).empty();
+}
+
 boost::iterator_range<memtable::partitions_type::const_iterator>
 memtable::slice(const dht::partition_range& range) const {
     if (query::is_single_partition(range)) {
@@ -580,9 +590,9 @@ class flush_reader final : public flat_mutation_reader::impl, private iterator_r
     flat_mutation_reader_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
 public:
-    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m, const dht::partition_range& range)
         : impl(s, std::move(permit))
-        , iterator_reader(std::move(s), m, query::full_partition_range)
+        , iterator_reader(std::move(s), m, range)
         , _flushed_memory(*m)
     {}
     flush_reader(const flush_reader&) = delete;
@@ -701,15 +711,49 @@ memtable::make_flat_reader(schema_ptr s,
     }
 }
 
+flat_mutation_reader
+memtable::make_reversed_reader(schema_ptr s,
+                      reader_permit permit,
+                      const dht::partition_range& range,
+                      const query::partition_slice& slice) {
+    assert(query::is_single_partition(range));
+    const query::ring_position& pos = range.start()->value();
+    auto snp = _read_section(*this, [&] () -> partition_snapshot_ptr {
+        auto i = partitions.find(pos, dht::ring_position_comparator(*_schema));
+        if (i != partitions.end()) {
+            upgrade_entry(*i);
+            return i->snapshot(*this);
+        } else {
+            return { };
+        }
+    });
+    if (!snp) {
+        return make_empty_flat_reader(std::move(s), std::move(permit));
+    }
+    auto dk = pos.as_decorated_key();
+    auto cr = query::clustering_key_filter_ranges::get_ranges(*s, slice, dk.key());
+    auto snp_schema = snp->schema();
+    bool digest_requested = slice.options.contains<query::partition_slice::option::with_digest>();
+    auto rd = make_partition_snapshot_reversing_reader(snp_schema, std::move(permit), std::move(dk), std::move(cr), std::move(snp), digest_requested,
+                                                       *this, _read_section, shared_from_this());
+    rd.upgrade_schema(s);
+    return rd;
+}
+
 flat_mutation_reader
 memtable::make_flush_reader(schema_ptr s, const io_priority_class& pc) {
+    return make_flush_reader(std::move(s), query::full_partition_range, pc);
+}
+
+flat_mutation_reader
+memtable::make_flush_reader(schema_ptr s, const dht::partition_range& range, const io_priority_class& pc) {
     auto permit = _flush_semaphore.make_permit(s.get(), "memtable-flush");
     if (group()) {
-        return make_flat_mutation_reader<flush_reader>(std::move(s), std::move(permit), shared_from_this());
+        return make_flat_mutation_reader<flush_reader>(std::move(s), std::move(permit), shared_from_this(), range);
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader<scanning_reader>(std::move(s), shared_from_this(), std::move(permit),
-            query::full_partition_range, full_slice, pc, mutation_reader::forwarding::no);
+            range, full_slice, pc, mutation_reader::forwarding::no);
     }
 }
 
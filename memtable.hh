@@ -34,7 +34,7 @@
 #include "utils/extremum_tracking.hh"
 #include "mutation_cleaner.hh"
 #include "sstables/types.hh"
-#include "utils/double-decker.hh"
+#include "utils/radix-decker.hh"
 
 class frozen_mutation;
 class flat_mutation_reader;
@@ -111,9 +111,8 @@ struct table_stats;
 // Managed by lw_shared_ptr<>.
 class memtable final : public enable_lw_shared_from_this<memtable>, private logalloc::region {
 public:
-    using partitions_type = double_decker<int64_t, memtable_entry,
-                            dht::raw_token_less_comparator, dht::ring_position_comparator,
-                            16, bplus::key_search::linear>;
+    using partitions_type = radix_decker<memtable_entry,
+                            dht::raw_token_less_comparator, dht::ring_position_comparator>;
 private:
     dirty_memory_manager& _dirty_mgr;
     mutation_cleaner _cleaner;
@@ -258,11 +257,25 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
         return make_flat_reader(s, std::move(permit), range, full_slice);
     }
 
+    // Creates a reader of a single partition in reverse clustering order, in
+    // the format of make_reversing_reader(). The range must be a single partition.
+    flat_mutation_reader make_reversed_reader(schema_ptr,
+                                              reader_permit permit,
+                                              const dht::partition_range& range,
+                                              const query::partition_slice& slice);
+
     flat_mutation_reader make_flush_reader(schema_ptr, const io_priority_class& pc);
+    // Reads only partitions within the range, which must be kept alive until
+    // the reader is closed. Flush readers of disjoint ranges may run concurrently.
+    flat_mutation_reader make_flush_reader(schema_ptr, const dht::partition_range&, const io_priority_class& pc);
 
     mutation_source as_data_source();
 
     bool empty() const { return partitions.empty(); }
+    // Tells whether the memtable holds any data for the given partition.
+    bool contains(const dht::decorated_key& key) const;
+    // Tells whether the memtable holds no partition within the given range.
+    bool empty(const dht::partition_range& range) const;
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const;
     void on_detach_from_region_group() noexcept;
@@ -550,6 +550,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -563,8 +564,11 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_RECONCILE_ROW_HASHES:
+    case messaging_verb::REPAIR_GET_RANGE_DIGEST:
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
+    case messaging_verb::HINT_MUTATION_BATCH:
     case messaging_verb::HINT_SYNC_POINT_CREATE:
     case messaging_verb::HINT_SYNC_POINT_CHECK:
         return 1;
@@ -578,6 +582,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::MIGRATION_REQUEST:
     case messaging_verb::SCHEMA_CHECK:
     case messaging_verb::COUNTER_MUTATION:
+    case messaging_verb::VIEW_UPDATE_BATCH:
     // Use the same RPC client for light weight transaction
     // protocol steps as for standard mutations and read requests.
     case messaging_verb::PAXOS_PREPARE:
@@ -887,6 +892,35 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(utils::UUID plan_id, utils::UUID cf_id, streaming::stream_reason reason, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        return make_exception_future<value_type>(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>().then([this, plan_id, cf_id, reason, rpc_client] (rpc::sink<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (utils::UUID, utils::UUID, streaming::stream_reason, rpc::sink<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client, plan_id, cf_id, reason, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<value_type>(value_type(std::move(sink), std::move(source.get0())));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID cf_id, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -1205,6 +1239,16 @@ future<> messaging_service::send_counter_mutation(msg_addr id, clock_type::time_
     return send_message_timeout<void>(this, messaging_verb::COUNTER_MUTATION, std::move(id), timeout, std::move(fms), cl, std::move(trace_info));
 }
 
+void messaging_service::register_view_update_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms, std::optional<tracing::trace_info> trace_info)>&& func) {
+    register_handler(this, netw::messaging_verb::VIEW_UPDATE_BATCH, std::move(func));
+}
+future<> messaging_service::unregister_view_update_batch() {
+    return unregister_handler(netw::messaging_verb::VIEW_UPDATE_BATCH);
+}
+future<db::view::update_backlog> messaging_service::send_view_update_batch(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms, std::optional<tracing::trace_info> trace_info) {
+    return send_message_timeout<db::view::update_backlog>(this, messaging_verb::VIEW_UPDATE_BATCH, std::move(id), timeout, std::move(fms), std::move(trace_info));
+}
+
 void messaging_service::register_mutation_done(std::function<future<rpc::no_wait_type> (const rpc::client_info& cinfo, unsigned shard, response_id_type response_id, rpc::optional<db::view::update_backlog> backlog)>&& func) {
     register_handler(this, netw::messaging_verb::MUTATION_DONE, std::move(func));
 }
@@ -1311,6 +1355,28 @@ future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes(msg_a
     return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(id), repair_meta_id);
 }
 
+// Wrapper for REPAIR_RECONCILE_ROW_HASHES
+void messaging_service::register_repair_reconcile_row_hashes(std::function<future<repair_reconcile_row_hashes_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, repair_hash_sketch sketch)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_RECONCILE_ROW_HASHES, std::move(func));
+}
+future<> messaging_service::unregister_repair_reconcile_row_hashes() {
+    return unregister_handler(messaging_verb::REPAIR_RECONCILE_ROW_HASHES);
+}
+future<repair_reconcile_row_hashes_response> messaging_service::send_repair_reconcile_row_hashes(msg_addr id, uint32_t repair_meta_id, repair_hash_sketch sketch) {
+    return send_message<future<repair_reconcile_row_hashes_response>>(this, messaging_verb::REPAIR_RECONCILE_ROW_HASHES, std::move(id), repair_meta_id, std::move(sketch));
+}
+
+// Wrapper for REPAIR_GET_RANGE_DIGEST
+void messaging_service::register_repair_get_range_digest(std::function<future<std::optional<std::vector<repair_bucket_digest>>> (const rpc::client_info& cinfo, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_RANGE_DIGEST, std::move(func));
+}
+future<> messaging_service::unregister_repair_get_range_digest() {
+    return unregister_handler(messaging_verb::REPAIR_GET_RANGE_DIGEST);
+}
+future<std::optional<std::vector<repair_bucket_digest>>> messaging_service::send_repair_get_range_digest(msg_addr id, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits) {
+    return send_message<future<std::optional<std::vector<repair_bucket_digest>>>>(this, messaging_verb::REPAIR_GET_RANGE_DIGEST, std::move(id), std::move(table_id), std::move(range), bucket_bits);
+}
+
 // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
 void messaging_service::register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func) {
     register_handler(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(func));
@@ -1494,6 +1560,16 @@ future<> messaging_service::send_hint_mutation(msg_addr id, clock_type::time_poi
         std::move(reply_to), shard, std::move(response_id), std::move(trace_info));
 }
 
+void messaging_service::register_hint_mutation_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func) {
+    register_handler(this, netw::messaging_verb::HINT_MUTATION_BATCH, std::move(func));
+}
+future<> messaging_service::unregister_hint_mutation_batch() {
+    return unregister_handler(netw::messaging_verb::HINT_MUTATION_BATCH);
+}
+future<db::view::update_backlog> messaging_service::send_hint_mutation_batch(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms) {
+    return send_message_timeout<db::view::update_backlog>(this, messaging_verb::HINT_MUTATION_BATCH, std::move(id), timeout, std::move(fms));
+}
+
 void messaging_service::register_raft_send_snapshot(std::function<future<raft::snapshot_reply> (const rpc::client_info&, rpc::opt_time_point, raft::group_id gid, raft::server_id from_id, raft::server_id dst_id, raft::install_snapshot)>&& func) {
    register_handler(this, netw::messaging_verb::RAFT_SEND_SNAPSHOT, std::move(func));
 }
@@ -38,6 +38,7 @@
 #include "digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files.hh"
 #include "cache_temperature.hh"
 #include "service/paxos/prepare_response.hh"
 #include "raft/raft.hh"
@@ -162,7 +163,12 @@ enum class messaging_verb : int32_t {
     RAFT_TIMEOUT_NOW = 51,
     HINT_SYNC_POINT_CREATE = 52,
     HINT_SYNC_POINT_CHECK = 53,
-    LAST = 54,
+    VIEW_UPDATE_BATCH = 54,
+    REPAIR_RECONCILE_ROW_HASHES = 55,
+    REPAIR_GET_RANGE_DIGEST = 56,
+    STREAM_SSTABLE_FILES = 57,
+    HINT_MUTATION_BATCH = 58,
+    LAST = 59,
 };
 
 } // namespace netw
@@ -332,6 +338,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // As for STREAM_MUTATION_FRAGMENTS, the receiver sends a status code to the sender, 0 means successful, -1 means error.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID cf_id, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>& source);
+    future<std::tuple<rpc::sink<streaming::stream_sstable_file_chunk, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(utils::UUID plan_id, utils::UUID cf_id, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -363,6 +376,16 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_repair_get_full_row_hashes();
     future<repair_hash_set> send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id);
 
+    // Wrapper for REPAIR_RECONCILE_ROW_HASHES
+    void register_repair_reconcile_row_hashes(std::function<future<repair_reconcile_row_hashes_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, repair_hash_sketch sketch)>&& func);
+    future<> unregister_repair_reconcile_row_hashes();
+    future<repair_reconcile_row_hashes_response> send_repair_reconcile_row_hashes(msg_addr id, uint32_t repair_meta_id, repair_hash_sketch sketch);
+
+    // Wrapper for REPAIR_GET_RANGE_DIGEST
+    void register_repair_get_range_digest(std::function<future<std::optional<std::vector<repair_bucket_digest>>> (const rpc::client_info& cinfo, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits)>&& func);
+    future<> unregister_repair_get_range_digest();
+    future<std::optional<std::vector<repair_bucket_digest>>> send_repair_get_range_digest(msg_addr id, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits);
+
     // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
     void register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func);
     future<> unregister_repair_get_combined_row_hash();
@@ -470,6 +493,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_counter_mutation();
     future<> send_counter_mutation(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms, db::consistency_level cl, std::optional<tracing::trace_info> trace_info = std::nullopt);
 
+    // Wrapper for VIEW_UPDATE_BATCH
+    void register_view_update_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms, std::optional<tracing::trace_info> trace_info)>&& func);
+    future<> unregister_view_update_batch();
+    future<db::view::update_backlog> send_view_update_batch(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms, std::optional<tracing::trace_info> trace_info = std::nullopt);
+
     // Wrapper for MUTATION_DONE
     void register_mutation_done(std::function<future<rpc::no_wait_type> (const rpc::client_info& cinfo, unsigned shard, response_id_type response_id, rpc::optional<db::view::update_backlog> backlog)>&& func);
     future<> unregister_mutation_done();
@@ -560,6 +588,12 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> send_hint_mutation(msg_addr id, clock_type::time_point timeout, const frozen_mutation& fm, inet_address_vector_replica_set forward,
         inet_address reply_to, unsigned shard, response_id_type response_id, std::optional<tracing::trace_info> trace_info = std::nullopt);
 
+    // Wrapper for HINT_MUTATION_BATCH
+    // Responds with the view update backlog of the receiving node.
+    void register_hint_mutation_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func);
+    future<> unregister_hint_mutation_batch();
+    future<db::view::update_backlog> send_hint_mutation_batch(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms);
+
     void register_hint_sync_point_create(std::function<future<db::hints::sync_point_create_response> (db::hints::sync_point_create_request request)>&& func);
     future<> unregister_hint_sync_point_create();
     future<db::hints::sync_point_create_response> send_hint_sync_point_create(msg_addr id, clock_type::time_point timeout, db::hints::sync_point_create_request request);
@@ -482,6 +482,12 @@ mutation_partition::apply_row_tombstone(const schema& schema, range_tombstone rt
     _row_tombstones.apply(schema, std::move(rt));
 }
 
+void
+mutation_partition::apply_row_tombstones(const schema& schema, std::vector<range_tombstone> rts) {
+    check_schema(schema);
+    _row_tombstones.apply(schema, std::move(rts));
+}
+
 void
 mutation_partition::apply_delete(const schema& schema, const clustering_key_prefix& prefix, tombstone t) {
     check_schema(schema);
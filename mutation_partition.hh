@@ -1185,6 +1185,8 @@ class mutation_partition final {
     // prefix must not be full
     void apply_row_tombstone(const schema& schema, clustering_key_prefix prefix, tombstone t);
     void apply_row_tombstone(const schema& schema, range_tombstone rt);
+    // Applies a batch of possibly overlapping range tombstones, see range_tombstone_list::apply().
+    void apply_row_tombstones(const schema& schema, std::vector<range_tombstone> rts);
     //
     // Applies p to current object.
     //
@@ -118,6 +118,10 @@ class reconcilable_result {
         return _short_read;
     }
 
+    void set_short_read(query::short_read sr) {
+        _short_read = sr;
+    }
+
     size_t memory_usage() const {
         return _memory_tracker.used_memory();
     }
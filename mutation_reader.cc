@@ -23,6 +23,7 @@
 #include <boost/range/algorithm/reverse.hpp>
 #include <boost/move/iterator.hpp>
 #include <variant>
+#include <stack>
 
 #include <seastar/core/future-util.hh>
 #include <seastar/core/coroutine.hh>
@@ -33,6 +34,7 @@
 #include "schema_registry.hh"
 #include "mutation_compactor.hh"
 #include "dht/sharder.hh"
+#include "range_tombstone_list.hh"
 
 logging::logger mrlog("mutation_reader");
 
@@ -2728,3 +2730,375 @@ flat_mutation_reader make_clustering_combined_reader(schema_ptr schema,
             schema, permit, fwd_sm,
             clustering_order_reader_merger(schema, permit, fwd_sm, std::move(rq)));
 }
+
+class reversed_combined_reader : public flat_mutation_reader::impl {
+    // Max-heap of the readers with a fragment to emit, on the position at which
+    // the fragment is emitted in reverse: the end of range tombstones.
+    class heap_compare {
+        position_in_partition::less_compare _less;
+        static position_in_partition_view key(const mutation_fragment& mf) {
+            return mf.is_range_tombstone() ? mf.as_range_tombstone().end_position() : mf.position();
+        }
+    public:
+        explicit heap_compare(const schema& s) : _less(s) { }
+        bool operator()(const flat_mutation_reader* a, const flat_mutation_reader* b) {
+            return _less(key(a->peek_buffer()), key(b->peek_buffer()));
+        }
+    };
+
+    std::vector<flat_mutation_reader> _readers;
+    std::vector<flat_mutation_reader*> _heap;
+    heap_compare _heap_cmp;
+    bool _started = false;
+private:
+    // Puts the reader back on the heap, unless it's done with the partition.
+    future<> refill(flat_mutation_reader& reader, db::timeout_clock::time_point timeout) {
+        auto* mf = co_await reader.peek(timeout);
+        if (!mf) {
+            co_return;
+        }
+        if (mf->is_end_of_partition()) {
+            reader.pop_mutation_fragment();
+            co_return;
+        }
+        _heap.push_back(&reader);
+        boost::range::push_heap(_heap, _heap_cmp);
+    }
+    // Emits the merged partition_start and static row.
+    future<> start(db::timeout_clock::time_point timeout) {
+        _started = true;
+        std::optional<dht::decorated_key> key;
+        tombstone partition_tombstone;
+        mutation_fragment_opt static_row;
+        for (auto& reader : _readers) {
+            if (!co_await reader.peek(timeout)) {
+                continue;
+            }
+            auto ps = std::move(reader.pop_mutation_fragment()).as_partition_start();
+            partition_tombstone.apply(ps.partition_tombstone());
+            if (!key) {
+                key = std::move(ps.key());
+            }
+            auto* mf = co_await reader.peek(timeout);
+            if (mf && mf->is_static_row()) {
+                if (static_row) {
+                    static_row->apply(*_schema, reader.pop_mutation_fragment());
+                } else {
+                    static_row = reader.pop_mutation_fragment();
+                }
+            }
+            co_await refill(reader, timeout);
+        }
+        if (!key) {
+            _end_of_stream = true;
+            co_return;
+        }
+        push_mutation_fragment(*_schema, _permit, partition_start(std::move(*key), partition_tombstone));
+        if (static_row && !static_row->as_static_row().empty()) {
+            push_mutation_fragment(std::move(*static_row));
+        }
+    }
+public:
+    reversed_combined_reader(schema_ptr schema, reader_permit permit, std::vector<flat_mutation_reader> readers)
+        : impl(std::move(schema), std::move(permit))
+        , _readers(std::move(readers))
+        , _heap_cmp(*_schema)
+    {
+        _heap.reserve(_readers.size());
+    }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        if (!_started) {
+            co_await start(timeout);
+        }
+        position_in_partition::equal_compare eq(*_schema);
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            if (_heap.empty()) {
+                push_mutation_fragment(*_schema, _permit, partition_end());
+                _end_of_stream = true;
+                break;
+            }
+            boost::range::pop_heap(_heap, _heap_cmp);
+            auto* reader = _heap.back();
+            _heap.pop_back();
+            auto mf = reader->pop_mutation_fragment();
+            co_await refill(*reader, timeout);
+            if (mf.is_clustering_row()) {
+                while (!_heap.empty() && _heap.front()->peek_buffer().is_clustering_row()
+                        && eq(_heap.front()->peek_buffer().position(), mf.position())) {
+                    boost::range::pop_heap(_heap, _heap_cmp);
+                    auto* other = _heap.back();
+                    _heap.pop_back();
+                    mf.apply(*_schema, other->pop_mutation_fragment());
+                    co_await refill(*other, timeout);
+                }
+            }
+            push_mutation_fragment(std::move(mf));
+        }
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            // There is a single partition only.
+            _heap.clear();
+            _started = true;
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range&, db::timeout_clock::time_point) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range, db::timeout_clock::time_point) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> close() noexcept override {
+        return parallel_for_each(_readers, [] (flat_mutation_reader& reader) {
+            return reader.close();
+        });
+    }
+};
+
+flat_mutation_reader make_reversed_combined_reader(schema_ptr schema,
+        reader_permit permit,
+        std::vector<flat_mutation_reader> readers) {
+    if (readers.size() == 1) {
+        return std::move(readers.front());
+    }
+    return make_flat_mutation_reader<reversed_combined_reader>(std::move(schema), std::move(permit), std::move(readers));
+}
+
+class chunked_reversing_reader : public flat_mutation_reader::impl {
+    mutation_source _source;
+    const dht::partition_range& _range;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    tracing::trace_state_ptr _trace_state;
+    const query::max_result_size _max_size;
+    bool _below_soft_limit = true;
+    // The clustering ranges of the partition, in clustering order.
+    query::clustering_row_ranges _ranges;
+    // Chunk i spans [_splits[i - 1], _splits[i]), the first and the last chunk
+    // are open-ended.
+    std::vector<position_in_partition> _splits;
+    // The number of chunks which were not read yet, these are the first ones.
+    size_t _chunks_left;
+    // The slice of the chunk being read, has to outlive its reader.
+    std::optional<query::partition_slice> _chunk_slice;
+    // Engaged once partition_start was emitted.
+    std::optional<tombstone> _partition_tombstone;
+    // The content of the last read chunk, not emitted yet.
+    std::stack<mutation_fragment> _rows;
+    range_tombstone_list _range_tombstones;
+    size_t _stack_size = 0;
+private:
+    const position_in_partition* chunk_start(size_t chunk) const {
+        return chunk ? &_splits[chunk - 1] : nullptr;
+    }
+    const position_in_partition* chunk_end(size_t chunk) const {
+        return chunk < _splits.size() ? &_splits[chunk] : nullptr;
+    }
+    void emit_chunk() {
+        auto emit_range_tombstone = [&] {
+            auto it = std::prev(_range_tombstones.end());
+            push_mutation_fragment(*_schema, _permit, _range_tombstones.pop_as<range_tombstone>(it));
+        };
+        position_in_partition::less_compare cmp(*_schema);
+        while (!_rows.empty() && !is_buffer_full()) {
+            auto& mf = _rows.top();
+            if (!_range_tombstones.empty() && !cmp(_range_tombstones.rbegin()->end_position(), mf.position())) {
+                emit_range_tombstone();
+            } else {
+                _stack_size -= mf.memory_usage();
+                push_mutation_fragment(std::move(mf));
+                _rows.pop();
+            }
+        }
+        while (!_range_tombstones.empty() && !is_buffer_full()) {
+            emit_range_tombstone();
+        }
+    }
+    void check_memory_usage(const partition_key& key) {
+        if (_stack_size > _max_size.hard_limit) {
+            throw std::runtime_error(fmt::format(
+                    "Memory usage of reversed read exceeds hard limit of {} (configured via max_memory_for_unlimited_query_hard_limit), while reading partition {}",
+                    _max_size.hard_limit,
+                    key.with_schema(*_schema)));
+        }
+        if (_stack_size > _max_size.soft_limit && _below_soft_limit) {
+            mrlog.warn(
+                    "Memory usage of reversed read exceeds soft limit of {} (configured via max_memory_for_unlimited_query_soft_limit), while reading partition {}",
+                    _max_size.soft_limit,
+                    key.with_schema(*_schema));
+            _below_soft_limit = false;
+        }
+    }
+    void consume_from_chunk(size_t chunk, mutation_fragment mf) {
+        auto start = chunk_start(chunk);
+        auto end = chunk_end(chunk);
+        position_in_partition::less_compare less(*_schema);
+        switch (mf.mutation_fragment_kind()) {
+        case mutation_fragment::kind::partition_start: {
+            auto t = mf.as_partition_start().partition_tombstone();
+            if (!_partition_tombstone) {
+                _partition_tombstone = t;
+                push_mutation_fragment(std::move(mf));
+            } else if (t > *_partition_tombstone) {
+                // Already emitted chunks can't be covered anymore, but this
+                // one still can.
+                _range_tombstones.apply(*_schema, range_tombstone(
+                        start ? position_in_partition_view(*start) : position_in_partition_view::before_all_clustered_rows(),
+                        end ? position_in_partition_view(*end) : position_in_partition_view::after_all_clustered_rows(),
+                        t));
+            }
+            break;
+        }
+        case mutation_fragment::kind::static_row:
+            // The static row is the same for all chunks, emit it together
+            // with the partition_start.
+            if (is_buffer_empty() || !buffer().back().is_partition_start()) {
+                break;
+            }
+            push_mutation_fragment(std::move(mf));
+            break;
+        case mutation_fragment::kind::range_tombstone: {
+            // The readers may emit range tombstones which overlap the chunk
+            // only partially, trim them so that chunks don't overlap.
+            auto rt = std::move(mf).as_range_tombstone();
+            if (start && !rt.trim_front(*_schema, *start)) {
+                break;
+            }
+            if (end) {
+                if (!less(rt.position(), *end)) {
+                    break;
+                }
+                if (less(*end, rt.end_position())) {
+                    rt.set_end(*_schema, *end);
+                }
+            }
+            _range_tombstones.apply(*_schema, std::move(rt));
+            break;
+        }
+        case mutation_fragment::kind::clustering_row:
+            _rows.emplace(std::move(mf));
+            _stack_size += _rows.top().memory_usage();
+            check_memory_usage(*_range.start()->value().key());
+            break;
+        case mutation_fragment::kind::partition_end:
+            break;
+        }
+    }
+    future<> read_chunk(size_t chunk, db::timeout_clock::time_point timeout) {
+        auto ranges = _ranges;
+        if (auto start = chunk_start(chunk)) {
+            query::trim_clustering_row_ranges_to(*_schema, ranges, *start);
+        }
+        if (auto end = chunk_end(chunk)) {
+            query::trim_clustering_row_ranges_to(*_schema, ranges, *end, true);
+        }
+        if (ranges.empty()) {
+            co_return;
+        }
+        auto options = _slice.options;
+        options.remove<query::partition_slice::option::reversed>();
+        _chunk_slice.emplace(std::move(ranges), _slice.static_columns, _slice.regular_columns, options, nullptr,
+                _slice.cql_format(), _slice.partition_row_limit());
+        auto reader = _source.make_reader(_schema, _permit, _range, *_chunk_slice, _pc, _trace_state,
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+        std::exception_ptr ex;
+        try {
+            co_await reader.consume_pausable([this, chunk] (mutation_fragment mf) {
+                consume_from_chunk(chunk, std::move(mf));
+                return stop_iteration::no;
+            }, timeout);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await reader.close();
+        _chunk_slice.reset();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+public:
+    chunked_reversing_reader(mutation_source source, schema_ptr schema, reader_permit permit,
+            const dht::partition_range& range, const query::partition_slice& slice, const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state, std::vector<position_in_partition> split_positions,
+            query::max_result_size max_size)
+        : impl(std::move(schema), std::move(permit))
+        , _source(std::move(source))
+        , _range(range)
+        , _slice(slice)
+        , _pc(pc)
+        , _trace_state(std::move(trace_state))
+        , _max_size(max_size)
+        , _ranges(slice.row_ranges(*_schema, *range.start()->value().key()))
+        , _splits(std::move(split_positions))
+        , _chunks_left(_splits.size() + 1)
+        , _range_tombstones(*_schema)
+    {
+        assert(range.is_singular() && range.start()->value().has_key());
+        // The ranges of a reversed slice are in reverse clustering order.
+        if (slice.options.contains(query::partition_slice::option::reversed)) {
+            std::reverse(_ranges.begin(), _ranges.end());
+        }
+    }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            if (!_rows.empty() || !_range_tombstones.empty()) {
+                emit_chunk();
+            } else if (_chunks_left) {
+                co_await read_chunk(--_chunks_left, timeout);
+            } else {
+                if (_partition_tombstone) {
+                    push_mutation_fragment(*_schema, _permit, partition_end());
+                }
+                _end_of_stream = true;
+            }
+        }
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            // There is a single partition only.
+            _rows = {};
+            _stack_size = 0;
+            _range_tombstones.clear();
+            _chunks_left = 0;
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range&, db::timeout_clock::time_point) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range, db::timeout_clock::time_point) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> close() noexcept override {
+        // Chunk readers are closed as soon as they are consumed.
+        return make_ready_future<>();
+    }
+};
+
+flat_mutation_reader make_chunked_reversing_reader(mutation_source source,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& range,
+        const query::partition_slice& slice,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        std::vector<position_in_partition> split_positions,
+        query::max_result_size max_size) {
+    return make_flat_mutation_reader<chunked_reversing_reader>(std::move(source), std::move(schema), std::move(permit),
+            range, slice, pc, std::move(trace_state), std::move(split_positions), max_size);
+}
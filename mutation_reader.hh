@@ -69,6 +69,14 @@ flat_mutation_reader make_combined_reader(schema_ptr schema,
         streamed_mutation::forwarding fwd_sm = streamed_mutation::forwarding::no,
         mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes);
 
+// Creates a mutation reader which combines readers of a single partition
+// which emit it in reverse clustering order, in the format of
+// make_reversing_reader(). The result has the same format.
+// Fast-forwarding is not supported.
+flat_mutation_reader make_reversed_combined_reader(schema_ptr schema,
+        reader_permit permit,
+        std::vector<flat_mutation_reader>);
+
 template <typename MutationFilter>
 requires requires(MutationFilter mf, const dht::decorated_key& dk) {
     { mf(dk) } -> std::same_as<bool>;
@@ -676,3 +684,34 @@ flat_mutation_reader make_clustering_combined_reader(schema_ptr schema,
         reader_permit,
         streamed_mutation::forwarding,
         std::unique_ptr<position_reader_queue>);
+
+/// A reader that emits a single partition of a reversed slice in reverse,
+/// in the same format as the reader returned by `make_reversing_reader()`.
+///
+/// Instead of reading the whole partition into memory before reversing it,
+/// the partition is split into consecutive clustering ranges (chunks) at
+/// `split_positions`, which are read from the last to the first, each with a
+/// separate forward reader of `source`. Only one chunk is kept in memory at a
+/// time, and a read which is stopped early (e.g. by a row limit) doesn't read
+/// the remaining chunks at all. Each chunk reader is created with a slice
+/// restricted to the chunk, so when the chunks are aligned with the sstables
+/// (see `sstables::sstable_set::clustering_split_positions()`), most of the
+/// sstables are not read for most of the chunks.
+///
+/// \param range must be singular, has to be kept alive while the reader is in
+///     use, the same goes for `slice` and `pc`.
+/// \param split_positions increasing positions which are not clustering row
+///     positions.
+/// \param max_size the limit of memory used for reversing a single chunk,
+///     see `make_reversing_reader()`.
+///
+/// Fast-forwarding is not supported.
+flat_mutation_reader make_chunked_reversing_reader(mutation_source source,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& range,
+        const query::partition_slice& slice,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        std::vector<position_in_partition> split_positions,
+        query::max_result_size max_size);
@@ -25,6 +25,9 @@
 
 class mutation_rebuilder {
     mutation _m;
+    // Range tombstones are applied in bulk at the end of the partition, since
+    // streams produced from older sstable formats may contain many overlapping ones.
+    std::vector<range_tombstone> _range_tombstones;
 
 public:
     mutation_rebuilder(dht::decorated_key dk, schema_ptr s)
@@ -37,7 +40,7 @@ class mutation_rebuilder {
     }
 
     stop_iteration consume(range_tombstone&& rt) {
-        _m.partition().apply_row_tombstone(*_m.schema(), std::move(rt));
+        _range_tombstones.push_back(std::move(rt));
         return stop_iteration::no;
     }
 
@@ -55,6 +58,9 @@ class mutation_rebuilder {
     }
 
     mutation_opt consume_end_of_stream() {
+        if (!_range_tombstones.empty()) {
+            _m.partition().apply_row_tombstones(*_m.schema(), std::move(_range_tombstones));
+        }
         return mutation_opt(std::move(_m));
     }
 };
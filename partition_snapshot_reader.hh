@@ -25,6 +25,7 @@
 #include "flat_mutation_reader.hh"
 #include "clustering_key_filter.hh"
 #include <boost/range/algorithm/heap_algorithm.hpp>
+#include <deque>
 
 struct partition_snapshot_reader_dummy_accounter {
    void operator()(const clustering_row& cr) {}
@@ -431,3 +432,384 @@ make_partition_snapshot_flat_reader(schema_ptr s,
     return make_partition_snapshot_flat_reader<partition_snapshot_reader_dummy_accounter>(std::move(s), std::move(permit),
             std::move(dk), std::move(crr), std::move(snp), digest_requested, region, read_section, std::move(pointer_to_container), fwd);
 }
+
+// Reads a partition snapshot in reverse clustering order.
+//
+// The fragments are emitted in the format of make_reversing_reader(): clustering
+// rows in descending order, and range tombstones, with their bounds unchanged,
+// in descending order of their ends, each before the rows it covers.
+//
+// Snapshots of the cache may not have all rows, and can lose rows to eviction
+// while they are read. When check_continuity is set, the reader checks, when
+// it enters a range and every time the snapshot changes, that the part of the
+// range it didn't read yet is continuous. When it is not, the reader stops
+// without emitting partition_end, discontinuous() becomes true and
+// remaining_ranges() returns what is left to read.
+class partition_snapshot_reversing_reader final : public flat_mutation_reader::impl {
+    struct rows_position {
+        // The rows in [_begin, _end) are left to be read, from the last one.
+        mutation_partition::rows_type::const_iterator _begin;
+        mutation_partition::rows_type::const_iterator _end;
+
+        const rows_entry& top() const {
+            return *std::prev(_end);
+        }
+    };
+
+    // Max-heaps: the next entry to read is the one with the largest position.
+    class heap_compare {
+        position_in_partition::less_compare _less;
+    public:
+        explicit heap_compare(const schema& s) : _less(s) { }
+        bool operator()(const rows_position& a, const rows_position& b) {
+            return _less(a.top().position(), b.top().position());
+        }
+        bool operator()(const range_tombstone_list::iterator_range& a, const range_tombstone_list::iterator_range& b) {
+            return _less(a.back().end_position(), b.back().end_position());
+        }
+    };
+
+    // Keeps shared pointer to the container we read mutation from to make sure
+    // that its lifetime is appropriately extended.
+    boost::any _container_guard;
+    partition_snapshot_ptr _snapshot;
+    logalloc::region& _region;
+    logalloc::allocating_section& _read_section;
+    position_in_partition::less_compare _less;
+    heap_compare _heap_cmp;
+    bool _digest_requested;
+    bool _check_continuity;
+
+    query::clustering_key_filter_ranges _ck_ranges;
+    query::clustering_row_ranges::const_reverse_iterator _current_ck_range;
+    query::clustering_row_ranges::const_reverse_iterator _ck_range_end;
+
+    // The state below is rebuilt from _last_row and _last_rt_end whenever the
+    // snapshot changes, or when an allocation section retry interrupted read_next().
+    partition_snapshot::change_mark _change_mark;
+    bool _needs_refresh = true;
+    bool _in_read_next = false;
+    std::vector<rows_position> _clustering_rows;
+    std::vector<range_tombstone_list::iterator_range> _range_tombstones;
+
+    // Popped from the snapshot but not emitted yet, all with the same end.
+    std::deque<range_tombstone> _pending_range_tombstones;
+    // Everything in the current range at or above these positions was read.
+    std::optional<position_in_partition> _last_row;
+    std::optional<position_in_partition> _last_rt_end;
+
+    bool _static_row_done = false;
+    bool _discontinuous = false;
+private:
+    template<typename Function>
+    decltype(auto) in_alloc_section(Function&& fn) {
+        return _read_section.with_reclaiming_disabled(_region, [&] {
+            return fn();
+        });
+    }
+
+    // The position below which the current range is left to be read.
+    std::optional<position_in_partition_view> read_until() const {
+        if (_last_row && (!_last_rt_end || _less(*_last_row, *_last_rt_end))) {
+            return position_in_partition_view(*_last_row);
+        }
+        if (_last_rt_end) {
+            return position_in_partition_view(*_last_rt_end);
+        }
+        return std::nullopt;
+    }
+
+    bool is_continuous_in_snapshot(position_in_partition_view start, position_in_partition_view end) {
+        auto range = position_range(position_in_partition(start), position_in_partition(end));
+        for (auto&& v : _snapshot->versions()) {
+            if (v.partition().check_continuity(*_schema, range, is_continuous::yes)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether the part of the current range which is left to be read is continuous.
+    // The next ranges are checked when they are entered.
+    bool current_range_continuous() {
+        const auto& ck_range = *_current_ck_range;
+        auto end = read_until().value_or(position_in_partition_view::for_range_end(ck_range));
+        return is_continuous_in_snapshot(position_in_partition_view::for_range_start(ck_range), end);
+    }
+
+    void refresh_state() {
+        _clustering_rows.clear();
+        _range_tombstones.clear();
+        if (_check_continuity && !current_range_continuous()) {
+            _discontinuous = true;
+            return;
+        }
+
+        const auto& ck_range = *_current_ck_range;
+        auto until = read_until();
+        rows_entry::tri_compare rows_cmp(*_schema);
+        for (auto&& v : _snapshot->versions()) {
+            auto& p = v.partition();
+            mutation_partition::rows_type::const_iterator cr_begin = p.lower_bound(*_schema, ck_range);
+            mutation_partition::rows_type::const_iterator cr_end = until
+                    ? p.clustered_rows().lower_bound(*until, rows_cmp)
+                    : p.upper_bound(*_schema, ck_range);
+            if (cr_begin != cr_end) {
+                _clustering_rows.emplace_back(rows_position{cr_begin, cr_end});
+            }
+
+            auto rt_slice = p.row_tombstones().slice(*_schema, ck_range);
+            if (until) {
+                while (!rt_slice.empty() && !_less(rt_slice.back().end_position(), *until)) {
+                    rt_slice.advance_end(-1);
+                }
+            }
+            if (!rt_slice.empty()) {
+                _range_tombstones.emplace_back(std::move(rt_slice));
+            }
+        }
+
+        boost::range::make_heap(_clustering_rows, _heap_cmp);
+        boost::range::make_heap(_range_tombstones, _heap_cmp);
+    }
+
+    void maybe_refresh_state() {
+        auto mark = _snapshot->get_change_mark();
+        if (_needs_refresh || _in_read_next || mark != _change_mark) {
+            refresh_state();
+            _change_mark = mark;
+            _needs_refresh = false;
+        }
+    }
+
+    const rows_entry& pop_clustering_row() {
+        boost::range::pop_heap(_clustering_rows, _heap_cmp);
+        auto& current = _clustering_rows.back();
+        current._end = std::prev(current._end);
+        const rows_entry& e = *current._end;
+        if (current._end == current._begin) {
+            _clustering_rows.pop_back();
+        } else {
+            boost::range::push_heap(_clustering_rows, _heap_cmp);
+        }
+        return e;
+    }
+
+    const range_tombstone& pop_range_tombstone() {
+        boost::range::pop_heap(_range_tombstones, _heap_cmp);
+        auto& current = _range_tombstones.back();
+        const range_tombstone& rt = current.back();
+        current.advance_end(-1);
+        if (current.empty()) {
+            _range_tombstones.pop_back();
+        } else {
+            boost::range::push_heap(_range_tombstones, _heap_cmp);
+        }
+        return rt;
+    }
+
+    const rows_entry& peek_row() const {
+        return _clustering_rows.front().top();
+    }
+
+    const range_tombstone& peek_range_tombstone() const {
+        return _range_tombstones.front().back();
+    }
+
+    // Pops all range tombstones ending at the largest end left, trimmed to the current range.
+    void pop_range_tombstones() {
+        const auto& ck_range = *_current_ck_range;
+        position_in_partition end(peek_range_tombstone().end_position());
+        position_in_partition::equal_compare eq(*_schema);
+        std::deque<range_tombstone> rts;
+        while (!_range_tombstones.empty() && eq(peek_range_tombstone().end_position(), end)) {
+            range_tombstone rt = pop_range_tombstone();
+            rt.trim_front(*_schema, position_in_partition_view::for_range_start(ck_range));
+            auto range_end = position_in_partition_view::for_range_end(ck_range);
+            if (_less(range_end, rt.end_position())) {
+                rt.set_end(*_schema, range_end);
+            }
+            rts.push_back(std::move(rt));
+        }
+        _pending_range_tombstones = std::move(rts);
+        _last_rt_end = std::move(end);
+    }
+
+    // Must be called in the allocating section.
+    mutation_fragment_opt read_next() {
+        if (!_pending_range_tombstones.empty()) {
+            auto mf = mutation_fragment(*_schema, _permit, std::move(_pending_range_tombstones.front()));
+            _pending_range_tombstones.pop_front();
+            return mf;
+        }
+
+        maybe_refresh_state();
+        _in_read_next = true;
+        if (_discontinuous) {
+            return { };
+        }
+        while (!_clustering_rows.empty() && peek_row().dummy()) {
+            pop_clustering_row();
+        }
+
+        if (!_range_tombstones.empty()
+                && (_clustering_rows.empty() || !_less(peek_range_tombstone().end_position(), peek_row().position()))) {
+            pop_range_tombstones();
+            _in_read_next = false;
+            auto mf = mutation_fragment(*_schema, _permit, std::move(_pending_range_tombstones.front()));
+            _pending_range_tombstones.pop_front();
+            return mf;
+        }
+
+        if (_clustering_rows.empty()) {
+            _in_read_next = false;
+            return { };
+        }
+
+        position_in_partition::equal_compare rows_eq(*_schema);
+        const rows_entry& e = pop_clustering_row();
+        if (_digest_requested) {
+            e.row().cells().prepare_hash(*_schema, column_kind::regular_column);
+        }
+        auto result = mutation_fragment(mutation_fragment::clustering_row_tag_t(), *_schema, _permit, *_schema, e);
+        while (!_clustering_rows.empty() && rows_eq(peek_row().position(), result.as_clustering_row().position())) {
+            const rows_entry& e = pop_clustering_row();
+            if (_digest_requested) {
+                e.row().cells().prepare_hash(*_schema, column_kind::regular_column);
+            }
+            result.mutate_as_clustering_row(*_schema, [&] (clustering_row& cr) mutable {
+                cr.apply(*_schema, e);
+            });
+        }
+        _last_row = position_in_partition(result.as_clustering_row().position());
+        _in_read_next = false;
+        return result;
+    }
+
+    void push_static_row() {
+        auto sr = in_alloc_section([&] {
+            return _snapshot->static_row(_digest_requested);
+        });
+        if (!sr.empty()) {
+            push_mutation_fragment(mutation_fragment(*_schema, _permit, std::move(sr)));
+        }
+    }
+
+    void next_range() {
+        ++_current_ck_range;
+        _last_row.reset();
+        _last_rt_end.reset();
+        _needs_refresh = true;
+    }
+
+    void do_fill_buffer() {
+        while (!is_end_of_stream() && !is_buffer_full()) {
+            if (_current_ck_range == _ck_range_end) {
+                push_mutation_fragment(mutation_fragment(*_schema, _permit, partition_end()));
+                _end_of_stream = true;
+                break;
+            }
+            auto mfopt = in_alloc_section([&] {
+                return read_next();
+            });
+            if (mfopt) {
+                push_mutation_fragment(std::move(*mfopt));
+            } else if (_discontinuous) {
+                _end_of_stream = true;
+                break;
+            } else {
+                next_range();
+            }
+            if (need_preempt()) {
+                break;
+            }
+        }
+    }
+public:
+    partition_snapshot_reversing_reader(schema_ptr s, reader_permit permit, dht::decorated_key dk, partition_snapshot_ptr snp,
+                              query::clustering_key_filter_ranges crr, bool digest_requested,
+                              logalloc::region& region, logalloc::allocating_section& read_section,
+                              boost::any pointer_to_container, bool check_continuity)
+        : impl(std::move(s), std::move(permit))
+        , _container_guard(std::move(pointer_to_container))
+        , _snapshot(std::move(snp))
+        , _region(region)
+        , _read_section(read_section)
+        , _less(*_schema)
+        , _heap_cmp(*_schema)
+        , _digest_requested(digest_requested)
+        , _check_continuity(check_continuity)
+        , _ck_ranges(std::move(crr))
+        , _current_ck_range(std::make_reverse_iterator(_ck_ranges.end()))
+        , _ck_range_end(std::make_reverse_iterator(_ck_ranges.begin()))
+    {
+        _read_section.with_reserve([&] {
+            logalloc::reclaim_lock guard(_region);
+            push_mutation_fragment(*_schema, _permit, partition_start(std::move(dk), _snapshot->partition_tombstone()));
+        });
+    }
+
+    bool discontinuous() const {
+        return _discontinuous;
+    }
+
+    // The clustering ranges left to be read, in descending order, after the
+    // reader stopped on a discontinuity.
+    query::clustering_row_ranges remaining_ranges() const {
+        query::clustering_row_ranges ranges(_current_ck_range, _ck_range_end);
+        if (_last_row) {
+            query::trim_clustering_row_ranges_to(*_schema, ranges, _last_row->key(), true);
+        }
+        if (_last_rt_end) {
+            query::trim_clustering_row_ranges_to(*_schema, ranges, *_last_rt_end, true);
+        }
+        return ranges;
+    }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        return do_until([this] { return is_end_of_stream() || is_buffer_full(); }, [this] {
+            _read_section.with_reserve([&] {
+                if (!_static_row_done) {
+                    push_static_row();
+                    _static_row_done = true;
+                }
+                do_fill_buffer();
+            });
+            return make_ready_future<>();
+        });
+    }
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another partition.");
+    };
+    virtual future<> fast_forward_to(position_range cr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another position.");
+    };
+    virtual future<> close() noexcept override {
+        return make_ready_future<>();
+    }
+};
+
+// Returns a reader which reads the snapshot in reverse clustering order,
+// see partition_snapshot_reversing_reader.
+inline flat_mutation_reader
+make_partition_snapshot_reversing_reader(schema_ptr s,
+                                         reader_permit permit,
+                                         dht::decorated_key dk,
+                                         query::clustering_key_filter_ranges crr,
+                                         partition_snapshot_ptr snp,
+                                         bool digest_requested,
+                                         logalloc::region& region,
+                                         logalloc::allocating_section& read_section,
+                                         boost::any pointer_to_container,
+                                         bool check_continuity = false)
+{
+    return make_flat_mutation_reader<partition_snapshot_reversing_reader>(std::move(s), std::move(permit), std::move(dk),
+            std::move(snp), std::move(crr), digest_requested, region, read_section, std::move(pointer_to_container), check_continuity);
+}
@@ -68,10 +68,16 @@ class clustering_position_tracker {
     }
 };
 
+/// Whether a reader of a reversed slice emits the partitions in reverse
+/// already, see `table::as_query_source()`.
+using reader_is_reversed = bool_class<class reader_is_reversed_tag>;
+
 /// Consume a page worth of data from the reader.
 ///
 /// Uses `compaction_state` for compacting the fragments and `consumer` for
 /// building the results.
+/// If the slice is reversed, the reader is wrapped in a reversing reader,
+/// unless `reversed` says its output is reversed already.
 /// Returns a future containing a tuple with the last consumed clustering key,
 /// or std::nullopt if the last row wasn't a clustering row, and whatever the
 /// consumer's `consume_end_of_stream()` method returns.
@@ -85,7 +91,8 @@ auto consume_page(flat_mutation_reader& reader,
         uint32_t partition_limit,
         gc_clock::time_point query_time,
         db::timeout_clock::time_point timeout,
-        query::max_result_size max_size) {
+        query::max_result_size max_size,
+        reader_is_reversed reversed = reader_is_reversed::no) {
     return reader.peek(timeout).then([=, &reader, consumer = std::move(consumer), &slice] (
                 mutation_fragment* next_fragment) mutable {
         const auto next_fragment_kind = next_fragment ? next_fragment->mutation_fragment_kind() : mutation_fragment::kind::partition_end;
@@ -96,8 +103,8 @@ auto consume_page(flat_mutation_reader& reader,
                 compaction_state,
                 clustering_position_tracker(std::move(consumer), last_ckey));
 
-        auto consume = [&reader, &slice, reader_consumer = std::move(reader_consumer), timeout, max_size] () mutable {
-            if (slice.options.contains(query::partition_slice::option::reversed)) {
+        auto consume = [&reader, &slice, reader_consumer = std::move(reader_consumer), timeout, max_size, reversed] () mutable {
+            if (slice.options.contains(query::partition_slice::option::reversed) && !reversed) {
                 return with_closeable(make_reversing_reader(reader, max_size),
                         [reader_consumer = std::move(reader_consumer), timeout] (flat_mutation_reader& reversing_reader) mutable {
                     return reversing_reader.consume(std::move(reader_consumer), timeout);
@@ -205,6 +212,7 @@ template <emit_only_live_rows OnlyLive>
 class querier : public querier_base {
     lw_shared_ptr<compact_for_query_state<OnlyLive>> _compaction_state;
     std::optional<clustering_key_prefix> _last_ckey;
+    reader_is_reversed _reader_is_reversed;
 
 public:
     querier(const mutation_source& ms,
@@ -213,9 +221,11 @@ class querier : public querier_base {
             dht::partition_range range,
             query::partition_slice slice,
             const io_priority_class& pc,
-            tracing::trace_state_ptr trace_ptr)
+            tracing::trace_state_ptr trace_ptr,
+            reader_is_reversed reversed = reader_is_reversed::no)
         : querier_base(schema, permit, std::move(range), std::move(slice), ms, pc, std::move(trace_ptr))
-        , _compaction_state(make_lw_shared<compact_for_query_state<OnlyLive>>(*schema, gc_clock::time_point{}, *_slice, 0, 0)) {
+        , _compaction_state(make_lw_shared<compact_for_query_state<OnlyLive>>(*schema, gc_clock::time_point{}, *_slice, 0, 0))
+        , _reader_is_reversed(reversed) {
     }
 
     bool are_limits_reached() const {
@@ -231,7 +241,7 @@ class querier : public querier_base {
             db::timeout_clock::time_point timeout,
             query::max_result_size max_size) {
         return ::query::consume_page(std::get<flat_mutation_reader>(_reader), _compaction_state, *_slice, std::move(consumer), row_limit,
-                partition_limit, query_time, timeout, max_size).then([this] (auto&& results) {
+                partition_limit, query_time, timeout, max_size, _reader_is_reversed).then([this] (auto&& results) {
             _last_ckey = std::get<std::optional<clustering_key>>(std::move(results));
             constexpr auto size = std::tuple_size<std::decay_t<decltype(results)>>::value;
             static_assert(size <= 2);
@@ -228,6 +228,22 @@ class partition_slice {
 
 constexpr auto max_partitions = std::numeric_limits<uint32_t>::max();
 
+// Asks the replica to read only the base rows listed in a local secondary
+// index before executing the read command.
+//
+// A local index view shares the partition key, and so the replicas and the
+// shard, with its base table. This allows the replica to look up the index
+// partition and read the matching base rows in one pass, without returning
+// the posting list to the coordinator first.
+struct local_index_lookup {
+    // The local index view.
+    utils::UUID view_id;
+    // The ranges of the index view partition holding the matching entries.
+    clustering_row_ranges ranges;
+
+    friend std::ostream& operator<<(std::ostream& out, const local_index_lookup& l);
+};
+
 // Tagged integers to disambiguate constructor arguments.
 enum class row_limit : uint64_t { max = max_rows };
 enum class partition_limit : uint32_t { max = max_partitions };
@@ -264,6 +280,9 @@ class read_command {
     // the remote doesn't send it.
     std::optional<query::max_result_size> max_result_size;
     uint32_t row_limit_high_bits;
+    // When set, only the base rows found in the given local index are read.
+    // Only valid for single partition reads.
+    std::optional<query::local_index_lookup> index_lookup;
     api::timestamp_type read_timestamp; // not serialized
 public:
     // IDL constructor
@@ -277,7 +296,8 @@ class read_command {
                  utils::UUID query_uuid,
                  query::is_first_page is_first_page,
                  std::optional<query::max_result_size> max_result_size,
-                 uint32_t row_limit_high_bits)
+                 uint32_t row_limit_high_bits,
+                 std::optional<query::local_index_lookup> index_lookup)
         : cf_id(std::move(cf_id))
         , schema_version(std::move(schema_version))
         , slice(std::move(slice))
@@ -289,6 +309,7 @@ class read_command {
         , is_first_page(is_first_page)
         , max_result_size(max_result_size)
         , row_limit_high_bits(row_limit_high_bits)
+        , index_lookup(std::move(index_lookup))
         , read_timestamp(api::new_timestamp())
     { }
 
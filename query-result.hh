@@ -433,12 +433,20 @@ class result {
         return _short_read;
     }
 
+    void set_short_read(short_read sr) {
+        _short_read = sr;
+    }
+
     const std::optional<uint32_t>& partition_count() const {
         return _partition_count;
     }
 
     void ensure_counts();
 
+    // Returns what an only_digest read would have, for a result read with
+    // result_and_digest.
+    result without_rows() const;
+
     struct printer {
         schema_ptr s;
         const query::partition_slice& slice;
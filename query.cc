@@ -65,7 +65,12 @@ std::ostream& operator<<(std::ostream& out, const read_command& r) {
         << ", slice=" << r.slice << ""
         << ", limit=" << r.get_row_limit()
         << ", timestamp=" << r.timestamp.time_since_epoch().count() << "}"
-        << ", partition_limit=" << r.partition_limit << "}";
+        << ", partition_limit=" << r.partition_limit
+        << ", index_lookup=" << r.index_lookup << "}";
+}
+
+std::ostream& operator<<(std::ostream& out, const local_index_lookup& l) {
+    return out << "{view_id=" << l.view_id << ", ranges=" << join(", ", l.ranges) << "}";
 }
 
 std::ostream& operator<<(std::ostream& out, const specific_ranges& s) {
@@ -242,6 +247,12 @@ void result::ensure_counts() {
     }
 }
 
+result result::without_rows() const {
+    bytes_ostream out;
+    ser::writer_of_query_result<bytes_ostream>(out).start_partitions().end_partitions().end_query_result();
+    return result(std::move(out), _digest, _last_modified, _short_read, {}, {});
+}
+
 result::result()
     : result([] {
         bytes_ostream out;
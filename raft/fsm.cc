@@ -286,6 +286,14 @@ fsm_output fsm::get_output() {
         }
     }
 
+    if (_config.enable_parallel_persistence && is_leader()) {
+        // Send the entries which are about to be persisted
+        // together with them, the messages of a leader do not
+        // depend on its own log being persisted.
+        replicate();
+        output.parallel_persistence = true;
+    }
+
     // Get a snapshot of all unsent messages.
     // Do it after populating log_entries and committed arrays
     // to not lose messages in case arrays population throws
@@ -715,39 +723,22 @@ void fsm::request_vote_reply(server_id from, vote_reply&& reply) {
     }
 }
 
-static size_t entry_size(const log_entry& e) {
-    struct overloaded {
-        size_t operator()(const command& c) {
-            return c.size();
-        }
-        size_t operator()(const configuration& c) {
-            size_t size = 0;
-            for (auto& s : c.current) {
-                size += sizeof(s.id);
-                size += s.info.size();
-            }
-            return size;
-        }
-        size_t operator()(const log_entry::dummy& d) {
-            return 0;
-        }
-    };
-    return std::visit(overloaded{}, e.data) + sizeof(e);
-}
-
 void fsm::replicate_to(follower_progress& progress, bool allow_empty) {
 
     logger.trace("replicate_to[{}->{}]: called next={} match={}",
         _my_id, progress.id, progress.next_idx, progress.match_idx);
 
+    // Send out only persisted entries, unless they are persisted
+    // in parallel with replication.
+    index_t last_idx = _config.enable_parallel_persistence ? _log.last_idx() : _log.stable_idx();
+
     while (progress.can_send_to()) {
         index_t next_idx = progress.next_idx;
-        if (progress.next_idx > _log.stable_idx()) {
+        if (progress.next_idx > last_idx) {
             next_idx = index_t(0);
-            logger.trace("replicate_to[{}->{}]: next past stable next={} stable={}, empty={}",
-                    _my_id, progress.id, progress.next_idx, _log.stable_idx(), allow_empty);
+            logger.trace("replicate_to[{}->{}]: next past last next={} last={}, empty={}",
+                    _my_id, progress.id, progress.next_idx, last_idx, allow_empty);
             if (!allow_empty) {
-                // Send out only persisted entries.
                 return;
             }
         }
@@ -790,12 +781,12 @@ void fsm::replicate_to(follower_progress& progress, bool allow_empty) {
 
         if (next_idx) {
             size_t size = 0;
-            while (next_idx <= _log.stable_idx() && size < _config.append_request_threshold) {
+            while (next_idx <= last_idx && size < _config.append_request_threshold) {
                 const auto& entry = _log[next_idx];
                 req.entries.push_back(entry);
                 logger.trace("replicate_to[{}->{}]: send entry idx={}, term={}",
                              _my_id, progress.id, entry->idx, entry->term);
-                size += entry_size(*entry);
+                size += log_entry_size(*entry);
                 next_idx++;
                 if (progress.state == follower_progress::state::PROBE) {
                     break; // in PROBE mode send only one entry
@@ -873,7 +864,7 @@ void fsm::install_snapshot_reply(server_id from, snapshot_reply&& reply) {
     // again and snapshot transfer will be attempted one more time.
 }
 
-bool fsm::apply_snapshot(snapshot snp, size_t trailing) {
+bool fsm::apply_snapshot(snapshot snp, size_t trailing, size_t max_trailing_memory) {
     logger.trace("apply_snapshot[{}]: term: {}, idx: {}", _my_id, _current_term, snp.idx);
     const auto& current_snp = _log.get_snapshot();
     // Uncommitted entries can not appear in the snapshot
@@ -883,7 +874,7 @@ bool fsm::apply_snapshot(snapshot snp, size_t trailing) {
                         _my_id, snp.id, snp.idx, current_snp.id, current_snp.idx);
         return false;
     }
-    size_t units = _log.apply_snapshot(std::move(snp), trailing);
+    size_t units = _log.apply_snapshot(std::move(snp), trailing, max_trailing_memory);
     if (is_leader()) {
         logger.trace("apply_snapshot[{}]: signal {} available units", _my_id, units);
         leader_state().log_limiter_semaphore.signal(units);
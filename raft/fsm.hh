@@ -39,6 +39,9 @@ struct fsm_output {
     // Latest configuration obtained from the log in case it has changed
     // since last fsm output poll.
     std::optional<server_address_set> rpc_configuration;
+    // True if the messages may be sent before log_entries are
+    // persisted, see fsm_config::enable_parallel_persistence.
+    bool parallel_persistence = false;
 
     // True if there is no new output
     bool empty() const {
@@ -61,6 +64,13 @@ struct fsm_config {
     size_t max_log_size;
     // If set to true will enable prevoting stage during election
     bool enable_prevoting;
+    // If set to true the leader replicates entries to followers
+    // while it is still persisting them in its own log (10.2.1).
+    // The leader is counted towards the commit quorum as before,
+    // but committed entries and the commit index are only
+    // published by the output following the one which carried
+    // the entries, i.e. after they are persisted locally.
+    bool enable_parallel_persistence = false;
 };
 
 class fsm;
@@ -405,13 +415,18 @@ class fsm {
 
     // This call will update the log to point to the new snapshot
     // and will truncate the log prefix up to (snp.idx - trailing)
-    // entry. Returns false if the snapshot is older than existing one.
-    bool apply_snapshot(snapshot snp, size_t traling);
+    // entry, keeping no more than max_trailing_memory of them.
+    // Returns false if the snapshot is older than existing one.
+    bool apply_snapshot(snapshot snp, size_t traling, size_t max_trailing_memory = std::numeric_limits<size_t>::max());
 
     size_t in_memory_log_size() const {
         return _log.in_memory_size();
     };
 
+    size_t log_memory_usage() const {
+        return _log.memory_usage();
+    }
+
     server_id id() const { return _my_id; }
 
     friend std::ostream& operator<<(std::ostream& os, const fsm& f);
@@ -22,6 +22,26 @@
 
 namespace raft {
 
+size_t log_entry_size(const log_entry& e) {
+    struct overloaded {
+        size_t operator()(const command& c) {
+            return c.size();
+        }
+        size_t operator()(const configuration& c) {
+            size_t size = 0;
+            for (auto& s : c.current) {
+                size += sizeof(s.id);
+                size += s.info.size();
+            }
+            return size;
+        }
+        size_t operator()(const log_entry::dummy& d) {
+            return 0;
+        }
+    };
+    return std::visit(overloaded{}, e.data) + sizeof(e);
+}
+
 log_entry_ptr& log::get_entry(index_t i) {
     return _log[i - _first_idx];
 }
@@ -33,12 +53,21 @@ log_entry_ptr& log::operator[](size_t i) {
 
 void log::emplace_back(log_entry_ptr&& e) {
     _log.emplace_back(std::move(e));
+    _memory_usage += log_entry_size(*_log.back());
     if (std::holds_alternative<configuration>(_log.back()->data)) {
         _prev_conf_idx = _last_conf_idx;
         _last_conf_idx = last_idx();
     }
 }
 
+size_t log::memory_usage_of(log_entries::const_iterator begin, log_entries::const_iterator end) {
+    size_t size = 0;
+    for (auto it = begin; it != end; ++it) {
+        size += log_entry_size(**it);
+    }
+    return size;
+}
+
 bool log::empty() const {
     return _log.empty();
 }
@@ -64,6 +93,7 @@ index_t log::next_idx() const {
 void log::truncate_uncommitted(index_t idx) {
     assert(idx >= _first_idx);
     auto it = _log.begin() + (idx - _first_idx);
+    _memory_usage -= memory_usage_of(it, _log.end());
     _log.erase(it, _log.end());
     stable_to(std::min(_stable_idx, last_idx()));
     if (_last_conf_idx > last_idx()) {
@@ -178,7 +208,7 @@ index_t log::maybe_append(std::vector<log_entry_ptr>&& entries) {
     return last_new_idx;
 }
 
-size_t log::apply_snapshot(snapshot&& snp, size_t trailing) {
+size_t log::apply_snapshot(snapshot&& snp, size_t trailing, size_t max_trailing_memory) {
     assert (snp.idx > _snapshot.idx);
 
     size_t removed;
@@ -190,10 +220,24 @@ size_t log::apply_snapshot(snapshot&& snp, size_t trailing) {
         // entries and the next entry index.
         removed = _log.size();
         _log.clear();
+        _memory_usage = 0;
         _first_idx = idx + index_t{1};
     } else {
         removed = _log.size() - (last_idx() - idx);
-        removed -= std::min(trailing, removed);
+        // Keep at most `trailing` entries preceding the snapshot
+        // index, and no more of them than fit in max_trailing_memory.
+        size_t kept = 0;
+        size_t kept_memory = 0;
+        while (kept < std::min(trailing, removed)) {
+            auto size = log_entry_size(*_log[removed - kept - 1]);
+            if (kept_memory + size > max_trailing_memory) {
+                break;
+            }
+            kept_memory += size;
+            kept++;
+        }
+        removed -= kept;
+        _memory_usage -= memory_usage_of(_log.begin(), _log.begin() + removed);
         _log.erase(_log.begin(), _log.begin() + removed);
         _first_idx = _first_idx + index_t{removed};
     }
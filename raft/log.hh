@@ -20,9 +20,14 @@
  */
 #pragma once
 
+#include <limits>
 #include "raft.hh"
 
 namespace raft {
+
+// Approximate memory occupied by a log entry.
+size_t log_entry_size(const log_entry& e);
+
 // This class represents the Raft log in memory.
 //
 // The value of the first index is 1.
@@ -70,7 +75,10 @@ class log {
     // The previous value of _last_conf_idx, to avoid scanning
     // the log backwards after truncate().
     index_t _prev_conf_idx = index_t{0};
+    // Sum of log_entry_size() of the entries in memory.
+    size_t _memory_usage = 0;
 private:
+    static size_t memory_usage_of(log_entries::const_iterator begin, log_entries::const_iterator end);
     // Drop uncommitted log entries not present on the leader.
     void truncate_uncommitted(index_t i);
     // A helper used to find the last configuration entry in the
@@ -92,6 +100,7 @@ class log {
         // The snapshot index is at least 0, so _first_idx
         // is at least 1
         assert(_first_idx > 0);
+        _memory_usage = memory_usage_of(_log.begin(), _log.end());
         stable_to(last_idx());
         init_last_conf_idx();
     }
@@ -128,6 +137,11 @@ class log {
     size_t in_memory_size() const {
         return _log.size();
     }
+    // Return the approximate memory occupied by the log entries
+    // in memory, see log_entry_size().
+    size_t memory_usage() const {
+        return _memory_usage;
+    }
 
     // The function returns current snapshot state of the log
     const snapshot& get_snapshot() const {
@@ -136,8 +150,10 @@ class log {
 
     // This call will update the log to point to the new snaphot
     // and will truncate the log prefix up to (snp.idx - trailing)
-    // entry. Return value specifies how many log entries were dropped
-    size_t apply_snapshot(snapshot&& snp, size_t trailing);
+    // entry, or further if the trailing entries occupy more than
+    // max_trailing_memory. Return value specifies how many log
+    // entries were dropped
+    size_t apply_snapshot(snapshot&& snp, size_t trailing, size_t max_trailing_memory = std::numeric_limits<size_t>::max());
 
     // 3.5
     // Raft maintains the following properties, which
@@ -30,6 +30,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/pipe.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/metrics.hh>
 #include <absl/container/flat_hash_map.h>
 
@@ -112,9 +113,11 @@ class server_impl : public rpc_server, public server {
         uint64_t sm_load_snapshot = 0;
         uint64_t truncate_persisted_log = 0;
         uint64_t persisted_log_entries = 0;
+        uint64_t messages_sent_before_persisted = 0;
         uint64_t queue_entries_for_apply = 0;
         uint64_t applied_entries = 0;
         uint64_t snapshots_taken = 0;
+        uint64_t snapshot_transfers_queued = 0;
         uint64_t timeout_now_sent = 0;
         uint64_t timeout_now_received = 0;
     } _stats;
@@ -146,6 +149,9 @@ class server_impl : public rpc_server, public server {
     // Contains aborted snapshot transfers with still unresolved futures
     std::unordered_map<uint64_t, future<>> _aborted_snapshot_transfers;
 
+    // Limits the number of snapshots transferred at a time
+    semaphore _snapshot_transfer_limiter;
+
     // The optional is engaged when incoming snapshot is received
     // And the promise signalled when it is successfully applied or there was an error
     std::unordered_map<server_id, promise<snapshot_reply>> _snapshot_application_done;
@@ -172,6 +178,10 @@ class server_impl : public rpc_server, public server {
     //  - send out messages
     future<> io_fiber(index_t stable_idx);
 
+    // Persist log entries polled from the FSM, truncating the
+    // persisted log first if they overwrite a part of it.
+    future<> store_log_entries(const std::vector<log_entry_ptr>& entries, index_t& last_stable);
+
     // This fiber runs in the background and applies committed entries.
     future<> applier_fiber();
 
@@ -232,11 +242,14 @@ server_impl::server_impl(server_id uuid, std::unique_ptr<rpc> rpc,
         seastar::shared_ptr<failure_detector> failure_detector, server::configuration config) :
                     _rpc(std::move(rpc)), _state_machine(std::move(state_machine)),
                     _persistence(std::move(persistence)), _failure_detector(failure_detector),
-                    _id(uuid), _config(config) {
+                    _id(uuid), _config(config), _snapshot_transfer_limiter(_config.max_snapshot_transfers) {
     set_rpc_server(_rpc.get());
     if (_config.snapshot_threshold > _config.max_log_size) {
         throw config_error("snapshot_threshold has to be smaller than max_log_size");
     }
+    if (_config.max_snapshot_transfers == 0) {
+        throw config_error("max_snapshot_transfers has to be positive");
+    }
 }
 
 future<> server_impl::start() {
@@ -252,7 +265,8 @@ future<> server_impl::start() {
                                  fsm_config {
                                      .append_request_threshold = _config.append_request_threshold,
                                      .max_log_size = _config.max_log_size,
-                                     .enable_prevoting = _config.enable_prevoting
+                                     .enable_prevoting = _config.enable_prevoting,
+                                     .enable_parallel_persistence = _config.enable_parallel_persistence
                                  });
 
     if (snp_id) {
@@ -460,6 +474,20 @@ static configuration_diff diff_address_sets(const server_address_set& prev, cons
     return result;
 }
 
+future<> server_impl::store_log_entries(const std::vector<log_entry_ptr>& entries, index_t& last_stable) {
+    if (last_stable >= entries[0]->idx) {
+        co_await _persistence->truncate_log(entries[0]->idx);
+        _stats.truncate_persisted_log++;
+    }
+
+    // Combine saving and truncating into one call?
+    // will require persistence to keep track of last idx
+    co_await _persistence->store_log_entries(entries);
+
+    last_stable = (*entries.crbegin())->idx;
+    _stats.persisted_log_entries += entries.size();
+}
+
 future<> server_impl::io_fiber(index_t last_stable) {
     logger.trace("[{}] io_fiber start", _id);
     try {
@@ -494,20 +522,13 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 }
             }
 
+            future<> log_entries_stored = make_ready_future<>();
             if (batch.log_entries.size()) {
-                auto& entries = batch.log_entries;
-
-                if (last_stable >= entries[0]->idx) {
-                    co_await _persistence->truncate_log(entries[0]->idx);
-                    _stats.truncate_persisted_log++;
+                log_entries_stored = store_log_entries(batch.log_entries, last_stable);
+                if (!batch.parallel_persistence) {
+                    co_await std::move(log_entries_stored);
+                    log_entries_stored = make_ready_future<>();
                 }
-
-                // Combine saving and truncating into one call?
-                // will require persistence to keep track of last idx
-                co_await _persistence->store_log_entries(entries);
-
-                last_stable = (*entries.crbegin())->idx;
-                _stats.persisted_log_entries += entries.size();
             }
 
             // Update RPC server address mappings. Add servers which are joining
@@ -519,15 +540,26 @@ future<> server_impl::io_fiber(index_t last_stable) {
             // network addresses of the joining servers).
             configuration_diff rpc_diff;
             if (batch.rpc_configuration) {
-                const server_address_set& current_rpc_config = get_rpc_config();
-                rpc_diff = diff_address_sets(get_rpc_config(), *batch.rpc_configuration);
-                for (const auto& addr: rpc_diff.joining) {
-                    add_to_rpc_config(addr);
-                    _rpc->add_server(addr.id, addr.info);
+                std::exception_ptr ex;
+                try {
+                    const server_address_set& current_rpc_config = get_rpc_config();
+                    rpc_diff = diff_address_sets(get_rpc_config(), *batch.rpc_configuration);
+                    for (const auto& addr: rpc_diff.joining) {
+                        add_to_rpc_config(addr);
+                        _rpc->add_server(addr.id, addr.info);
+                    }
+                } catch (...) {
+                    ex = std::current_exception();
+                }
+                if (ex) {
+                    // The log entries may be still being stored, do not leave it behind.
+                    co_await std::move(log_entries_stored).handle_exception([] (std::exception_ptr) {});
+                    std::rethrow_exception(ex);
                 }
             }
 
-             // After entries are persisted we can send messages.
+             // After entries are persisted we can send messages,
+             // or while they are being persisted by a leader.
             for (auto&& m : batch.messages) {
                 try {
                     send_message(m.first, std::move(m.second));
@@ -536,6 +568,10 @@ future<> server_impl::io_fiber(index_t last_stable) {
                     logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
                 }
             }
+            if (batch.parallel_persistence && batch.log_entries.size()) {
+                _stats.messages_sent_before_persisted += batch.messages.size();
+            }
+            co_await std::move(log_entries_stored);
 
             if (batch.rpc_configuration) {
                 for (const auto& addr: rpc_diff.leaving) {
@@ -572,9 +608,22 @@ future<> server_impl::io_fiber(index_t last_stable) {
 }
 
 void server_impl::send_snapshot(server_id dst, install_snapshot&& snp) {
-    seastar::abort_source as;
     uint64_t id = _next_snapshot_transfer_id++;
-    future<> f = _rpc->send_snapshot(dst, std::move(snp), as).then_wrapped([this, dst, id] (future<snapshot_reply> f) {
+    // Register the transfer first, so that its abort source has a stable
+    // address while the transfer waits for its turn.
+    auto res = _snapshot_transfers.emplace(dst, snapshot_transfer{make_ready_future<>(), seastar::abort_source(), id});
+    assert(res.second);
+    if (_snapshot_transfer_limiter.available_units() <= 0) {
+        _stats.snapshot_transfers_queued++;
+    }
+    future<> f = get_units(_snapshot_transfer_limiter, 1).then([this, dst, id, snp = std::move(snp)] (semaphore_units<> units) mutable {
+        auto it = _snapshot_transfers.find(dst);
+        if (it == _snapshot_transfers.end() || it->second.id != id) {
+            // The transfer was aborted while waiting for its turn
+            return make_exception_future<snapshot_reply>(seastar::abort_requested_exception());
+        }
+        return _rpc->send_snapshot(dst, std::move(snp), it->second.as).finally([units = std::move(units)] {});
+    }).then_wrapped([this, dst, id] (future<snapshot_reply> f) {
         if (_aborted_snapshot_transfers.erase(id)) {
             // The transfer was aborted
             f.ignore_ready_future();
@@ -590,8 +639,11 @@ void server_impl::send_snapshot(server_id dst, install_snapshot&& snp) {
         }
         _fsm->step(dst, std::move(reply));
     });
-    auto res = _snapshot_transfers.emplace(dst, snapshot_transfer{std::move(f), std::move(as), id});
-    assert(res.second);
+    // The transfer may have already completed and been unregistered.
+    auto it = _snapshot_transfers.find(dst);
+    if (it != _snapshot_transfers.end() && it->second.id == id) {
+        it->second.f = std::move(f);
+    }
 }
 
 future<snapshot_reply> server_impl::apply_snapshot(server_id from, install_snapshot snp) {
@@ -604,12 +656,16 @@ future<snapshot_reply> server_impl::apply_snapshot(server_id from, install_snaps
 future<> server_impl::applier_fiber() {
     logger.trace("applier_fiber start");
     size_t applied_since_snapshot = 0;
+    size_t applied_size_since_snapshot = 0;
 
     try {
         while (true) {
             auto batch = co_await _apply_entries.pop_eventually();
 
             applied_since_snapshot += batch.size();
+            for (auto& entry : batch) {
+                applied_size_since_snapshot += log_entry_size(*entry);
+            }
 
             std::vector<command_cref> commands;
             commands.reserve(batch.size());
@@ -627,15 +683,17 @@ future<> server_impl::applier_fiber() {
             _stats.applied_entries += size;
             notify_waiters(_awaited_applies, batch);
 
-            if (applied_since_snapshot >= _config.snapshot_threshold) {
+            if (applied_since_snapshot >= _config.snapshot_threshold ||
+                    applied_size_since_snapshot >= _config.snapshot_threshold_log_size) {
                 snapshot snp;
                 snp.term = get_current_term();
                 snp.idx = last_idx;
                 logger.trace("[{}] applier fiber taking snapshot term={}, idx={}", _id, snp.term, snp.idx);
                 snp.id = co_await _state_machine->take_snapshot();
                 _last_loaded_snapshot_id = snp.id;
-                _fsm->apply_snapshot(snp, _config.snapshot_trailing);
+                _fsm->apply_snapshot(snp, _config.snapshot_trailing, _config.snapshot_trailing_size);
                 applied_since_snapshot = 0;
+                applied_size_since_snapshot = 0;
                 _stats.snapshots_taken++;
             }
         }
@@ -769,15 +827,21 @@ void server_impl::register_metrics() {
              sm::description("how many times log was truncated on storage"), {server_id_label(_id)}),
         sm::make_total_operations("persisted_log_entries", _stats.persisted_log_entries,
              sm::description("how many log entries were persisted"), {server_id_label(_id)}),
+        sm::make_total_operations("messages_sent_before_persisted", _stats.messages_sent_before_persisted,
+             sm::description("how many messages were sent while log entries were being persisted"), {server_id_label(_id)}),
         sm::make_total_operations("queue_entries_for_apply", _stats.queue_entries_for_apply,
              sm::description("how many log entries were queued to be applied"), {server_id_label(_id)}),
         sm::make_total_operations("applied_entries", _stats.applied_entries,
              sm::description("how many log entries were applied"), {server_id_label(_id)}),
         sm::make_total_operations("snapshots_taken", _stats.snapshots_taken,
              sm::description("how many time the user's state machine was snapshotted"), {server_id_label(_id)}),
+        sm::make_total_operations("snapshot_transfers_queued", _stats.snapshot_transfers_queued,
+             sm::description("how many snapshot transfers waited for other transfers to complete"), {server_id_label(_id)}),
 
         sm::make_gauge("in_memory_log_size", [this] { return _fsm->in_memory_log_size(); },
              sm::description("size of in-memory part of the log"), {server_id_label(_id)}),
+        sm::make_gauge("in_memory_log_memory_usage", [this] { return _fsm->log_memory_usage(); },
+             sm::description("size in bytes of the entries in the in-memory part of the log"), {server_id_label(_id)}),
     });
 }
 
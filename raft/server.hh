@@ -35,8 +35,19 @@ class server {
         // automatically snapshot state machine after applying
         // this number of entries
         size_t snapshot_threshold = 1024;
+        // automatically snapshot state machine after applying
+        // entries of this total size in bytes, even if there are
+        // fewer than snapshot_threshold of them
+        size_t snapshot_threshold_log_size = 2 * 1024 * 1024;
         // how many entries to leave in the log after tacking a snapshot
         size_t snapshot_trailing = 200;
+        // max size in bytes of the entries left in the log after
+        // taking a snapshot, fewer than snapshot_trailing entries
+        // are left if they exceed it
+        size_t snapshot_trailing_size = 1024 * 1024;
+        // max number of snapshots transferred to followers at a
+        // time, the others wait for their turn
+        size_t max_snapshot_transfers = 2;
         // max size of appended entries in bytes
         size_t append_request_threshold = 100000;
         // Max number of entries of in-memory part of the log after
@@ -48,6 +59,9 @@ class server {
         size_t max_log_size = 5000;
         // If set to true will enable prevoting stage during election
         bool enable_prevoting = true;
+        // If set to true the leader sends new entries to followers
+        // while persisting them in its own log, instead of after.
+        bool enable_parallel_persistence = true;
     };
 
     virtual ~server() {}
@@ -75,12 +75,15 @@ void range_tombstone_accumulator::drop_unneeded_tombstones(const clustering_key_
         auto bv = rt.end_bound();
         return _cmp(bv.prefix(), weight(bv.kind()), ck, w);
     };
-    bool dropped = false;
+    // Only dropping the tombstone which determines the current one can change
+    // it. Recomputing on every drop would make the accumulator quadratic in
+    // the number of overlapping range tombstones.
+    bool dropped_current = false;
     while (!_range_tombstones.empty() && cmp(*_range_tombstones.begin(), ck, w)) {
-        dropped = true;
+        dropped_current |= _range_tombstones.front().tomb == _current_tombstone;
         _range_tombstones.pop_front();
     }
-    if (dropped) {
+    if (dropped_current && _current_tombstone != _partition_tombstone) {
         update_current_tombstone();
     }
 }
@@ -19,6 +19,7 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <boost/range/adaptor/reversed.hpp>
 #include "range_tombstone_list.hh"
 #include "utils/allocation_strategy.hh"
@@ -300,6 +301,25 @@ void range_tombstone_list::apply(const schema& s, const range_tombstone_list& rt
     }
 }
 
+void range_tombstone_list::apply(const schema& s, std::vector<range_tombstone> rts) {
+    std::stable_sort(rts.begin(), rts.end(), [] (const range_tombstone& a, const range_tombstone& b) {
+        return a.tomb < b.tomb;
+    });
+    if (_tombstones.empty()) {
+        for (auto&& rt : rts) {
+            apply(s, std::move(rt));
+        }
+        return;
+    }
+    // Normalize the batch first. Merging the resulting disjoint list visits
+    // every entry of this list at most a constant number of times.
+    range_tombstone_list batch(s);
+    for (auto&& rt : rts) {
+        batch.apply(s, std::move(rt));
+    }
+    apply(s, batch);
+}
+
 // See reversibly_mergeable.hh
 range_tombstone_list::reverter range_tombstone_list::apply_reversibly(const schema& s, range_tombstone_list& rt_list) {
     reverter rev(s, *this);
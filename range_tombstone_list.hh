@@ -151,6 +151,13 @@ class range_tombstone_list final {
         nop_reverter rev(s, *this);
         apply_reversibly(s, std::move(start), start_kind, std::move(end), end_kind, std::move(tomb), rev);
     }
+    // Applies a batch of possibly overlapping range tombstones.
+    // The batch is applied in the order of increasing tombstones, so that every
+    // tombstone only overwrites the entries it covers instead of filling the gaps
+    // between the newer ones. This bounds the cost by O(n log n) regardless of
+    // how the deletions nest, where applying them one by one in arbitrary order
+    // can be quadratic.
+    void apply(const schema& s, std::vector<range_tombstone> rts);
     // Monotonic exception guarantees. In case of failure the object will contain at least as much information as before the call.
     void apply_monotonically(const schema& s, const range_tombstone& rt);
     // Merges another list with this object.
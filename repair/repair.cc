@@ -146,10 +146,99 @@ std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo
         return out << "send_full_set";
     case row_level_diff_detect_algorithm::send_full_set_rpc_stream:
         return out << "send_full_set_rpc_stream";
+    case row_level_diff_detect_algorithm::send_sketch_rpc_stream:
+        return out << "send_sketch_rpc_stream";
     };
     return out << "unknown";
 }
 
+// The finalizer of splitmix64, used to derive the cell indexes and the
+// checksum of a row hash, which is already uniformly distributed.
+static uint64_t mix_repair_hash(uint64_t x, uint64_t seed) {
+    x += seed;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static constexpr uint64_t repair_hash_check_seed = 0x9e3779b97f4a7c15ULL;
+
+repair_hash_sketch repair_hash_sketch::for_differences(size_t differences) {
+    // Peeling succeeds with high probability when the number of cells is
+    // about 1.5 times the number of differences. Small sketches need more slack.
+    auto part_size = std::max<size_t>(differences / 2 + 1, 8);
+    return repair_hash_sketch(std::vector<repair_hash_sketch_cell>(part_size * hash_count));
+}
+
+void repair_hash_sketch::update(const repair_hash& h, int32_t count) {
+    auto part_size = _cells.size() / hash_count;
+    auto check = mix_repair_hash(h.hash, repair_hash_check_seed);
+    for (size_t i = 0; i < hash_count; ++i) {
+        auto& c = _cells[i * part_size + mix_repair_hash(h.hash, i) % part_size];
+        c.count += count;
+        c.key_sum ^= h.hash;
+        c.check_sum ^= check;
+    }
+}
+
+bool repair_hash_sketch::is_pure(const repair_hash_sketch_cell& c) const {
+    return (c.count == 1 || c.count == -1) && c.check_sum == mix_repair_hash(c.key_sum, repair_hash_check_seed);
+}
+
+void repair_hash_sketch::subtract(const repair_hash_sketch& other) {
+    if (other._cells.size() != _cells.size()) {
+        throw std::runtime_error(format("Cannot subtract repair hash sketch of size {} from one of size {}", other._cells.size(), _cells.size()));
+    }
+    for (size_t i = 0; i < _cells.size(); ++i) {
+        _cells[i].count -= other._cells[i].count;
+        _cells[i].key_sum ^= other._cells[i].key_sum;
+        _cells[i].check_sum ^= other._cells[i].check_sum;
+    }
+}
+
+std::optional<repair_hash_sketch::difference> repair_hash_sketch::decode() && {
+    if (_cells.empty() || _cells.size() % hash_count) {
+        return std::nullopt;
+    }
+    difference diff;
+    std::vector<size_t> pure;
+    for (size_t i = 0; i < _cells.size(); ++i) {
+        if (is_pure(_cells[i])) {
+            pure.push_back(i);
+        }
+    }
+    auto part_size = _cells.size() / hash_count;
+    while (!pure.empty()) {
+        auto& c = _cells[pure.back()];
+        pure.pop_back();
+        // The cell may have been peeled through another one in the meantime.
+        if (!is_pure(c)) {
+            continue;
+        }
+        auto h = repair_hash(c.key_sum);
+        auto count = c.count;
+        (count > 0 ? diff.added : diff.removed).push_back(h);
+        // A sketch of n cells cannot hold more than n distinct hashes, more means
+        // a checksum collision produced garbage.
+        if (diff.added.size() + diff.removed.size() > _cells.size()) {
+            return std::nullopt;
+        }
+        update(h, -count);
+        for (size_t i = 0; i < hash_count; ++i) {
+            auto idx = i * part_size + mix_repair_hash(h.hash, i) % part_size;
+            if (is_pure(_cells[idx])) {
+                pure.push_back(idx);
+            }
+        }
+    }
+    for (auto& c : _cells) {
+        if (c.count || c.key_sum || c.check_sum) {
+            return std::nullopt;
+        }
+    }
+    return diff;
+}
+
 static std::vector<sstring> list_column_families(const database& db, const sstring& keyspace) {
     std::vector<sstring> ret;
     for (auto &&e : db.get_column_families_mapping()) {
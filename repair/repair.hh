@@ -365,6 +365,85 @@ class repair_hash {
 
 using repair_hash_set = absl::btree_set<repair_hash>;
 
+struct repair_hash_sketch_cell {
+    int32_t count = 0;
+    uint64_t key_sum = 0;
+    uint64_t check_sum = 0;
+};
+
+// An invertible Bloom lookup table of row hashes.
+//
+// Subtracting the sketch of one set from the sketch of the same size of
+// another set leaves only the hashes in the symmetric difference, which
+// can be listed as long as the difference is small compared to the number
+// of cells. This lets two nodes find the differing rows by exchanging
+// O(differences) data instead of their full row hash sets.
+class repair_hash_sketch {
+    std::vector<repair_hash_sketch_cell> _cells;
+public:
+    // Each hash is stored in one cell of each of the hash_count equal
+    // parts of the sketch.
+    static constexpr size_t hash_count = 3;
+    static constexpr size_t cell_size = sizeof(int32_t) + 2 * sizeof(uint64_t);
+
+    explicit repair_hash_sketch(std::vector<repair_hash_sketch_cell> cells)
+        : _cells(std::move(cells)) {
+    }
+    // Returns an empty sketch which can be decoded with high probability
+    // when the difference has up to `differences` hashes.
+    static repair_hash_sketch for_differences(size_t differences);
+
+    const std::vector<repair_hash_sketch_cell>& cells() const {
+        return _cells;
+    }
+    size_t size() const {
+        return _cells.size();
+    }
+    size_t serialized_size() const {
+        return _cells.size() * cell_size;
+    }
+
+    void insert(const repair_hash& h) {
+        update(h, 1);
+    }
+    // Subtracts the sketch of another set. Both sketches must have the same size.
+    void subtract(const repair_hash_sketch& other);
+
+    struct difference {
+        // Hashes inserted into this sketch but not into the subtracted one.
+        std::vector<repair_hash> added;
+        // Hashes inserted into the subtracted sketch but not into this one.
+        std::vector<repair_hash> removed;
+    };
+    // Lists the hashes left after subtract(). Returns std::nullopt if the
+    // difference is too large to be listed with this number of cells.
+    std::optional<difference> decode() &&;
+private:
+    void update(const repair_hash& h, int32_t count);
+    bool is_pure(const repair_hash_sketch_cell& c) const;
+};
+
+// Return value of the REPAIR_RECONCILE_ROW_HASHES RPC verb
+struct repair_reconcile_row_hashes_response {
+    // False if the difference was too large to be decoded
+    bool decoded;
+    // The row hashes present on the follower only
+    std::vector<repair_hash> follower_only;
+    // The row hashes present on the master only
+    std::vector<repair_hash> master_only;
+};
+
+// The sum of the sstable repair digests of a table on a node for one bucket of
+// the ring, see sstables::repair_digest_builder. Returned by the
+// REPAIR_GET_RANGE_DIGEST RPC verb.
+struct repair_bucket_digest {
+    uint32_t index;
+    uint64_t fragments;
+    uint64_t sum;
+
+    bool operator==(const repair_bucket_digest&) const = default;
+};
+
 enum class repair_row_level_start_status: uint8_t {
     ok,
     no_such_column_family,
@@ -443,6 +522,9 @@ struct repair_row_on_wire_with_cmd {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    // Like send_full_set_rpc_stream, but nodes first try to find the
+    // differing row hashes with a repair_hash_sketch.
+    send_sketch_rpc_stream,
 };
 
 std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo);
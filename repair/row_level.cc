@@ -23,6 +23,7 @@
 #include "message/messaging_service.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
+#include "sstables/repair_digest.hh"
 #include "mutation_fragment.hh"
 #include "mutation_writer/multishard_writer.hh"
 #include "dht/i_partitioner.hh"
@@ -42,6 +43,7 @@
 #include <optional>
 #include <boost/range/adaptors.hpp>
 #include <boost/intrusive/list.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
 #include "gms/i_endpoint_state_change_subscriber.hh"
 #include "gms/gossiper.hh"
 #include "repair/row_level.hh"
@@ -80,6 +82,8 @@ enum class repair_state : uint16_t {
     get_full_row_hashes_with_rpc_stream_finished,
     get_full_row_hashes_started,
     get_full_row_hashes_finished,
+    reconcile_row_hashes_started,
+    reconcile_row_hashes_finished,
     get_row_diff_started,
     get_row_diff_finished,
     put_row_diff_with_rpc_stream_started,
@@ -175,6 +179,10 @@ struct row_level_repair_metrics {
     uint64_t row_from_disk_bytes{0};
     uint64_t tx_hashes_nr{0};
     uint64_t rx_hashes_nr{0};
+    uint64_t tx_sketch_bytes{0};
+    uint64_t rx_sketch_bytes{0};
+    uint64_t sketch_fallback_nr{0};
+    uint64_t digest_skipped_buckets_nr{0};
     row_level_repair_metrics() {
         namespace sm = seastar::metrics;
         _metrics.add_group("repair", {
@@ -190,6 +198,14 @@ struct row_level_repair_metrics {
                             sm::description("Total number of row hashes sent on this shard.")),
             sm::make_derive("rx_hashes_nr", rx_hashes_nr,
                             sm::description("Total number of row hashes received on this shard.")),
+            sm::make_derive("tx_sketch_bytes", tx_sketch_bytes,
+                            sm::description("Total bytes of row hash sketches sent on this shard.")),
+            sm::make_derive("rx_sketch_bytes", rx_sketch_bytes,
+                            sm::description("Total bytes of row hash sketches received on this shard.")),
+            sm::make_derive("sketch_fallback_nr", sketch_fallback_nr,
+                            sm::description("Total number of row hash sketch reconciliations on this shard which fell back to sending full row hash sets.")),
+            sm::make_derive("digest_skipped_buckets_nr", digest_skipped_buckets_nr,
+                            sm::description("Total number of token ring buckets which were not read on this shard since their sstable repair digests matched on all nodes.")),
             sm::make_derive("row_from_disk_nr", row_from_disk_nr,
                             sm::description("Total number of rows read from disk on this shard.")),
             sm::make_derive("row_from_disk_bytes", row_from_disk_bytes,
@@ -204,6 +220,7 @@ static const std::vector<row_level_diff_detect_algorithm>& suportted_diff_detect
     static std::vector<row_level_diff_detect_algorithm> _algorithms = {
         row_level_diff_detect_algorithm::send_full_set,
         row_level_diff_detect_algorithm::send_full_set_rpc_stream,
+        row_level_diff_detect_algorithm::send_sketch_rpc_stream,
     };
     return _algorithms;
 };
@@ -764,6 +781,10 @@ class repair_meta {
     const repair_hash& working_row_buf_combined_hash() const {
         return _working_row_buf_combined_hash;
     }
+    bool use_hash_sketch() const {
+        return _algo == row_level_diff_detect_algorithm::send_sketch_rpc_stream;
+    }
+
     bool use_rpc_stream() const {
         return is_rpc_stream_supported(_algo);
     }
@@ -1614,6 +1635,50 @@ class repair_meta {
         });
     }
 
+    // RPC API
+    // Return the differences between the row hashes in the working row buf
+    // of this node, summarized by the sketch, and those of the remote node
+    future<repair_reconcile_row_hashes_response>
+    reconcile_row_hashes(repair_hash_sketch sketch, gms::inet_address remote_node) {
+        if (remote_node == _myip) {
+            return reconcile_row_hashes_handler(std::move(sketch));
+        }
+        _metrics.tx_sketch_bytes += sketch.serialized_size();
+        return _messaging.local().send_repair_reconcile_row_hashes(msg_addr(remote_node),
+                _repair_meta_id, std::move(sketch)).then([this, remote_node] (repair_reconcile_row_hashes_response resp) {
+            auto nr_hashes = resp.follower_only.size() + resp.master_only.size();
+            rlogger.debug("Got reconciled hashes from peer={}, decoded={}, follower_only={}, master_only={}",
+                    remote_node, resp.decoded, resp.follower_only.size(), resp.master_only.size());
+            _metrics.rx_hashes_nr += nr_hashes;
+            stats().rx_hashes_nr += nr_hashes;
+            stats().rpc_call_nr++;
+            return resp;
+        });
+    }
+
+    // RPC handler
+    future<repair_reconcile_row_hashes_response>
+    reconcile_row_hashes_handler(repair_hash_sketch master_sketch) {
+        return with_gate(_gate, [this, master_sketch = std::move(master_sketch)] () mutable {
+            if (master_sketch.size() == 0 || master_sketch.size() % repair_hash_sketch::hash_count) {
+                return make_exception_future<repair_reconcile_row_hashes_response>(std::runtime_error(
+                        format("reconcile_row_hashes: Got repair hash sketch of invalid size {}", master_sketch.size())));
+            }
+            return working_row_hashes().then([master_sketch = std::move(master_sketch)] (repair_hash_set hashes) {
+                repair_hash_sketch sketch(std::vector<repair_hash_sketch_cell>(master_sketch.size()));
+                for (auto& h : hashes) {
+                    sketch.insert(h);
+                }
+                sketch.subtract(master_sketch);
+                auto diff = std::move(sketch).decode();
+                if (!diff) {
+                    return repair_reconcile_row_hashes_response{false, {}, {}};
+                }
+                return repair_reconcile_row_hashes_response{true, std::move(diff->added), std::move(diff->removed)};
+            });
+        });
+    }
+
     // RPC API
     // Return the combined hashes of the current working row buf
     future<get_combined_row_hash_response>
@@ -2268,6 +2333,32 @@ static future<> repair_get_full_row_hashes_with_rpc_stream_handler(
     });
 }
 
+using range_digest = std::optional<std::vector<repair_bucket_digest>>;
+
+// Sums the sstable repair digests of the table on all shards of this node,
+// see table::get_repair_digest().
+static future<range_digest> get_local_range_digest(sharded<database>& db, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits) {
+    using digest_map = std::map<uint32_t, repair_bucket_digest>;
+    return db.map_reduce0([table_id, range = std::move(range), bucket_bits] (database& db) {
+        return db.find_column_family(table_id).get_repair_digest(range, bucket_bits);
+    }, std::make_optional<digest_map>(), [] (std::optional<digest_map> acc, std::optional<utils::chunked_vector<sstables::repair_digest_bucket>> digest) {
+        if (!acc || !digest) {
+            return std::optional<digest_map>();
+        }
+        for (auto& b : *digest) {
+            auto& d = acc->try_emplace(b.index, repair_bucket_digest{b.index, 0, 0}).first->second;
+            d.fragments += b.fragments;
+            d.sum += b.sum;
+        }
+        return acc;
+    }).then([] (std::optional<digest_map> acc) -> range_digest {
+        if (!acc) {
+            return std::nullopt;
+        }
+        return boost::copy_range<std::vector<repair_bucket_digest>>(*acc | boost::adaptors::map_values);
+    });
+}
+
 future<> repair_service::init_row_level_ms_handlers() {
     auto& ms = this->_messaging;
 
@@ -2317,6 +2408,20 @@ future<> repair_service::init_row_level_ms_handlers() {
             });
         }) ;
     });
+    ms.register_repair_reconcile_row_hashes([] (const rpc::client_info& cinfo, uint32_t repair_meta_id, repair_hash_sketch sketch) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return smp::submit_to(src_cpu_id % smp::count, [from, repair_meta_id, sketch = std::move(sketch)] () mutable {
+            auto rm = repair_meta::get_repair_meta(from, repair_meta_id);
+            _metrics.rx_sketch_bytes += sketch.serialized_size();
+            rm->set_repair_state_for_local_node(repair_state::reconcile_row_hashes_started);
+            return rm->reconcile_row_hashes_handler(std::move(sketch)).then([rm] (repair_reconcile_row_hashes_response resp) {
+                rm->set_repair_state_for_local_node(repair_state::reconcile_row_hashes_finished);
+                _metrics.tx_hashes_nr += resp.follower_only.size() + resp.master_only.size();
+                return resp;
+            });
+        });
+    });
     ms.register_repair_get_combined_row_hash([] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
             std::optional<repair_sync_boundary> common_sync_boundary) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
@@ -2429,6 +2534,9 @@ future<> repair_service::init_row_level_ms_handlers() {
             return repair_meta::repair_set_estimated_partitions_handler(from, repair_meta_id, estimated_partitions);
         });
     });
+    ms.register_repair_get_range_digest([this] (const rpc::client_info& cinfo, utils::UUID table_id, dht::token_range range, uint32_t bucket_bits) {
+        return get_local_range_digest(_db, table_id, std::move(range), bucket_bits);
+    });
     ms.register_repair_get_diff_algorithms([] (const rpc::client_info& cinfo) {
         return make_ready_future<std::vector<row_level_diff_detect_algorithm>>(suportted_diff_detect_algorithms());
     });
@@ -2444,6 +2552,7 @@ future<> repair_service::uninit_row_level_ms_handlers() {
         ms.unregister_repair_put_row_diff_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes(),
+        ms.unregister_repair_reconcile_row_hashes(),
         ms.unregister_repair_get_combined_row_hash(),
         ms.unregister_repair_get_sync_boundary(),
         ms.unregister_repair_get_row_diff(),
@@ -2452,6 +2561,7 @@ future<> repair_service::uninit_row_level_ms_handlers() {
         ms.unregister_repair_row_level_stop(),
         ms.unregister_repair_get_estimated_partitions(),
         ms.unregister_repair_set_estimated_partitions(),
+        ms.unregister_repair_get_range_digest(),
         ms.unregister_repair_get_diff_algorithms()).discard_result();
 }
 
@@ -2551,6 +2661,48 @@ class row_level_repair {
         return is_rpc_stream_supported(algo) ?  tracker::max_repair_memory_per_range() : 256 * 1024;
     }
 
+    // Get the row hashes in the working row buf of the peer by reconciling
+    // them with the local ones using sketches, which transfers O(differences)
+    // data. The sketch is enlarged until it can be decoded, or until it would
+    // not be smaller than the full set of hashes, in which case std::nullopt is
+    // returned and the caller falls back to fetching the full set.
+    std::optional<repair_hash_set> get_peer_row_hashes_with_sketch(repair_meta& master, repair_node_state& ns) {
+        repair_hash_set hashes = master.working_row_hashes().get0();
+        auto full_set_size = std::max(hashes.size(), size_t(1)) * sizeof(repair_hash);
+        bool tried = false;
+        for (size_t differences = 16; ; differences *= 4) {
+            auto sketch = repair_hash_sketch::for_differences(differences);
+            if (sketch.serialized_size() > full_set_size / 2) {
+                break;
+            }
+            for (auto& h : hashes) {
+                sketch.insert(h);
+                thread::maybe_yield();
+            }
+            ns.state = repair_state::reconcile_row_hashes_started;
+            auto resp = master.reconcile_row_hashes(std::move(sketch), ns.node).get0();
+            ns.state = repair_state::reconcile_row_hashes_finished;
+            tried = true;
+            if (!resp.decoded) {
+                continue;
+            }
+            for (auto& h : resp.master_only) {
+                if (!hashes.erase(h)) {
+                    rlogger.warn("Got inconsistent row hash differences from peer={}, falling back to full row hashes", ns.node);
+                    _metrics.sketch_fallback_nr++;
+                    return std::nullopt;
+                }
+            }
+            hashes.insert(resp.follower_only.begin(), resp.follower_only.end());
+            return hashes;
+        }
+        // Small sets are sent in full right away, that is not a fallback.
+        if (tried) {
+            _metrics.sketch_fallback_nr++;
+        }
+        return std::nullopt;
+    }
+
     // Step A: Negotiate sync boundary to use
     op_status negotiate_sync_boundary(repair_meta& master) {
         check_in_shutdown();
@@ -2699,8 +2851,16 @@ class row_level_repair {
 
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
-            // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            // Try to find the differences with a sketch first, and only ask the
+            // peer to send the full list hashes in the working row buf if they are
+            // too many for that.
+            std::optional<repair_hash_set> peer_hashes;
+            if (master.use_hash_sketch()) {
+                peer_hashes = get_peer_row_hashes_with_sketch(master, ns);
+            }
+            if (peer_hashes) {
+                master.peer_row_hash_sets(node_idx) = std::move(*peer_hashes);
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
@@ -2890,13 +3050,145 @@ class row_level_repair {
     }
 };
 
+// Every range left to repair is repaired by its own row_level_repair, so
+// there is a cap on their number. Above it, the shortest runs of matching
+// buckets are repaired too, merging the ranges around them.
+static constexpr size_t max_digest_mismatch_ranges = 16;
+
+// Keeps the longest of the runs of buckets, sorted, such that taking them out
+// of a range leaves at most max_ranges ranges.
+static void keep_longest_runs(std::vector<std::pair<uint32_t, uint32_t>>& runs, size_t max_ranges) {
+    if (runs.size() < max_ranges) {
+        return;
+    }
+    auto longer = [] (const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+        return a.second - a.first > b.second - b.first;
+    };
+    std::stable_sort(runs.begin(), runs.end(), longer);
+    runs.resize(max_ranges - 1);
+    std::sort(runs.begin(), runs.end());
+}
+
+// Returns the parts of the range which are left once the given runs of
+// buckets, sorted and within the range, are taken out.
+static dht::token_range_vector subtract_buckets(const dht::token_range& range, const std::vector<std::pair<uint32_t, uint32_t>>& runs, uint32_t bits) {
+    if (runs.empty()) {
+        return dht::token_range_vector{range};
+    }
+    dht::token_range_vector ranges;
+    auto start = range.start();
+    for (auto& [first, last] : runs) {
+        auto end = dht::token_range::bound(sstables::repair_digest_bucket_first_token(first, bits), false);
+        if (!start || dht::tri_compare(start->value(), end.value()) < 0) {
+            ranges.emplace_back(std::move(start), std::move(end));
+        }
+        start = dht::token_range::bound(sstables::repair_digest_bucket_last_token(last, bits), false);
+    }
+    if (!range.end() || dht::tri_compare(start->value(), range.end()->value()) < 0) {
+        ranges.emplace_back(std::move(start), range.end());
+    }
+    return ranges;
+}
+
+// Sstables carry digests of their fragments per bucket of the ring, see
+// sstables::repair_digest_builder. The buckets within the range whose
+// digests match on all nodes hold the same data everywhere, so only the rest
+// of the range needs to be read and compared row by row. Returns the whole
+// range if any node has data not covered by digests.
+static future<dht::token_range_vector> get_ranges_with_digest_mismatch(repair_info& ri, utils::UUID table_id, dht::token_range range,
+        const std::vector<gms::inet_address>& all_peer_nodes) {
+    if (ri.reason != streaming::stream_reason::repair || all_peer_nodes.empty()) {
+        return make_ready_future<dht::token_range_vector>(dht::token_range_vector{std::move(range)});
+    }
+    auto bits = sstables::repair_digest_bucket_bits;
+    auto digests = make_lw_shared<std::vector<range_digest>>(all_peer_nodes.size() + 1);
+    auto get_digest = [&ri, table_id, range, bits] (std::optional<gms::inet_address> node) {
+        if (!node) {
+            return get_local_range_digest(ri.db, table_id, range, bits);
+        }
+        // Nodes which do not know the verb have no digests either.
+        return ri.messaging.local().send_repair_get_range_digest(netw::msg_addr(*node), table_id, range, bits).handle_exception([node] (std::exception_ptr ep) {
+            rlogger.debug("Failed to get repair range digest from node {}: {}", *node, ep);
+            return range_digest();
+        });
+    };
+    auto idx = boost::irange(size_t(0), digests->size());
+    return parallel_for_each(idx, [&all_peer_nodes, digests, get_digest] (size_t i) {
+        auto node = i ? std::make_optional(all_peer_nodes[i - 1]) : std::nullopt;
+        return get_digest(node).then([digests, i] (range_digest d) {
+            (*digests)[i] = std::move(d);
+        });
+    }).then([range = std::move(range), digests, bits] () mutable {
+        if (boost::algorithm::any_of(*digests, [] (const range_digest& d) { return !d; })) {
+            return dht::token_range_vector{std::move(range)};
+        }
+        auto contains_bucket = [&] (uint32_t index) {
+            auto cmp = dht::token_comparator();
+            return range.contains(sstables::repair_digest_bucket_first_token(index, bits), cmp)
+                    && range.contains(sstables::repair_digest_bucket_last_token(index, bits), cmp);
+        };
+        auto first = sstables::repair_digest_bucket_of(range.start() ? range.start()->value() : dht::minimum_token(), bits);
+        auto last = sstables::repair_digest_bucket_of(range.end() ? range.end()->value() : dht::maximum_token(), bits);
+        if (!contains_bucket(first)) {
+            first++;
+        }
+        if (!contains_bucket(last)) {
+            if (last == 0) {
+                return dht::token_range_vector{std::move(range)};
+            }
+            last--;
+        }
+        // Digests are sorted by bucket index, walk them all in step.
+        std::vector<std::vector<repair_bucket_digest>::const_iterator> its;
+        for (auto& d : *digests) {
+            its.push_back(std::lower_bound(d->begin(), d->end(), first, [] (const repair_bucket_digest& b, uint32_t index) {
+                return b.index < index;
+            }));
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> runs;
+        for (uint64_t index = first; index <= last; ++index) {
+            std::optional<repair_bucket_digest> expected;
+            bool match = true;
+            for (size_t i = 0; i < its.size(); ++i) {
+                auto& it = its[i];
+                auto d = it != (*digests)[i]->end() && it->index == index ? *it++ : repair_bucket_digest{uint32_t(index), 0, 0};
+                if (!expected) {
+                    expected = d;
+                } else if (*expected != d) {
+                    match = false;
+                }
+            }
+            if (!match) {
+                continue;
+            }
+            if (!runs.empty() && runs.back().second + 1 == index) {
+                runs.back().second = index;
+            } else {
+                runs.emplace_back(index, index);
+            }
+        }
+        keep_longest_runs(runs, max_digest_mismatch_ranges);
+        for (auto& run : runs) {
+            _metrics.digest_skipped_buckets_nr += run.second - run.first + 1;
+        }
+        auto ranges = subtract_buckets(range, runs, bits);
+        rlogger.debug("Repair digests of range {} match in {} runs of buckets, ranges left to repair: {}", range, runs.size(), ranges);
+        return ranges;
+    });
+}
+
 future<> repair_cf_range_row_level(repair_info& ri,
         sstring cf_name, utils::UUID table_id, dht::token_range range,
         const std::vector<gms::inet_address>& all_peer_nodes) {
-    return seastar::futurize_invoke([&ri, cf_name = std::move(cf_name), table_id = std::move(table_id), range = std::move(range), &all_peer_nodes] () mutable {
-        auto repair = row_level_repair(ri, std::move(cf_name), std::move(table_id), std::move(range), all_peer_nodes);
-        return do_with(std::move(repair), [] (row_level_repair& repair) {
-            return repair.run();
+    return get_ranges_with_digest_mismatch(ri, table_id, std::move(range), all_peer_nodes).then([&ri, cf_name = std::move(cf_name), table_id = std::move(table_id),
+            &all_peer_nodes] (dht::token_range_vector ranges) mutable {
+        return do_with(std::move(ranges), [&ri, cf_name = std::move(cf_name), table_id = std::move(table_id), &all_peer_nodes] (dht::token_range_vector& ranges) {
+            return do_for_each(ranges, [&ri, &cf_name, &table_id, &all_peer_nodes] (const dht::token_range& range) {
+                auto repair = row_level_repair(ri, cf_name, table_id, range, all_peer_nodes);
+                return do_with(std::move(repair), [] (row_level_repair& repair) {
+                    return repair.run();
+                });
+            });
         });
     });
 }
@@ -32,6 +32,7 @@
 #include "read_context.hh"
 #include "dirty_memory_manager.hh"
 #include "cache_flat_mutation_reader.hh"
+#include "partition_snapshot_reader.hh"
 #include "real_dirty_memory_accounter.hh"
 
 namespace cache {
@@ -135,6 +136,10 @@ cache_tracker::setup_metrics() {
             sm::description("total number of rows in memtables which were dropped during cache update on memtable flush")),
         sm::make_derive("rows_merged_from_memtable", _stats.rows_merged_from_memtable,
             sm::description("total number of rows in memtables which were merged with existing rows during cache update on memtable flush")),
+        sm::make_derive("population_admissions", _stats.population_admissions,
+            sm::description("total number of partitions missing in cache which were populated by reads of tables with frequency-based admission")),
+        sm::make_derive("population_rejections", _stats.population_rejections,
+            sm::description("total number of partitions missing in cache which were not populated by reads of tables with frequency-based admission because they were not read frequently enough")),
     });
 }
 
@@ -164,13 +169,23 @@ void cache_tracker::touch(rows_entry& e) {
 
 void cache_tracker::insert(cache_entry& entry) {
     insert(entry.partition());
+    if (cache_profiler::is_sampled(entry.key().token())) {
+        if (auto* p = profiler_for(entry.schema()->id())) {
+            p->on_insert(entry.key().token());
+        }
+    }
     ++_stats.partition_insertions;
     ++_stats.partitions;
     // partition_range_cursor depends on this to detect invalidation of _end
     _region.allocator().invalidate_references();
 }
 
-void cache_tracker::on_partition_erase() noexcept {
+void cache_tracker::on_partition_erase(const cache_entry& e) noexcept {
+    if (cache_profiler::is_sampled(e.key().token())) {
+        if (auto* p = profiler_for(e.schema()->id())) {
+            p->on_removal(e.key().token());
+        }
+    }
     --_stats.partitions;
     ++_stats.partition_removals;
     allocator().invalidate_references();
@@ -188,7 +203,12 @@ void cache_tracker::on_partition_miss() noexcept {
     ++_stats.partition_misses;
 }
 
-void cache_tracker::on_partition_eviction() noexcept {
+void cache_tracker::on_partition_eviction(const cache_entry& e) noexcept {
+    if (cache_profiler::is_sampled(e.key().token())) {
+        if (auto* p = profiler_for(e.schema()->id())) {
+            p->on_eviction(e.key().token());
+        }
+    }
     --_stats.partitions;
     ++_stats.partition_evictions;
 }
@@ -218,6 +238,44 @@ void cache_tracker::on_miss_already_populated() noexcept {
     ++_stats.concurrent_misses_same_key;
 }
 
+void cache_tracker::add_profiler(const utils::UUID& table_id) {
+    _profilers.try_emplace(table_id);
+}
+
+cache_profiler* cache_tracker::profiler_for(const utils::UUID& table_id) noexcept {
+    auto it = _profilers.find(table_id);
+    return it == _profilers.end() ? nullptr : &it->second;
+}
+
+cache_profile cache_tracker::get_profile(const utils::UUID& table_id) const {
+    auto it = _profilers.find(table_id);
+    return it == _profilers.end() ? cache_profile{} : it->second.profile();
+}
+
+void cache_tracker::drop_profiler(const utils::UUID& table_id) noexcept {
+    _profilers.erase(table_id);
+}
+
+void cache_tracker::record_access(dht::token t) noexcept {
+    if (_admission_sketch.record(t.raw())) {
+        _row_evictions_at_last_aging = _stats.row_evictions;
+    }
+}
+
+bool cache_tracker::admit(dht::token t) noexcept {
+    record_access(t);
+    // Populating only competes with the working set for memory once the
+    // cache is full, which is detected by eviction happening within the
+    // current aging period of the sketch. Until then, everything is admitted.
+    if (_stats.row_evictions == _row_evictions_at_last_aging
+            || _admission_sketch.estimate(t.raw()) >= admission_threshold) {
+        ++_stats.population_admissions;
+        return true;
+    }
+    ++_stats.population_rejections;
+    return false;
+}
+
 void cache_tracker::pinned_dirty_memory_overload(uint64_t bytes) noexcept {
     _stats.pinned_dirty_memory_overload += bytes;
 }
@@ -364,7 +422,14 @@ class single_partition_populating_reader final : public flat_mutation_reader::im
         _read_context->enter_partition(_read_context->range().start()->value().as_decorated_key(), src_and_phase.snapshot, phase);
         return _read_context->create_underlying(timeout).then([this, phase, timeout] {
           return _read_context->underlying().underlying()(timeout).then([this, phase] (auto&& mfopt) {
-            if (!mfopt) {
+            if (!_cache.should_admit(_read_context->key())) {
+                if (mfopt) {
+                    _reader = read_directly_from_underlying(*_read_context);
+                    this->push_mutation_fragment(std::move(*mfopt));
+                } else {
+                    _end_of_stream = true;
+                }
+            } else if (!mfopt) {
                 if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                     _cache._read_section(_cache._tracker.region(), [this] {
                         _cache.find_or_create_missing(_read_context->key());
@@ -437,12 +502,26 @@ void cache_tracker::clear_continuity(cache_entry& ce) noexcept {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
+void row_cache::on_partition_hit(cache_entry& e) {
     _tracker.on_partition_hit();
+    if (cache_profiler::is_sampled(e.key().token())) {
+        if (auto* p = _tracker.profiler_for(_schema->id())) {
+            p->on_hit(e.key().token(), [&] { return e.estimated_size_in_allocator(_tracker.allocator()); });
+        }
+    }
 }
 
-void row_cache::on_partition_miss() {
+void row_cache::on_partition_miss(dht::token t) {
     _tracker.on_partition_miss();
+    if (cache_profiler::is_sampled(t)) {
+        if (auto* p = _tracker.profiler_for(_schema->id())) {
+            p->on_miss(t);
+        }
+    }
+}
+
+cache_profile row_cache::get_profile() const {
+    return _tracker.get_profile(_schema->id());
 }
 
 void row_cache::on_row_hit() {
@@ -463,6 +542,13 @@ void row_cache::on_static_row_insert() {
     ++_tracker._stats.static_row_insertions;
 }
 
+bool row_cache::should_admit(const dht::decorated_key& dk) noexcept {
+    if (!_schema->caching_options().frequency_admission()) {
+        return true;
+    }
+    return _tracker.admit(dk.token());
+}
+
 class range_populating_reader {
     row_cache& _cache;
     autoupdating_underlying_reader& _reader;
@@ -517,10 +603,16 @@ class range_populating_reader {
                         return make_ready_future<read_result>(read_result(std::nullopt, std::nullopt));
                     });
                 }
-                _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                _cache.on_partition_miss(key.token());
+                if (!_cache.should_admit(key)) {
+                    // Not inserting the entry breaks continuity with the
+                    // previous one, the next population will detect that.
+                    _last_key = row_cache::previous_entry_pointer(key);
+                    return make_ready_future<read_result>(
+                            read_result(read_directly_from_underlying(_read_context), std::move(mfopt)));
+                } else if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
                                                                this->can_set_continuity() ? &*_last_key : nullptr);
@@ -570,7 +662,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader::impl {
 private:
     flat_mutation_reader read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce);
         return ce.read(_cache, *_read_context);
     }
 
@@ -745,13 +837,16 @@ row_cache::make_reader(schema_ptr s,
             if (hint.match) {
                 cache_entry& e = *i;
                 upgrade_entry(e);
-                on_partition_hit();
+                on_partition_hit(e);
+                if (_schema->caching_options().frequency_admission()) {
+                    _tracker.record_access(e.key().token());
+                }
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return make_empty_flat_reader(std::move(s), std::move(permit));
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
-                on_partition_miss();
+                on_partition_miss(pos.token());
                 return make_flat_mutation_reader<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -773,22 +868,319 @@ row_cache::make_reader(schema_ptr s,
     }
 }
 
+// Reads a partition in reverse from a cache snapshot, and the ranges which
+// the snapshot turned out not to have from the underlying reversed source.
+class reversed_cache_reader final : public flat_mutation_reader::impl {
+    partition_snapshot_reversing_reader& _cache_reader;
+    flat_mutation_reader _reader;
+    mutation_source _underlying;
+    const dht::partition_range& _range;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    tracing::trace_state_ptr _trace_state;
+    // Owned here since the underlying reader keeps a reference to it.
+    std::optional<query::partition_slice> _underlying_slice;
+    bool _reading_underlying = false;
+private:
+    future<> switch_to_underlying() {
+        tracing::trace(_trace_state, "Reading the rest of the partition in reverse from the underlying source");
+        _underlying_slice.emplace(_cache_reader.remaining_ranges(), _slice.static_columns, _slice.regular_columns, _slice.options,
+                nullptr, _slice.cql_format(), _slice.partition_row_limit());
+        auto rd = _underlying.make_reader(_schema, _permit, _range, *_underlying_slice, _pc, _trace_state,
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+        auto cache_rd = std::exchange(_reader, std::move(rd));
+        _reading_underlying = true;
+        return cache_rd.close();
+    }
+public:
+    reversed_cache_reader(schema_ptr s, reader_permit permit, std::unique_ptr<partition_snapshot_reversing_reader> cache_reader,
+            mutation_source underlying, const dht::partition_range& range, const query::partition_slice& slice,
+            const io_priority_class& pc, tracing::trace_state_ptr trace_state)
+        : impl(s, permit)
+        , _cache_reader(*cache_reader)
+        , _reader(std::move(cache_reader))
+        , _underlying(std::move(underlying))
+        , _range(range)
+        , _slice(slice)
+        , _pc(pc)
+        , _trace_state(std::move(trace_state))
+    {
+        _reader.upgrade_schema(std::move(s));
+    }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            if (_reader.is_buffer_empty()) {
+                if (!_reader.is_end_of_stream()) {
+                    co_await _reader.fill_buffer(timeout);
+                } else if (_reading_underlying) {
+                    // The underlying source has no partition_end to give
+                    // if it has no data in the remaining ranges.
+                    push_mutation_fragment(*_schema, _permit, partition_end());
+                    _end_of_stream = true;
+                } else if (_cache_reader.discontinuous()) {
+                    co_await switch_to_underlying();
+                } else {
+                    _end_of_stream = true;
+                }
+                continue;
+            }
+            auto mf = _reader.pop_mutation_fragment();
+            if (_reading_underlying && (mf.is_partition_start() || mf.is_static_row() || mf.is_end_of_partition())) {
+                continue;
+            }
+            push_mutation_fragment(std::move(mf));
+        }
+    }
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another partition.");
+    };
+    virtual future<> fast_forward_to(position_range cr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another position.");
+    };
+    virtual future<> close() noexcept override {
+        return _reader.close();
+    }
+};
+
+// Reads a partition missing in cache in reverse from the underlying reversed
+// source and populates the cache with what was read once the reader is closed.
+//
+// Forward reads populate the cache as they go, in cache_flat_mutation_reader,
+// which only knows how to extend continuity in forward order. Here the
+// fragments are collected into a mutation_partition instead, up to
+// max_size bytes, and inserted as a new entry which is continuous over
+// the part of the slice which was read.
+class reversed_populating_reader final : public flat_mutation_reader::impl {
+    row_cache& _cache;
+    flat_mutation_reader _reader;
+    dht::decorated_key _key;
+    const query::partition_slice& _slice;
+    row_cache::phase_type _phase;
+    size_t _max_size;
+    size_t _size = 0;
+    // Disengaged once the partition turned out to be too large to be populated.
+    std::optional<mutation_partition> _data;
+    // The position above which everything in the slice was read.
+    std::optional<position_in_partition> _last_pos;
+    bool _partition_found = false;
+    bool _static_row_read = false;
+    bool _read_all = false;
+private:
+    void record(const mutation_fragment& mf) {
+        if (!_data) {
+            return;
+        }
+        _size += mf.memory_usage();
+        if (_size > _max_size) {
+            _data.reset();
+            return;
+        }
+        if (mf.is_partition_start()) {
+            _partition_found = true;
+        } else {
+            _static_row_read = true;
+        }
+        if (mf.is_clustering_row()) {
+            _last_pos = position_in_partition(mf.position());
+        } else if (mf.is_range_tombstone()) {
+            _last_pos = position_in_partition(mf.as_range_tombstone().end_position());
+        }
+        _data->apply(*_schema, mf);
+    }
+
+    void mark_continuity() {
+        const schema& s = *_schema;
+        position_in_partition::less_compare less(s);
+        _data->set_continuity(s, position_range::all_clustered_rows(), is_continuous::no);
+        for (auto&& r : query::clustering_key_filter_ranges::get_ranges(s, _slice, _key.key())) {
+            auto pr = position_range(r);
+            if (_read_all || (_last_pos && less(*_last_pos, pr.start()))) {
+                _data->set_continuity(s, pr, is_continuous::yes);
+            } else if (_last_pos && less(*_last_pos, pr.end())) {
+                _data->set_continuity(s, position_range(*_last_pos, pr.end()), is_continuous::yes);
+            }
+        }
+        _data->set_static_row_continuous(_static_row_read || !s.has_static_columns());
+        _data->ensure_last_dummy(s);
+    }
+
+    void populate() {
+        if (!_data || (!_partition_found && !_read_all)) {
+            return;
+        }
+        if (_phase != _cache.phase_of(_key)) {
+            _cache.on_mispopulate();
+            return;
+        }
+        if (!_partition_found) {
+            _cache._read_section(_cache._tracker.region(), [this] {
+                _cache.find_or_create_missing(_key);
+            });
+            return;
+        }
+        mark_continuity();
+        _cache._populate_section(_cache._tracker.region(), [this] {
+            _cache.do_find_or_create_entry(_key, nullptr, [this] (auto i, const row_cache::partitions_type::bound_hint& hint) {
+                auto entry = _cache._partitions.emplace_before(i, _key.token().raw(), hint, _schema, _key, *_data);
+                _cache._tracker.insert(*entry);
+                entry->set_continuous(i->continuous());
+                _cache.upgrade_entry(*entry);
+                return entry;
+            }, [this] (auto) {
+                // Populated by a concurrent read.
+                _cache._tracker.on_miss_already_populated();
+            });
+        });
+    }
+public:
+    reversed_populating_reader(row_cache& cache, schema_ptr s, reader_permit permit, flat_mutation_reader reader,
+            dht::decorated_key key, const query::partition_slice& slice, row_cache::phase_type phase, size_t max_size)
+        : impl(s, std::move(permit))
+        , _cache(cache)
+        , _reader(std::move(reader))
+        , _key(std::move(key))
+        , _slice(slice)
+        , _phase(phase)
+        , _max_size(max_size)
+        , _data(std::in_place, s)
+    { }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            if (_reader.is_buffer_empty()) {
+                if (_reader.is_end_of_stream()) {
+                    _read_all = true;
+                    _end_of_stream = true;
+                } else {
+                    co_await _reader.fill_buffer(timeout);
+                }
+                continue;
+            }
+            auto mf = _reader.pop_mutation_fragment();
+            record(mf);
+            push_mutation_fragment(std::move(mf));
+        }
+    }
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another partition.");
+    };
+    virtual future<> fast_forward_to(position_range cr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another position.");
+    };
+    virtual future<> close() noexcept override {
+        try {
+            populate();
+        } catch (...) {
+            clogger.warn("Failed to populate cache from a reversed read of {}: {}", _key, std::current_exception());
+        }
+        return _reader.close();
+    }
+};
+
+flat_mutation_reader
+row_cache::make_reversed_reader(schema_ptr s,
+                                reader_permit permit,
+                                const dht::partition_range& range,
+                                const query::partition_slice& slice,
+                                const io_priority_class& pc,
+                                tracing::trace_state_ptr trace_state,
+                                mutation_source reversed_underlying,
+                                size_t max_populate_size)
+{
+    assert(query::is_single_partition(range));
+    tracing::trace(trace_state, "Querying cache in reverse for range {} and slice {}",
+            range, seastar::value_of([&slice] { return slice.get_all_ranges(); }));
+    bool absent = false;
+    bool missing = false;
+    phase_type phase = 0;
+    std::optional<dht::decorated_key> key;
+    auto snp = _read_section(_tracker.region(), [&] () -> partition_snapshot_ptr {
+        absent = false;
+        missing = false;
+        dht::ring_position_comparator cmp(*_schema);
+        auto&& pos = range.start()->value();
+        phase = phase_of(pos);
+        partitions_type::bound_hint hint;
+        auto i = _partitions.lower_bound(pos, cmp, hint);
+        if (!hint.match) {
+            absent = i->continuous();
+            if (!absent) {
+                missing = true;
+                on_partition_miss(pos.token());
+            }
+            return { };
+        }
+        cache_entry& e = *i;
+        upgrade_entry(e);
+        auto snp = e.partition().read(_tracker.region(), _tracker.cleaner(), e.schema(), &_tracker, phase_of(pos));
+        if (!snp->static_row_continuous()) {
+            on_partition_miss(pos.token());
+            return { };
+        }
+        on_partition_hit(e);
+        if (_schema->caching_options().frequency_admission()) {
+            _tracker.record_access(e.key().token());
+        }
+        key = e.key();
+        return snp;
+    });
+    if (absent) {
+        return make_empty_flat_reader(std::move(s), std::move(permit));
+    }
+    if (!snp) {
+        tracing::trace(trace_state, "Range {} not found in cache", range);
+        auto rd = reversed_underlying.make_reader(s, permit, range, slice, pc, std::move(trace_state),
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+        auto dk = range.start()->value().as_decorated_key();
+        // Entries which are in cache but incomplete are filled by forward reads.
+        if (!missing || !should_admit(dk)) {
+            return rd;
+        }
+        return make_flat_mutation_reader<reversed_populating_reader>(*this, std::move(s), std::move(permit), std::move(rd),
+                std::move(dk), slice, phase, max_populate_size);
+    }
+    auto snp_schema = snp->schema();
+    auto ckr = query::clustering_key_filter_ranges::get_ranges(*snp_schema, slice, key->key());
+    bool digest_requested = slice.options.contains<query::partition_slice::option::with_digest>();
+    auto cache_reader = std::make_unique<partition_snapshot_reversing_reader>(snp_schema, permit, std::move(*key), std::move(snp),
+            std::move(ckr), digest_requested, _tracker.region(), _read_section, boost::any(), true);
+    return make_flat_mutation_reader<reversed_cache_reader>(std::move(s), std::move(permit), std::move(cache_reader),
+            std::move(reversed_underlying), range, slice, pc, std::move(trace_state));
+}
 
 row_cache::~row_cache() {
     with_allocator(_tracker.allocator(), [this] {
         _partitions.clear_and_dispose([this] (cache_entry* p) mutable noexcept {
             if (!p->is_dummy_entry()) {
-                _tracker.on_partition_erase();
+                _tracker.on_partition_erase(*p);
             }
             p->evict(_tracker);
         });
     });
+    if (_schema) {
+        _tracker.drop_profiler(_schema->id());
+    }
 }
 
 void row_cache::clear_now() noexcept {
     with_allocator(_tracker.allocator(), [this] {
         auto it = _partitions.erase_and_dispose(_partitions.begin(), partitions_end(), [this] (cache_entry* p) noexcept {
-            _tracker.on_partition_erase();
+            _tracker.on_partition_erase(*p);
             p->evict(_tracker);
         });
         _tracker.clear_continuity(*it);
@@ -1102,7 +1494,7 @@ void row_cache::invalidate_locked(const dht::decorated_key& dk) {
     } else {
         auto it = pos.erase_and_dispose(dht::raw_token_less_comparator{},
             [this](cache_entry* p) mutable noexcept {
-                _tracker.on_partition_erase();
+                _tracker.on_partition_erase(*p);
                 p->evict(_tracker);
             });
         _tracker.clear_continuity(*it);
@@ -1139,7 +1531,7 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
                             while (it != end) {
                                 it = it.erase_and_dispose(dht::raw_token_less_comparator{},
                                     [&] (cache_entry* p) mutable noexcept {
-                                        _tracker.on_partition_erase();
+                                        _tracker.on_partition_erase(*p);
                                         p->evict(_tracker);
                                     });
                                 // it != end is necessary for correctness. We cannot set _prev_snapshot_pos to end->position()
@@ -1186,6 +1578,7 @@ row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker,
         entry.set_continuous(bool(cont));
         _partitions.insert(entry.position().token().raw(), std::move(entry), dht::ring_position_comparator{*_schema});
     });
+    _tracker.add_profiler(_schema->id());
 }
 
 cache_entry::cache_entry(cache_entry&& o) noexcept
@@ -1199,6 +1592,45 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
 cache_entry::~cache_entry() {
 }
 
+size_t cache_entry::size_in_allocator(allocation_strategy& allocator) {
+    auto size = row_cache::partitions_type::estimated_object_memory_size_in_allocator(allocator, this)
+            + _key.key().external_memory_usage();
+    for (auto&& v : _pe.versions()) {
+        size += v.size_in_allocator(*_schema, allocator);
+    }
+    return size;
+}
+
+size_t cache_entry::estimated_size_in_allocator(allocation_strategy& allocator) {
+    // Measuring every row of a large partition would stall the read.
+    constexpr size_t max_measured_rows = 128;
+    // Partitions with more rows are underestimated.
+    constexpr size_t max_counted_rows = 16 * 1024;
+    auto size = row_cache::partitions_type::estimated_object_memory_size_in_allocator(allocator, this)
+            + _key.key().external_memory_usage();
+    for (auto&& v : _pe.versions()) {
+        auto& p = v.partition();
+        size += allocator.object_memory_size_in_allocator(&v)
+                + p.static_row().external_memory_usage(*_schema, column_kind::static_column);
+        size_t measured = 0;
+        size_t measured_size = 0;
+        size_t counted = 0;
+        for (auto& row : p.clustered_rows()) {
+            if (measured < max_measured_rows) {
+                measured_size += row.memory_usage(*_schema);
+                ++measured;
+            }
+            if (++counted == max_counted_rows) {
+                break;
+            }
+        }
+        if (measured) {
+            size += measured_size * counted / measured;
+        }
+    }
+    return size;
+}
+
 void cache_entry::evict(cache_tracker& tracker) noexcept {
     _pe.evict(tracker.cleaner());
 }
@@ -1211,7 +1643,7 @@ void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
     row_cache::partitions_type::iterator it(this);
     std::next(it)->set_continuous(false);
     evict(tracker);
-    tracker.on_partition_eviction();
+    tracker.on_partition_eviction(*this);
     it.erase(dht::raw_token_less_comparator{});
 }
 
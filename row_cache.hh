@@ -37,6 +37,8 @@
 #include <seastar/core/metrics_registration.hh>
 #include "mutation_cleaner.hh"
 #include "utils/double-decker.hh"
+#include "utils/frequency_sketch.hh"
+#include "cache_profiler.hh"
 
 namespace bi = boost::intrusive;
 
@@ -144,6 +146,11 @@ class cache_entry {
     flat_mutation_reader read(row_cache&, std::unique_ptr<cache::read_context>);
     flat_mutation_reader read(row_cache&, cache::read_context&, utils::phased_barrier::phase_type);
     flat_mutation_reader read(row_cache&, std::unique_ptr<cache::read_context>, utils::phased_barrier::phase_type);
+    // Memory footprint of this entry, including all partition versions.
+    size_t size_in_allocator(allocation_strategy&);
+    // Cheaper estimate of size_in_allocator(), which measures a bounded
+    // number of rows of each version and extrapolates from the row count.
+    size_t estimated_size_in_allocator(allocation_strategy&);
     bool continuous() const noexcept { return _flags._continuous; }
     void set_continuous(bool value) noexcept { _flags._continuous = value; }
 
@@ -188,6 +195,8 @@ class cache_tracker final {
         uint64_t reads_with_misses;
         uint64_t reads_done;
         uint64_t pinned_dirty_memory_overload;
+        uint64_t population_admissions;
+        uint64_t population_rejections;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -200,8 +209,20 @@ class cache_tracker final {
     lru_type _lru;
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
+    // Access frequencies of partitions of tables with frequency-based
+    // cache admission, see row_cache::should_admit().
+    utils::frequency_sketch _admission_sketch{admission_sketch_width};
+    uint64_t _row_evictions_at_last_aging = 0;
+    // Per-table cache profilers, keyed by table id. Owned here rather than
+    // by row_cache so that eviction, which only knows the tracker, can find them.
+    std::unordered_map<utils::UUID, cache_profiler> _profilers;
 private:
     void setup_metrics();
+public:
+    static constexpr size_t admission_sketch_width = 64 * 1024;
+    // Minimum estimated number of recent reads of a missing partition
+    // for it to be admitted into a full cache.
+    static constexpr unsigned admission_threshold = 2;
 public:
     cache_tracker(mutation_application_stats&);
     cache_tracker();
@@ -214,11 +235,11 @@ class cache_tracker final {
     void insert(rows_entry&) noexcept;
     void on_remove(rows_entry&) noexcept;
     void clear_continuity(cache_entry& ce) noexcept;
-    void on_partition_erase() noexcept;
+    void on_partition_erase(const cache_entry&) noexcept;
     void on_partition_merge() noexcept;
     void on_partition_hit() noexcept;
     void on_partition_miss() noexcept;
-    void on_partition_eviction() noexcept;
+    void on_partition_eviction(const cache_entry&) noexcept;
     void on_row_eviction() noexcept;
     void on_row_hit() noexcept;
     void on_dummy_row_hit() noexcept;
@@ -228,6 +249,21 @@ class cache_tracker final {
     void on_row_processed_from_memtable() noexcept { ++_stats.rows_processed_from_memtable; }
     void on_row_dropped_from_memtable() noexcept { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
+    // Creates the profiler of the given table, if it doesn't exist yet.
+    // May allocate, so profilers are created along with the table's cache
+    // rather than on first use, which can be in eviction.
+    void add_profiler(const utils::UUID& table_id);
+    // Returns the profiler of the given table, or nullptr if there is none.
+    // Doesn't allocate.
+    cache_profiler* profiler_for(const utils::UUID& table_id) noexcept;
+    // Returns the cache profile of the given table on this shard.
+    cache_profile get_profile(const utils::UUID& table_id) const;
+    void drop_profiler(const utils::UUID& table_id) noexcept;
+    // Records a read of the partition with the given token in the admission sketch.
+    void record_access(dht::token) noexcept;
+    // Records a read of a partition missing in cache and decides whether it
+    // should be populated.
+    bool admit(dht::token) noexcept;
     void pinned_dirty_memory_overload(uint64_t bytes) noexcept;
     allocation_strategy& allocator() noexcept;
     logalloc::region& region() noexcept;
@@ -381,12 +417,20 @@ class row_cache final {
     logalloc::allocating_section _read_section;
     flat_mutation_reader create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
-    void on_partition_hit();
-    void on_partition_miss();
+    void on_partition_hit(cache_entry&);
+    void on_partition_miss(dht::token);
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
     void on_mispopulate();
+    // Decides whether a partition missing in cache should be populated
+    // by the read which missed it.
+    //
+    // Tables with frequency admission enabled in their caching options
+    // only admit partitions which were read repeatedly in the recent past
+    // once the cache is full, so that one-off scans don't evict the working set.
+    // Other tables admit everything.
+    bool should_admit(const dht::decorated_key&) noexcept;
     void upgrade_entry(cache_entry&);
     void invalidate_locked(const dht::decorated_key&);
     void clear_now() noexcept;
@@ -497,6 +541,24 @@ class row_cache final {
         return make_reader(std::move(s), std::move(permit), range, full_slice);
     }
 
+    // Reads a single partition in reverse clustering order, in the format of
+    // make_reversing_reader(). What the cache doesn't have is read from
+    // reversed_underlying, which must produce the same format.
+    //
+    // A partition missing in cache is populated with what was read once the
+    // reader is closed, unless it takes more than max_populate_size bytes.
+    // Partitions which are in cache but incomplete are not populated.
+    // User needs to ensure that the row_cache object stays alive
+    // as long as the reader is used.
+    flat_mutation_reader make_reversed_reader(schema_ptr,
+                                              reader_permit permit,
+                                              const dht::partition_range&,
+                                              const query::partition_slice&,
+                                              const io_priority_class&,
+                                              tracing::trace_state_ptr trace_state,
+                                              mutation_source reversed_underlying,
+                                              size_t max_populate_size);
+
     const stats& stats() const { return _stats; }
 public:
     // Populate cache from given mutation, which must be fully continuous.
@@ -565,6 +627,9 @@ class row_cache final {
     void set_schema(schema_ptr) noexcept;
     const schema_ptr& schema() const;
 
+    // Returns sampled statistics of this cache, split by partition size.
+    cache_profile get_profile() const;
+
     friend std::ostream& operator<<(std::ostream&, row_cache&);
 
     friend class just_cache_scanning_reader;
@@ -572,6 +637,7 @@ class row_cache final {
     friend class range_populating_reader;
     friend class cache_tracker;
     friend class mark_end_as_continuous;
+    friend class reversed_populating_reader;
 };
 
 namespace cache {
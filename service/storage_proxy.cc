@@ -2596,6 +2596,33 @@ future<> storage_proxy::send_to_endpoint(
             allow_hints);
 }
 
+future<> storage_proxy::send_view_update_batch(gms::inet_address target, std::vector<frozen_mutation> fms, tracing::trace_state_ptr tr_state) {
+    // Same near-infinite timeout as send_to_endpoint() uses for views
+    auto timeout = clock_type::now() + 5min;
+    return _messaging.send_view_update_batch(netw::messaging_service::msg_addr{target, 0}, timeout, std::move(fms), tracing::make_trace_info(tr_state)).then([this, target] (db::view::update_backlog backlog) {
+        got_view_update_batch_response(target, backlog);
+    });
+}
+
+void storage_proxy::got_view_update_batch_response(gms::inet_address from, db::view::update_backlog backlog) {
+    maybe_update_view_backlog_of(from, backlog);
+}
+
+future<db::view::update_backlog> storage_proxy::apply_view_update_batch(netw::msg_addr from, std::vector<frozen_mutation> fms,
+        clock_type::time_point timeout, tracing::trace_state_ptr tr_state, migration_manager& mm) {
+    return do_with(std::move(fms), std::move(tr_state), [this, from, timeout, &mm] (std::vector<frozen_mutation>& fms, tracing::trace_state_ptr& tr_state) {
+        return parallel_for_each(fms, [this, from, timeout, &tr_state, &mm] (const frozen_mutation& fm) {
+            return mm.get_schema_for_write(fm.schema_version(), from, _messaging).then([this, &fm, timeout, &tr_state] (schema_ptr s) {
+                ++get_stats().received_mutations;
+                return mutate_locally(std::move(s), fm, tr_state, db::commitlog::force_sync::no, timeout);
+            });
+        });
+    }).then([this] {
+        // The reply lets the sender throttle view updates by our backlog.
+        return get_view_update_backlog();
+    });
+}
+
 future<> storage_proxy::send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target) {
     if (!_features.cluster_supports_hinted_handoff_separate_connection()) {
         return send_to_endpoint(
@@ -2618,6 +2645,14 @@ future<> storage_proxy::send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s,
             allow_hints::no);
 }
 
+future<db::view::update_backlog> storage_proxy::send_hint_batch_to_endpoint(std::vector<frozen_mutation> fms, gms::inet_address target) {
+    auto timeout = clock_type::now() + std::chrono::milliseconds(_db.local().get_config().write_request_timeout_in_ms());
+    return _messaging.send_hint_mutation_batch(netw::messaging_service::msg_addr{target, 0}, timeout, std::move(fms)).then([this, target] (db::view::update_backlog backlog) {
+        maybe_update_view_backlog_of(target, backlog);
+        return backlog;
+    });
+}
+
 future<> storage_proxy::send_hint_to_all_replicas(frozen_mutation_and_schema fm_a_s) {
     if (!_features.cluster_supports_hinted_handoff_separate_connection()) {
         std::array<mutation, 1> ms{fm_a_s.fm.unfreeze(fm_a_s.s)};
@@ -4800,6 +4835,20 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
         });
     });
 
+    ms.register_view_update_batch([mm] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms, std::optional<tracing::trace_info> trace_info) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+
+        tracing::trace_state_ptr trace_state_ptr;
+        if (trace_info) {
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(*trace_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "Message received from /{}", src_addr.addr);
+        }
+
+        auto timeout = t ? *t : clock_type::time_point::max();
+        return get_local_shared_storage_proxy()->apply_view_update_batch(src_addr, std::move(fms), timeout, std::move(trace_state_ptr), *mm);
+    });
+
     static auto handle_write = [] (netw::messaging_service::msg_addr src_addr, service::migration_manager& mm, rpc::opt_time_point t,
                       utils::UUID schema_version, auto in, std::vector<gms::inet_address> forward, gms::inet_address reply_to,
                       unsigned shard, storage_proxy::response_id_type response_id, std::optional<tracing::trace_info> trace_info,
@@ -4919,6 +4968,21 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
     };
     ms.register_mutation(std::bind_front<>(receive_mutation_handler, mm, _write_smp_service_group));
     ms.register_hint_mutation(std::bind_front<>(receive_mutation_handler, mm, _hints_write_smp_service_group));
+    ms.register_hint_mutation_batch([&ms, mm, smp_grp = _hints_write_smp_service_group] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        auto timeout = t ? *t : clock_type::time_point::max();
+        return do_with(std::move(fms), [src_addr, timeout, smp_grp, &ms, mm] (std::vector<frozen_mutation>& fms) {
+            return parallel_for_each(fms, [src_addr, timeout, smp_grp, &ms, mm] (const frozen_mutation& fm) {
+                return mm->get_schema_for_write(fm.schema_version(), src_addr, ms).then([&fm, timeout, smp_grp] (schema_ptr s) {
+                    auto sp = get_local_shared_storage_proxy();
+                    ++sp->get_stats().received_mutations;
+                    return sp->mutate_locally(std::move(s), fm, nullptr, db::commitlog::force_sync::no, timeout, smp_grp);
+                });
+            });
+        }).then([] {
+            return get_local_shared_storage_proxy()->get_view_update_backlog();
+        });
+    });
 
     ms.register_paxos_learn([mm] (const rpc::client_info& cinfo, rpc::opt_time_point t, paxos::proposal decision,
             std::vector<gms::inet_address> forward, gms::inet_address reply_to, unsigned shard,
@@ -5173,8 +5237,10 @@ future<> storage_proxy::uninit_messaging_service() {
     auto& ms = _messaging;
     return when_all_succeed(
         ms.unregister_counter_mutation(),
+        ms.unregister_view_update_batch(),
         ms.unregister_mutation(),
         ms.unregister_hint_mutation(),
+        ms.unregister_hint_mutation_batch(),
         ms.unregister_mutation_done(),
         ms.unregister_mutation_failed(),
         ms.unregister_read_data(),
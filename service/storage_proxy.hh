@@ -67,6 +67,7 @@
 #include "locator/token_metadata.hh"
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
+#include "message/msg_addr.hh"
 
 class reconcilable_result;
 class frozen_mutation_and_schema;
@@ -432,12 +433,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             write_stats& stats,
             allow_hints allow_hints = allow_hints::yes);
 
-    db::view::update_backlog get_view_update_backlog() const;
-
     void maybe_update_view_backlog_of(gms::inet_address, std::optional<db::view::update_backlog>);
 
-    db::view::update_backlog get_backlog_of(gms::inet_address) const;
-
     template<typename Range>
     future<> mutate_counters(Range&& mutations, db::consistency_level cl, tracing::trace_state_ptr tr_state, service_permit permit, clock_type::time_point timeout);
 
@@ -559,11 +556,30 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<> send_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target, inet_address_vector_topology_change pending_endpoints, db::write_type type,
             tracing::trace_state_ptr tr_state, allow_hints allow_hints = allow_hints::yes);
 
+    // Send a batch of view updates to a single paired view replica in one
+    // message. The replica acknowledges once it applied all of them. Unlike
+    // send_to_endpoint(), no hints are written on failure, so the caller is
+    // expected to fall back to sending the updates one by one.
+    future<> send_view_update_batch(gms::inet_address target, std::vector<frozen_mutation> fms, tracing::trace_state_ptr tr_state);
+    void got_view_update_batch_response(gms::inet_address from, db::view::update_backlog backlog);
+    // The view update backlog of this node, as reported to other replicas.
+    db::view::update_backlog get_view_update_backlog() const;
+    // The view update backlog last reported by the replica.
+    db::view::update_backlog get_backlog_of(gms::inet_address) const;
+    // Applies the view updates of a VIEW_UPDATE_BATCH message and returns the backlog to reply with.
+    future<db::view::update_backlog> apply_view_update_batch(netw::msg_addr from, std::vector<frozen_mutation> fms,
+            clock_type::time_point timeout, tracing::trace_state_ptr tr_state, migration_manager& mm);
+
     // Send a mutation to a specific remote target as a hint.
     // Unlike regular mutations during write operations, hints are sent on the streaming connection
     // and use different RPC verb.
     future<> send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target);
 
+    // Send a batch of hints to a target which is a replica of all of them, in
+    // one message. Resolves to the view update backlog of the target, once it
+    // applied all of them.
+    future<db::view::update_backlog> send_hint_batch_to_endpoint(std::vector<frozen_mutation> fms, gms::inet_address target);
+
     /**
      * Performs the truncate operatoin, which effectively deletes all data from
      * the column family cfname
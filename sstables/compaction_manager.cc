@@ -391,6 +391,8 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the number of compaction tasks waiting for an opportunity to run.")),
         sm::make_gauge("backlog", [this] { return _last_backlog; },
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
+        sm::make_derive("tombstone_purges", [this] { return _stats.completed_tombstone_purges; },
+                       sm::description("Holds the number of completed compactions run to purge droppable tombstones.")),
     });
 }
 
@@ -411,6 +413,7 @@ std::function<void()> compaction_manager::compaction_submission_callback() {
     return [this] () mutable {
         for (auto& e: _compaction_locks) {
             submit(e.first);
+            submit_tombstone_purge(e.first);
         }
     };
 }
@@ -618,6 +621,61 @@ void compaction_manager::submit(column_family* cf) {
     });
 }
 
+void compaction_manager::submit_tombstone_purge(column_family* cf) {
+    if (cf->is_auto_compaction_disabled_by_user()) {
+        return;
+    }
+
+    auto task = make_lw_shared<compaction_manager::task>();
+    task->compacting_cf = cf;
+    _tasks.push_back(task);
+    _stats.pending_tasks++;
+
+    task->compaction_done = with_lock(_compaction_locks[cf].for_read(), [this, task, cf] () mutable {
+      return with_scheduling_group(_scheduling_group, [this, task, cf] () mutable {
+        _stats.pending_tasks--;
+        if (!can_proceed(task) || cf->is_auto_compaction_disabled_by_user()) {
+            return make_ready_future<>();
+        }
+        sstables::compaction_strategy cs = cf->get_compaction_strategy();
+        sstables::compaction_descriptor descriptor = cs.get_tombstone_purge_job(*cf, get_candidates(*cf));
+        if (descriptor.sstables.empty()) {
+            return make_ready_future<>();
+        }
+        int weight = calculate_weight(descriptor.sstables);
+        // Not postponed, the purge is reconsidered at the next periodic submission.
+        if (!can_register_weight(cf, weight)) {
+            cmlog.debug("Refused tombstone purge job ({} sstable(s)) of weight {} for {}.{}",
+                descriptor.sstables.size(), weight, cf->schema()->ks_name(), cf->schema()->cf_name());
+            return make_ready_future<>();
+        }
+        auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
+        auto weight_r = compaction_weight_registration(this, weight);
+        descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
+            compacting->release_compacting(exhausted_sstables);
+        };
+        cmlog.debug("Accepted tombstone purge job ({} sstable(s)) of weight {} for {}.{}",
+            descriptor.sstables.size(), weight, cf->schema()->ks_name(), cf->schema()->cf_name());
+
+        _stats.active_tasks++;
+        task->compaction_running = true;
+        return cf->run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting = std::move(compacting), weight_r = std::move(weight_r)] (future<> f) mutable {
+            _stats.active_tasks--;
+            task->compaction_running = false;
+            if (f.failed()) {
+                _stats.errors++;
+                maybe_stop_on_error(std::move(f), stop_iteration::yes);
+                return;
+            }
+            _stats.completed_tasks++;
+            _stats.completed_tombstone_purges++;
+        });
+      });
+    }).finally([this, task] {
+        _tasks.remove(task);
+    });
+}
+
 void compaction_manager::submit_offstrategy(column_family* cf) {
     auto task = make_lw_shared<compaction_manager::task>();
     task->compacting_cf = cf;
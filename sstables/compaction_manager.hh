@@ -56,6 +56,7 @@ class compaction_manager {
         int64_t completed_tasks = 0;
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
+        int64_t completed_tombstone_purges = 0;
     };
 private:
     struct task {
@@ -194,6 +195,12 @@ class compaction_manager {
     // Submit a column family to be compacted.
     void submit(column_family* cf);
 
+    // Submit a column family for a single compaction purging droppable tombstones,
+    // picked by compaction_strategy::get_tombstone_purge_job(). Called periodically
+    // for all column families, since tombstones become droppable as time passes
+    // rather than as a result of writes.
+    void submit_tombstone_purge(column_family* cf);
+
     // Submit a column family to be off-strategy compacted.
     void submit_offstrategy(column_family* cf);
 
@@ -82,6 +82,52 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+shared_sstable compaction_strategy_impl::get_tombstone_purge_target(const schema& s, const std::vector<sstables::shared_sstable>& candidates) {
+    auto gc_before = gc_clock::now() - s.gc_grace_seconds();
+
+    shared_sstable target;
+    double target_ratio = 0;
+    for (auto& sst : candidates) {
+        if (!worth_dropping_tombstones(sst, gc_before)) {
+            continue;
+        }
+        auto ratio = sst->estimate_droppable_tombstone_ratio(gc_before);
+        if (!target || ratio > target_ratio) {
+            target = sst;
+            target_ratio = ratio;
+        }
+    }
+    return target;
+}
+
+compaction_descriptor compaction_strategy_impl::get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    auto& s = *cf.schema();
+    auto target = get_tombstone_purge_target(s, candidates);
+    if (!target) {
+        return compaction_descriptor();
+    }
+
+    auto max_timestamp = target->get_stats_metadata().max_timestamp;
+    auto overlaps_target = [&] (const shared_sstable& sst) {
+        return sst->get_first_decorated_key().tri_compare(s, target->get_last_decorated_key()) <= 0
+            && target->get_first_decorated_key().tri_compare(s, sst->get_last_decorated_key()) <= 0;
+    };
+    auto e = boost::range::remove_if(candidates, [&] (const shared_sstable& sst) {
+        return sst == target || sst->get_stats_metadata().min_timestamp > max_timestamp || !overlaps_target(sst);
+    });
+    candidates.erase(e, candidates.end());
+    // Oldest sstables first, they are the most likely to hold shadowed data.
+    std::sort(candidates.begin(), candidates.end(), [] (const shared_sstable& i, const shared_sstable& j) {
+        return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
+    });
+    auto max_sstables = std::max(s.max_compaction_threshold(), 2) - 1;
+    if (candidates.size() > size_t(max_sstables)) {
+        candidates.resize(max_sstables);
+    }
+    candidates.push_back(std::move(target));
+    return compaction_descriptor(std::move(candidates), cf.get_sstable_set(), service::get_local_compaction_priority());
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
     return partition_estimate;
 }
@@ -639,6 +685,10 @@ compaction_descriptor compaction_strategy::get_major_compaction_job(column_famil
     return _compaction_strategy_impl->get_major_compaction_job(cf, std::move(candidates));
 }
 
+compaction_descriptor compaction_strategy::get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    return _compaction_strategy_impl->get_tombstone_purge_job(cf, std::move(candidates));
+}
+
 void compaction_strategy::notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) {
     _compaction_strategy_impl->notify_completion(removed, added);
 }
@@ -76,6 +76,16 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before);
 
+    // Returns a job purging the droppable tombstones of the candidate with the highest
+    // droppable tombstone ratio. Tombstones can only be purged when the data they may
+    // shadow is compacted with them, so the job also includes the overlapping candidates
+    // holding older data. Returns an empty descriptor if no candidate is worth it.
+    virtual compaction_descriptor get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates);
+
+    // Returns the candidate a tombstone purge job would be built around, or a null
+    // pointer if no candidate is worth it.
+    shared_sstable get_tombstone_purge_target(const schema& s, const std::vector<sstables::shared_sstable>& candidates);
+
     virtual compaction_backlog_tracker& get_backlog_tracker() = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate);
@@ -295,6 +295,11 @@ class date_tiered_compaction_strategy : public compaction_strategy_impl {
     date_tiered_compaction_strategy(const std::map<sstring, sstring>& options);
     virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) override;
 
+    // Merging overlapping sstables regardless of their age would mix the data of different tiers.
+    virtual compaction_descriptor get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) override {
+        return compaction_descriptor();
+    }
+
     virtual int64_t estimated_pending_compactions(column_family& cf) const override {
         return _manifest.get_estimated_tasks(cf);
     }
@@ -233,6 +233,7 @@ class promoted_index {
 
     [[nodiscard]] deletion_time get_deletion_time() const { return _del_time; }
     [[nodiscard]] uint32_t get_promoted_index_size() const { return _promoted_index_size; }
+    [[nodiscard]] uint32_t get_num_blocks() const { return _num_blocks; }
 
     std::unique_ptr<clustered_index_cursor> make_cursor(shared_sstable,
         reader_permit,
@@ -80,6 +80,10 @@ compaction_descriptor leveled_compaction_strategy::get_major_compaction_job(colu
                                  sst->get_sstable_level(), _max_sstable_size_in_mb*1024*1024);
 }
 
+compaction_descriptor leveled_compaction_strategy::get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    return compaction_descriptor();
+}
+
 void leveled_compaction_strategy::notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) {
     if (removed.empty() || added.empty()) {
         return;
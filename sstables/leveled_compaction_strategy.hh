@@ -57,6 +57,10 @@ class leveled_compaction_strategy : public compaction_strategy_impl {
 
     virtual compaction_descriptor get_major_compaction_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) override;
 
+    // Merging overlapping sstables from different levels would break the level invariant.
+    // Tombstones are purged in-level by get_sstables_for_compaction() instead.
+    virtual compaction_descriptor get_tombstone_purge_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) override;
+
     virtual void notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) override;
 
     // for each level > 0, get newest sstable and use its last key as last
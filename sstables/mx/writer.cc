@@ -27,9 +27,11 @@
 #include "vint-serialization.hh"
 #include "sstables/types.hh"
 #include "sstables/mx/types.hh"
+#include "sstables/repair_digest.hh"
 #include "db/config.hh"
 #include "atomic_cell.hh"
 #include "utils/exceptions.hh"
+#include "utils/bloom_filter.hh"
 
 #include <functional>
 #include <boost/iterator/iterator_facade.hpp>
@@ -606,6 +608,18 @@ class writer : public sstable_writer::writer_impl {
     utils::UUID _run_identifier;
     bool _write_regular_as_static; // See #4139
     scylla_metadata::large_data_stats _large_data_stats;
+    // The number of rows is not known up front, so the clustering key
+    // filter is a series of bloom filters, each twice as large as the
+    // previous one, and a new one is started when the last one is full.
+    // See sstable::make_clustering_key_filter_hash().
+    struct {
+        bool enabled = false;
+        bool partition_has_tombstones = false;
+        std::vector<utils::filter_ptr> filters;
+        uint64_t capacity = 0;
+        uint64_t keys = 0;
+    } _ck_filter;
+    repair_digest_builder _repair_digest;
 
     void init_file_writers();
 
@@ -741,6 +755,11 @@ class writer : public sstable_writer::writer_impl {
     void write_promoted_index();
     void consume(rt_marker&& marker);
 
+    void add_to_ck_filter(utils::hashed_key h);
+    void add_to_ck_filter(const clustering_key_prefix& ck);
+    void add_tombstones_to_ck_filter();
+    std::optional<scylla_metadata::clustering_key_filter> build_ck_filter();
+
     void flush_tmp_bufs(file_writer& writer) {
         for (auto&& buf : _tmp_bufs) {
             writer.write(buf);
@@ -764,6 +783,7 @@ class writer : public sstable_writer::writer_impl {
         , _sst_schema(make_sstable_schema(s, _enc_stats, _cfg))
         , _run_identifier(cfg.run_identifier)
         , _write_regular_as_static(s.is_static_compact_table())
+        , _repair_digest(s)
         , _large_data_stats({{
                 {
                     large_data_type::partition_size,
@@ -806,6 +826,10 @@ class writer : public sstable_writer::writer_impl {
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
         _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
         _pi_write_m.desired_block_size = cfg.promoted_index_block_size;
+        _ck_filter.enabled = cfg.clustering_key_filter && _schema.clustering_key_size()
+                && !_write_regular_as_static && _schema.bloom_filter_fp_chance() < 1.0;
+        // Every partition has at least one row, or is added by its key
+        _ck_filter.capacity = estimated_partitions;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
     }
@@ -1015,6 +1039,9 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _pi_write_m.first_clustering.reset();
     _pi_write_m.last_clustering.reset();
 
+    _ck_filter.partition_has_tombstones = false;
+    _repair_digest.consume_new_partition(dk);
+
     write(_sst.get_version(), *_data_writer, p_key);
     _partition_header_length = _data_writer->offset() - _c_stats.start_offset;
 
@@ -1031,10 +1058,60 @@ void writer::consume(tombstone t) {
 
     _pi_write_m.tomb = t;
     _tombstone_written = true;
+    _repair_digest.consume(t);
 
     if (t) {
         _collector.update_min_max_components(clustering_key_prefix::make_empty(_schema));
+        add_tombstones_to_ck_filter();
+    }
+}
+
+void writer::add_to_ck_filter(utils::hashed_key h) {
+    if (_ck_filter.filters.empty() || _ck_filter.keys == _ck_filter.capacity) {
+        if (!_ck_filter.filters.empty()) {
+            _ck_filter.capacity *= 2;
+        }
+        // Halve the false positive chance of every next filter, so that the
+        // chance of the whole series stays within the one of the schema.
+        // The smallest chance bloom_calculations can satisfy bounds it.
+        auto fp_chance = std::max(_schema.bloom_filter_fp_chance() / (uint64_t(2) << std::min(_ck_filter.filters.size(), size_t(32))),
+                utils::bloom_calculations::probs.back().back());
+        _ck_filter.filters.push_back(utils::i_filter::get_filter(_ck_filter.capacity, fp_chance, utils::filter_format::m_format));
+        _ck_filter.keys = 0;
+    }
+    _ck_filter.filters.back()->add(h);
+    ++_ck_filter.keys;
+}
+
+void writer::add_to_ck_filter(const clustering_key_prefix& ck) {
+    if (!_ck_filter.enabled || _ck_filter.partition_has_tombstones) {
+        return;
+    }
+    add_to_ck_filter(sstable::make_clustering_key_filter_hash(bytes_view(*_partition_key), ck));
+}
+
+void writer::add_tombstones_to_ck_filter() {
+    if (!_ck_filter.enabled || _ck_filter.partition_has_tombstones) {
+        return;
+    }
+    // Tombstones may cover rows absent from this sstable, so reads of this
+    // partition must not skip it. Rows of the partition which were already
+    // added don't matter.
+    _ck_filter.partition_has_tombstones = true;
+    add_to_ck_filter(utils::make_hashed_key(bytes_view(*_partition_key)));
+}
+
+std::optional<scylla_metadata::clustering_key_filter> writer::build_ck_filter() {
+    if (!_ck_filter.enabled || _ck_filter.filters.empty()) {
+        return std::nullopt;
+    }
+    scylla_metadata::clustering_key_filter ret;
+    for (auto& f : _ck_filter.filters) {
+        auto& bf = static_cast<utils::filter::murmur3_bloom_filter&>(*f);
+        ret.elements.emplace_back(bf.num_hashes(), bf.bits().get_storage());
     }
+    _ck_filter.filters.clear();
+    return ret;
 }
 
 void writer::maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size) {
@@ -1310,6 +1387,7 @@ void writer::write_static_row(const row& static_row, column_kind kind) {
 
 stop_iteration writer::consume(static_row&& sr) {
     ensure_tombstone_is_written();
+    _repair_digest.consume(sr);
     write_static_row(sr.cells(), column_kind::static_column);
     return stop_iteration::no;
 }
@@ -1361,12 +1439,14 @@ void writer::write_clustered(const clustering_row& clustered_row, uint64_t prev_
 }
 
 stop_iteration writer::consume(clustering_row&& cr) {
+    _repair_digest.consume(cr);
     if (_write_regular_as_static) {
         ensure_tombstone_is_written();
         write_static_row(cr.cells(), column_kind::regular_column);
         return stop_iteration::no;
     }
     drain_tombstones(position_in_partition_view::after_key(cr.key()));
+    add_to_ck_filter(cr.key());
     write_clustered(cr);
     return stop_iteration::no;
 }
@@ -1440,6 +1520,8 @@ void writer::consume(rt_marker&& marker) {
 }
 
 stop_iteration writer::consume(range_tombstone&& rt) {
+    add_tombstones_to_ck_filter();
+    _repair_digest.consume(rt);
     drain_tombstones(rt.position());
     _range_tombstones.apply(std::move(rt));
     return stop_iteration::no;
@@ -1499,7 +1581,8 @@ void writer::consume_end_of_stream() {
     auto features = sstable_enabled_features::all();
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(std::move(_large_data_stats));
-    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin, build_ck_filter());
+    _sst.write_repair_digest(_pc, std::move(_repair_digest).build());
     if (!_cfg.leave_unsealed) {
         _sst.seal_sstable(_cfg.backup).get();
     }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "repair_digest.hh"
+#include "mutation_fragment.hh"
+#include "atomic_cell_hash.hh"
+#include "xx_hasher.hh"
+
+namespace sstables {
+
+// Fixed, so that digests written by different nodes can be compared.
+static constexpr uint64_t repair_digest_seed = 0x7265706169726467;
+
+static constexpr uint64_t token_bias = uint64_t(1) << 63;
+
+uint32_t repair_digest_bucket_of(dht::token t, uint32_t bits) {
+    return (uint64_t(t.raw()) ^ token_bias) >> (64 - bits);
+}
+
+dht::token repair_digest_bucket_first_token(uint32_t index, uint32_t bits) {
+    return dht::token::from_int64(int64_t((uint64_t(index) << (64 - bits)) ^ token_bias));
+}
+
+dht::token repair_digest_bucket_last_token(uint32_t index, uint32_t bits) {
+    auto last = (uint64_t(index) << (64 - bits)) | ((uint64_t(1) << (64 - bits)) - 1);
+    return dht::token::from_int64(int64_t(last ^ token_bias));
+}
+
+repair_digest_builder::repair_digest_builder(const schema& s)
+    : _schema(s)
+    , _digest{repair_digest_bucket_bits, {}} {
+}
+
+void repair_digest_builder::add(uint64_t hash) {
+    _bucket->fragments++;
+    _bucket->sum += hash;
+}
+
+void repair_digest_builder::consume_new_partition(const dht::decorated_key& dk) {
+    xx_hasher h(repair_digest_seed);
+    feed_hash(h, dk.key(), _schema);
+    _partition_key_hash = h.finalize_uint64();
+
+    // Partitions are written in token order.
+    auto index = repair_digest_bucket_of(dk.token(), _digest.bucket_bits);
+    auto& buckets = _digest.buckets.elements;
+    if (buckets.empty() || buckets.back().index != index) {
+        buckets.push_back(repair_digest_bucket{index, 0, 0});
+    }
+    _bucket = &buckets.back();
+}
+
+void repair_digest_builder::consume(tombstone t) {
+    if (!t) {
+        return;
+    }
+    xx_hasher h(repair_digest_seed);
+    feed_hash(h, _partition_key_hash);
+    feed_hash(h, t);
+    add(h.finalize_uint64());
+}
+
+void repair_digest_builder::consume(const static_row& sr) {
+    xx_hasher h(repair_digest_seed);
+    feed_hash(h, _partition_key_hash);
+    sr.cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& cell) {
+        auto& col = _schema.static_column_at(id);
+        feed_hash(h, col.name());
+        feed_hash(h, cell, col);
+    });
+    add(h.finalize_uint64());
+}
+
+void repair_digest_builder::consume(const clustering_row& cr) {
+    xx_hasher h(repair_digest_seed);
+    feed_hash(h, _partition_key_hash);
+    feed_hash(h, cr.key(), _schema);
+    feed_hash(h, cr.tomb());
+    feed_hash(h, cr.marker());
+    cr.cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& cell) {
+        auto& col = _schema.regular_column_at(id);
+        feed_hash(h, col.name());
+        feed_hash(h, cell, col);
+    });
+    add(h.finalize_uint64());
+}
+
+void repair_digest_builder::consume(const range_tombstone& rt) {
+    xx_hasher h(repair_digest_seed);
+    feed_hash(h, _partition_key_hash);
+    feed_hash(h, rt.start, _schema);
+    feed_hash(h, rt.start_kind);
+    feed_hash(h, rt.tomb);
+    feed_hash(h, rt.end, _schema);
+    feed_hash(h, rt.end_kind);
+    add(h.finalize_uint64());
+}
+
+repair_digest repair_digest_builder::build() && {
+    return std::move(_digest);
+}
+
+}
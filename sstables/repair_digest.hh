@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.hh"
+#include "dht/i_partitioner.hh"
+#include "schema_fwd.hh"
+
+class static_row;
+class clustering_row;
+class range_tombstone;
+
+namespace sstables {
+
+// Number of bits of the token used to select the bucket of a partition in
+// the repair digest of newly written sstables.
+constexpr uint32_t repair_digest_bucket_bits = 14;
+
+// The ring is split into 2^bits buckets of equal width, bucket 0 holding the
+// lowest tokens.
+uint32_t repair_digest_bucket_of(dht::token t, uint32_t bits);
+dht::token repair_digest_bucket_first_token(uint32_t index, uint32_t bits);
+dht::token repair_digest_bucket_last_token(uint32_t index, uint32_t bits);
+
+// Accumulates the repair digest of an sstable while it is written.
+//
+// Every fragment of a partition is hashed together with the partition key,
+// and the hashes are summed per bucket of the ring. Sums can be added up
+// across sstables. If two nodes have equal sums for a bucket, they hold, with
+// high probability, the same multiset of fragments in it, and so the same
+// data once the fragments are merged. The converse does not hold: the same
+// data split differently into sstables, e.g. after compaction, has different
+// digests, which is safe as it only makes repair read the bucket.
+//
+// Cells are hashed with the name of their column, not its id, since ids
+// shift when columns are added.
+class repair_digest_builder {
+    const schema& _schema;
+    repair_digest _digest;
+    uint64_t _partition_key_hash = 0;
+    repair_digest_bucket* _bucket = nullptr;
+private:
+    void add(uint64_t hash);
+public:
+    explicit repair_digest_builder(const schema& s);
+
+    void consume_new_partition(const dht::decorated_key& dk);
+    void consume(tombstone t);
+    void consume(const static_row& sr);
+    void consume(const clustering_row& cr);
+    void consume(const range_tombstone& rt);
+
+    repair_digest build() &&;
+};
+
+}
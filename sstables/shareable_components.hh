@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <seastar/core/semaphore.hh>
+
 #include "compress.hh"
 #include "sstables/types.hh"
 #include "utils/i_filter.hh"
@@ -32,6 +34,11 @@ namespace sstables {
 struct shareable_components {
     sstables::compression compression;
     utils::filter_ptr filter;
+    // Bloom filters of the clustering rows, see sstable::clustering_key_filter_may_contain().
+    // Empty if the sstable was written without them.
+    std::vector<utils::filter_ptr> clustering_key_filters;
+    // The memory taken by clustering_key_filters, reserved from the sstables_manager.
+    semaphore_units<> clustering_key_filters_memory;
     sstables::summary summary;
     sstables::statistics statistics;
     std::optional<sstables::scylla_metadata> scylla_metadata;
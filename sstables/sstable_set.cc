@@ -732,6 +732,30 @@ filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, column_f
     return std::move(sstables);
 }
 
+// Filter out sstables for reader using the bloom filter of clustering keys,
+// when the slice selects individual rows only.
+static std::vector<shared_sstable>
+filter_sstable_for_reader_by_ck_bloom_filter(std::vector<shared_sstable>&& sstables, column_family& cf, const schema_ptr& schema,
+        const dht::ring_position& pos, const query::partition_slice& slice) {
+    if (!schema->clustering_key_size() || slice.static_columns.size()) {
+        return std::move(sstables);
+    }
+    auto& ranges = slice.row_ranges(*schema, *pos.key());
+    if (ranges.empty() || !std::ranges::all_of(ranges, [&] (const query::clustering_range& r) {
+                return r.is_singular() && r.start()->value().is_full(*schema);
+            })) {
+        return std::move(sstables);
+    }
+
+    auto pk = key::from_partition_key(*schema, *pos.key());
+    auto skipped = std::partition(sstables.begin(), sstables.end(), [&] (const shared_sstable& sst) {
+        return sst->clustering_key_filter_may_contain(pk, ranges);
+    });
+    cf.cf_stats()->sstables_skipped_by_clustering_key_filter += std::distance(skipped, sstables.end());
+    sstables.erase(skipped, sstables.end());
+    return std::move(sstables);
+}
+
 std::vector<sstable_run>
 sstable_set_impl::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     throw_with_backtrace<std::bad_function_call>();
@@ -757,14 +781,15 @@ sstable_set_impl::create_single_key_sstable_reader(
         return make_empty_flat_reader(schema, permit);
     }
     auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
-        filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice)
+        filter_sstable_for_reader_by_ck(filter_sstable_for_reader_by_ck_bloom_filter(std::move(selected_sstables), *cf, schema, pos, slice),
+                *cf, schema, slice)
         | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
         })
     );
 
-    // If filter_sstable_for_reader_by_ck filtered any sstable that contains the partition
+    // If the clustering filters filtered any sstable that contains the partition
     // we want to emit partition_start/end if no rows were found,
     // to prevent https://github.com/scylladb/scylla/issues/3552.
     //
@@ -856,6 +881,37 @@ time_series_sstable_set::create_single_key_sstable_reader(
                 std::move(create_reader), std::move(filter), *pos.key(), schema, permit, fwd_sm));
 }
 
+std::vector<position_in_partition>
+time_series_sstable_set::clustering_split_positions(const dht::ring_position& pos) const {
+    // The same conditions as for the optimized single partition reader apply:
+    // sstables older than md lack the min/max column metadata, and a partition
+    // tombstone must be seen by the read of every range.
+    using sst_entry = std::pair<position_in_partition, shared_sstable>;
+    if (_schema->has_static_columns()
+            || std::any_of(_sstables->begin(), _sstables->end(),
+                [] (const sst_entry& e) {
+                    return e.second->get_version() < sstable_version_types::md
+                        || e.second->may_have_partition_tombstones();
+    })) {
+        return {};
+    }
+
+    std::vector<position_in_partition> ret;
+    position_in_partition::equal_compare eq(*_schema);
+    auto pk_filter = make_pk_filter(pos, *_schema);
+    for (auto& [min_pos, sst] : *_sstables) {
+        if (!min_pos.has_clustering_key() || min_pos.key().is_empty(*_schema) || !pk_filter(*sst)) {
+            continue;
+        }
+        // The container is ordered by min_position(), so are the split positions.
+        auto split = position_in_partition::before_key(min_pos.key());
+        if (ret.empty() || !eq(ret.back(), split)) {
+            ret.push_back(std::move(split));
+        }
+    }
+    return ret;
+}
+
 compound_sstable_set::compound_sstable_set(schema_ptr schema, std::vector<lw_shared_ptr<sstable_set>> sets)
     : _schema(std::move(schema))
     , _sets(std::move(sets)) {
@@ -1034,6 +1090,20 @@ compound_sstable_set::create_single_key_sstable_reader(
     return make_combined_reader(std::move(schema), std::move(permit), std::move(readers), fwd, fwd_mr);
 }
 
+std::vector<position_in_partition>
+compound_sstable_set::clustering_split_positions(const dht::ring_position& pos) const {
+    std::vector<position_in_partition> ret;
+    for (auto& set : _sets) {
+        auto positions = set->clustering_split_positions(pos);
+        std::move(positions.begin(), positions.end(), std::back_inserter(ret));
+    }
+    position_in_partition::less_compare less(*_schema);
+    position_in_partition::equal_compare eq(*_schema);
+    std::sort(ret.begin(), ret.end(), less);
+    ret.erase(std::unique(ret.begin(), ret.end(), eq), ret.end());
+    return ret;
+}
+
 flat_mutation_reader
 sstable_set::create_single_key_sstable_reader(
         column_family* cf,
@@ -1051,6 +1121,49 @@ sstable_set::create_single_key_sstable_reader(
             std::move(permit), sstable_histogram, pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
 }
 
+flat_mutation_reader
+sstable_set::create_single_key_reversed_sstable_reader(
+        column_family* cf,
+        schema_ptr schema,
+        reader_permit permit,
+        utils::estimated_histogram& sstable_histogram,
+        const dht::partition_range& pr,
+        const query::partition_slice& slice,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        query::max_result_size max_size) const {
+    assert(pr.is_singular() && pr.start()->value().has_key());
+    const auto& pos = pr.start()->value();
+    auto selected_sstables = filter_sstable_for_reader_by_pk(select(pr), *schema, pos);
+    auto num_sstables = selected_sstables.size();
+    if (!num_sstables) {
+        return make_empty_flat_reader(schema, permit);
+    }
+    auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
+        filter_sstable_for_reader_by_ck(filter_sstable_for_reader_by_ck_bloom_filter(std::move(selected_sstables), *cf, schema, pos, slice),
+                *cf, schema, slice)
+        | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
+            tracing::trace(trace_state, "Reading key {} in reverse from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
+            return sstable->make_reversed_reader(schema, permit, pr, slice, pc, trace_state, max_size);
+        })
+    );
+
+    // See create_single_key_sstable_reader(). An empty partition is the same
+    // in both orders.
+    auto num_readers = readers.size();
+    if (num_readers != num_sstables) {
+        readers.push_back(flat_mutation_reader_from_mutations(permit, {mutation(schema, *pos.key())}, slice));
+    }
+    sstable_histogram.add(num_readers);
+    return make_reversed_combined_reader(schema, std::move(permit), std::move(readers));
+}
+
+std::vector<position_in_partition>
+sstable_set::clustering_split_positions(const dht::ring_position& pos) const {
+    assert(pos.has_key());
+    return _impl->clustering_split_positions(pos);
+}
+
 flat_mutation_reader
 sstable_set::make_range_sstable_reader(
         schema_ptr s,
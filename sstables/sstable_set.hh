@@ -117,6 +117,28 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         streamed_mutation::forwarding,
         mutation_reader::forwarding) const;
 
+    // Like create_single_key_sstable_reader(), but reads the partition in
+    // reverse clustering order, in the format of make_reversing_reader(),
+    // see sstable::make_reversed_reader().
+    flat_mutation_reader create_single_key_reversed_sstable_reader(
+        column_family*,
+        schema_ptr,
+        reader_permit,
+        utils::estimated_histogram&,
+        const dht::partition_range&, // must be singular and contain a key
+        const query::partition_slice&,
+        const io_priority_class&,
+        tracing::trace_state_ptr,
+        query::max_result_size) const;
+
+    // Returns the positions at which a read of the partition at `pos` can be
+    // split into consecutive clustering ranges, each served by a few sstables
+    // only, in increasing order. The positions are never clustering row
+    // positions. Empty if the sstables are not laid out along the clustering
+    // order, or if the split would not be safe, e.g. due to partition
+    // tombstones, which the reads of the ranges could disagree on.
+    std::vector<position_in_partition> clustering_split_positions(const dht::ring_position& pos) const;
+
     /// Read a range from the sstable set.
     ///
     /// The reader is unrestricted, but will account its resource usage on the
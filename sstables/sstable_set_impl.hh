@@ -58,6 +58,10 @@ class sstable_set_impl {
         tracing::trace_state_ptr,
         streamed_mutation::forwarding,
         mutation_reader::forwarding) const;
+
+    virtual std::vector<position_in_partition> clustering_split_positions(const dht::ring_position&) const {
+        return {};
+    }
 };
 
 // specialized when sstables are partitioned in the token range space
@@ -151,6 +155,8 @@ class time_series_sstable_set : public sstable_set_impl {
         tracing::trace_state_ptr,
         streamed_mutation::forwarding,
         mutation_reader::forwarding) const override;
+
+    virtual std::vector<position_in_partition> clustering_split_positions(const dht::ring_position&) const override;
 };
 
 // this compound set holds reference to N sstable sets and allow their operations to be combined.
@@ -182,6 +188,8 @@ class compound_sstable_set : public sstable_set_impl {
             streamed_mutation::forwarding,
             mutation_reader::forwarding) const override;
 
+    virtual std::vector<position_in_partition> clustering_split_positions(const dht::ring_position&) const override;
+
     class incremental_selector;
 };
 
@@ -910,6 +910,9 @@ void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
         _recognized_components.insert(component_type::CompressionInfo);
     }
     _recognized_components.insert(component_type::Scylla);
+    if (_version >= sstable_version_types::mc) {
+        _recognized_components.insert(component_type::RepairDigest);
+    }
 }
 
 file_writer::~file_writer() {
@@ -1325,6 +1328,29 @@ future<> sstable::open_data() noexcept {
         if (origin) {
             _origin = sstring(to_sstring_view(bytes_view(origin->value)));
         }
+        auto* ck_filter = _components->scylla_metadata->data.get<scylla_metadata_type::ClusteringKeyFilter, scylla_metadata::clustering_key_filter>();
+        if (ck_filter) {
+            size_t memory = 0;
+            for (auto& f : ck_filter->elements) {
+                memory += f.buckets.elements.size() * sizeof(typename decltype(f.buckets.elements)::value_type);
+            }
+            auto units = _manager.reserve_clustering_key_filter_memory(memory);
+            if (!units) {
+                sstlog.debug("Not loading the clustering key filter of {}, of {} bytes: its memory limit was reached", get_filename(), memory);
+                ck_filter->elements.clear();
+            } else {
+                _components->clustering_key_filters_memory = std::move(*units);
+            }
+            // Keep only the in-memory form of the filters.
+            for (auto& f : ck_filter->elements) {
+                auto nr_bits = f.buckets.elements.size() * std::numeric_limits<typename decltype(f.buckets.elements)::value_type>::digits;
+                if (nr_bits) {
+                    large_bitset bs(nr_bits, std::move(f.buckets.elements));
+                    _components->clustering_key_filters.push_back(utils::filter::create_filter(f.hashes, std::move(bs), utils::filter_format::m_format));
+                }
+            }
+            _components->scylla_metadata->data.data.erase(scylla_metadata_type::ClusteringKeyFilter);
+        }
     }).then([this] {
         _open_mode.emplace(open_flags::ro);
         _stats.on_open_for_reading();
@@ -1610,7 +1636,7 @@ sstable::read_scylla_metadata(const io_priority_class& pc) noexcept {
 
 void
 sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin, std::optional<scylla_metadata::clustering_key_filter> ck_filter) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
     auto sm = create_sharding_metadata(_schema, first_key, last_key, shard);
@@ -1636,10 +1662,72 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
         o.value = bytes(to_bytes_view(sstring_view(origin)));
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
-
+    if (ck_filter) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ClusteringKeyFilter>(std::move(*ck_filter));
+    }
     write_simple<component_type::Scylla>(*_components->scylla_metadata, pc);
 }
 
+void sstable::write_repair_digest(const io_priority_class& pc, const repair_digest& digest) {
+    write_simple<component_type::RepairDigest>(digest, pc);
+}
+
+future<std::optional<utils::chunked_vector<repair_digest_bucket>>>
+sstable::read_repair_digest(uint32_t first, uint32_t last, uint32_t bits, const io_priority_class& pc) {
+    if (!has_repair_digest()) {
+        co_return std::nullopt;
+    }
+    // bucket_bits and bucket_count, followed by the buckets
+    constexpr uint64_t header_size = 2 * sizeof(uint32_t);
+    constexpr uint64_t bucket_size = sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    auto f = co_await new_sstable_component_file(_read_error_handler, component_type::RepairDigest, open_flags::ro);
+    auto size = co_await f.size();
+    // Lookups seek around, read ahead only once the buckets of the range are found.
+    file_random_access_reader r(std::move(f), size, 4096, 0);
+    std::optional<utils::chunked_vector<repair_digest_bucket>> ret;
+    std::exception_ptr ex;
+    try {
+        uint32_t bucket_bits;
+        uint32_t bucket_count;
+        co_await parse(*_schema, _version, r, bucket_bits, bucket_count);
+        if (bucket_bits >= bits) {
+            auto shift = bucket_bits - bits;
+            // The first bucket whose index is not below the range
+            uint32_t lo = 0;
+            uint32_t hi = bucket_count;
+            while (lo < hi) {
+                auto mid = lo + (hi - lo) / 2;
+                repair_digest_bucket b;
+                co_await r.seek(header_size + mid * bucket_size);
+                co_await parse(*_schema, _version, r, b);
+                if ((b.index >> shift) < first) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            ret.emplace();
+            co_await r.seek(header_size + lo * bucket_size);
+            for (auto i = lo; i < bucket_count; ++i) {
+                repair_digest_bucket b;
+                co_await parse(*_schema, _version, r, b);
+                if ((b.index >> shift) > last) {
+                    break;
+                }
+                b.index >>= shift;
+                ret->push_back(b);
+            }
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await r.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return ret;
+}
+
 bool sstable::may_contain_rows(const query::clustering_row_ranges& ranges) const {
     if (_version < sstables::sstable_version_types::md) {
         return true;
@@ -1663,6 +1751,32 @@ bool sstable::may_contain_rows(const query::clustering_row_ranges& ranges) const
     });
 }
 
+utils::hashed_key sstable::make_clustering_key_filter_hash(bytes_view partition_key, const clustering_key_prefix& ck) {
+    auto ck_repr = ck.representation();
+    bytes buf(bytes::initialized_later(), partition_key.size() + ck_repr.size());
+    auto out = std::copy(partition_key.begin(), partition_key.end(), buf.begin());
+    for (bytes_view frag : fragment_range(ck_repr)) {
+        out = std::copy(frag.begin(), frag.end(), out);
+    }
+    return utils::make_hashed_key(buf);
+}
+
+bool sstable::clustering_key_filter_may_contain(const key& partition_key, const query::clustering_row_ranges& rows) const {
+    auto& filters = _components->clustering_key_filters;
+    if (filters.empty()) {
+        return true;
+    }
+    auto is_present = [&] (utils::hashed_key h) {
+        return std::ranges::any_of(filters, [&] (const utils::filter_ptr& f) { return f->is_present(h); });
+    };
+    if (is_present(utils::make_hashed_key(bytes_view(partition_key)))) {
+        return true;
+    }
+    return std::ranges::any_of(rows, [&] (const query::clustering_range& r) {
+        return is_present(make_clustering_key_filter_hash(bytes_view(partition_key), r.start()->value()));
+    });
+}
+
 future<> sstable::seal_sstable(bool backup)
 {
     return seal_sstable().then([this, backup] {
@@ -2120,7 +2234,7 @@ entry_descriptor entry_descriptor::make_descriptor(sstring sstdir, sstring fname
     static std::regex la_mx("(la|m[cd])-(\\d+)-(\\w+)-(.*)");
     static std::regex ka("(\\w+)-(\\w+)-ka-(\\d+)-(.*)");
 
-    static std::regex dir(".*/([^/]*)/([^/]+)-[\\da-fA-F]+(?:/staging|/upload|/snapshots/[^/]+)?/?");
+    static std::regex dir(".*/([^/]*)/([^/]+)-[\\da-fA-F]+(?:/staging|/upload|/snapshots/[^/]+|/streaming/[^/]+)?/?");
 
     std::smatch match;
 
@@ -2671,6 +2785,56 @@ future<bool> sstable::has_partition_key(const utils::hashed_key& hk, const dht::
     });
 }
 
+future<std::vector<position_in_partition>>
+sstable::get_clustering_split_positions(const dht::decorated_key& dk, uint64_t chunk_size,
+        reader_permit permit, const io_priority_class& pc, tracing::trace_state_ptr trace_state) {
+    auto index = std::make_unique<sstables::index_reader>(shared_from_this(), std::move(permit), pc, std::move(trace_state));
+    std::vector<position_in_partition> ret;
+    std::exception_ptr ex;
+    try {
+        bool present = co_await index->advance_lower_and_check_if_present(dk);
+        // A partition with less than two promoted index blocks is smaller than
+        // column_index_size_in_kb and has nothing to split, so its promoted
+        // index isn't worth reading.
+        const promoted_index* pi = present ? index->current_partition_entry().get_promoted_index().get() : nullptr;
+        auto* cursor = pi && pi->get_num_blocks() >= 2 ? index->current_clustered_cursor() : nullptr;
+        position_in_partition::less_compare less(*_schema);
+        std::optional<uint64_t> last_split_offset;
+        while (cursor) {
+            auto entry = co_await cursor->next_entry();
+            if (!entry) {
+                break;
+            }
+            auto* pos = std::get_if<position_in_partition_view>(&entry->start);
+            if (!pos) {
+                ret.clear();
+                break;
+            }
+            if (!last_split_offset) {
+                // The first block starts the first chunk.
+                last_split_offset = entry->offset;
+                continue;
+            }
+            if (entry->offset - *last_split_offset < chunk_size || !pos->has_clustering_key() || pos->key().is_empty(*_schema)) {
+                continue;
+            }
+            auto split = position_in_partition::before_key(pos->key());
+            if (!ret.empty() && !less(ret.back(), split)) {
+                continue;
+            }
+            ret.push_back(std::move(split));
+            last_split_offset = entry->offset;
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await index->close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return ret;
+}
+
 utils::hashed_key sstable::make_hashed_key(const schema& s, const partition_key& key) {
     return utils::make_hashed_key(static_cast<bytes_view>(key::from_partition_key(s, key)));
 }
@@ -2935,6 +3099,75 @@ mutation_source sstable::as_mutation_source() {
     });
 }
 
+class reversed_sstable_reader final : public flat_mutation_reader::impl {
+    shared_sstable _sst;
+    const dht::partition_range& _range;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    tracing::trace_state_ptr _trace_state;
+    query::max_result_size _max_size;
+    flat_mutation_reader_opt _reader;
+private:
+    future<> create_reader() {
+        std::vector<position_in_partition> split_positions;
+        if (_sst->get_version() >= sstable_version_types::mc) {
+            // The in-memory representation of the rows is larger than the
+            // serialized one, hence the margin.
+            const auto chunk_size = _max_size.soft_limit / 4;
+            split_positions = co_await _sst->get_clustering_split_positions(_range.start()->value().as_decorated_key(), chunk_size,
+                    _permit, _pc, _trace_state);
+        }
+        _reader = make_chunked_reversing_reader(_sst->as_mutation_source(), _schema, _permit, _range, _slice, _pc, _trace_state,
+                std::move(split_positions), _max_size);
+    }
+public:
+    reversed_sstable_reader(shared_sstable sst, schema_ptr s, reader_permit permit, const dht::partition_range& range,
+            const query::partition_slice& slice, const io_priority_class& pc, tracing::trace_state_ptr trace_state,
+            query::max_result_size max_size)
+        : impl(std::move(s), std::move(permit))
+        , _sst(std::move(sst))
+        , _range(range)
+        , _slice(slice)
+        , _pc(pc)
+        , _trace_state(std::move(trace_state))
+        , _max_size(max_size)
+    { }
+
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        if (!_reader) {
+            co_await create_reader();
+        }
+        co_await _reader->fill_buffer(timeout);
+        _end_of_stream = _reader->is_end_of_stream();
+        _reader->move_buffer_content_to(*this);
+    }
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = true;
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another partition.");
+    };
+    virtual future<> fast_forward_to(position_range cr, db::timeout_clock::time_point timeout) override {
+        throw std::runtime_error("This reader can't be fast forwarded to another position.");
+    };
+    virtual future<> close() noexcept override {
+        return _reader ? _reader->close() : make_ready_future<>();
+    }
+};
+
+flat_mutation_reader
+sstable::make_reversed_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
+        const query::partition_slice& slice, const io_priority_class& pc, tracing::trace_state_ptr trace_state,
+        query::max_result_size max_size) {
+    assert(query::is_single_partition(range));
+    return make_flat_mutation_reader<reversed_sstable_reader>(shared_from_this(), std::move(schema), std::move(permit), range, slice, pc,
+            std::move(trace_state), max_size);
+}
+
 sstable::sstable(schema_ptr schema,
         sstring dir,
         int64_t generation,
@@ -2997,6 +3230,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::RepairDigest: out << "RepairDigest"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
@@ -119,6 +119,7 @@ struct sstable_writer_config {
     write_monitor* monitor = &default_write_monitor();
     utils::UUID run_identifier = utils::make_random_uuid();
     size_t summary_byte_cost;
+    bool clustering_key_filter = false;
     sstring origin;
 
 private:
@@ -217,6 +218,20 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // The mutation_source shares ownership of this sstable.
     mutation_source as_mutation_source();
 
+    // Returns a reader of a single partition in reverse clustering order, in
+    // the format of make_reversing_reader(). The partition is read forward
+    // one chunk of at least a quarter of max_size.soft_limit at a time, from
+    // its last chunk, along the promoted index. The chunks are computed when
+    // the reader is first filled, that is after the read was admitted.
+    flat_mutation_reader make_reversed_reader(
+            schema_ptr schema,
+            reader_permit permit,
+            const dht::partition_range& range,
+            const query::partition_slice& slice,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state,
+            query::max_result_size max_size);
+
     future<> write_components(flat_mutation_reader mr,
             uint64_t estimated_partitions,
             schema_ptr schema,
@@ -292,7 +307,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     }
 
     uint64_t filter_memory_size() const {
-        return _components->filter->memory_size();
+        auto size = _components->filter->memory_size();
+        for (auto& f : _components->clustering_key_filters) {
+            size += f->memory_size();
+        }
+        return size;
     }
 
     version_types get_version() const {
@@ -361,6 +380,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return dirpath.filename().string() == pending_delete_dir_basename().c_str();
     }
 
+    // Holds the component files of sstables received by streaming, one
+    // subdirectory per stream, until they are loaded.
+    static sstring streaming_dir_basename() {
+        return "streaming";
+    }
+
+    static bool is_streaming_dir(const fs::path& dirpath)
+    {
+        return dirpath.filename().string() == streaming_dir_basename().c_str();
+    }
+
     const sstring& get_dir() const {
         return _dir;
     }
@@ -548,7 +578,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> read_scylla_metadata(const io_priority_class& pc) noexcept;
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, run_identifier identifier,
-            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
+            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin, std::optional<scylla_metadata::clustering_key_filter> ck_filter = std::nullopt);
+
+    void write_repair_digest(const io_priority_class& pc, const repair_digest& digest);
 
     future<> read_filter(const io_priority_class& pc);
 
@@ -686,6 +718,15 @@ class sstable : public enable_lw_shared_from_this<sstable> {
      */
     future<bool> has_partition_key(const utils::hashed_key& hk, const dht::decorated_key& dk);
 
+    // Returns the positions at which the promoted index splits the partition
+    // into chunks of at least `chunk_size` bytes of data, in clustering order.
+    // The positions are never clustering row positions. Empty if the sstable
+    // doesn't contain the partition, or its promoted index doesn't have
+    // clustering positions (ka/la), or has less than two blocks, in which
+    // case it isn't read.
+    future<std::vector<position_in_partition>> get_clustering_split_positions(const dht::decorated_key& dk, uint64_t chunk_size,
+            reader_permit permit, const io_priority_class& pc, tracing::trace_state_ptr trace_state);
+
     bool filter_has_key(utils::hashed_key key) const {
         return _components->filter->is_present(key);
     }
@@ -792,6 +833,35 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // Return true if this sstable possibly stores clustering row(s) specified by ranges.
     bool may_contain_rows(const query::clustering_row_ranges& ranges) const;
 
+    bool has_repair_digest() const {
+        return has_component(component_type::RepairDigest);
+    }
+
+    // Reads the buckets of the repair digest of the sstable, see
+    // repair_digest_builder, whose indexes fall into [first, last] once
+    // reduced to the given number of bits. Only the part of the RepairDigest
+    // component covering them is read, and nothing is kept in memory.
+    // Returns std::nullopt if the sstable has no digest, or one with fewer
+    // bits.
+    future<std::optional<utils::chunked_vector<repair_digest_bucket>>> read_repair_digest(uint32_t first, uint32_t last, uint32_t bits,
+            const io_priority_class& pc);
+
+    bool has_clustering_key_filter() const {
+        return !_components->clustering_key_filters.empty();
+    }
+
+    // Consults the clustering key filter, if the sstable has one.
+    // false => the partition given by partition_key has none of the given
+    // rows, nor tombstones covering them, true => we don't know.
+    // The rows must be given as singular ranges of full clustering keys.
+    bool clustering_key_filter_may_contain(const key& partition_key, const query::clustering_row_ranges& rows) const;
+
+    // The clustering key filter holds the hashes of the keys of all rows
+    // of the sstable. Partitions having a partition tombstone or range
+    // tombstones are also represented by the hash of the partition key
+    // alone, which disables filtering of their rows.
+    static utils::hashed_key make_clustering_key_filter_hash(bytes_view partition_key, const clustering_key_prefix& ck);
+
     // false => there are no partition tombstones, true => we don't know
     bool may_have_partition_tombstones() const {
         return !has_correct_min_max_column_names()
@@ -19,6 +19,8 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <seastar/core/memory.hh>
+
 #include "log.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/sstables.hh"
@@ -32,7 +34,8 @@ logging::logger smlogger("sstables_manager");
 
 sstables_manager::sstables_manager(
     db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat)
-    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat) {
+    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat)
+    , _clustering_key_filter_memory(memory::stats().total_memory() * dbcfg.sstable_clustering_key_filter_memory_ratio()) {
 }
 
 sstables_manager::~sstables_manager() {
@@ -60,6 +63,7 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.clustering_key_filter = _db_config.enable_sstable_clustering_key_filter();
 
     cfg.origin = std::move(origin);
 
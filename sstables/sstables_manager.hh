@@ -24,6 +24,7 @@
 
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "utils/disk-error-handler.hh"
 #include "gc_clock.hh"
@@ -70,6 +71,8 @@ class sstables_manager {
 
     list_type _active;
     list_type _undergoing_close;
+    // Memory left for the clustering key filters of open sstables
+    semaphore _clustering_key_filter_memory;
     bool _closing = false;
     promise<> _done;
 public:
@@ -90,6 +93,12 @@ class sstables_manager {
     const db::config& config() const { return _db_config; }
 
     void set_format(sstable_version_types format) { _format = format; }
+
+    // Reserves memory for the clustering key filters of an sstable about to
+    // be opened, which are not loaded if none is left.
+    std::optional<semaphore_units<>> reserve_clustering_key_filter_memory(size_t size) {
+        return try_get_units(_clustering_key_filter_memory, size);
+    }
     sstables::sstable::version_types get_highest_supported_format() const { return _format; }
 
     // Wait until all sstables managed by this sstables_manager instance
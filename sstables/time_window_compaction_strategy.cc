@@ -223,6 +223,22 @@ time_window_compaction_strategy::get_sstables_for_compaction(column_family& cf,
     return compaction_descriptor(std::move(compaction_candidates), cf.get_sstable_set(), service::get_local_compaction_priority());
 }
 
+compaction_descriptor
+time_window_compaction_strategy::get_tombstone_purge_job(column_family& cf, std::vector<shared_sstable> candidates) {
+    auto target = get_tombstone_purge_target(*cf.schema(), candidates);
+    if (!target) {
+        return compaction_descriptor();
+    }
+    // Only consider the sstables of the target's window, so that the job doesn't
+    // merge the data of different windows.
+    auto window = get_window_for(_options, target->get_stats_metadata().max_timestamp);
+    auto e = boost::range::remove_if(candidates, [&] (const shared_sstable& sst) {
+        return get_window_for(_options, sst->get_stats_metadata().max_timestamp) != window;
+    });
+    candidates.erase(e, candidates.end());
+    return compaction_strategy_impl::get_tombstone_purge_job(cf, std::move(candidates));
+}
+
 time_window_compaction_strategy::bucket_compaction_mode
 time_window_compaction_strategy::compaction_mode(const bucket_t& bucket, timestamp_type bucket_key,
         timestamp_type now, size_t min_threshold) const {
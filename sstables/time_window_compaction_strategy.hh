@@ -116,6 +116,9 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
 public:
     time_window_compaction_strategy(const std::map<sstring, sstring>& options);
     virtual compaction_descriptor get_sstables_for_compaction(column_family& cf, std::vector<shared_sstable> candidates) override;
+
+    // Restricted to the sstables of a single time window, as windows are never merged.
+    virtual compaction_descriptor get_tombstone_purge_job(column_family& cf, std::vector<shared_sstable> candidates) override;
 private:
     static timestamp_type
     to_timestamp_type(time_window_compaction_strategy_options::timestamp_resolutions resolution, int64_t timestamp_from_sstable) {
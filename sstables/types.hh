@@ -511,6 +511,7 @@ enum class scylla_metadata_type : uint32_t {
     RunIdentifier = 4,
     LargeDataStats = 5,
     SSTableOrigin = 6,
+    ClusteringKeyFilter = 7,
 };
 
 struct run_identifier {
@@ -542,10 +543,35 @@ struct large_data_stats_entry {
     auto describe_type(sstable_version_types v, Describer f) { return f(max_value, threshold, above_threshold); }
 };
 
+// The sum of the hashes of the fragments of the partitions whose tokens fall
+// into one bucket of the token ring, see sstables::repair_digest_builder.
+struct repair_digest_bucket {
+    uint32_t index;
+    uint64_t fragments;
+    uint64_t sum;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(index, fragments, sum); }
+};
+
+// The RepairDigest component. Buckets have a fixed size on disk, so that
+// the ones of a range can be looked up without reading the whole component.
+struct repair_digest {
+    // The ring is split into 2^bucket_bits buckets of equal width
+    uint32_t bucket_bits;
+    // Sorted by index, empty buckets are left out
+    disk_array<uint32_t, repair_digest_bucket> buckets;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(bucket_bits, buckets); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
     using large_data_stats = disk_hash<uint32_t, large_data_type, large_data_stats_entry>;
     using sstable_origin = disk_string<uint32_t>;
+    // A series of bloom filters of growing size, see sstable::clustering_key_filter_may_contain()
+    using clustering_key_filter = disk_array<uint32_t, filter>;
 
     disk_set_of_tagged_union<scylla_metadata_type,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
@@ -553,7 +579,8 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ExtensionAttributes, extension_attributes>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ClusteringKeyFilter, clustering_key_filter>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -59,6 +59,9 @@ stream_manager::stream_manager() {
 
         sm::make_derive("total_outgoing_bytes", [this] { return _total_outgoing_bytes; },
                         sm::description("Total number of bytes sent on this shard.")),
+
+        sm::make_gauge("plans_in_progress", [this] { return _stream_bytes.size(); },
+                        sm::description("Number of stream plans which sent or received data on this shard, and are not done yet.")),
     });
 }
 
@@ -46,6 +46,7 @@
 #include "gms/endpoint_state.hh"
 #include "gms/application_state.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <map>
 
@@ -97,6 +98,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
     semaphore _mutation_send_limiter{256};
+    // Held while sstable files received from peers are written and loaded
+    seastar::gate _receive_sstable_files_gate;
     seastar::metrics::metric_groups _metrics;
 
 public:
@@ -104,6 +107,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
 
     semaphore& mutation_send_limiter() { return _mutation_send_limiter; }
 
+    seastar::gate& receive_sstable_files_gate() { return _receive_sstable_files_gate; }
+
     void register_sending(shared_ptr<stream_result_future> result);
 
     void register_receiving(shared_ptr<stream_result_future> result);
@@ -129,7 +134,7 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
 
     future<> stop() {
         fail_all_sessions();
-        return make_ready_future<>();
+        return _receive_sstable_files_gate.close();
     }
 
     void update_progress(UUID cf_id, gms::inet_address peer, progress_info::direction dir, size_t fm_size);
@@ -102,6 +102,8 @@ class stream_result_future {
 public:
     shared_ptr<stream_coordinator> get_coordinator() { return _coordinator; };
 
+    lowres_clock::time_point start_time() const { return _start_time; }
+
 public:
     static future<stream_state> init_sending_side(UUID plan_id_, sstring description_, std::vector<stream_event_handler*> listeners_, shared_ptr<stream_coordinator> coordinator_);
     static shared_ptr<stream_result_future> init_receiving_side(UUID plan_id, sstring description, inet_address from);
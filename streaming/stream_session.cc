@@ -68,7 +68,12 @@
 #include "../db/view/view_update_generator.hh"
 #include "mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files.hh"
 #include "consumer.hh"
+#include "distributed_loader.hh"
+#include "lister.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/seastar.hh>
 
 namespace streaming {
 
@@ -112,6 +117,58 @@ static sstables::offstrategy is_offstrategy_supported(streaming::stream_reason r
     return sstables::offstrategy(operations_supported.contains(reason));
 }
 
+// Writes the sstable component files received from source into dir,
+// verifying their checksums.
+static future<> receive_sstable_files(rpc::source<stream_sstable_file_chunk, stream_sstable_files_cmd> source, std::filesystem::path dir,
+        UUID plan_id, gms::inet_address from) {
+    sstable_files_writer writer(std::move(dir));
+    std::exception_ptr ex;
+    try {
+        while (auto opt = co_await source()) {
+            auto& [chunk, cmd] = *opt;
+            streaming::get_local_stream_manager().update_progress(plan_id, from, progress_info::direction::IN, chunk.data.size());
+            co_await writer.consume(std::move(chunk), cmd);
+        }
+        writer.check_finished();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await writer.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+static future<size_t> receive_and_load_sstable_files(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+        distributed<db::view::view_update_generator>& view_update_generator, schema_ptr s, UUID plan_id, gms::inet_address from,
+        stream_reason reason, rpc::source<stream_sstable_file_chunk, stream_sstable_files_cmd> source) {
+    auto dir = std::filesystem::path(db.local().find_column_family(s->id()).dir())
+            / sstables::sstable::streaming_dir_basename().c_str() / utils::make_random_uuid().to_sstring().c_str();
+    co_await recursive_touch_directory(dir.native());
+    size_t loaded = 0;
+    std::exception_ptr ex;
+    try {
+        co_await receive_sstable_files(std::move(source), dir, plan_id, from);
+        // Loading reshards the sstables, it is coordinated by shard 0.
+        loaded = co_await smp::submit_to(0, [&db, &sys_dist_ks, &view_update_generator, s, dir, reason] {
+            return distributed_loader::process_streamed_dir(db, sys_dist_ks, view_update_generator, s->ks_name(), s->cf_name(), dir, reason,
+                    is_offstrategy_supported(reason));
+        });
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // Loaded sstables were moved to the table directory already
+    try {
+        co_await lister::rmdir(dir);
+    } catch (...) {
+        sslog.warn("[Stream #{}] Failed to remove {}: {}", plan_id, dir.native(), std::current_exception());
+    }
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return loaded;
+}
+
 void stream_session::init_messaging_service_handler(netw::messaging_service& ms, shared_ptr<service::migration_manager> mm) {
     ms.register_prepare_message([] (const rpc::client_info& cinfo, prepare_message msg, UUID plan_id, sstring description, rpc::optional<stream_reason> reason_opt) {
         const auto& src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
@@ -216,6 +273,40 @@ void stream_session::init_messaging_service_handler(netw::messaging_service& ms,
             return make_ready_future<rpc::sink<int>>(sink);
         });
     });
+    ms.register_stream_sstable_files([] (const rpc::client_info& cinfo, UUID plan_id, UUID cf_id, stream_reason reason, rpc::source<stream_sstable_file_chunk, stream_sstable_files_cmd> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        auto s = get_local_db().find_column_family(cf_id).schema();
+        if (!_sys_dist_ks->local_is_initialized() || !_view_update_generator->local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        auto& gate = get_local_stream_manager().receive_sstable_files_gate();
+        if (gate.is_closed()) {
+            return make_exception_future<rpc::sink<int>>(gate_closed_exception());
+        }
+        auto sink = stream_session::ms().make_sink_for_stream_sstable_files(source);
+        // Runs in the background under the gate, which stream_manager::stop() waits for.
+        (void)with_gate(gate, [s, plan_id, from, reason, source, sink] () mutable {
+            return receive_and_load_sstable_files(*_db, *_sys_dist_ks, *_view_update_generator, s, plan_id, from.addr, reason, source).then_wrapped([s, plan_id, from, sink] (future<size_t> f) mutable {
+                int32_t status = 0;
+                if (f.failed()) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive and load phase) for ks={}, cf={}, peer={}: {}",
+                            plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                    status = -1;
+                } else {
+                    sslog.info("[Stream #{}] Loaded streamed sstable files for ks={}, cf={}, loaded_sstables={}", plan_id, s->ks_name(), s->cf_name(), f.get0());
+                }
+                return sink(status).finally([sink] () mutable {
+                    return sink.close();
+                });
+            }).handle_exception([s, plan_id, from] (std::exception_ptr ep) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for ks={}, cf={}, peer={}: {}",
+                        plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+            });
+        });
+        return make_ready_future<rpc::sink<int>>(sink);
+    });
     ms.register_stream_mutation_done([] (const rpc::client_info& cinfo, UUID plan_id, dht::token_range_vector ranges, UUID cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return smp::submit_to(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] () mutable {
@@ -245,6 +336,7 @@ future<> stream_session::uninit_messaging_service_handler(netw::messaging_servic
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
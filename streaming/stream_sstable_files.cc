@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include "streaming/stream_sstable_files.hh"
+#include "sstables/sstables.hh"
+#include "sstables/checksum_utils.hh"
+
+namespace streaming {
+
+static void validate_sstable_component_name(const std::filesystem::path& dir, const sstring& name) {
+    auto path = std::filesystem::path(name.c_str());
+    if (name.empty() || path.filename() != path || name == "." || name == "..") {
+        throw std::runtime_error(format("Invalid sstable component name {}", name));
+    }
+    // Throws if the name is not the one of an sstable component
+    sstables::entry_descriptor::make_descriptor(dir.native(), name);
+}
+
+sstable_files_writer::sstable_files_writer(std::filesystem::path dir)
+    : _dir(std::move(dir))
+{ }
+
+future<> sstable_files_writer::consume(stream_sstable_file_chunk chunk, stream_sstable_files_cmd cmd) {
+    switch (cmd) {
+    case stream_sstable_files_cmd::component_data:
+    case stream_sstable_files_cmd::component_end:
+        if (_got_end_of_stream) {
+            throw std::runtime_error("Sender sent data after end_of_stream");
+        }
+        if (!_out) {
+            validate_sstable_component_name(_dir, chunk.component);
+            auto f = co_await open_file_dma((_dir / chunk.component.c_str()).native(), open_flags::wo | open_flags::create | open_flags::exclusive);
+            _out = co_await make_file_output_stream(std::move(f));
+            _component = chunk.component;
+            _checksum = crc32_utils::init_checksum();
+        } else if (chunk.component != _component) {
+            throw std::runtime_error(format("Sender sent {} before the end of {}", chunk.component, _component));
+        }
+        if (cmd == stream_sstable_files_cmd::component_data) {
+            _checksum = crc32_utils::checksum(_checksum, reinterpret_cast<const char*>(chunk.data.data()), chunk.data.size());
+            co_await _out->write(reinterpret_cast<const char*>(chunk.data.data()), chunk.data.size());
+        } else {
+            co_await _out->flush();
+            auto out = std::move(*_out);
+            _out.reset();
+            co_await out.close();
+            if (_checksum != chunk.checksum) {
+                throw std::runtime_error(format("Checksum mismatch for {}: expected {}, got {}", _component, chunk.checksum, _checksum));
+            }
+        }
+        break;
+    case stream_sstable_files_cmd::error:
+        throw std::runtime_error("Sender failed");
+    case stream_sstable_files_cmd::end_of_stream:
+        _got_end_of_stream = true;
+        break;
+    default:
+        throw std::runtime_error("Sender sent wrong cmd");
+    }
+}
+
+void sstable_files_writer::check_finished() const {
+    if (!_got_end_of_stream) {
+        throw std::runtime_error("Sender did not sent end_of_stream");
+    }
+    if (_out) {
+        throw std::runtime_error(format("Sender did not finish sending {}", _component));
+    }
+}
+
+future<> sstable_files_writer::close() noexcept {
+    if (_out) {
+        auto out = std::move(*_out);
+        _out.reset();
+        try {
+            co_await out.close();
+        } catch (...) {
+        }
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/iostream.hh>
+#include "bytes.hh"
+#include "seastarx.hh"
+
+namespace streaming {
+
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    component_data,
+    component_end,
+    end_of_stream,
+};
+
+// A piece of an sstable component file sent with STREAM_SSTABLE_FILES.
+struct stream_sstable_file_chunk {
+    // File name of the component, e.g. md-1-big-Data.db
+    sstring component;
+    // Data of the component following the previous chunk, for component_data
+    bytes data;
+    // CRC32 of the whole component, for component_end
+    uint32_t checksum;
+};
+
+// Writes the sstable component files received with STREAM_SSTABLE_FILES
+// into a directory, verifying their checksums. Only plain sstable component
+// names are accepted, so that the peer cannot write outside of the directory.
+class sstable_files_writer {
+    std::filesystem::path _dir;
+    std::optional<output_stream<char>> _out;
+    sstring _component;
+    uint32_t _checksum = 0;
+    bool _got_end_of_stream = false;
+public:
+    explicit sstable_files_writer(std::filesystem::path dir);
+
+    // Throws if the peer failed, or sent an invalid chunk.
+    future<> consume(stream_sstable_file_chunk chunk, stream_sstable_files_cmd cmd);
+    // Throws unless the peer finished all components and sent end_of_stream.
+    void check_finished() const;
+    // Must be called before destruction, also after a failure.
+    future<> close() noexcept;
+};
+
+}
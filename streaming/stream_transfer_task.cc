@@ -43,6 +43,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files.hh"
 #include "mutation_reader.hh"
 #include "flat_mutation_reader.hh"
 #include "mutation_fragment_stream_validator.hh"
@@ -57,8 +58,14 @@
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
+#include "sstables/checksum_utils.hh"
 #include "database.hh"
+#include "db/config.hh"
 #include "gms/feature_service.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <boost/algorithm/cxx11/any_of.hpp>
 
 namespace streaming {
 
@@ -86,6 +93,8 @@ struct send_info {
     column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sstables sent as files, the reader reads everything else.
+    std::vector<sstables::shared_sstable> sstables_to_send;
     flat_mutation_reader reader;
     send_info(database& db_, netw::messaging_service& ms_, utils::UUID plan_id_, utils::UUID cf_id_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
@@ -100,7 +109,38 @@ struct send_info {
         , cf(db.find_column_family(cf_id))
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), prs)) {
+        , sstables_to_send(select_sstables_to_send())
+        , reader(cf.make_streaming_reader(cf.schema(), prs, sstables_to_send)) {
+    }
+    // An sstable can be sent as is when all of its data belongs to the
+    // streamed ranges, so that the peer owns all of it.
+    std::vector<sstables::shared_sstable> select_sstables_to_send() const {
+        static const std::unordered_set<stream_reason> reasons_supported = {
+            stream_reason::bootstrap,
+            stream_reason::replace,
+            stream_reason::decommission,
+            stream_reason::removenode,
+            stream_reason::rebuild,
+        };
+        if (!reasons_supported.contains(reason) || !db.features().cluster_supports_stream_sstable_files()) {
+            return {};
+        }
+        std::vector<sstables::shared_sstable> ret;
+        for (auto& sst : *cf.get_sstables()) {
+            // Shared sstables also hold data of other shards, staging
+            // sstables still have to generate view updates here.
+            if (sst->is_shared() || sst->requires_view_building()) {
+                continue;
+            }
+            auto first = sst->get_first_decorated_key().token();
+            auto last = sst->get_last_decorated_key().token();
+            if (boost::algorithm::any_of(ranges, [&] (const dht::token_range& r) {
+                return r.contains(first, dht::token_comparator()) && r.contains(last, dht::token_comparator());
+            })) {
+                ret.push_back(sst);
+            }
+        }
+        return ret;
     }
     future<bool> has_relevant_range_on_this_shard() {
         return do_with(false, ranges.begin(), [this] (bool& found_relevant_range, dht::token_range_vector::iterator& ranges_it) {
@@ -213,6 +253,120 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+static constexpr size_t sstable_file_chunk_size = 128 * 1024;
+
+static future<> send_sstable_component(send_info& si, rpc::sink<stream_sstable_file_chunk, stream_sstable_files_cmd>& sink, sstring filename) {
+    auto component = sstring(std::filesystem::path(filename).filename().native());
+    auto f = co_await open_file_dma(filename, open_flags::ro);
+    file_input_stream_options options;
+    options.buffer_size = sstable_file_chunk_size;
+    options.read_ahead = 2;
+    options.io_priority_class = service::get_local_streaming_priority();
+    auto in = make_file_input_stream(std::move(f), 0, std::move(options));
+    std::exception_ptr ex;
+    try {
+        uint32_t checksum = crc32_utils::init_checksum();
+        for (;;) {
+            auto buf = co_await in.read();
+            if (buf.empty()) {
+                break;
+            }
+            checksum = crc32_utils::checksum(checksum, buf.get(), buf.size());
+            streaming::get_local_stream_manager().update_progress(si.plan_id, si.id.addr, streaming::progress_info::direction::OUT, buf.size());
+            co_await sink(stream_sstable_file_chunk{component, bytes(reinterpret_cast<const bytes::value_type*>(buf.get()), buf.size()), 0},
+                    stream_sstable_files_cmd::component_data);
+        }
+        co_await sink(stream_sstable_file_chunk{component, bytes(), checksum}, stream_sstable_files_cmd::component_end);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+static future<> send_sstable_components(lw_shared_ptr<send_info> si, rpc::sink<stream_sstable_file_chunk, stream_sstable_files_cmd> sink) {
+    std::exception_ptr ex;
+    try {
+        for (auto& sst : si->sstables_to_send) {
+            for (auto& filename : sst->component_filenames()) {
+                co_await send_sstable_component(*si, sink, filename);
+            }
+        }
+        co_await sink(stream_sstable_file_chunk{}, stream_sstable_files_cmd::end_of_stream);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        // Notify the receiver the sender has failed
+        try {
+            co_await sink(stream_sstable_file_chunk{}, stream_sstable_files_cmd::error);
+        } catch (...) {
+        }
+    }
+    co_await sink.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+static future<> receive_sstable_files_status(lw_shared_ptr<send_info> si, rpc::source<int32_t> source, lw_shared_ptr<bool> got_error_from_peer) {
+    // Keep reading until EOS, see send_mutation_fragments().
+    while (auto status_opt = co_await source()) {
+        auto status = std::get<0>(*status_opt);
+        *got_error_from_peer = status == -1;
+        sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+    }
+}
+
+// Sends the sstables selected by send_info::select_sstables_to_send() as
+// files. The peer loads them once all are received and their checksums
+// verified, before replying.
+future<> send_sstable_files(lw_shared_ptr<send_info> si) {
+    if (si->sstables_to_send.empty()) {
+        co_return;
+    }
+    sslog.info("[Stream #{}] Start sending ks={}, cf={}, sstables={}, as files", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(),
+            si->sstables_to_send.size());
+    auto [sink, source] = co_await si->ms.make_sink_and_source_for_stream_sstable_files(si->plan_id, si->cf_id, si->reason, si->id);
+    auto got_error_from_peer = make_lw_shared<bool>(false);
+    co_await when_all_succeed(receive_sstable_files_status(si, std::move(source), got_error_from_peer),
+            send_sstable_components(si, std::move(sink))).discard_result();
+    if (*got_error_from_peer) {
+        throw std::runtime_error(format("Peer failed to load sstable files peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
+    }
+}
+
+std::vector<dht::token_range_vector> split_ranges_for_streams(dht::token_range_vector ranges, size_t n) {
+    while (ranges.size() < n) {
+        dht::token_range_vector bisected;
+        bisected.reserve(ranges.size() * 2);
+        for (auto& r : ranges) {
+            if (r.start() && r.end()) {
+                auto mid = dht::token::midpoint(r.start()->value(), r.end()->value());
+                if (mid > r.start()->value() && mid < r.end()->value()) {
+                    bisected.emplace_back(r.start(), dht::token_range::bound(mid, true));
+                    bisected.emplace_back(dht::token_range::bound(mid, false), r.end());
+                    continue;
+                }
+            }
+            bisected.push_back(std::move(r));
+        }
+        if (bisected.size() == ranges.size()) {
+            ranges = std::move(bisected);
+            break;
+        }
+        ranges = std::move(bisected);
+    }
+    n = std::min(n, ranges.size());
+    std::vector<dht::token_range_vector> groups(n);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        groups[i * n / ranges.size()].push_back(std::move(ranges[i]));
+    }
+    return groups;
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -222,16 +376,26 @@ future<> stream_transfer_task::execute() {
     sort_and_merge_ranges();
     auto reason = session->get_reason();
     return session->get_db().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (database& db) {
-        auto si = make_lw_shared<send_info>(db, stream_session::ms(), plan_id, cf_id, std::move(ranges), id, dst_cpu_id, reason);
-        return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
-            if (!has_relevant_range_on_this_shard) {
-                sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
-                        plan_id, cf_id, this_shard_id());
-                return make_ready_future<>();
-            }
-            return send_mutation_fragments(std::move(si));
-        }).finally([si] {
-            return si->reader.close();
+        auto nr_streams = std::max(db.get_config().streaming_parallel_streams_per_shard(), 1u);
+        auto groups = split_ranges_for_streams(ranges, nr_streams);
+        // Each group is received by its own rpc handler, so the peer writes
+        // the groups, which cover disjoint token ranges, in parallel.
+        return do_with(std::move(groups), [&db, plan_id, cf_id, id, dst_cpu_id, reason] (std::vector<dht::token_range_vector>& groups) {
+          return parallel_for_each(groups, [&db, plan_id, cf_id, id, dst_cpu_id, reason] (dht::token_range_vector& ranges) {
+            auto si = make_lw_shared<send_info>(db, stream_session::ms(), plan_id, cf_id, std::move(ranges), id, dst_cpu_id, reason);
+            return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
+                if (!has_relevant_range_on_this_shard) {
+                    sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
+                            plan_id, cf_id, this_shard_id());
+                    return make_ready_future<>();
+                }
+                return send_sstable_files(si).then([si] {
+                    return send_mutation_fragments(si);
+                });
+            }).finally([si] {
+                return si->reader.close();
+            });
+          });
         });
     }).then([this, plan_id, cf_id, id] {
         sslog.debug("[Stream #{}] SEND STREAM_MUTATION_DONE to {}, cf_id={}", plan_id, id, cf_id);
@@ -49,6 +49,12 @@ namespace streaming {
 class stream_session;
 class send_info;
 
+// Splits the sorted and disjoint ranges into at most n groups of contiguous
+// ranges, each sent over its own stream. Ranges are bisected first when there
+// are fewer of them than streams, so that a single large range, as streamed
+// by rebuild, can be sent in parallel too.
+std::vector<dht::token_range_vector> split_ranges_for_streams(dht::token_range_vector ranges, size_t n);
+
 /**
  * StreamTransferTask sends sections of SSTable files in certain ColumnFamily.
  */
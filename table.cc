@@ -26,6 +26,7 @@
 #include "database.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
+#include "sstables/repair_digest.hh"
 #include "service/priority_manager.hh"
 #include "db/schema_tables.hh"
 #include "cell_locking.hh"
@@ -42,6 +43,7 @@
 #include "db/view/view.hh"
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 #include "utils/error_injection.hh"
 #include "utils/histogram_metrics_helper.hh"
 #include "utils/fb_utilities.hh"
@@ -120,6 +122,37 @@ table::make_sstable_reader(schema_ptr s,
     return make_restricted_flat_reader(std::move(ms), std::move(s), std::move(permit), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
 }
 
+flat_mutation_reader
+table::make_reversed_sstable_reader(schema_ptr s,
+                                   reader_permit permit,
+                                   lw_shared_ptr<sstables::sstable_set> sstables,
+                                   const dht::partition_range& pr,
+                                   const query::partition_slice& slice,
+                                   const io_priority_class& pc,
+                                   tracing::trace_state_ptr trace_state,
+                                   query::max_result_size max_size) const {
+    const dht::ring_position& pos = pr.start()->value();
+    if (dht::shard_of(*s, pos.token()) != this_shard_id()) {
+        return make_empty_flat_reader(s, std::move(permit)); // range doesn't belong to this shard
+    }
+    // The readers, and with them the clustering split positions of the
+    // sstables, are created only once the read is admitted.
+    auto ms = mutation_source([this, sstables = std::move(sstables), max_size] (
+            schema_ptr s,
+            reader_permit permit,
+            const dht::partition_range& pr,
+            const query::partition_slice& slice,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state,
+            streamed_mutation::forwarding,
+            mutation_reader::forwarding) {
+        return sstables->create_single_key_reversed_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(permit),
+                _stats.estimated_sstable_per_read, pr, slice, pc, std::move(trace_state), max_size);
+    });
+    return make_restricted_flat_reader(std::move(ms), std::move(s), std::move(permit), pr, slice, pc, std::move(trace_state),
+            streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+}
+
 lw_shared_ptr<sstables::sstable_set> table::make_compound_sstable_set() {
     return make_lw_shared(sstables::make_compound_sstable_set(_schema, { _main_sstables, _maintenance_sstables }));
 }
@@ -225,6 +258,49 @@ table::make_reader(schema_ptr s,
     }
 }
 
+flat_mutation_reader
+table::make_reversed_reader(schema_ptr s,
+                           reader_permit permit,
+                           const dht::partition_range& range,
+                           const query::partition_slice& slice,
+                           const io_priority_class& pc,
+                           tracing::trace_state_ptr trace_state,
+                           query::max_result_size max_size) const {
+    std::vector<flat_mutation_reader> readers;
+    readers.reserve(_memtables->size() + 1);
+
+    // See make_reader() for why the memtables and the cache can be read
+    // separately for a single partition.
+    for (auto&& mt : *_memtables) {
+        readers.emplace_back(mt->make_reversed_reader(s, permit, range, slice));
+    }
+
+    auto sstables_source = mutation_source([this, sstables = _sstables, max_size] (schema_ptr s,
+                                   reader_permit permit,
+                                   const dht::partition_range& range,
+                                   const query::partition_slice& slice,
+                                   const io_priority_class& pc,
+                                   tracing::trace_state_ptr trace_state,
+                                   streamed_mutation::forwarding,
+                                   mutation_reader::forwarding) {
+        return make_reversed_sstable_reader(std::move(s), std::move(permit), sstables, range, slice, pc, std::move(trace_state), max_size);
+    });
+    if (cache_enabled() && !slice.options.contains(query::partition_slice::option::bypass_cache)) {
+        readers.emplace_back(_cache.make_reversed_reader(s, permit, range, slice, pc, std::move(trace_state), std::move(sstables_source),
+                max_size.soft_limit));
+    } else {
+        readers.emplace_back(sstables_source.make_reader(s, permit, range, slice, pc, std::move(trace_state),
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no));
+    }
+
+    auto comb_reader = make_reversed_combined_reader(s, std::move(permit), std::move(readers));
+    if (_config.data_listeners && !_config.data_listeners->empty()) {
+        return _config.data_listeners->on_read(s, range, slice, std::move(comb_reader));
+    } else {
+        return comb_reader;
+    }
+}
+
 sstables::shared_sstable table::make_streaming_sstable_for_write(std::optional<sstring> subdir) {
     sstring dir = _config.datadir;
     if (subdir) {
@@ -237,19 +313,31 @@ sstables::shared_sstable table::make_streaming_sstable_for_write(std::optional<s
 
 flat_mutation_reader
 table::make_streaming_reader(schema_ptr s,
-                           const dht::partition_range_vector& ranges) const {
+                           const dht::partition_range_vector& ranges, const std::vector<sstables::shared_sstable>& excluded) const {
     auto permit = _config.streaming_read_concurrency_semaphore->make_permit(s.get(), "stream-ranges");
     auto& slice = s->full_slice();
     auto& pc = service::get_local_streaming_priority();
 
-    auto source = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+    auto excluded_ssts = boost::copy_range<std::unordered_set<sstables::shared_sstable>>(excluded);
+    auto source = mutation_source([this, excluded_ssts = std::move(excluded_ssts)] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
                                       const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
         std::vector<flat_mutation_reader> readers;
         readers.reserve(_memtables->size() + 1);
         for (auto&& mt : *_memtables) {
             readers.emplace_back(mt->make_flat_reader(s, permit, range, slice, pc, trace_state, fwd, fwd_mr));
         }
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        // Filter the sstables when each range is read, like the memtables,
+        // so that memtables flushed in the meantime are read from sstables.
+        auto effective_sstables = _sstables;
+        if (!excluded_ssts.empty()) {
+            effective_sstables = make_lw_shared(_compaction_strategy.make_sstable_set(_schema));
+            _sstables->for_each_sstable([&excluded_ssts, &effective_sstables] (const sstables::shared_sstable& sst) mutable {
+                if (!excluded_ssts.contains(sst)) {
+                    effective_sstables->insert(sst);
+                }
+            });
+        }
+        readers.emplace_back(make_sstable_reader(s, permit, std::move(effective_sstables), range, slice, pc, std::move(trace_state), fwd, fwd_mr));
         return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
     });
 
@@ -606,6 +694,24 @@ table::seal_active_memtable(flush_permit&& permit) {
     // FIXME: provide back-pressure to upper layers
 }
 
+// Splits the token ring into count ranges of equal token span. Partitions of
+// a memtable are spread evenly over the ring by the partitioner, so writers of
+// the ranges receive similar amounts of data.
+static dht::partition_range_vector split_flush_range(size_t count) {
+    dht::partition_range_vector ret;
+    ret.reserve(count);
+    std::optional<dht::partition_range::bound> start;
+    auto step = std::numeric_limits<uint64_t>::max() / count;
+    for (size_t i = 1; i < count; ++i) {
+        // Offsetting in unsigned arithmetic avoids signed overflow past the middle of the ring.
+        auto t = dht::token::from_int64(int64_t(uint64_t(std::numeric_limits<int64_t>::min()) + step * i));
+        ret.emplace_back(start, dht::partition_range::bound(dht::ring_position::ending_at(t), true));
+        start = dht::partition_range::bound(dht::ring_position::ending_at(t), false);
+    }
+    ret.emplace_back(start, std::nullopt);
+    return ret;
+}
+
 future<stop_iteration>
 table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
   return with_scheduling_group(_config.memtable_scheduling_group, [this, old = std::move(old), permit = std::move(permit)] () mutable {
@@ -621,31 +727,56 @@ table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_
     // The code as is guarantees that we'll never partially backup a
     // single sstable, so that is enough of a guarantee.
 
-    return do_with(std::vector<sstables::shared_sstable>(), [this, old, permit = make_lw_shared(std::move(permit))] (auto& newtabs) {
+    // A large memtable is split into token ranges written by parallel writers, as long as
+    // there are spare sstable write permits, i.e. the disk isn't busy with other flushes.
+    std::vector<lw_shared_ptr<sstable_write_permit>> permits;
+    permits.push_back(make_lw_shared(std::move(permit)));
+    auto memtable_size = old->occupancy().used_space();
+    if (_config.memtable_flush_split_threshold && memtable_size > _config.memtable_flush_split_threshold && old->partition_count() > 1) {
+        auto& dmm = get_dirty_memory_manager();
+        auto wanted = std::min<size_t>(memtable_size / _config.memtable_flush_split_threshold, dmm.max_concurrent_flushes());
+        for (auto&& p : dmm.try_get_sstable_write_permits(wanted - 1)) {
+            permits.push_back(make_lw_shared(std::move(p)));
+        }
+    }
+    auto ranges = split_flush_range(permits.size());
+    if (ranges.size() > 1) {
+        tlogger.debug("Splitting flush of memtable of {}.{} ({} bytes) into {} ranges", _schema->ks_name(), _schema->cf_name(), memtable_size, ranges.size());
+        _config.cf_stats->split_memtables_flushes_count++;
+    }
+
+    return do_with(std::vector<sstables::shared_sstable>(), std::move(ranges), std::move(permits),
+            [this, old] (auto& newtabs, const dht::partition_range_vector& ranges, auto& permits) {
         auto metadata = mutation_source_metadata{};
         metadata.min_timestamp = old->get_min_timestamp();
         metadata.max_timestamp = old->get_max_timestamp();
 
-        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs] (flat_mutation_reader reader) mutable {
-            auto&& priority = service::get_local_memtable_flush_priority();
-            sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
-            cfg.backup = incremental_backups_enabled();
+        auto write_range = [this, old, metadata, &newtabs] (const dht::partition_range& range, lw_shared_ptr<sstable_write_permit> permit) {
+            auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs] (flat_mutation_reader reader) mutable {
+                auto&& priority = service::get_local_memtable_flush_priority();
+                sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
+                cfg.backup = incremental_backups_enabled();
 
-            auto newtab = make_sstable();
-            newtabs.push_back(newtab);
-            tlogger.debug("Flushing to {}", newtab->get_filename());
+                auto newtab = make_sstable();
+                newtabs.push_back(newtab);
+                tlogger.debug("Flushing to {}", newtab->get_filename());
 
-            auto monitor = database_sstable_write_monitor(permit, newtab, _compaction_strategy,
-                old->get_max_timestamp());
+                auto monitor = database_sstable_write_monitor(permit, newtab, _compaction_strategy,
+                    old->get_max_timestamp());
 
-            return do_with(std::move(monitor), [newtab, cfg = std::move(cfg), old, reader = std::move(reader), &priority] (auto& monitor) mutable {
-                // FIXME: certain writers may receive only a small subset of the partitions, so bloom filters will be
-                // bigger than needed, due to overestimation. That's eventually adjusted through compaction, though.
-                return write_memtable_to_sstable(std::move(reader), *old, newtab, monitor, cfg, priority);
+                return do_with(std::move(monitor), [newtab, cfg = std::move(cfg), old, reader = std::move(reader), &priority] (auto& monitor) mutable {
+                    // FIXME: certain writers may receive only a small subset of the partitions, so bloom filters will be
+                    // bigger than needed, due to overestimation. That's eventually adjusted through compaction, though.
+                    return write_memtable_to_sstable(std::move(reader), *old, newtab, monitor, cfg, priority);
+                });
             });
-        });
 
-        auto f = consumer(old->make_flush_reader(old->schema(), service::get_local_memtable_flush_priority()));
+            return consumer(old->make_flush_reader(old->schema(), range, service::get_local_memtable_flush_priority()));
+        };
+
+        auto f = parallel_for_each(boost::irange<size_t>(0, ranges.size()), [&ranges, &permits, write_range = std::move(write_range)] (size_t i) {
+            return write_range(ranges[i], permits[i]);
+        });
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -1147,6 +1278,36 @@ std::vector<sstables::shared_sstable> table::select_sstables(const dht::partitio
     return _sstables->select(range);
 }
 
+future<std::optional<utils::chunked_vector<sstables::repair_digest_bucket>>>
+table::get_repair_digest(const dht::token_range& range, uint32_t bucket_bits) const {
+    auto pr = dht::to_partition_range(range);
+    for (auto&& mt : *_memtables) {
+        if (!mt->empty(pr)) {
+            co_return std::nullopt;
+        }
+    }
+    auto first = sstables::repair_digest_bucket_of(range.start() ? range.start()->value() : dht::minimum_token(), bucket_bits);
+    auto last = sstables::repair_digest_bucket_of(range.end() ? range.end()->value() : dht::maximum_token(), bucket_bits);
+    auto ssts = _sstables->select(pr);
+    // Shared sstables are also selected by the other owning shards.
+    if (std::ranges::any_of(ssts, [] (const sstables::shared_sstable& sst) { return !sst->has_repair_digest() || sst->is_shared(); })) {
+        co_return std::nullopt;
+    }
+    std::map<uint32_t, sstables::repair_digest_bucket> buckets;
+    for (auto& sst : ssts) {
+        auto digest = co_await sst->read_repair_digest(first, last, bucket_bits, service::get_local_streaming_priority());
+        if (!digest) {
+            co_return std::nullopt;
+        }
+        for (auto& b : *digest) {
+            auto& acc = buckets.try_emplace(b.index, sstables::repair_digest_bucket{b.index, 0, 0}).first->second;
+            acc.fragments += b.fragments;
+            acc.sum += b.sum;
+        }
+    }
+    co_return boost::copy_range<utils::chunked_vector<sstables::repair_digest_bucket>>(buckets | boost::adaptors::map_values);
+}
+
 std::vector<sstables::shared_sstable> table::in_strategy_sstables() const {
     auto sstables = _main_sstables->all();
     return boost::copy_range<std::vector<sstables::shared_sstable>>(*sstables
@@ -1758,6 +1919,37 @@ table::local_base_lock(
     }
 }
 
+/**
+ * Checks whether the given partition is known not to exist in the table, in
+ * which case view update generation has no existing rows to read.
+ *
+ * Only memtables and sstable bloom filters are consulted, so the check is
+ * cheap and never touches the disk. The cache needs no checking, because it
+ * only holds data which is also present in memtables or sstables.
+ *
+ * The result is stable only as long as the caller holds the base lock on
+ * the rows it is about to modify.
+ */
+bool table::partition_definitely_absent(const dht::decorated_key& key) const {
+    for (auto&& mt : *_memtables) {
+        if (mt->contains(key)) {
+            return false;
+        }
+    }
+    auto sel = _sstables->make_incremental_selector();
+    auto& ssts = sel.select(key).sstables;
+    if (ssts.empty()) {
+        return true;
+    }
+    auto hk = sstables::sstable::make_hashed_key(*_schema, key.key());
+    for (auto&& sst : ssts) {
+        if (sst->filter_has_key(hk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Given some updates on the base table and assuming there are no pre-existing, overlapping updates,
  * generates the mutations to be applied to the base table's views, and sends them to the paired
@@ -1978,10 +2170,12 @@ table::query(schema_ptr s,
         auto&& range = *qs.current_partition_range++;
 
         auto querier_opt = cache_ctx.lookup_data_querier(*s, range, qs.cmd.slice, trace_state);
-        auto q = querier_opt
-                ? std::move(*querier_opt)
-                : query::data_querier(as_mutation_source(), s, class_config.semaphore.make_permit(s.get(), "data-query"), range, qs.cmd.slice,
-                        service::get_local_sstable_query_read_priority(), trace_state);
+        auto make_querier = [&] {
+            auto [source, reversed] = as_query_source(range, qs.cmd.slice, class_config.max_memory_for_unlimited_query);
+            return query::data_querier(source, s, class_config.semaphore.make_permit(s.get(), "data-query"), range, qs.cmd.slice,
+                    service::get_local_sstable_query_read_priority(), trace_state, reversed);
+        };
+        auto q = querier_opt ? std::move(*querier_opt) : make_querier();
 
         std::exception_ptr ex;
       try {
@@ -2017,10 +2211,12 @@ table::mutation_query(schema_ptr s,
     }
 
     auto querier_opt = cache_ctx.lookup_mutation_querier(*s, range, cmd.slice, trace_state);
-    auto q = querier_opt
-            ? std::move(*querier_opt)
-            : query::mutation_querier(as_mutation_source(), s, class_config.semaphore.make_permit(s.get(), "mutation-query"), range, cmd.slice,
-                    service::get_local_sstable_query_read_priority(), trace_state);
+    auto make_querier = [&] {
+        auto [source, reversed] = as_query_source(range, cmd.slice, class_config.max_memory_for_unlimited_query);
+        return query::mutation_querier(source, s, class_config.semaphore.make_permit(s.get(), "mutation-query"), range, cmd.slice,
+                service::get_local_sstable_query_read_priority(), trace_state, reversed);
+    };
+    auto q = querier_opt ? std::move(*querier_opt) : make_querier();
 
     std::exception_ptr ex;
   try {
@@ -2053,6 +2249,49 @@ table::as_mutation_source() const {
     });
 }
 
+std::pair<mutation_source, query::reader_is_reversed>
+table::as_query_source(const dht::partition_range& range, const query::partition_slice& slice, query::max_result_size max_size) const {
+    // A reversed read of a forward source has to read the whole partition
+    // into memory before emitting its last row first. Read single partitions
+    // in reverse in each of the memtables, the cache and the sstables instead.
+    if (!slice.options.contains(query::partition_slice::option::reversed) || !range.is_singular() || !range.start()->value().has_key()
+            || _virtual_reader) {
+        return {as_mutation_source(), query::reader_is_reversed::no};
+    }
+    // When the sstables are laid out along the clustering order, as with
+    // TWCS, read the partition in reverse one chunk of sstables at a time,
+    // so that a read of the latest rows stops before even opening the older
+    // sstables.
+    auto split_positions = _sstables->clustering_split_positions(range.start()->value());
+    if (!split_positions.empty()) {
+        tlogger.trace("Reading partition {} of {}.{} in reverse in {} chunks", range.start()->value(), _schema->ks_name(), _schema->cf_name(),
+                split_positions.size() + 1);
+        auto source = mutation_source([this, split_positions = std::move(split_positions), max_size] (schema_ptr s,
+                                       reader_permit permit,
+                                       const dht::partition_range& range,
+                                       const query::partition_slice& slice,
+                                       const io_priority_class& pc,
+                                       tracing::trace_state_ptr trace_state,
+                                       streamed_mutation::forwarding,
+                                       mutation_reader::forwarding) {
+            return make_chunked_reversing_reader(as_mutation_source(), std::move(s), std::move(permit), range, slice, pc, std::move(trace_state),
+                    split_positions, max_size);
+        });
+        return {std::move(source), query::reader_is_reversed::yes};
+    }
+    auto source = mutation_source([this, max_size] (schema_ptr s,
+                                   reader_permit permit,
+                                   const dht::partition_range& range,
+                                   const query::partition_slice& slice,
+                                   const io_priority_class& pc,
+                                   tracing::trace_state_ptr trace_state,
+                                   streamed_mutation::forwarding,
+                                   mutation_reader::forwarding) {
+        return make_reversed_reader(std::move(s), std::move(permit), range, slice, pc, std::move(trace_state), max_size);
+    });
+    return {std::move(source), query::reader_is_reversed::yes};
+}
+
 void table::add_coordinator_read_latency(utils::estimated_histogram::duration latency) {
     _stats.estimated_coordinator_read.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
 }
@@ -2243,7 +2482,13 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
         std::move(m),
         [base, views = std::move(views), lock = std::move(lock), this, timeout, now, source = std::move(source), &sem, &io_priority, tr_state = std::move(tr_state)] (auto& pk, auto& slice, auto& m) mutable {
             auto permit = sem.make_permit(base.get(), "push-view-updates-2");
-            auto reader = source.make_reader(base, permit, pk, slice, io_priority, tr_state, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+            flat_mutation_reader_opt reader;
+            if (this->partition_definitely_absent(m.decorated_key())) {
+                tracing::trace(tr_state, "Base partition does not exist, skipping read-before-write");
+                ++_config.cf_stats->total_view_update_reads_skipped;
+            } else {
+                reader = source.make_reader(base, permit, pk, slice, io_priority, tr_state, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+            }
             return this->generate_and_propagate_view_updates(base, std::move(permit), std::move(views), std::move(m), std::move(reader), tr_state, now)
                     .then([base, tr_state = std::move(tr_state), lock = std::move(lock)] () mutable {
                 tracing::trace(tr_state, "View updates for {}.{} were generated and propagated", base->ks_name(), base->cf_name());
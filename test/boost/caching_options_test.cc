@@ -39,6 +39,22 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         sstring out_str = co.to_sstring();
         BOOST_REQUIRE_EQUAL(in_str, out_str);
     }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "FREQUENT"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.frequency_admission());
+        BOOST_REQUIRE(in_map == co.to_map());
+    }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "ALL"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(!co.frequency_admission());
+        BOOST_REQUIRE(co.to_map().count("admission") == 0);
+    }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "SOME"}};
+        BOOST_REQUIRE_THROW(caching_options::from_map(in_map), std::exception);
+    }
     {
         sstring in_str = "{\"keys\": \"SOME\", \"rows_per_partition\": \"ALL\"}";
         BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
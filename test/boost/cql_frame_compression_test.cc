@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/semaphore.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "transport/frame_compression.hh"
+
+using namespace cql_transport;
+
+namespace {
+
+// Compressible, but not trivially so: snappy output is a sizeable fraction of the input.
+bytes_ostream make_body(size_t size) {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<int> dist('a', 'p');
+    bytes_ostream body;
+    while (size) {
+        bytes chunk(bytes::initialized_later(), std::min<size_t>(size, 1000));
+        for (auto& c : chunk) {
+            c = dist(gen);
+        }
+        body.write(chunk);
+        size -= chunk.size();
+    }
+    return body;
+}
+
+// Splits the buffer into fragments of the given size, as if it was read from the network.
+fragmented_temporary_buffer to_fragments(bytes_ostream& in, size_t fragment_size) {
+    auto flat = in.linearize();
+    std::vector<temporary_buffer<char>> fragments;
+    for (size_t pos = 0; pos < flat.size(); pos += fragment_size) {
+        auto n = std::min(fragment_size, flat.size() - pos);
+        fragments.emplace_back(reinterpret_cast<const char*>(flat.data()) + pos, n);
+    }
+    return fragmented_temporary_buffer(std::move(fragments), flat.size());
+}
+
+bytes linearize(const fragmented_temporary_buffer& buf, size_t& nr_fragments) {
+    bytes out;
+    nr_fragments = 0;
+    for (bytes_view frag : fragmented_temporary_buffer::view(buf)) {
+        out.append(frag.data(), frag.size());
+        ++nr_fragments;
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+SEASTAR_THREAD_TEST_CASE(test_snappy_multi_fragment_frame) {
+    // Small frames are decompressed into a single fragment, large ones into
+    // many, without the output being allocated contiguously.
+    for (size_t body_size : {size_t(0), size_t(100), size_t(100 * 1024), size_t(1024 * 1024)}) {
+        BOOST_TEST_MESSAGE(format("body size {}", body_size));
+        auto body = make_body(body_size);
+        auto compressed = snappy_fragmented::compress(body);
+        BOOST_REQUIRE_GT(compressed.size(), 0);
+
+        // The compressed frame arrives in odd-sized fragments, which snappy's
+        // tags and blocks straddle.
+        auto frame = to_fragments(compressed, 777);
+        BOOST_REQUIRE_EQUAL(snappy_fragmented::uncompressed_length(frame), body_size);
+
+        size_t nr_fragments;
+        auto out = linearize(snappy_fragmented::uncompress(frame), nr_fragments);
+        BOOST_REQUIRE(bytes_view(out) == body.linearize());
+        if (body_size > fragmented_temporary_buffer::default_fragment_size) {
+            BOOST_REQUIRE_GT(nr_fragments, 1);
+        }
+        for (bytes_view frag : fragmented_temporary_buffer::view(snappy_fragmented::uncompress(frame))) {
+            BOOST_REQUIRE_LE(frag.size(), fragmented_temporary_buffer::default_fragment_size);
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_snappy_corrupted_frame) {
+    auto body = make_body(200 * 1024);
+    auto compressed = snappy_fragmented::compress(body);
+    auto flat = compressed.linearize();
+    bytes_ostream truncated;
+    truncated.write(flat.substr(0, flat.size() / 2));
+    auto frame = to_fragments(truncated, 1000);
+    BOOST_REQUIRE_EQUAL(snappy_fragmented::uncompressed_length(frame), body.size());
+    BOOST_REQUIRE_THROW(snappy_fragmented::uncompress(frame), std::runtime_error);
+
+    bytes_ostream garbage;
+    garbage.write(bytes(10, int8_t(0xff)));
+    auto garbage_frame = to_fragments(garbage, 3);
+    BOOST_REQUIRE_THROW(snappy_fragmented::uncompressed_length(garbage_frame), std::runtime_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_decompression_memory_oversized_frame) {
+    semaphore memory(1024 * 1024);
+    auto permit = get_units(memory, 1000).get0();
+    uint64_t blocked = 0;
+
+    // The estimate is the compressed and decompressed sizes plus 8000 bytes of overhead.
+    auto f = reserve_decompression_memory(memory, permit, 1000, 100 * 1024, 100 * 1024, false, blocked);
+    BOOST_REQUIRE(f.failed());
+    BOOST_REQUIRE_THROW(f.get(), decompressed_frame_too_large);
+    // The permit is left alone, for the connection to answer with an error and go on.
+    BOOST_REQUIRE_EQUAL(permit.count(), 1000);
+    BOOST_REQUIRE_EQUAL(blocked, 0);
+
+    reserve_decompression_memory(memory, permit, 1000, 100 * 1024 - 9000, 100 * 1024, false, blocked).get();
+    BOOST_REQUIRE_EQUAL(permit.count(), 100 * 1024);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_decompression_memory_permit_covers_frame) {
+    semaphore memory(100000);
+    auto permit = get_units(memory, 50000).get0();
+    uint64_t blocked = 0;
+    auto f = reserve_decompression_memory(memory, permit, 1000, 1000, 1000000, false, blocked);
+    BOOST_REQUIRE(f.available());
+    f.get();
+    BOOST_REQUIRE_EQUAL(permit.count(), 50000);
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 50000);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_decompression_memory_waits_without_holding_permit) {
+    semaphore memory(100000);
+    uint64_t blocked = 0;
+
+    // Two connections hold a permit for the compressed frame each and both
+    // need 80000 units for decompressing it. Had they waited while holding
+    // their permits, neither would ever get the memory.
+    auto permit_a = get_units(memory, 60000).get0();
+    auto permit_b = get_units(memory, 40000).get0();
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 0);
+
+    auto fa = reserve_decompression_memory(memory, permit_a, 1000, 71000, 1000000, false, blocked);
+    BOOST_REQUIRE(!fa.available());
+    BOOST_REQUIRE_EQUAL(permit_a.count(), 0);
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 60000);
+
+    auto fb = reserve_decompression_memory(memory, permit_b, 1000, 71000, 1000000, false, blocked);
+    BOOST_REQUIRE_EQUAL(permit_b.count(), 0);
+    fa.get();
+    BOOST_REQUIRE_EQUAL(permit_a.count(), 80000);
+    BOOST_REQUIRE_EQUAL(blocked, 2);
+
+    // The second connection gets its memory once the first one is done with the request.
+    BOOST_REQUIRE(!fb.available());
+    permit_a.return_all();
+    fb.get();
+    BOOST_REQUIRE_EQUAL(permit_b.count(), 80000);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_decompression_memory_shedding) {
+    semaphore memory(100000);
+    uint64_t blocked = 0;
+    auto other = get_units(memory, 90000).get0();
+    auto permit = get_units(memory, 5000).get0();
+
+    // With shedding allowed, a request doesn't wait long for memory and gives
+    // back its permit either way.
+    auto f = reserve_decompression_memory(memory, permit, 1000, 71000, 1000000, true, blocked);
+    BOOST_REQUIRE_THROW(f.get(), semaphore_timed_out);
+    BOOST_REQUIRE_EQUAL(permit.count(), 0);
+    BOOST_REQUIRE_EQUAL(blocked, 1);
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 10000);
+}
@@ -43,6 +43,11 @@
 #include "test/lib/tmpdir.hh"
 #include "db/data_listeners.hh"
 #include "multishard_mutation_query.hh"
+#include "distributed_loader.hh"
+#include "streaming/stream_sstable_files.hh"
+#include "sstables/checksum_utils.hh"
+#include "test/lib/cql_assertions.hh"
+#include <seastar/core/fstream.hh>
 
 using namespace std::chrono_literals;
 
@@ -101,6 +106,49 @@ SEASTAR_TEST_CASE(test_safety_after_truncate) {
     }, cfg);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_large_memtable_flush_is_split) {
+    auto cfg = make_shared<db::config>();
+    cfg->memtable_flush_split_threshold_in_mb.set(1);
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (pk int, v blob, primary key (pk));").get();
+        auto& db = e.local_db();
+        auto& cf = db.find_column_family("ks", "cf");
+        auto s = cf.schema();
+
+        // About 4MB of data, so the flush of the memtable can use all the writers
+        // memtable_flush_concurrency allows.
+        auto apply = [&] (int pk, size_t value_size) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", data_value(bytes(value_size, int8_t(pk))), api::new_timestamp());
+            db.apply(s, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+        };
+        const int nr_partitions = 64;
+        for (int i = 0; i < nr_partitions; ++i) {
+            apply(i, 64 * 1024);
+        }
+
+        auto split_flushes = cf.cf_stats()->split_memtables_flushes_count;
+        auto sstables = cf.sstables_count();
+        // No other flush holds or waits for a permit, so the flush takes the spare one.
+        BOOST_REQUIRE_EQUAL(cf.get_dirty_memory_manager().max_concurrent_flushes(), 2);
+        cf.flush().get();
+        BOOST_REQUIRE_EQUAL(cf.cf_stats()->split_memtables_flushes_count, split_flushes + 1);
+        BOOST_REQUIRE_EQUAL(cf.sstables_count(), sstables + 2);
+        // All permits are released once the flush is done.
+        BOOST_REQUIRE_EQUAL(cf.get_dirty_memory_manager().flushes_in_progress(), 0);
+
+        auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(),
+                query::max_result_size(std::numeric_limits<size_t>::max()), query::row_limit(1000));
+        auto&& [result, cache_temperature] = db.query(s, cmd, query::result_options::only_result(), {query::full_partition_range}, nullptr, db::no_timeout).get0();
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *result)).has_size(nr_partitions);
+
+        // A small memtable is flushed by a single writer.
+        apply(0, 1);
+        cf.flush().get();
+        BOOST_REQUIRE_EQUAL(cf.cf_stats()->split_memtables_flushes_count, split_flushes + 1);
+    }, cfg).get();
+}
+
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env([](cql_test_env& e) {
         return seastar::async([&] {
@@ -379,6 +427,125 @@ future<> take_snapshot(cql_test_env& e) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_stream_sstable_files) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        using streaming::stream_sstable_file_chunk;
+        using streaming::stream_sstable_files_cmd;
+
+        e.execute_cql("create table ks.cf (p int, c int, v int, primary key (p, c))").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("insert into ks.cf (p, c, v) values ({}, {}, {})", i, i, i)).get();
+        }
+        e.db().invoke_on_all([] (database& db) {
+            return db.find_column_family("ks", "cf").flush();
+        }).get();
+
+        // What the sender sends for each component, see send_sstable_files()
+        struct component {
+            sstring name;
+            std::vector<bytes> chunks;
+            uint32_t checksum = crc32_utils::init_checksum();
+        };
+        auto filenames = e.db().map_reduce0([] (database& db) {
+            std::vector<sstring> ret;
+            for (auto& sst : *db.find_column_family("ks", "cf").get_sstables()) {
+                auto names = sst->component_filenames();
+                ret.insert(ret.end(), names.begin(), names.end());
+            }
+            return ret;
+        }, std::vector<sstring>(), [] (std::vector<sstring> a, std::vector<sstring> b) {
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        }).get0();
+        BOOST_REQUIRE(!filenames.empty());
+        std::vector<component> components;
+        size_t nr_sstables = 0;
+        for (auto& filename : filenames) {
+            component c{sstring(std::filesystem::path(filename).filename().native())};
+            nr_sstables += std::string_view(c.name).ends_with("TOC.txt");
+            auto in = make_file_input_stream(open_file_dma(filename, open_flags::ro).get0());
+            for (auto buf = in.read().get0(); !buf.empty(); buf = in.read().get0()) {
+                c.checksum = crc32_utils::checksum(c.checksum, buf.get(), buf.size());
+                c.chunks.emplace_back(reinterpret_cast<const bytes::value_type*>(buf.get()), buf.size());
+            }
+            in.close().get();
+            components.push_back(std::move(c));
+        }
+
+        e.execute_cql("truncate ks.cf").get();
+        assert_that(e.execute_cql("select * from ks.cf").get0()).is_rows().is_empty();
+
+        auto table_dir = std::filesystem::path(e.local_db().find_column_family("ks", "cf").dir());
+        auto receive = [&] (std::function<void (streaming::sstable_files_writer&)> send) {
+            auto dir = table_dir / sstables::sstable::streaming_dir_basename().c_str() / utils::make_random_uuid().to_sstring().c_str();
+            recursive_touch_directory(dir.native()).get();
+            streaming::sstable_files_writer writer(dir);
+            std::exception_ptr ex;
+            try {
+                send(writer);
+                writer.check_finished();
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            writer.close().get();
+            if (ex) {
+                lister::rmdir(dir).get();
+                std::rethrow_exception(ex);
+            }
+            return dir;
+        };
+        auto send_component = [] (streaming::sstable_files_writer& writer, const component& c, uint32_t checksum) {
+            for (auto& chunk : c.chunks) {
+                writer.consume(stream_sstable_file_chunk{c.name, chunk, 0}, stream_sstable_files_cmd::component_data).get();
+            }
+            writer.consume(stream_sstable_file_chunk{c.name, bytes(), checksum}, stream_sstable_files_cmd::component_end).get();
+        };
+        auto end_of_stream = [] (streaming::sstable_files_writer& writer) {
+            writer.consume(stream_sstable_file_chunk{}, stream_sstable_files_cmd::end_of_stream).get();
+        };
+
+        // Names which are not the ones of sstable components are rejected.
+        for (sstring name : {"../md-1-big-Data.db", "md-1-big-Data.db/x", "..", "", "foo"}) {
+            BOOST_REQUIRE_THROW(receive([&] (streaming::sstable_files_writer& writer) {
+                send_component(writer, component{name, {to_bytes("x")}}, 0);
+            }), std::exception);
+        }
+        // So are corrupted components, incomplete ones, and streams without end_of_stream.
+        BOOST_REQUIRE_THROW(receive([&] (streaming::sstable_files_writer& writer) {
+            send_component(writer, components.front(), components.front().checksum + 1);
+            end_of_stream(writer);
+        }), std::runtime_error);
+        BOOST_REQUIRE_THROW(receive([&] (streaming::sstable_files_writer& writer) {
+            writer.consume(stream_sstable_file_chunk{components.front().name, to_bytes("x"), 0}, stream_sstable_files_cmd::component_data).get();
+            end_of_stream(writer);
+        }), std::runtime_error);
+        BOOST_REQUIRE_THROW(receive([&] (streaming::sstable_files_writer& writer) {
+            send_component(writer, components.front(), components.front().checksum);
+        }), std::runtime_error);
+        BOOST_REQUIRE_THROW(receive([&] (streaming::sstable_files_writer& writer) {
+            writer.consume(stream_sstable_file_chunk{}, stream_sstable_files_cmd::error).get();
+        }), std::runtime_error);
+
+        auto dir = receive([&] (streaming::sstable_files_writer& writer) {
+            for (auto& c : components) {
+                send_component(writer, c, c.checksum);
+            }
+            end_of_stream(writer);
+        });
+        auto loaded = distributed_loader::process_streamed_dir(e.db(), e.sys_dist_ks(), e.view_update_generator(), "ks", "cf", dir,
+                streaming::stream_reason::bootstrap, sstables::offstrategy::yes).get0();
+        BOOST_REQUIRE_EQUAL(loaded, nr_sstables);
+        lister::rmdir(dir).get();
+
+        assert_that(e.execute_cql("select * from ks.cf").get0()).is_rows().with_size(10);
+        // Bootstrap loads them off-strategy, into the maintenance set.
+        auto in_strategy = e.db().map_reduce0([] (database& db) {
+            return db.find_column_family("ks", "cf").in_strategy_sstables().size();
+        }, size_t(0), std::plus<size_t>()).get0();
+        BOOST_REQUIRE_EQUAL(in_strategy, 0);
+    }).get();
+}
+
 SEASTAR_TEST_CASE(snapshot_works) {
     return do_with_some_data([] (cql_test_env& e) {
         take_snapshot(e).get();
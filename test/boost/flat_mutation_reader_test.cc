@@ -823,3 +823,50 @@ SEASTAR_THREAD_TEST_CASE(test_reverse_reader_memory_limit) {
     test_with_partition(true);
     test_with_partition(false);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_chunked_reversing_reader) {
+    random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+    auto s = gen.schema();
+
+    auto slice = s->full_slice();
+    slice.options.set<query::partition_slice::option::reversed>();
+
+    for (auto& m : gen(4)) {
+        auto readers_created = make_lw_shared<size_t>(0);
+        auto source = mutation_source([m, readers_created] (schema_ptr, reader_permit permit, const dht::partition_range& pr,
+                const query::partition_slice& slice, const io_priority_class&, tracing::trace_state_ptr, streamed_mutation::forwarding fwd_sm) {
+            ++*readers_created;
+            return flat_mutation_reader_from_mutations(std::move(permit), {m}, pr, slice, fwd_sm);
+        });
+        auto pr = dht::partition_range::make_singular(m.decorated_key());
+
+        std::vector<position_in_partition> split_positions;
+        unsigned i = 0;
+        for (auto& row : m.partition().clustered_rows()) {
+            if (i++ % 3 == 1) {
+                split_positions.push_back(position_in_partition::before_key(row.key()));
+            }
+        }
+        const auto chunks = split_positions.size() + 1;
+        testlog.info("Reading partition {} in {} chunks", m.decorated_key(), chunks);
+
+        auto rd = make_chunked_reversing_reader(source, s, tests::make_permit(), pr, slice, default_priority_class(), nullptr,
+                split_positions, query::max_result_size(size_t(1) << 20));
+        auto close_rd = deferred_close(rd);
+        auto muts = rd.consume(flat_stream_consumer(s, reversed_partitions::yes), db::no_timeout).get0();
+        BOOST_REQUIRE_EQUAL(muts.size(), 1);
+        assert_that(muts[0]).is_equal_to(m);
+        BOOST_REQUIRE_EQUAL(*readers_created, chunks);
+
+        // A read stopped after the first rows doesn't read the first chunks.
+        if (chunks > 2 && !m.partition().clustered_rows().empty()) {
+            *readers_created = 0;
+            auto rd = make_chunked_reversing_reader(source, s, tests::make_permit(), pr, slice, default_priority_class(), nullptr,
+                    split_positions, query::max_result_size(size_t(1) << 20));
+            auto close_rd = deferred_close(rd);
+            rd.set_max_buffer_size(1);
+            rd.fill_buffer(db::no_timeout).get();
+            BOOST_REQUIRE_EQUAL(*readers_created, 1);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include "utils/frequency_sketch.hh"
+
+BOOST_AUTO_TEST_CASE(test_frequency_sketch_estimates) {
+    utils::frequency_sketch sketch(1024, 1'000'000);
+
+    BOOST_REQUIRE_EQUAL(sketch.width(), 1024);
+    BOOST_REQUIRE_EQUAL(sketch.estimate(1), 0);
+
+    for (int i = 0; i < 5; ++i) {
+        sketch.record(1);
+    }
+    sketch.record(2);
+
+    // Count-min sketches never underestimate
+    BOOST_REQUIRE_GE(sketch.estimate(1), 5);
+    BOOST_REQUIRE_GE(sketch.estimate(2), 1);
+    BOOST_REQUIRE_LT(sketch.estimate(2), sketch.estimate(1));
+
+    for (int i = 0; i < 100; ++i) {
+        sketch.record(1);
+    }
+    BOOST_REQUIRE_EQUAL(sketch.estimate(1), utils::frequency_sketch::max_count);
+}
+
+BOOST_AUTO_TEST_CASE(test_frequency_sketch_aging) {
+    utils::frequency_sketch sketch(1024, 16);
+
+    for (int i = 0; i < 8; ++i) {
+        BOOST_REQUIRE(!sketch.record(7));
+    }
+    BOOST_REQUIRE_EQUAL(sketch.estimate(7), 8);
+
+    // Accesses of other keys push the sketch to its sample size
+    bool aged = false;
+    for (uint64_t key = 100; key < 108; ++key) {
+        aged |= sketch.record(key);
+    }
+    BOOST_REQUIRE(aged);
+    BOOST_REQUIRE_EQUAL(sketch.estimate(7), 4);
+
+    sketch.clear();
+    BOOST_REQUIRE_EQUAL(sketch.estimate(7), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_frequency_sketch_distinguishes_hot_keys) {
+    utils::frequency_sketch sketch(4096, 1'000'000);
+
+    // A scan touching many keys once must not make them look as hot
+    // as a small working set which is read repeatedly.
+    for (uint64_t key = 0; key < 2000; ++key) {
+        sketch.record(key * 0x9e3779b97f4a7c15ull);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (uint64_t key = 1'000'000; key < 1'000'100; ++key) {
+            sketch.record(key);
+        }
+    }
+
+    unsigned cold_admitted = 0;
+    for (uint64_t key = 0; key < 2000; ++key) {
+        cold_admitted += sketch.estimate(key * 0x9e3779b97f4a7c15ull) >= 2;
+    }
+    for (uint64_t key = 1'000'000; key < 1'000'100; ++key) {
+        BOOST_REQUIRE_GE(sketch.estimate(key), 3);
+    }
+    BOOST_REQUIRE_LT(cold_admitted, 20);
+}
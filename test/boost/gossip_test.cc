@@ -46,6 +46,17 @@ namespace db::view {
 class view_update_generator;
 }
 
+namespace gms {
+
+class gossiper_test {
+public:
+    static bool is_stale_state(const gossiper& g, inet_address node, const endpoint_state& remote_state) {
+        return g.is_stale_state(node, remote_state);
+    }
+};
+
+} // namespace gms
+
 SEASTAR_TEST_CASE(test_boot_shutdown){
     return seastar::async([] {
         distributed<database> db;
@@ -127,3 +138,80 @@ SEASTAR_TEST_CASE(test_boot_shutdown){
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_is_stale_state) {
+    return seastar::async([] {
+        auto cfg = std::make_unique<db::config>();
+        sharded<abort_source> abort_sources;
+        sharded<gms::feature_service> feature_service;
+        sharded<locator::shared_token_metadata> token_metadata;
+        sharded<netw::messaging_service> _messaging;
+        utils::fb_utilities::set_broadcast_address(gms::inet_address("127.0.0.1"));
+
+        token_metadata.start().get();
+        auto stop_token_mgr = defer([&token_metadata] { token_metadata.stop().get(); });
+
+        abort_sources.start().get();
+        auto stop_abort_sources = defer([&] { abort_sources.stop().get(); });
+
+        feature_service.start(gms::feature_config_from_db_config(*cfg)).get();
+        auto stop_feature_service = defer([&] { feature_service.stop().get(); });
+
+        locator::i_endpoint_snitch::create_snitch("SimpleSnitch").get();
+        auto stop_snitch = defer([&] { locator::i_endpoint_snitch::stop_snitch().get(); });
+
+        _messaging.start(gms::inet_address("127.0.0.1"), 7000).get();
+        auto stop_messaging_service = defer([&] { _messaging.stop().get(); });
+
+        gms::get_gossiper().start(std::ref(abort_sources), std::ref(feature_service), std::ref(token_metadata), std::ref(_messaging), std::ref(*cfg)).get();
+        auto stop_gossiper = defer([&] { gms::get_gossiper().stop().get(); });
+
+        auto& g = gms::get_local_gossiper();
+        const int generation = 10;
+        const int version = 5;
+
+        // A state of the given generation with versions up to the given one.
+        auto make_state = [] (int generation, int version) {
+            return gms::endpoint_state(gms::heart_beat_state(generation, version));
+        };
+
+        auto live = gms::inet_address("127.0.0.2");
+        g.endpoint_state_map[live] = make_state(generation, version);
+
+        auto dead = gms::inet_address("127.0.0.3");
+        auto dead_state = make_state(generation, version);
+        dead_state.add_application_state(gms::application_state::STATUS, gms::versioned_value(gms::versioned_value::left({}, 0).value, version - 1));
+        dead_state.mark_dead();
+        g.endpoint_state_map[dead] = dead_state;
+
+        // Known, but not marked alive yet.
+        auto not_yet_alive = gms::inet_address("127.0.0.4");
+        auto not_yet_alive_state = make_state(generation, version);
+        not_yet_alive_state.mark_dead();
+        g.endpoint_state_map[not_yet_alive] = not_yet_alive_state;
+
+        auto is_stale = [&] (gms::inet_address node, int generation, int version) {
+            return gms::gossiper_test::is_stale_state(g, node, make_state(generation, version));
+        };
+
+        for (auto node : {live, dead}) {
+            BOOST_REQUIRE(is_stale(node, generation, version));
+            BOOST_REQUIRE(is_stale(node, generation, version - 1));
+            BOOST_REQUIRE(!is_stale(node, generation, version + 1));
+        }
+
+        // Applying even an older state may mark the node alive.
+        BOOST_REQUIRE(!is_stale(not_yet_alive, generation, version));
+        BOOST_REQUIRE(!is_stale(not_yet_alive, generation, version - 1));
+        BOOST_REQUIRE(!is_stale(not_yet_alive, generation, version + 1));
+
+        // The generation decides first.
+        for (auto node : {live, dead, not_yet_alive}) {
+            BOOST_REQUIRE(is_stale(node, generation - 1, version + 1));
+            BOOST_REQUIRE(!is_stale(node, generation + 1, 0));
+        }
+
+        // Nothing is known about the node.
+        BOOST_REQUIRE(!is_stale(gms::inet_address("127.0.0.5"), generation, version));
+    });
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/hints/hints_batch.hh"
+#include "db/hints/hints_coalescer.hh"
+#include "schema_builder.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/mutation_assertions.hh"
+
+using namespace db::hints;
+
+namespace {
+
+// Hints of a segment, in the order they were written, each for a different partition.
+using hints_segment = std::vector<std::pair<db::replay_position, frozen_mutation>>;
+
+hints_segment make_segment(simple_schema& s, int nr_hints) {
+    hints_segment seg;
+    int i = 0;
+    for (auto& dk : s.make_pkeys(nr_hints)) {
+        mutation m(s.schema(), dk);
+        s.add_row(m, s.make_ckey(0), "v");
+        seg.emplace_back(db::replay_position(0, 1, 100 * ++i), freeze(m));
+    }
+    return seg;
+}
+
+using delivered_keys = std::set<dht::decorated_key, dht::decorated_key::less_comparator>;
+
+// Replays the hints of the segment starting at the given position, the way the hints sender does:
+// hints are collected into batches of up to max_batch_size bytes, no more hints are read after
+// a batch failed to be sent, and what is left in the batch is sent once reading stops.
+//
+// Sending the batches whose number is in failing_batches fails.
+//
+// \return the position to resume the replay from, disengaged if all the hints were sent.
+std::optional<db::replay_position> replay(schema_ptr s, const hints_segment& seg, db::replay_position from, size_t max_batch_size,
+        std::set<unsigned> failing_batches, delivered_keys& delivered) {
+    hints_batch batch;
+    unsigned batch_nr = 0;
+    std::optional<db::replay_position> first_failed_rp;
+
+    auto send_batch = [&] {
+        if (batch.empty()) {
+            return;
+        }
+        auto rp = *batch.first_rp();
+        auto fms = batch.release();
+        if (failing_batches.contains(batch_nr++)) {
+            if (!first_failed_rp || rp < *first_failed_rp) {
+                first_failed_rp = rp;
+            }
+            return;
+        }
+        for (auto& fm : fms) {
+            delivered.insert(fm.decorated_key(*s));
+        }
+    };
+
+    for (auto& [rp, fm] : seg) {
+        if (rp < from) {
+            continue;
+        }
+        if (first_failed_rp) {
+            break;
+        }
+        batch.add(fm, rp);
+        if (batch.size_bytes() >= max_batch_size) {
+            send_batch();
+        }
+    }
+    send_batch();
+
+    return first_failed_rp;
+}
+
+} // anonymous namespace
+
+SEASTAR_THREAD_TEST_CASE(test_hints_batch) {
+    simple_schema s;
+    auto seg = make_segment(s, 3);
+
+    hints_batch batch;
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE(!batch.first_rp());
+
+    size_t size = 0;
+    for (auto& [rp, fm] : seg) {
+        batch.add(fm, rp);
+        size += fm.representation().size();
+    }
+    BOOST_REQUIRE(!batch.empty());
+    BOOST_REQUIRE_EQUAL(batch.size_bytes(), size);
+    BOOST_REQUIRE_EQUAL(*batch.first_rp(), seg.front().first);
+
+    auto fms = batch.release();
+    BOOST_REQUIRE_EQUAL(fms.size(), seg.size());
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE_EQUAL(batch.size_bytes(), 0);
+    BOOST_REQUIRE(!batch.first_rp());
+
+    // A new batch is accounted to its own first hint.
+    batch.add(seg.back().second, seg.back().first);
+    BOOST_REQUIRE_EQUAL(*batch.first_rp(), seg.back().first);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_failed_hints_batch_is_replayed_from_its_first_hint) {
+    simple_schema s;
+    auto seg = make_segment(s, 10);
+    // All the hints have the same size, batches hold 3 of them.
+    auto max_batch_size = 3 * seg.front().second.representation().size();
+
+    auto all_delivered = [&] (const delivered_keys& delivered) {
+        BOOST_REQUIRE_EQUAL(delivered.size(), seg.size());
+        for (auto& [rp, fm] : seg) {
+            BOOST_REQUIRE(delivered.contains(fm.decorated_key(*s.schema())));
+        }
+    };
+
+    // The second batch fails: the replay is resumed from its first hint, the hints sent before are kept.
+    {
+        delivered_keys delivered(dht::decorated_key::less_comparator(s.schema()));
+        auto resume_rp = replay(s.schema(), seg, db::replay_position(), max_batch_size, {1}, delivered);
+        BOOST_REQUIRE(resume_rp);
+        BOOST_REQUIRE_EQUAL(*resume_rp, seg[3].first);
+        BOOST_REQUIRE_EQUAL(delivered.size(), 3);
+
+        BOOST_REQUIRE(!replay(s.schema(), seg, *resume_rp, max_batch_size, {}, delivered));
+        all_delivered(delivered);
+    }
+
+    // The last batch, which is not full and sent once the whole segment was read, fails.
+    {
+        delivered_keys delivered(dht::decorated_key::less_comparator(s.schema()));
+        auto resume_rp = replay(s.schema(), seg, db::replay_position(), max_batch_size, {3}, delivered);
+        BOOST_REQUIRE(resume_rp);
+        BOOST_REQUIRE_EQUAL(*resume_rp, seg[9].first);
+        BOOST_REQUIRE_EQUAL(delivered.size(), 9);
+
+        BOOST_REQUIRE(!replay(s.schema(), seg, *resume_rp, max_batch_size, {}, delivered));
+        all_delivered(delivered);
+    }
+
+    // The replay keeps failing at the same batch, until it succeeds.
+    {
+        delivered_keys delivered(dht::decorated_key::less_comparator(s.schema()));
+        auto resume_rp = replay(s.schema(), seg, db::replay_position(), max_batch_size, {2}, delivered);
+        BOOST_REQUIRE_EQUAL(*resume_rp, seg[6].first);
+        resume_rp = replay(s.schema(), seg, *resume_rp, max_batch_size, {0}, delivered);
+        BOOST_REQUIRE_EQUAL(*resume_rp, seg[6].first);
+        BOOST_REQUIRE(!replay(s.schema(), seg, *resume_rp, max_batch_size, {}, delivered));
+        all_delivered(delivered);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hints_coalescing_keeps_the_newest_write) {
+    simple_schema s;
+    auto pkeys = s.make_pkeys(2);
+    auto ck0 = s.make_ckey(0);
+    auto ck1 = s.make_ckey(1);
+
+    mutation newer(s.schema(), pkeys[0]);
+    s.add_row(newer, ck0, "new", 20);
+    mutation older(s.schema(), pkeys[0]);
+    s.add_row(older, ck0, "old", 10);
+    mutation other_row(s.schema(), pkeys[0]);
+    s.add_row(other_row, ck1, "v", 5);
+    mutation other_partition(s.schema(), pkeys[1]);
+    s.add_row(other_partition, ck0, "old", 10);
+
+    hints_coalescer coalescer;
+    BOOST_REQUIRE(coalescer.empty());
+
+    // Hints are not necessarily written in the order of their timestamps.
+    auto add = [&] (const mutation& m, db::replay_position rp) {
+        return coalescer.add(frozen_mutation_and_schema{freeze(m), s.schema()}, rp);
+    };
+    BOOST_REQUIRE(add(newer, db::replay_position(0, 1, 100)) == hints_coalescer::add_result::added);
+    BOOST_REQUIRE(add(older, db::replay_position(0, 1, 200)) == hints_coalescer::add_result::merged);
+    BOOST_REQUIRE(add(other_partition, db::replay_position(0, 1, 300)) == hints_coalescer::add_result::added);
+    BOOST_REQUIRE(add(other_row, db::replay_position(0, 1, 400)) == hints_coalescer::add_result::merged);
+    BOOST_REQUIRE(!coalescer.empty());
+    BOOST_REQUIRE_GT(coalescer.memory_usage(), 0);
+
+    auto expected = newer;
+    expected.apply(other_row);
+
+    auto merged = coalescer.release();
+    BOOST_REQUIRE(coalescer.empty());
+    BOOST_REQUIRE_EQUAL(coalescer.memory_usage(), 0);
+    BOOST_REQUIRE_EQUAL(merged.size(), 2);
+
+    bool found_first = false;
+    bool found_second = false;
+    for (auto& p : merged) {
+        if (p.m.decorated_key().equal(*s.schema(), pkeys[0])) {
+            // The merged mutation is accounted to the first hint merged into it.
+            BOOST_REQUIRE_EQUAL(p.first_rp, db::replay_position(0, 1, 100));
+            assert_that(p.m).is_equal_to(expected);
+            found_first = true;
+        } else {
+            BOOST_REQUIRE_EQUAL(p.first_rp, db::replay_position(0, 1, 300));
+            assert_that(p.m).is_equal_to(other_partition);
+            found_second = true;
+        }
+    }
+    BOOST_REQUIRE(found_first && found_second);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hints_of_counter_tables_are_not_coalesced) {
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("c", counter_type)
+            .build();
+    BOOST_REQUIRE(!hints_coalescer::can_coalesce(*s));
+    BOOST_REQUIRE(hints_coalescer::can_coalesce(*simple_schema().schema()));
+
+    auto pk = partition_key::from_single_value(*s, int32_type->decompose(0));
+    mutation m(s, pk);
+    m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+
+    hints_coalescer coalescer;
+    for (auto i : {1, 2}) {
+        BOOST_REQUIRE(coalescer.add(frozen_mutation_and_schema{freeze(m), s}, db::replay_position(0, 1, i)) == hints_coalescer::add_result::rejected);
+    }
+    BOOST_REQUIRE(coalescer.empty());
+    BOOST_REQUIRE_EQUAL(coalescer.memory_usage(), 0);
+}
@@ -39,6 +39,8 @@
 #include "test/lib/random_utils.hh"
 #include "test/lib/log.hh"
 #include "test/lib/reader_permit.hh"
+#include "test/lib/simple_schema.hh"
+#include "partition_slice_builder.hh"
 
 static api::timestamp_type next_timestamp() {
     static thread_local api::timestamp_type next_timestamp = 1;
@@ -297,6 +299,46 @@ SEASTAR_TEST_CASE(test_virtual_dirty_accounting_on_flush) {
     });
 }
 
+SEASTAR_TEST_CASE(test_concurrent_flush_readers_of_disjoint_ranges) {
+    return seastar::async([] {
+        schema_ptr s = schema_builder("ks", "cf")
+                .with_column("pk", bytes_type, column_kind::partition_key)
+                .with_column("col", bytes_type, column_kind::regular_column)
+                .build();
+
+        dirty_memory_manager mgr;
+        table_stats tbl_stats;
+
+        auto mt = make_lw_shared<memtable>(s, mgr, tbl_stats);
+
+        std::vector<mutation> ring = make_ring(s, 4);
+        for (auto&& m : ring) {
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("col"),
+                                 data_value(bytes(bytes::initialized_later(), 1024)), next_timestamp());
+            mt->apply(m);
+        }
+
+        // Split between the second and the third partition.
+        auto split = dht::ring_position(ring[1].decorated_key());
+        auto left = dht::partition_range::make_ending_with({split, true});
+        auto right = dht::partition_range::make_starting_with({split, false});
+
+        auto left_check = assert_that(mt->make_flush_reader(s, left, default_priority_class()));
+        auto right_check = assert_that(mt->make_flush_reader(s, right, default_priority_class()));
+
+        // Interleave the readers, like parallel sstable writers would.
+        right_check.produces_partition(ring[2]);
+        left_check.produces_partition(ring[0]);
+        right_check.produces_partition(ring[3]);
+        left_check.produces_partition(ring[1]);
+        left_check.produces_end_of_stream();
+        right_check.produces_end_of_stream();
+
+        // Both readers account flushed memory of the same memtable.
+        BOOST_REQUIRE_LT(mgr.virtual_dirty_memory(), mgr.real_dirty_memory());
+    });
+}
+
 // Reproducer for #1753
 SEASTAR_TEST_CASE(test_partition_version_consistency_after_lsa_compaction_happens) {
     return seastar::async([] {
@@ -631,3 +673,45 @@ SEASTAR_THREAD_TEST_CASE(test_collecting_encoding_stats) {
     BOOST_CHECK_EQUAL(stats.min_timestamp, -10);
     BOOST_CHECK(stats.min_ttl == md2_ttl);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reversed_reader) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pk = ss.make_pkey();
+    auto pr = dht::partition_range::make_singular(pk);
+    auto mt = make_lw_shared<memtable>(s);
+
+    mutation m1(s, pk);
+    ss.add_static_row(m1, "s1");
+    for (auto ck : {1, 3, 5, 7}) {
+        ss.add_row(m1, ss.make_ckey(ck), "v1");
+    }
+    ss.delete_range(m1, ss.make_ckey_range(4, 6));
+    mt->apply(m1);
+
+    // Keep a snapshot of the partition, so that the next write goes to a new version.
+    auto snapshot_holder = mt->make_flat_reader(s, tests::make_permit(), pr);
+    auto close_snapshot_holder = deferred_close(snapshot_holder);
+
+    mutation m2(s, pk);
+    for (auto ck : {2, 3, 6}) {
+        ss.add_row(m2, ss.make_ckey(ck), "v2");
+    }
+    ss.delete_range(m2, ss.make_ckey_range(0, 5));
+    mt->apply(m2);
+
+    auto full_slice = partition_slice_builder(*s).reversed().build();
+    assert_that(mt->make_reversed_reader(s, tests::make_permit(), pr, full_slice))
+        .produces_reversed(m1 + m2)
+        .produces_end_of_stream();
+
+    // The ranges of a reversed slice are in reverse clustering order.
+    auto ranges = query::clustering_row_ranges{ss.make_ckey_range(1, 2), ss.make_ckey_range(5, 6)};
+    auto slice = partition_slice_builder(*s).with_ranges(query::clustering_row_ranges(ranges.rbegin(), ranges.rend())).reversed().build();
+    assert_that(mt->make_reversed_reader(s, tests::make_permit(), pr, slice))
+        .produces_reversed(m1 + m2, ranges)
+        .produces_end_of_stream();
+
+    assert_that(mt->make_reversed_reader(s, tests::make_permit(), dht::partition_range::make_singular(ss.make_pkey(1)), full_slice))
+        .produces_end_of_stream();
+}
@@ -4120,3 +4120,57 @@ SEASTAR_THREAD_TEST_CASE(test_clustering_combining_of_empty_readers) {
         BOOST_FAIL(format("reader combined of empty readers returned fragment {}", mutation_fragment::printer(*s, *mf)));
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reversed_combined_reader) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pk = ss.make_pkey();
+    auto pr = dht::partition_range::make_singular(pk);
+    auto slice = partition_slice_builder(*s).reversed().build();
+
+    mutation m1(s, pk);
+    ss.add_static_row(m1, "s1");
+    ss.add_row(m1, ss.make_ckey(1), "v1");
+    ss.add_row(m1, ss.make_ckey(4), "v1");
+    ss.delete_range(m1, ss.make_ckey_range(2, 6));
+
+    mutation m2(s, pk);
+    m2.partition().apply(ss.new_tombstone());
+    ss.add_row(m2, ss.make_ckey(4), "v2");
+    ss.add_row(m2, ss.make_ckey(7), "v2");
+    ss.delete_range(m2, ss.make_ckey_range(0, 4));
+
+    mutation m3(s, pk);
+    ss.add_static_row(m3, "s3");
+    ss.delete_range(m3, ss.make_ckey_range(6, 9));
+
+    std::vector<lw_shared_ptr<memtable>> memtables;
+    for (auto* m : {&m1, &m2, &m3}) {
+        memtables.push_back(make_lw_shared<memtable>(s));
+        memtables.back()->apply(*m);
+    }
+    // Doesn't have the partition.
+    memtables.push_back(make_lw_shared<memtable>(s));
+    memtables.back()->apply(mutation(s, ss.make_pkey(1)));
+
+    auto make_reader = [&] {
+        std::vector<flat_mutation_reader> readers;
+        for (auto& mt : memtables) {
+            readers.push_back(mt->make_reversed_reader(s, tests::make_permit(), pr, slice));
+        }
+        return make_reversed_combined_reader(s, tests::make_permit(), std::move(readers));
+    };
+
+    assert_that(make_reader())
+        .produces_reversed(m1 + m2 + m3)
+        .produces_end_of_stream();
+
+    auto rd = make_reader();
+    rd.set_max_buffer_size(1);
+    assert_that(std::move(rd))
+        .produces_reversed(m1 + m2 + m3)
+        .produces_end_of_stream();
+
+    assert_that(make_reversed_combined_reader(s, tests::make_permit(), {}))
+        .produces_end_of_stream();
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <seastar/core/print.hh>
+#include <fmt/core.h>
+#include <string>
+#include <set>
+
+#include "utils/radix-decker.hh"
+#include "utils/logalloc.hh"
+#include "test/lib/random_utils.hh"
+
+class compound_key {
+public:
+    int64_t key;
+    std::string sub_key;
+
+    compound_key(int64_t k, std::string sk) noexcept : key(k), sub_key(sk) {}
+
+    compound_key(const compound_key& other) = delete;
+    compound_key(compound_key&& other) noexcept : key(other.key), sub_key(std::move(other.sub_key)) {}
+
+    std::string format() const {
+        return seastar::format("{}.{}", key, sub_key);
+    }
+
+    bool operator==(const compound_key& other) const {
+        return key == other.key && sub_key == other.sub_key;
+    }
+
+    struct compare {
+        int operator()(const int64_t& a, const int64_t& b) const { return a < b ? -1 : (a > b ? 1 : 0); }
+
+        int operator()(const compound_key& a, const compound_key& b) const {
+            if (a.key != b.key) {
+                return this->operator()(a.key, b.key);
+            } else {
+                return a.sub_key.compare(b.sub_key);
+            }
+        }
+    };
+
+    struct less_compare {
+        int64_t simplify_key(const compound_key& k) const noexcept { return k.key; }
+        int64_t simplify_key(int64_t k) const noexcept { return k; }
+    };
+};
+
+class test_data {
+    compound_key _key;
+    bool _head = false;
+    bool _tail = false;
+    bool _train = false;
+
+    int *_cookie;
+public:
+    bool is_head() const noexcept { return _head; }
+    bool is_tail() const noexcept { return _tail; }
+    bool with_train() const noexcept { return _train; }
+    void set_head(bool v) noexcept { _head = v; }
+    void set_tail(bool v) noexcept { _tail = v; }
+    void set_train(bool v) noexcept { _train = v; }
+
+    test_data(int64_t key, std::string sub) : _key(key, sub), _cookie(new int(0)) {}
+
+    test_data(const test_data& other) = delete;
+    test_data(test_data&& other) noexcept : _key(std::move(other._key)),
+            _head(other._head), _tail(other._tail), _train(other._train),
+            _cookie(std::exchange(other._cookie, nullptr)) {
+    }
+
+    ~test_data() {
+        delete _cookie;
+    }
+
+    bool operator==(const compound_key& k) const { return _key == k; }
+
+    std::string format() const { return _key.format(); }
+
+    struct compare {
+        compound_key::compare kcmp;
+        int operator()(const compound_key& a, const test_data& b) { return kcmp(a, b._key); }
+        int operator()(const test_data& a, const compound_key& b) { return kcmp(a._key, b); }
+        int operator()(const test_data& a, const test_data& b) { return kcmp(a._key, b._key); }
+    };
+};
+
+using collection = radix_decker<test_data, compound_key::less_compare, test_data::compare>;
+
+struct oracle_less {
+    bool operator()(const compound_key& a, const compound_key& b) const {
+        return compound_key::compare{}(a, b) < 0;
+    }
+};
+
+using oracle = std::set<compound_key, oracle_less>;
+
+static collection::iterator insert(collection& c, int64_t key, std::string sub) {
+    compound_key k(key, sub);
+    collection::bound_hint h;
+    auto i = c.lower_bound(k, test_data::compare{}, h);
+    BOOST_REQUIRE(!h.match);
+    return c.emplace_before(i, key, h, key, std::move(sub));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_lower_bound) {
+    collection c;
+    test_data::compare cmp;
+
+    insert(c, 3, "e");
+    insert(c, 5, "i");
+    insert(c, 5, "o");
+
+    collection::bound_hint h;
+
+    BOOST_REQUIRE(*c.lower_bound(compound_key(2, "a"), cmp, h) == compound_key(3, "e") && !h.key_match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(3, "a"), cmp, h) == compound_key(3, "e") && h.key_match && !h.key_tail && !h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(3, "e"), cmp, h) == compound_key(3, "e") && h.key_match && !h.key_tail && h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(3, "o"), cmp, h) == compound_key(5, "i") && h.key_match && h.key_tail && !h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(4, "i"), cmp, h) == compound_key(5, "i") && !h.key_match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(5, "a"), cmp, h) == compound_key(5, "i") && h.key_match && !h.key_tail && !h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(5, "i"), cmp, h) == compound_key(5, "i") && h.key_match && !h.key_tail && h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(5, "l"), cmp, h) == compound_key(5, "o") && h.key_match && !h.key_tail && !h.match);
+    BOOST_REQUIRE(*c.lower_bound(compound_key(5, "o"), cmp, h) == compound_key(5, "o") && h.key_match && !h.key_tail && h.match);
+    BOOST_REQUIRE(c.lower_bound(compound_key(5, "q"), cmp, h) == c.end() && h.key_match && h.key_tail);
+    BOOST_REQUIRE(c.lower_bound(compound_key(6, "q"), cmp, h) == c.end() && !h.key_match);
+
+    c.clear();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_upper_bound) {
+    collection c;
+    test_data::compare cmp;
+
+    insert(c, 3, "e");
+    insert(c, 5, "i");
+    insert(c, 5, "o");
+
+    BOOST_REQUIRE(*c.upper_bound(compound_key(2, "a"), cmp) == compound_key(3, "e"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(3, "a"), cmp) == compound_key(3, "e"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(3, "e"), cmp) == compound_key(5, "i"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(3, "o"), cmp) == compound_key(5, "i"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(4, "i"), cmp) == compound_key(5, "i"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(5, "a"), cmp) == compound_key(5, "i"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(5, "i"), cmp) == compound_key(5, "o"));
+    BOOST_REQUIRE(*c.upper_bound(compound_key(5, "l"), cmp) == compound_key(5, "o"));
+    BOOST_REQUIRE(c.upper_bound(compound_key(5, "o"), cmp) == c.end());
+    BOOST_REQUIRE(c.upper_bound(compound_key(5, "q"), cmp) == c.end());
+    BOOST_REQUIRE(c.upper_bound(compound_key(6, "q"), cmp) == c.end());
+
+    c.clear();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_signed_keys_order) {
+    collection c;
+    test_data::compare cmp;
+    constexpr int64_t min = std::numeric_limits<int64_t>::min();
+    constexpr int64_t max = std::numeric_limits<int64_t>::max();
+
+    insert(c, max, "a");
+    insert(c, 0, "a");
+    insert(c, -1, "a");
+    insert(c, min, "a");
+    insert(c, 1, "a");
+    insert(c, max, "b");
+
+    auto i = c.begin();
+    BOOST_REQUIRE(*i++ == compound_key(min, "a"));
+    BOOST_REQUIRE(*i++ == compound_key(-1, "a"));
+    BOOST_REQUIRE(*i++ == compound_key(0, "a"));
+    BOOST_REQUIRE(*i++ == compound_key(1, "a"));
+    BOOST_REQUIRE(*i++ == compound_key(max, "a"));
+    BOOST_REQUIRE(*i++ == compound_key(max, "b"));
+    BOOST_REQUIRE(i == c.end());
+
+    BOOST_REQUIRE(c.upper_bound(compound_key(max, "b"), cmp) == c.end());
+
+    c.find(compound_key(max, "a"), cmp).erase(compound_key::less_compare{});
+    auto j = c.find(compound_key(max, "b"), cmp).erase(compound_key::less_compare{});
+    BOOST_REQUIRE(j == c.end());
+    BOOST_REQUIRE(c.lower_bound(compound_key(2, "a"), cmp) == c.end());
+
+    c.clear();
+}
+
+void validate_sorted(collection& c) {
+    auto i = c.begin();
+    if (i == c.end()) {
+        return;
+    }
+
+    while (1) {
+        auto cur = i;
+        i++;
+        if (i == c.end()) {
+            break;
+        }
+        test_data::compare cmp;
+        BOOST_REQUIRE(cmp(*cur, *i) < 0);
+    }
+}
+
+void compare_with_set(collection& c, oracle& s) {
+    test_data::compare cmp;
+    /* All keys must be findable */
+    for (auto i = s.begin(); i != s.end(); i++) {
+        auto j = c.find(*i, cmp);
+        BOOST_REQUIRE(j != c.end() && *j == *i);
+    }
+
+    /* Both iterators must coinside */
+    auto i = c.begin();
+    auto j = s.begin();
+
+    while (i != c.end()) {
+        BOOST_REQUIRE(*i == *j);
+        i++;
+        j++;
+    }
+    BOOST_REQUIRE(j == s.end());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_insert_via_emplace) {
+    collection c;
+    test_data::compare cmp;
+    oracle s;
+    int nr = 0;
+
+    while (nr < 4000) {
+        compound_key k(tests::random::get_int<int64_t>(-450, 450), tests::random::get_sstring(4));
+
+        collection::bound_hint h;
+        auto i = c.lower_bound(k, cmp, h);
+
+        if (i == c.end() || !h.match) {
+            auto it = c.emplace_before(i, k.key, h, k.key, k.sub_key);
+            BOOST_REQUIRE(*it == k);
+            s.insert(std::move(k));
+            nr++;
+        }
+    }
+
+    compare_with_set(c, s);
+    c.clear();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_insert_and_erase) {
+    collection c;
+    test_data::compare cmp;
+    int nr = 0;
+
+    while (nr < 500) {
+        compound_key k(tests::random::get_int<int64_t>(), tests::random::get_sstring(3));
+
+        if (c.find(k, cmp) == c.end()) {
+            auto it = insert(c, k.key, k.sub_key);
+            BOOST_REQUIRE(*it == k);
+            nr++;
+        }
+        if (nr % 3 == 0) {
+            // Make some collisions
+            compound_key kc(k.key, tests::random::get_sstring(3));
+            if (c.find(kc, cmp) == c.end()) {
+                insert(c, kc.key, kc.sub_key);
+                nr++;
+            }
+        }
+    }
+
+    validate_sorted(c);
+
+    while (nr > 0) {
+        int n = tests::random::get_int<int>() % nr;
+
+        auto i = c.begin();
+        while (n > 0) {
+            i++;
+            n--;
+        }
+
+        i.erase(compound_key::less_compare{});
+        nr--;
+
+        validate_sorted(c);
+    }
+
+    BOOST_REQUIRE(c.empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_compaction) {
+    logalloc::region reg;
+    with_allocator(reg.allocator(), [&] {
+        collection c;
+        test_data::compare cmp;
+        oracle s;
+
+        {
+            logalloc::reclaim_lock rl(reg);
+
+            int nr = 0;
+
+            while (nr < 1500) {
+                compound_key k(tests::random::get_int<int64_t>(400), tests::random::get_sstring(3));
+
+                if (c.find(k, cmp) == c.end()) {
+                    auto it = insert(c, k.key, k.sub_key);
+                    BOOST_REQUIRE(*it == k);
+                    s.insert(std::move(k));
+                    nr++;
+                }
+            }
+        }
+
+        reg.full_compaction();
+
+        compare_with_set(c, s);
+        c.clear();
+    });
+}
@@ -24,6 +24,7 @@
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
 #include <fmt/core.h>
+#include <set>
 
 #include "utils/compact-radix-tree.hh"
 
@@ -140,6 +141,71 @@ BOOST_AUTO_TEST_CASE(test_clear) {
     BOOST_REQUIRE(tree.lower_bound(0) == nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(test_lower_bound_iterator) {
+    test_tree tree;
+
+    for (int i = 0; i < 1000; i++) {
+        tree.emplace(i * 2, i * 2 + 1);
+    }
+
+    for (int i = 0; i < 1998; i++) {
+        auto it = tree.lower_bound_iterator(i);
+        unsigned expected = i % 2 == 0 ? i : i + 1;
+        for (unsigned k = expected; k < 2000; k += 2, it++) {
+            BOOST_REQUIRE(it != tree.end());
+            BOOST_REQUIRE_EQUAL(it.key(), k);
+        }
+        BOOST_REQUIRE(it == tree.end());
+    }
+
+    BOOST_REQUIRE(tree.lower_bound_iterator(1999) == tree.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_iterating_up_to_the_max_key) {
+    test_tree tree;
+    constexpr unsigned max = std::numeric_limits<unsigned>::max();
+
+    // Covers the last leaves, including the max key itself
+    for (unsigned j = 0; j <= 100; j++) {
+        tree.emplace(max - 300 + 3 * j, j);
+    }
+
+    unsigned nr = 0;
+    unsigned prev = 0;
+    for (auto it = tree.begin(); it != tree.end(); it++) {
+        BOOST_REQUIRE(nr == 0 || it.key() > prev);
+        prev = it.key();
+        nr++;
+    }
+    BOOST_REQUIRE_EQUAL(prev, max);
+    BOOST_REQUIRE_EQUAL(nr, 101);
+}
+
+BOOST_AUTO_TEST_CASE(test_64bit_keys) {
+    tree<test_data, uint64_t> tree;
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        tree.emplace(i << 54 | i, i);
+        tree.emplace(i << 34, i);
+    }
+
+    std::set<uint64_t> keys;
+    for (uint64_t i = 0; i < 1000; i++) {
+        keys.insert(i << 54 | i);
+        keys.insert(i << 34);
+    }
+
+    auto it = tree.begin();
+    for (uint64_t k : keys) {
+        BOOST_REQUIRE(it != tree.end());
+        BOOST_REQUIRE_EQUAL(it.key(), k);
+        it++;
+    }
+    BOOST_REQUIRE(it == tree.end());
+
+    tree.clear();
+}
+
 static void do_test_clone(size_t sz) {
     test_tree t;
 
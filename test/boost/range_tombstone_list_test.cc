@@ -493,6 +493,45 @@ BOOST_AUTO_TEST_CASE(test_random_list_is_not_overlapped) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_bulk_apply_is_equivalent_to_sequential_apply) {
+    auto covering_tombstones_equal = [] (const range_tombstone_list& l1, const range_tombstone_list& l2) {
+        for (int32_t i = -1; i <= 51; ++i) {
+            if (l1.search_tombstone_covering(*s, key({i})) != l2.search_tombstone_covering(*s, key({i}))) {
+                return false;
+            }
+            for (int32_t j : {-1, 0, 25, 50, 51}) {
+                if (l1.search_tombstone_covering(*s, key({i, j})) != l2.search_tombstone_covering(*s, key({i, j}))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto initial = i % 2 ? make_random() : std::vector<range_tombstone>();
+        auto input = make_random();
+
+        range_tombstone_list expected(*s);
+        range_tombstone_list l(*s);
+        for (auto&& rt : initial) {
+            expected.apply(*s, rt);
+            l.apply(*s, rt);
+        }
+        for (auto&& rt : input) {
+            expected.apply(*s, rt);
+        }
+        l.apply(*s, input);
+
+        BOOST_REQUIRE(assert_valid(l));
+        if (!covering_tombstones_equal(expected, l)) {
+            testlog.error("Expected: {}", expected);
+            testlog.error("Produced: {}", l);
+            BOOST_FAIL("bulk apply produced a different list");
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_non_sorted_addition_with_one_range_with_empty_end) {
     range_tombstone_list l(*s);
 
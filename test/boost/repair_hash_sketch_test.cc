@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+
+#include "repair/repair.hh"
+
+// Decoding a sketch only succeeds with high probability, so use a fixed seed
+// for the outcome of the tests not to depend on the run.
+static std::mt19937_64 gen(20211019);
+
+static repair_hash_set random_hashes(size_t n) {
+    repair_hash_set hashes;
+    while (hashes.size() < n) {
+        hashes.insert(repair_hash(gen()));
+    }
+    return hashes;
+}
+
+static repair_hash_sketch make_sketch(const repair_hash_set& hashes, size_t nr_cells) {
+    repair_hash_sketch sketch(std::vector<repair_hash_sketch_cell>(nr_cells));
+    for (auto& h : hashes) {
+        sketch.insert(h);
+    }
+    return sketch;
+}
+
+static repair_hash_set to_set(const std::vector<repair_hash>& hashes) {
+    return repair_hash_set(hashes.begin(), hashes.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_identical_sets_have_no_difference) {
+    auto hashes = random_hashes(10000);
+    auto nr_cells = repair_hash_sketch::for_differences(10).size();
+    auto sketch = make_sketch(hashes, nr_cells);
+    sketch.subtract(make_sketch(hashes, nr_cells));
+    auto diff = std::move(sketch).decode();
+    BOOST_REQUIRE(diff);
+    BOOST_REQUIRE(diff->added.empty());
+    BOOST_REQUIRE(diff->removed.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_symmetric_difference) {
+    for (size_t differences : {1, 10, 100, 1000}) {
+        auto common = random_hashes(5000);
+        auto only_local = random_hashes(differences / 2);
+        auto only_remote = random_hashes(differences - differences / 2);
+        auto local = common;
+        local.insert(only_local.begin(), only_local.end());
+        auto remote = common;
+        remote.insert(only_remote.begin(), only_remote.end());
+
+        auto nr_cells = repair_hash_sketch::for_differences(differences).size();
+        // Decoding is probabilistic, allow a twice larger sketch to decode.
+        std::optional<repair_hash_sketch::difference> diff;
+        for (auto cells : {nr_cells, 2 * nr_cells}) {
+            auto sketch = make_sketch(local, cells);
+            sketch.subtract(make_sketch(remote, cells));
+            diff = std::move(sketch).decode();
+            if (diff) {
+                break;
+            }
+        }
+        BOOST_REQUIRE(diff);
+        BOOST_REQUIRE(to_set(diff->added) == only_local);
+        BOOST_REQUIRE(to_set(diff->removed) == only_remote);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_too_large_difference_is_not_decoded) {
+    auto nr_cells = repair_hash_sketch::for_differences(10).size();
+    auto sketch = make_sketch(random_hashes(1000), nr_cells);
+    sketch.subtract(make_sketch(random_hashes(1000), nr_cells));
+    BOOST_REQUIRE(!std::move(sketch).decode());
+}
+
+BOOST_AUTO_TEST_CASE(test_subtract_requires_equal_sizes) {
+    auto sketch = repair_hash_sketch::for_differences(10);
+    BOOST_REQUIRE_THROW(sketch.subtract(repair_hash_sketch::for_differences(100)), std::runtime_error);
+}
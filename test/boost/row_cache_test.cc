@@ -1766,6 +1766,59 @@ static void evict_one_row(cache_tracker& tracker) {
     }
 }
 
+#ifndef SEASTAR_DEFAULT_ALLOCATOR // Depends on eviction, which is absent with the std allocator
+
+SEASTAR_TEST_CASE(test_frequency_admission) {
+    return seastar::async([] {
+        auto s = schema_builder(make_schema())
+                .set_caching_options(caching_options::from_map({
+                    {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "FREQUENT"}}))
+                .build();
+        auto mt = make_lw_shared<memtable>(s);
+        std::vector<mutation> partitions = make_ring(s, 3);
+        for (auto&& m : partitions) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(cache.make_reader(s, tests::make_permit(), pr))
+                .produces(m)
+                .produces_end_of_stream();
+        };
+
+        // Until the cache is full, everything is admitted
+        read(partitions[0]);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_admissions, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_rejections, 0);
+
+        // Eviction tells that the cache is full
+        evict_one_row(tracker);
+        auto partitions_before = tracker.partitions();
+
+        // A partition read once is served from the underlying source only
+        read(partitions[1]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_rejections, 1);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), partitions_before);
+
+        // A partition read repeatedly is admitted
+        read(partitions[1]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_admissions, 2);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), partitions_before + 1);
+
+        // And then served from cache
+        auto misses = tracker.get_stats().partition_misses;
+        read(partitions[1]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+    });
+}
+
+#endif
+
 SEASTAR_TEST_CASE(test_lru) {
     return seastar::async([] {
         auto s = make_schema();
@@ -3715,3 +3768,244 @@ SEASTAR_TEST_CASE(test_scans_erase_dummies) {
         BOOST_REQUIRE_EQUAL(tracker.get_stats().rows, 2);
     });
 }
+
+SEASTAR_TEST_CASE(test_cache_profile_follows_sampled_partitions) {
+    return seastar::async([] {
+        auto s = make_schema();
+        std::vector<mutation> mutations = make_ring(s, 1024);
+
+        auto mt = make_lw_shared<memtable>(s);
+        for (auto&& m : mutations) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        uint64_t sampled = 0;
+        for (auto&& m : mutations) {
+            if (cache_profiler::is_sampled(m.decorated_key().token())) {
+                ++sampled;
+            }
+        }
+        BOOST_REQUIRE(sampled > 0);
+
+        for (int i = 0; i < 2; ++i) {
+            for (auto&& m : mutations) {
+                assert_that(cache.make_reader(s, tests::make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+                    .produces(m)
+                    .produces_end_of_stream();
+            }
+        }
+
+        auto profile = cache.get_profile();
+        auto scaled = sampled << cache_profiler::sample_shift;
+
+        // First reads miss partitions never seen before, second reads hit and measure them.
+        BOOST_REQUIRE_EQUAL(profile.unknown_size.misses, scaled);
+        BOOST_REQUIRE_EQUAL(profile.unknown_size.resident_partitions, 0);
+
+        uint64_t hits = 0;
+        uint64_t resident = 0;
+        uint64_t resident_bytes = 0;
+        for (auto&& b : profile.buckets) {
+            hits += b.hits;
+            resident += b.resident_partitions;
+            resident_bytes += b.resident_bytes;
+            BOOST_REQUIRE_EQUAL(b.evictions, 0);
+        }
+        BOOST_REQUIRE_EQUAL(hits, scaled);
+        BOOST_REQUIRE_EQUAL(resident, scaled);
+        BOOST_REQUIRE(resident_bytes > 0);
+
+        cache.invalidate(row_cache::external_updater([] {})).get();
+
+        profile = cache.get_profile();
+        resident = profile.unknown_size.resident_partitions;
+        for (auto&& b : profile.buckets) {
+            resident += b.resident_partitions;
+        }
+        BOOST_REQUIRE_EQUAL(resident, 0);
+    });
+}
+
+SEASTAR_TEST_CASE(test_cache_profiler_forgets_non_resident_samples) {
+    return seastar::async([] {
+        std::vector<dht::token> tokens;
+        for (int64_t i = 0; tokens.size() < cache_profiler::max_non_resident_samples + 2; ++i) {
+            auto t = dht::token::from_int64(i);
+            if (cache_profiler::is_sampled(t)) {
+                tokens.push_back(t);
+            }
+        }
+
+        cache_profiler p;
+        auto enter_and_leave = [&] (dht::token t) {
+            p.on_insert(t);
+            p.on_hit(t, [] { return 100; });
+            p.on_eviction(t);
+        };
+
+        // Misses of partitions which left the cache are attributed to their size.
+        enter_and_leave(tokens[0]);
+        p.on_miss(tokens[0]);
+        BOOST_REQUIRE_EQUAL(p.profile().buckets[0].misses, uint64_t(1) << cache_profiler::sample_shift);
+
+        // Until there are too many of them.
+        for (auto t : tokens) {
+            enter_and_leave(t);
+        }
+        p.on_miss(tokens[0]);
+        BOOST_REQUIRE_EQUAL(p.profile().buckets[0].misses, uint64_t(1) << cache_profiler::sample_shift);
+        BOOST_REQUIRE_EQUAL(p.profile().unknown_size.misses, uint64_t(1) << cache_profiler::sample_shift);
+    });
+}
+
+SEASTAR_TEST_CASE(test_reversed_reads) {
+    return seastar::async([] {
+        simple_schema ss;
+        auto s = ss.schema();
+        cache_tracker tracker;
+        memtable_snapshot_source underlying(s);
+
+        auto pk = ss.make_pkey(0);
+        auto pr = dht::partition_range::make_singular(pk);
+
+        mutation m(s, pk);
+        ss.add_static_row(m, "s1");
+        for (int ck = 0; ck < 1000; ++ck) {
+            ss.add_row(m, ss.make_ckey(ck), format("v{}", ck));
+        }
+        ss.delete_range(m, ss.make_ckey_range(100, 200));
+        ss.delete_range(m, ss.make_ckey_range(500, 999));
+        underlying.apply(m);
+
+        // What the cache doesn't have is read in reverse from the same data.
+        auto reversed_mt = make_lw_shared<memtable>(s);
+        reversed_mt->apply(m);
+        unsigned underlying_reads = 0;
+        auto reversed_underlying = mutation_source([&] (schema_ptr s, reader_permit permit, const dht::partition_range& range,
+                const query::partition_slice& slice, const io_priority_class&, tracing::trace_state_ptr, streamed_mutation::forwarding,
+                mutation_reader::forwarding) {
+            ++underlying_reads;
+            return reversed_mt->make_reversed_reader(std::move(s), std::move(permit), range, slice);
+        });
+
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+        auto slice = partition_slice_builder(*s).reversed().build();
+        auto max_populate_size = std::numeric_limits<size_t>::max();
+        auto make_reader = [&] {
+            return cache.make_reversed_reader(s, tests::make_permit(), pr, slice, default_priority_class(), nullptr, reversed_underlying,
+                    max_populate_size);
+        };
+
+        // Not cached, populated by the read.
+        assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+        underlying_reads = 0;
+        assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+
+        // Partially cached, the rest is read from the underlying source.
+        // Incomplete entries are not populated by reversed reads.
+        cache.evict();
+        populate_range(cache, pr, query::clustering_range::make_starting_with({ss.make_ckey(600)}));
+        for (int i = 0; i < 2; ++i) {
+            underlying_reads = 0;
+            assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+        }
+
+        // The last range is read from the cache, the first one from the underlying source.
+        auto ranges = query::clustering_row_ranges{ss.make_ckey_range(50, 150), ss.make_ckey_range(700, 800)};
+        auto ranges_slice = partition_slice_builder(*s).with_ranges(query::clustering_row_ranges(ranges.rbegin(), ranges.rend()))
+                .reversed().build();
+        auto make_ranges_reader = [&] {
+            return cache.make_reversed_reader(s, tests::make_permit(), pr, ranges_slice, default_priority_class(), nullptr, reversed_underlying,
+                    max_populate_size);
+        };
+        underlying_reads = 0;
+        assert_that(make_ranges_reader()).produces_reversed(m, ranges).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+
+        // Fully cached.
+        populate_range(cache, pr);
+        underlying_reads = 0;
+        assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+
+        assert_that(make_ranges_reader()).produces_reversed(m, ranges).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+
+        // Eviction in the middle of the read.
+        auto rd = make_reader();
+        rd.fill_buffer(db::no_timeout).get();
+        BOOST_REQUIRE(!rd.is_end_of_stream());
+        cache.evict();
+        assert_that(std::move(rd)).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+
+        // Only the part of the slice which was read is populated by a read
+        // which stopped early.
+        {
+            underlying_reads = 0;
+            auto rd = make_reader();
+            auto close_rd = deferred_close(rd);
+            rd.set_max_buffer_size(1);
+            auto last_ck = ss.make_ckey(900);
+            while (true) {
+                auto mfo = rd(db::no_timeout).get0();
+                BOOST_REQUIRE(mfo);
+                if (mfo->is_clustering_row() && mfo->as_clustering_row().key().equal(*s, last_ck)) {
+                    break;
+                }
+            }
+        }
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+        auto top_range = query::clustering_row_ranges{ss.make_ckey_range(950, 999)};
+        auto top_slice = partition_slice_builder(*s).with_ranges(top_range).reversed().build();
+        underlying_reads = 0;
+        assert_that(cache.make_reversed_reader(s, tests::make_permit(), pr, top_slice, default_priority_class(), nullptr, reversed_underlying,
+                max_populate_size)).produces_reversed(m, top_range).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+        assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+
+        // A read which started before the cache was invalidated doesn't populate it.
+        cache.evict();
+        underlying_reads = 0;
+        {
+            auto rd = make_reader();
+            cache.invalidate(row_cache::external_updater([] {}), pr).get();
+            assert_that(std::move(rd)).produces_reversed(m).produces_end_of_stream();
+        }
+        assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 2);
+
+        // Partitions larger than the limit are not populated.
+        cache.evict();
+        max_populate_size = m.partition().external_memory_usage(*s) / 2;
+        underlying_reads = 0;
+        for (int i = 0; i < 2; ++i) {
+            assert_that(make_reader()).produces_reversed(m).produces_end_of_stream();
+        }
+        BOOST_REQUIRE_EQUAL(underlying_reads, 2);
+        max_populate_size = std::numeric_limits<size_t>::max();
+
+        // Known to be absent.
+        auto other_pr = dht::partition_range::make_singular(ss.make_pkey(1));
+        populate_range(cache, other_pr);
+        underlying_reads = 0;
+        assert_that(cache.make_reversed_reader(s, tests::make_permit(), other_pr, slice, default_priority_class(), nullptr, reversed_underlying,
+                max_populate_size)).produces_eos_or_empty_mutation();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+
+        // Found to be absent by a reversed read.
+        auto missing_pr = dht::partition_range::make_singular(ss.make_pkey(2));
+        for (int i = 0; i < 2; ++i) {
+            assert_that(cache.make_reversed_reader(s, tests::make_permit(), missing_pr, slice, default_priority_class(), nullptr,
+                    reversed_underlying, max_populate_size)).produces_eos_or_empty_mutation();
+        }
+        BOOST_REQUIRE_EQUAL(underlying_reads, 1);
+    });
+}
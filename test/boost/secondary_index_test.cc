@@ -856,6 +856,182 @@ SEASTAR_TEST_CASE(test_local_index_paging) {
     });
 }
 
+// Local index queries are served by the replicas in a single pass, which
+// reads the base rows found in the index right away. Check that it respects
+// the base clustering order, reversed reads and paging.
+SEASTAR_TEST_CASE(test_local_index_single_pass) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v int, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE INDEX ON t ((p),v)").get();
+
+        for (int c = 0; c < 10; ++c) {
+            e.execute_cql(format("INSERT INTO t (p, c, v) VALUES (1, {}, {})", c, c % 2)).get();
+            e.execute_cql(format("INSERT INTO t (p, c, v) VALUES (2, {}, 1)", c)).get();
+        }
+
+        auto row = [] (int c) {
+            return std::vector<bytes_opt>{int32_type->decompose(1), int32_type->decompose(c), int32_type->decompose(1)};
+        };
+        auto& stats = e.local_qp().get_cql_stats();
+
+        eventually([&] {
+            auto single_pass_reads = stats.local_index_single_pass_reads;
+            auto res = e.execute_cql("SELECT * FROM t WHERE p = 1 AND v = 1").get0();
+            assert_that(res).is_rows().with_rows({row(1), row(3), row(5), row(7), row(9)});
+            BOOST_REQUIRE_EQUAL(stats.local_index_single_pass_reads, single_pass_reads + 1);
+        });
+
+        eventually([&] {
+            auto res = e.execute_cql("SELECT * FROM t WHERE p = 1 AND v = 1 ORDER BY c DESC").get0();
+            assert_that(res).is_rows().with_rows({row(9), row(7), row(5), row(3), row(1)});
+        });
+
+        eventually([&] {
+            auto res = e.execute_cql("SELECT * FROM t WHERE p = 1 AND c > 4 AND v = 1 LIMIT 2").get0();
+            assert_that(res).is_rows().with_rows({row(5), row(7)});
+        });
+
+        // Each page only reads the index entries from its paging position
+        // onwards, up to the page size
+        auto query_paged = [&] (sstring query, int32_t page_size) {
+            std::vector<std::vector<bytes_opt>> rows;
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{page_size, paging_state, {}, api::new_timestamp()});
+                auto res = e.execute_cql(query, std::move(qo)).get0();
+                auto rs = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(res);
+                for (auto& r : rs->rs().result_set().rows()) {
+                    rows.push_back(r);
+                }
+                auto ps = rs->rs().get_metadata().paging_state();
+                paging_state = ps ? make_lw_shared<service::pager::paging_state>(*ps) : nullptr;
+            } while (paging_state);
+            return rows;
+        };
+
+        eventually([&] {
+            BOOST_REQUIRE(query_paged("SELECT * FROM t WHERE p = 1 AND v = 1", 2) == std::vector<std::vector<bytes_opt>>({row(1), row(3), row(5), row(7), row(9)}));
+        });
+
+        eventually([&] {
+            BOOST_REQUIRE(query_paged("SELECT * FROM t WHERE p = 1 AND v = 1 ORDER BY c DESC", 2) == std::vector<std::vector<bytes_opt>>({row(9), row(7), row(5), row(3), row(1)}));
+        });
+
+        eventually([&] {
+            BOOST_REQUIRE(query_paged("SELECT * FROM t WHERE p = 1 AND c >= 3 AND c < 9 AND v = 1", 1) == std::vector<std::vector<bytes_opt>>({row(3), row(5), row(7)}));
+        });
+
+        eventually([&] {
+            BOOST_REQUIRE(query_paged("SELECT * FROM t WHERE p = 1 AND c >= 3 AND c < 9 AND v = 1 ORDER BY c DESC", 1) == std::vector<std::vector<bytes_opt>>({row(7), row(5), row(3)}));
+        });
+    });
+}
+
+// Each replica reads the base rows its own copy of a local index points to.
+// Simulate replicas which diverged on a single node, by reading its state
+// before and after the indexed value of a row changes, and by adding index
+// entries without the matching base rows.
+SEASTAR_TEST_CASE(test_local_index_single_pass_with_diverged_replicas) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v int, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE INDEX ON t ((p),v)").get();
+
+        // Runs func in a thread on the shard owning partition p.
+        auto on_owner_of = [&] (int p, auto func) {
+            auto s = e.local_db().find_schema("ks", "t");
+            auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(p)));
+            return e.db().invoke_on(s->get_sharder().shard_of(dk.token()), [&func, dk] (database& db) {
+                return seastar::async([&] {
+                    return func(db, db.find_schema("ks", "t"), db.find_schema("ks", "t_v_idx_index"), dk);
+                });
+            }).get0();
+        };
+        auto lookup_cmd = [] (schema_ptr s, schema_ptr view_schema, int v, uint64_t row_limit) {
+            auto slice = s->full_slice();
+            slice.options.set<query::partition_slice::option::allow_short_read>();
+            auto cmd = query::read_command(s->id(), s->version(), std::move(slice),
+                    query::max_result_size(query::result_memory_limiter::unlimited_result_size), query::row_limit(row_limit));
+            auto value = clustering_key_prefix::from_single_value(*view_schema, int32_type->decompose(v));
+            cmd.index_lookup = query::local_index_lookup{view_schema->id(), {query::clustering_range::make_singular(value)}};
+            return cmd;
+        };
+        auto add_index_entry = [&] (int p, int v, int c) {
+            on_owner_of(p, [&] (database& db, schema_ptr s, schema_ptr view_schema, const dht::decorated_key& dk) {
+                mutation m(view_schema, partition_key::from_single_value(*view_schema, int32_type->decompose(p)));
+                auto ck = clustering_key::from_exploded(*view_schema, {int32_type->decompose(v), int32_type->decompose(c)});
+                m.partition().clustered_row(*view_schema, ck).apply(row_marker(api::new_timestamp()));
+                db.apply(view_schema, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+                return true;
+            });
+        };
+        auto read_mutation = [&] (int p, int v) {
+            return on_owner_of(p, [&] (database& db, schema_ptr s, schema_ptr view_schema, const dht::decorated_key& dk) {
+                auto cmd = lookup_cmd(s, view_schema, v, query::max_rows);
+                auto res = std::get<0>(db.query_mutations(s, cmd, dht::partition_range::make_singular(dk), nullptr, db::no_timeout).get0());
+                BOOST_REQUIRE_EQUAL(res.partitions().size(), 1);
+                return make_foreign(std::make_unique<frozen_mutation>(res.partitions().front().mut()));
+            });
+        };
+        auto row = [] (int c) {
+            return std::vector<bytes_opt>{int32_type->decompose(c)};
+        };
+
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (1, 1, 1)").get();
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (1, 2, 1)").get();
+        eventually([&] {
+            auto res = e.execute_cql("SELECT c FROM t WHERE p = 1 AND v = 1").get0();
+            assert_that(res).is_rows().with_rows({row(1), row(2)});
+        });
+
+        // Replica A misses the update of the indexed value of row 1, which
+        // replica B deletes the index entry of. B still returns the row, so
+        // its newer value wins reconciliation.
+        auto s = e.local_db().find_schema("ks", "t");
+        auto replica_a = read_mutation(1, 1)->unfreeze(s);
+        e.execute_cql("UPDATE t SET v = 2 WHERE p = 1 AND c = 1").get();
+        eventually([&] {
+            auto res = e.execute_cql("SELECT c FROM t WHERE p = 1 AND v = 1").get0();
+            assert_that(res).is_rows().with_rows({row(2)});
+        });
+        auto replica_b = read_mutation(1, 1)->unfreeze(s);
+        auto ck1 = clustering_key::from_single_value(*s, int32_type->decompose(1));
+        BOOST_REQUIRE(replica_b.partition().find_row(*s, ck1));
+        replica_a.apply(replica_b);
+        auto& v_def = *s->get_column_definition("v");
+        auto* cell = replica_a.partition().find_row(*s, ck1)->find_cell(v_def.id);
+        BOOST_REQUIRE(cell);
+        BOOST_REQUIRE_EQUAL(value_cast<int32_t>(int32_type->deserialize(cell->as_atomic_cell(v_def).value().linearize())), 2);
+
+        // The coordinator filters out rows which no longer have the value
+        // their index entry points to, even if the indexed column isn't selected.
+        add_index_entry(1, 1, 1);
+        assert_that(e.execute_cql("SELECT c FROM t WHERE p = 1 AND v = 1").get0()).is_rows().with_rows({row(2)});
+        assert_that(e.execute_cql("SELECT c FROM t WHERE p = 1 AND v = 1 ORDER BY c DESC").get0()).is_rows().with_rows({row(2)});
+
+        // The first index entry of partition 2 has no base row, so the replica
+        // has to look further to fill the page. Digest-only reads do the same,
+        // for their digest to match the one of the data read.
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (2, 1, 1)").get();
+        eventually([&] {
+            auto res = e.execute_cql("SELECT c FROM t WHERE p = 2 AND v = 1").get0();
+            assert_that(res).is_rows().with_rows({row(1)});
+        });
+        add_index_entry(2, 1, 0);
+        on_owner_of(2, [&] (database& db, schema_ptr s, schema_ptr view_schema, const dht::decorated_key& dk) {
+            auto cmd = lookup_cmd(s, view_schema, 1, 1);
+            auto ranges = dht::partition_range_vector{dht::partition_range::make_singular(dk)};
+            auto digest_algo = query::digest_algorithm::xxHash;
+            auto data = std::get<0>(db.query(s, cmd, query::result_options{query::result_request::result_and_digest, digest_algo},
+                    ranges, nullptr, db::no_timeout).get0());
+            auto digest = std::get<0>(db.query(s, cmd, query::result_options::only_digest(digest_algo), ranges, nullptr, db::no_timeout).get0());
+            BOOST_REQUIRE_EQUAL(*data->row_count(), 1);
+            BOOST_REQUIRE(*digest->digest() == *data->digest());
+            return true;
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_malformed_local_index) {
     return do_with_cql_env_thread([] (auto& e) {
         e.execute_cql("CREATE TABLE tab (p1 int, p2 int, c1 int, c2 int, v int, PRIMARY KEY ((p1, p2), c1, c2))").get();
@@ -46,6 +46,7 @@
 #include "range.hh"
 #include "partition_slice_builder.hh"
 #include "sstables/compaction_strategy_impl.hh"
+#include "sstables/repair_digest.hh"
 #include "sstables/date_tiered_compaction_strategy.hh"
 #include "sstables/time_window_compaction_strategy.hh"
 #include "test/lib/mutation_assertions.hh"
@@ -68,6 +69,7 @@
 #include <ftw.h>
 #include <unistd.h>
 #include <boost/range/algorithm/find_if.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
 #include <boost/icl/interval_map.hpp>
@@ -3608,6 +3610,199 @@ SEASTAR_TEST_CASE(min_max_clustering_key_test_2) {
     });
 }
 
+SEASTAR_TEST_CASE(clustering_key_filter_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        test_db_config.enable_sstable_clustering_key_filter.set(true);
+        auto disable_ck_filter = defer([] { test_db_config.enable_sstable_clustering_key_filter.set(false); });
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck1", utf8_type, column_kind::clustering_key)
+                .with_column("r1", int32_type)
+                .build();
+        auto tmp = tmpdir();
+        const column_definition& r1_col = *s->get_column_definition("r1");
+        auto make_ck = [&] (sstring v) { return clustering_key::from_exploded(*s, {to_bytes(v)}); };
+        auto make_pk = [&] (sstring v) { return partition_key::from_exploded(*s, {to_bytes(v)}); };
+
+        auto mt = make_lw_shared<memtable>(s);
+        for (auto j = 0; j < 4; j++) {
+            mutation m(s, make_pk("key" + to_sstring(j)));
+            for (auto i = 0; i < 100; i += 2) {
+                m.set_clustered_cell(make_ck("ck" + to_sstring(i)), r1_col, make_atomic_cell(int32_type, int32_type->decompose(1)));
+            }
+            mt->apply(std::move(m));
+        }
+        {
+            // A partition tombstone may shadow rows in other sstables
+            mutation m(s, make_pk("key_deleted"));
+            m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+            m.set_clustered_cell(make_ck("ck0"), r1_col, make_atomic_cell(int32_type, int32_type->decompose(1)));
+            mt->apply(std::move(m));
+        }
+        auto sst = env.make_sstable(s, tmp.path().string(), 1, sstable_version_types::md, big);
+        write_memtable_to_sstable_for_test(*mt, sst).get();
+        sst = env.reusable_sst(s, tmp.path().string(), 1, sstable_version_types::md).get0();
+        BOOST_REQUIRE(sst->has_clustering_key_filter());
+
+        auto rows = [&] (std::vector<sstring> cks) {
+            query::clustering_row_ranges ranges;
+            for (auto& ck : cks) {
+                ranges.push_back(query::clustering_range::make_singular(make_ck(ck)));
+            }
+            return ranges;
+        };
+        auto may_contain = [&] (sstring pk, std::vector<sstring> cks) {
+            return sst->clustering_key_filter_may_contain(key::from_partition_key(*s, make_pk(pk)), rows(cks));
+        };
+
+        for (auto j = 0; j < 4; j++) {
+            auto pk = "key" + to_sstring(j);
+            for (auto i = 0; i < 100; i += 2) {
+                BOOST_REQUIRE(may_contain(pk, {"ck" + to_sstring(i)}));
+                BOOST_REQUIRE(may_contain(pk, {"ck" + to_sstring(i + 1), "ck" + to_sstring(i)}));
+            }
+            auto false_positives = 0;
+            for (auto i = 1; i < 100; i += 2) {
+                false_positives += may_contain(pk, {"ck" + to_sstring(i)});
+            }
+            BOOST_REQUIRE_LT(false_positives, 10);
+        }
+        BOOST_REQUIRE(may_contain("key_deleted", {"ck1"}));
+    });
+}
+
+// Clustering key filters of sstables opened once the filters of the shard
+// take all the memory they are allowed are not loaded.
+SEASTAR_TEST_CASE(clustering_key_filter_memory_limit_test) {
+    test_db_config.enable_sstable_clustering_key_filter.set(true);
+    test_db_config.sstable_clustering_key_filter_memory_ratio.set(0.0);
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck1", utf8_type, column_kind::clustering_key)
+                .with_column("r1", int32_type)
+                .build();
+        auto tmp = tmpdir();
+        auto pk = partition_key::from_exploded(*s, {to_bytes("key0")});
+        auto ck = clustering_key::from_exploded(*s, {to_bytes("ck0")});
+        mutation m(s, pk);
+        m.set_clustered_cell(ck, *s->get_column_definition("r1"), make_atomic_cell(int32_type, int32_type->decompose(1)));
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(std::move(m));
+
+        auto sst = env.make_sstable(s, tmp.path().string(), 1, sstable_version_types::md, big);
+        write_memtable_to_sstable_for_test(*mt, sst).get();
+        sst = env.reusable_sst(s, tmp.path().string(), 1, sstable_version_types::md).get0();
+        BOOST_REQUIRE(!sst->has_clustering_key_filter());
+        auto other_ck = clustering_key::from_exploded(*s, {to_bytes("ck1")});
+        BOOST_REQUIRE(sst->clustering_key_filter_may_contain(key::from_partition_key(*s, pk),
+                {query::clustering_range::make_singular(other_ck)}));
+    }).finally([] {
+        test_db_config.enable_sstable_clustering_key_filter.set(false);
+        test_db_config.sstable_clustering_key_filter_memory_ratio.set(0.05);
+    });
+}
+
+SEASTAR_TEST_CASE(repair_digest_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck1", int32_type, column_kind::clustering_key)
+                .with_column("r1", int32_type)
+                .build();
+        auto tmp = tmpdir();
+        const column_definition& r1_col = *s->get_column_definition("r1");
+
+        std::vector<mutation> muts;
+        for (auto i = 0; i < 20; i++) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(format("key{}", i))}));
+            for (auto j = 0; j < 5; j++) {
+                auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(j)});
+                m.set_clustered_cell(ck, r1_col, make_atomic_cell(int32_type, int32_type->decompose(i * j)));
+            }
+            if (i % 3 == 0) {
+                m.partition().apply(tombstone(api::timestamp_type(-1), gc_clock::now()));
+            }
+            muts.push_back(std::move(m));
+        }
+
+        auto gen = 1;
+        auto write = [&] (const std::vector<mutation>& ms) {
+            auto mt = make_lw_shared<memtable>(s);
+            for (auto& m : ms) {
+                mt->apply(m);
+            }
+            auto sst = env.make_sstable(s, tmp.path().string(), gen, sstable_version_types::md, big);
+            write_memtable_to_sstable_for_test(*mt, sst).get();
+            return env.reusable_sst(s, tmp.path().string(), gen++, sstable_version_types::md).get0();
+        };
+        using digest_map = std::map<uint32_t, std::pair<uint64_t, uint64_t>>;
+        auto max_bucket = (uint32_t(1) << repair_digest_bucket_bits) - 1;
+        auto digest_of = [&] (std::initializer_list<shared_sstable> ssts) {
+            digest_map digest;
+            for (auto& sst : ssts) {
+                BOOST_REQUIRE(sst->has_repair_digest());
+                auto d = sst->read_repair_digest(0, max_bucket, repair_digest_bucket_bits, default_priority_class()).get0();
+                BOOST_REQUIRE(d);
+                BOOST_REQUIRE(std::is_sorted(d->begin(), d->end(), [] (auto& a, auto& b) { return a.index < b.index; }));
+                for (auto& b : *d) {
+                    auto& e = digest[b.index];
+                    e.first += b.fragments;
+                    e.second += b.sum;
+                }
+            }
+            return digest;
+        };
+
+        auto all = write(muts);
+        auto digest = digest_of({all});
+        for (auto& m : muts) {
+            BOOST_REQUIRE(digest.contains(repair_digest_bucket_of(m.token(), repair_digest_bucket_bits)));
+        }
+
+        // Digests of sstables holding parts of the data add up to the digest of the whole data.
+        std::vector<mutation> even, odd;
+        for (size_t i = 0; i < muts.size(); i++) {
+            (i % 2 ? odd : even).push_back(muts[i]);
+        }
+        BOOST_REQUIRE(digest_of({write(even), write(odd)}) == digest);
+
+        // Any difference in data changes the digest of its bucket only.
+        auto changed = muts;
+        auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(1)});
+        changed[7].set_clustered_cell(ck, r1_col, atomic_cell::make_live(*int32_type, 1, int32_type->decompose(-1)));
+        auto changed_digest = digest_of({write(changed)});
+        auto changed_bucket = repair_digest_bucket_of(changed[7].token(), repair_digest_bucket_bits);
+        BOOST_REQUIRE(changed_digest.at(changed_bucket) != digest.at(changed_bucket));
+        changed_digest.erase(changed_bucket);
+        digest.erase(changed_bucket);
+        BOOST_REQUIRE(changed_digest == digest);
+
+        // Only the buckets of the given range are read, reduced to the given number of bits.
+        auto full = all->read_repair_digest(0, max_bucket, repair_digest_bucket_bits, default_priority_class()).get0();
+        BOOST_REQUIRE(full && full->size() > 2);
+        auto first = (*full)[1].index;
+        auto last = (*full)[full->size() - 2].index;
+        auto part = all->read_repair_digest(first, last, repair_digest_bucket_bits, default_priority_class()).get0();
+        BOOST_REQUIRE(part);
+        BOOST_REQUIRE(std::equal(part->begin(), part->end(), full->begin() + 1, full->end() - 1, [] (auto& a, auto& b) {
+            return a.index == b.index && a.fragments == b.fragments && a.sum == b.sum;
+        }));
+        auto coarse = all->read_repair_digest(0, 1, 1, default_priority_class()).get0();
+        BOOST_REQUIRE(coarse);
+        uint64_t fragments = 0;
+        for (auto& b : *coarse) {
+            BOOST_REQUIRE_LE(b.index, 1);
+            fragments += b.fragments;
+        }
+        for (auto& b : *full) {
+            fragments -= b.fragments;
+        }
+        BOOST_REQUIRE_EQUAL(fragments, 0);
+        BOOST_REQUIRE(!all->read_repair_digest(0, max_bucket, repair_digest_bucket_bits + 1, default_priority_class()).get0());
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_tombstone_metadata_check) {
     return test_env::do_with_async([] (test_env& env) {
         for (const auto version : all_sstable_versions) {
@@ -4821,6 +5016,79 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+// A tombstone purge job is built around the sstable with the highest droppable
+// tombstone ratio, and includes the sstables which may hold data it shadows.
+SEASTAR_TEST_CASE(tombstone_purge_job_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto tmp = tmpdir();
+        auto s = make_shared_schema({}, some_keyspace, some_column_family,
+            {{"p1", utf8_type}}, {{"c1", utf8_type}}, {{"r1", utf8_type}}, {}, utf8_type);
+        auto creator = [&, gen = make_lw_shared<unsigned>(1)] {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+        };
+        auto c_key = clustering_key::from_exploded(*s, {to_bytes("c1")});
+        auto& r1 = *s->get_column_definition("r1");
+
+        // Half an hour into a one hour time window.
+        api::timestamp_type ts = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::minutes(10 * 60 + 30)).count();
+
+        // All the data of the target is expired, with expiration times spread for the histogram not to merge them.
+        std::vector<mutation> expired;
+        auto now = gc_clock::now();
+        for (auto i = 0; i < 10; i++) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+            auto expiry = now - gc_clock::duration(DEFAULT_GC_GRACE_SECONDS * 2 + i);
+            m.set_clustered_cell(c_key, r1, atomic_cell::make_live(*utf8_type, ts, bytes("a"), expiry, gc_clock::duration(1)));
+            expired.push_back(std::move(m));
+        }
+        auto target = make_sstable_containing(creator, std::move(expired));
+        // Only old enough sstables are worth dropping tombstones from.
+        sstables::test(target).set_data_file_write_time(db_clock::time_point::min());
+
+        auto make_sstable_with_timestamp = [&] (api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key0")}));
+            m.set_clustered_cell(c_key, r1, atomic_cell::make_live(*utf8_type, ts, bytes("b")));
+            return make_sstable_containing(creator, {std::move(m)});
+        };
+        auto older = make_sstable_with_timestamp(ts - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::minutes(1)).count());
+        auto older_window = make_sstable_with_timestamp(ts - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::hours(2)).count());
+        auto newer = make_sstable_with_timestamp(ts + 1);
+
+        column_family_for_tests cf(env.manager(), s);
+
+        // Sstables holding data newer than the tombstones can't be shadowed by them.
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto descriptor = cs.get_tombstone_purge_job(*cf, { newer, target, older_window, older });
+        BOOST_REQUIRE(descriptor.sstables.size() == 3);
+        BOOST_REQUIRE(boost::algorithm::any_of_equal(descriptor.sstables, target));
+        BOOST_REQUIRE(boost::algorithm::any_of_equal(descriptor.sstables, older));
+        BOOST_REQUIRE(boost::algorithm::any_of_equal(descriptor.sstables, older_window));
+
+        descriptor = cs.get_tombstone_purge_job(*cf, { newer, older_window, older });
+        BOOST_REQUIRE(descriptor.sstables.empty());
+
+        // TWCS never merges sstables of different windows.
+        std::map<sstring, sstring> twcs_options;
+        twcs_options.emplace("compaction_window_unit", "HOURS");
+        twcs_options.emplace("compaction_window_size", "1");
+        cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, twcs_options);
+        descriptor = cs.get_tombstone_purge_job(*cf, { newer, target, older_window, older });
+        BOOST_REQUIRE(descriptor.sstables.size() == 2);
+        BOOST_REQUIRE(boost::algorithm::any_of_equal(descriptor.sstables, target));
+        BOOST_REQUIRE(boost::algorithm::any_of_equal(descriptor.sstables, older));
+
+        // LCS and DTCS opt out.
+        cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::leveled, {});
+        descriptor = cs.get_tombstone_purge_job(*cf, { newer, target, older_window, older });
+        BOOST_REQUIRE(descriptor.sstables.empty());
+        std::map<sstring, sstring> dtcs_options;
+        dtcs_options.emplace("tombstone_threshold", "0.2f");
+        cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::date_tiered, dtcs_options);
+        descriptor = cs.get_tombstone_purge_job(*cf, { newer, target, older_window, older });
+        BOOST_REQUIRE(descriptor.sstables.empty());
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_owner_shards) {
     return test_env::do_with_async([] (test_env& env) {
         cell_locker_stats cl_stats;
@@ -7700,6 +7968,83 @@ SEASTAR_TEST_CASE(test_twcs_single_key_reader_filtering) {
     });
 }
 
+// Single-row reads skip sstables whose clustering key filter doesn't
+// contain the row, unless the partition has tombstones in them.
+SEASTAR_TEST_CASE(test_single_key_reader_clustering_key_bloom_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        test_db_config.enable_sstable_clustering_key_filter.set(true);
+        auto disable_ck_filter = defer([] { test_db_config.enable_sstable_clustering_key_filter.set(false); });
+        auto s = schema_builder("tests", "single_key_reader_clustering_key_bloom_filter")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)]() {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::md, big);
+        };
+
+        auto make_ck = [&] (int32_t ck) {
+            return clustering_key::from_single_value(*s, int32_type->decompose(ck));
+        };
+        auto make_row = [&] (int32_t pk, int32_t ck) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+            m.set_clustered_cell(make_ck(ck), to_bytes("v"), int32_t(0), api::new_timestamp());
+            return m;
+        };
+
+        auto sst1 = make_sstable_containing(sst_gen, {make_row(0, 0)});
+        auto sst2 = make_sstable_containing(sst_gen, {make_row(0, 1)});
+        auto deleted = make_row(0, 2);
+        deleted.partition().apply(tombstone(api::min_timestamp + 1, gc_clock::now()));
+        auto sst3 = make_sstable_containing(sst_gen, {deleted});
+        BOOST_REQUIRE(sst1->has_clustering_key_filter());
+        BOOST_REQUIRE(sst2->has_clustering_key_filter());
+        BOOST_REQUIRE(sst3->has_clustering_key_filter());
+        auto dkey = sst1->get_first_decorated_key();
+
+        auto cm = make_lw_shared<compaction_manager>();
+        column_family::config cfg = column_family_test_config(env.manager());
+        ::cf_stats cf_stats{0};
+        cfg.cf_stats = &cf_stats;
+        cfg.datadir = tmp.path().string();
+        auto tracker = make_lw_shared<cache_tracker>();
+        cell_locker_stats cl_stats;
+        column_family cf(s, cfg, column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf.mark_ready_for_writes();
+        cf.start();
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto set = cs.make_sstable_set(s);
+        set.insert(sst1);
+        set.insert(sst2);
+        set.insert(sst3);
+
+        reader_permit permit = tests::make_permit();
+        utils::estimated_histogram eh;
+        auto pr = dht::partition_range::make_singular(dkey);
+        auto slice = partition_slice_builder(*s)
+                .with_range(query::clustering_range::make_singular(make_ck(0)))
+                .build();
+
+        auto reader = set.create_single_key_sstable_reader(
+                &cf, s, permit, eh, pr, slice, default_priority_class(),
+                tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no);
+        auto close_reader = deferred_close(reader);
+
+        // sst2 has neither the row nor tombstones for the partition, while
+        // the partition tombstone in sst3 could shadow the row.
+        BOOST_REQUIRE_EQUAL(cf_stats.sstables_skipped_by_clustering_key_filter, 1);
+
+        auto mopt = read_mutation_from_flat_mutation_reader(reader, db::no_timeout).get0();
+        BOOST_REQUIRE(mopt);
+        BOOST_REQUIRE(mopt->partition().find_row(*s, make_ck(0)));
+        BOOST_REQUIRE(mopt->partition().partition_tombstone());
+    });
+}
+
 SEASTAR_TEST_CASE(max_ongoing_compaction_test) {
     return test_env::do_with_async([] (test_env& env) {
         BOOST_REQUIRE(smp::count == 1);
@@ -1666,3 +1666,54 @@ SEASTAR_TEST_CASE(test_static_compact_tables_are_read) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_clustering_split_positions) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : all_sstable_versions) {
+            simple_schema ss;
+            auto s = ss.schema();
+            auto pks = ss.make_pkeys(2);
+
+            mutation m = ss.new_mutation(pks[0]);
+            for (int i = 0; i < 100; ++i) {
+                ss.add_row(m, ss.make_ckey(i), sstring(100, 'v'));
+            }
+            auto mt = make_lw_shared<memtable>(s);
+            mt->apply(m);
+
+            tmpdir dir;
+            auto sst = env.make_sstable(s, dir.path().string(), 1, version, sstables::sstable::format_types::big);
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.promoted_index_block_size = 1000;
+            sst->write_components(mt->make_flat_reader(s, tests::make_permit()), 1, s, cfg, mt->get_encoding_stats()).get();
+            sst->load().get();
+
+            // Read in reverse in chunks of about 30 rows.
+            auto pr = dht::partition_range::make_singular(pks[0]);
+            auto slice = partition_slice_builder(*s).reversed().build();
+            assert_that(sst->make_reversed_reader(s, tests::make_permit(), pr, slice, default_priority_class(), nullptr,
+                            query::max_result_size(12000, 1 << 20)))
+                .produces_reversed(m)
+                .produces_end_of_stream();
+
+            // About 10 rows per index block and 30 rows per chunk.
+            auto positions = sst->get_clustering_split_positions(pks[0], 3000, tests::make_permit(), default_priority_class(), nullptr).get0();
+            testlog.info("Version {}: {} split positions", static_cast<int>(version), positions.size());
+            if (version < sstable_version_types::mc) {
+                // The promoted index of ka/la sstables has no clustering positions.
+                BOOST_REQUIRE(positions.empty());
+                continue;
+            }
+            BOOST_REQUIRE_GE(positions.size(), 2);
+            BOOST_REQUIRE_LE(positions.size(), 4);
+            position_in_partition::less_compare less(*s);
+            for (unsigned i = 0; i < positions.size(); ++i) {
+                BOOST_REQUIRE(!positions[i].is_clustering_row());
+                BOOST_REQUIRE(i == 0 || less(positions[i - 1], positions[i]));
+            }
+
+            BOOST_REQUIRE(sst->get_clustering_split_positions(pks[0], 1 << 20, tests::make_permit(), default_priority_class(), nullptr).get0().empty());
+            BOOST_REQUIRE(sst->get_clustering_split_positions(pks[1], 3000, tests::make_permit(), default_priority_class(), nullptr).get0().empty());
+        }
+    });
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+
+#include "streaming/stream_transfer_task.hh"
+
+static dht::token token(int64_t t) {
+    return dht::token(dht::token::kind::key, t);
+}
+
+static dht::token_range range(int64_t start, int64_t end) {
+    return dht::token_range(dht::token_range::bound(token(start), false), dht::token_range::bound(token(end), true));
+}
+
+static dht::token_range_vector concat(const std::vector<dht::token_range_vector>& groups) {
+    dht::token_range_vector ret;
+    for (auto& g : groups) {
+        BOOST_REQUIRE(!g.empty());
+        ret.insert(ret.end(), g.begin(), g.end());
+    }
+    return ret;
+}
+
+// The ranges cover the same tokens as [start, end], in order.
+static void check_covers(const dht::token_range_vector& ranges, const dht::token_range& r) {
+    BOOST_REQUIRE(!ranges.empty());
+    BOOST_REQUIRE(ranges.front().start() == r.start());
+    BOOST_REQUIRE(ranges.back().end() == r.end());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        auto& prev_end = *ranges[i - 1].end();
+        auto& start = *ranges[i].start();
+        BOOST_REQUIRE(prev_end.value() == start.value());
+        BOOST_REQUIRE(prev_end.is_inclusive() != start.is_inclusive());
+        BOOST_REQUIRE(ranges[i].start()->value() < ranges[i].end()->value());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_split_ranges_for_one_stream) {
+    auto ranges = dht::token_range_vector{range(0, 10), range(20, 30), range(40, 50)};
+    auto groups = streaming::split_ranges_for_streams(ranges, 1);
+    BOOST_REQUIRE_EQUAL(groups.size(), 1);
+    BOOST_REQUIRE(groups[0] == ranges);
+}
+
+BOOST_AUTO_TEST_CASE(test_split_many_ranges_into_contiguous_groups) {
+    dht::token_range_vector ranges;
+    for (int64_t i = 0; i < 10; ++i) {
+        ranges.push_back(range(i * 100, i * 100 + 50));
+    }
+    auto groups = streaming::split_ranges_for_streams(ranges, 4);
+    BOOST_REQUIRE_EQUAL(groups.size(), 4);
+    for (auto& g : groups) {
+        BOOST_REQUIRE_GE(g.size(), 2);
+        BOOST_REQUIRE_LE(g.size(), 3);
+    }
+    // Nothing is bisected when there are enough ranges.
+    BOOST_REQUIRE(concat(groups) == ranges);
+}
+
+BOOST_AUTO_TEST_CASE(test_split_bisects_a_single_range) {
+    auto r = range(-1000000, 1000000);
+    auto groups = streaming::split_ranges_for_streams({r}, 4);
+    BOOST_REQUIRE_EQUAL(groups.size(), 4);
+    check_covers(concat(groups), r);
+
+    // Ranges are bisected evenly, some groups end up with more of them.
+    groups = streaming::split_ranges_for_streams({r}, 3);
+    BOOST_REQUIRE_EQUAL(groups.size(), 3);
+    check_covers(concat(groups), r);
+}
+
+BOOST_AUTO_TEST_CASE(test_split_ranges_which_cannot_be_bisected) {
+    // Unbounded ranges are not bisected.
+    auto full = dht::token_range_vector{dht::token_range::make_open_ended_both_sides()};
+    auto groups = streaming::split_ranges_for_streams(full, 4);
+    BOOST_REQUIRE_EQUAL(groups.size(), 1);
+    BOOST_REQUIRE(groups[0] == full);
+
+    // Nor are ranges of a single token.
+    auto single = dht::token_range_vector{range(0, 1), range(5, 6)};
+    groups = streaming::split_ranges_for_streams(single, 4);
+    BOOST_REQUIRE_EQUAL(groups.size(), 2);
+    BOOST_REQUIRE(concat(groups) == single);
+}
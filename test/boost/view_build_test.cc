@@ -23,6 +23,7 @@
 
 #include "database.hh"
 #include "db/view/view_builder.hh"
+#include "db/view/inflight_batches.hh"
 #include "db/view/view_updating_consumer.hh"
 #include "db/system_keyspace.hh"
 #include "db/system_keyspace_view_types.hh"
@@ -42,6 +43,7 @@
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
 #include "utils/ranges.hh"
+#include "utils/error_injection.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -175,6 +177,148 @@ SEASTAR_TEST_CASE(test_builder_with_multiple_partitions_of_batch_size_rows) {
     });
 }
 
+SEASTAR_TEST_CASE(test_builder_with_concurrent_batches) {
+    auto cfg = make_shared<db::config>();
+    cfg->view_building_concurrency(8);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        for (auto i = 0; i < 2048; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, 0)", i, i % 3)).get();
+        }
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        f.get();
+        BOOST_REQUIRE(e.local_view_builder().get_build_progress("ks", "vcf").get0().empty());
+
+        auto msg = e.execute_cql("select count(*) from vcf where v = 0").get0();
+        assert_that(msg).is_rows().with_size(1);
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(2048L)}}});
+    }, cfg);
+}
+
+// A step of the view builder keeps up to view_building_concurrency batches in
+// flight. Check that no more than that many run at once, and that a batch is
+// started as soon as another one completes.
+SEASTAR_THREAD_TEST_CASE(test_inflight_batches_concurrency) {
+    db::view::inflight_batches batches(3);
+    std::vector<promise<>> done(10);
+    unsigned in_flight = 0;
+    unsigned max_in_flight = 0;
+    unsigned completed = 0;
+    auto start = [&] (unsigned i) {
+        batches.run([&, i] {
+            max_in_flight = std::max(++in_flight, max_in_flight);
+            return done[i].get_future().then([&] {
+                --in_flight;
+                ++completed;
+            });
+        });
+    };
+
+    for (unsigned i = 0; i < 3; ++i) {
+        start(i);
+    }
+    BOOST_REQUIRE_EQUAL(in_flight, 3);
+
+    // All slots are taken, so the fourth batch has to wait for one to be freed.
+    auto f = seastar::async([&] { start(3); });
+    seastar::thread::yield();
+    BOOST_REQUIRE(!f.available());
+    BOOST_REQUIRE_EQUAL(in_flight, 3);
+    done[1].set_value();
+    f.get();
+    BOOST_REQUIRE_EQUAL(in_flight, 3);
+    BOOST_REQUIRE_EQUAL(completed, 1);
+
+    for (unsigned i : {0, 2, 3}) {
+        done[i].set_value();
+    }
+    for (unsigned i = 4; i < done.size(); ++i) {
+        start(i);
+        done[i].set_value();
+    }
+    batches.wait();
+    BOOST_REQUIRE_EQUAL(in_flight, 0);
+    BOOST_REQUIRE_EQUAL(completed, done.size());
+    BOOST_REQUIRE_EQUAL(max_in_flight, 3);
+}
+
+// Once a batch failed, the step stops producing batches and has to be redone,
+// but the batches already started still have to complete before that.
+SEASTAR_THREAD_TEST_CASE(test_inflight_batches_failure) {
+    db::view::inflight_batches batches(2);
+    promise<> first;
+    promise<> second;
+    batches.run([&] { return first.get_future(); });
+    batches.run([&] { return second.get_future(); });
+    second.set_exception(std::runtime_error("batch failed"));
+
+    // The batch waiting for the slot of the failed one is still started, for it
+    // to release what it holds, but the failure is reported to the producer.
+    bool started = false;
+    BOOST_REQUIRE_THROW(batches.run([&] { started = true; return make_ready_future<>(); }), std::runtime_error);
+    BOOST_REQUIRE(started);
+    BOOST_REQUIRE_THROW(batches.check(), std::runtime_error);
+
+    auto f = seastar::async([&] { batches.close(); });
+    seastar::thread::yield();
+    BOOST_REQUIRE(!f.available());
+    first.set_value();
+    f.get();
+    BOOST_REQUIRE_THROW(batches.wait(), std::runtime_error);
+}
+
+// If a batch of a build step fails, the rows of the step's other batches may
+// already be behind the recorded progress, so the whole step is redone from
+// its start. Check that no base rows end up missing from the view.
+SEASTAR_TEST_CASE(test_builder_redoes_step_after_failed_batch) {
+    auto cfg = make_shared<db::config>();
+    cfg->view_building_concurrency(4);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        for (auto i = 0; i < 2048; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, 0)", i, i % 3)).get();
+        }
+
+        // Fail the first batch each shard completes, after it already propagated its view updates.
+        utils::get_local_injector().enable_on_all("view_builder_populate_views", true).get();
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+        f.get();
+
+        // One-shot injections are disabled once triggered: in builds with error injection,
+        // every shard went through a failed batch.
+        auto still_enabled = e.db().map_reduce0([] (database&) {
+            return utils::get_local_injector().enabled_injections().size();
+        }, size_t(0), std::plus<size_t>()).get0();
+        BOOST_REQUIRE_EQUAL(still_enabled, 0);
+        auto msg = e.execute_cql("select count(*) from vcf where v = 0").get0();
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(2048L)}}});
+    }, cfg);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_build_fraction_built) {
+    using db::view::view_builder;
+    auto t = [] (int64_t v) { return dht::token(dht::token::kind::key, v); };
+    auto quarter = int64_t(1) << 62;
+
+    BOOST_REQUIRE_EQUAL(view_builder::fraction_built(t(0), std::nullopt), 0);
+    BOOST_REQUIRE_EQUAL(view_builder::fraction_built(t(0), t(quarter)), 0.25);
+    // The walk may wrap around the end of the ring.
+    BOOST_REQUIRE_EQUAL(view_builder::fraction_built(t(quarter), t(-quarter)), 0.5);
+    // A shard back at its first token has walked the whole ring.
+    BOOST_REQUIRE_EQUAL(view_builder::fraction_built(t(quarter), t(quarter)), 1);
+}
+
 SEASTAR_TEST_CASE(test_builder_view_added_during_ongoing_build) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
@@ -1759,3 +1759,42 @@ SEASTAR_TEST_CASE(test_3362_row_deletion_2) {
         });
     });
 }
+
+// Writes to base partitions which don't exist yet need no read-before-write,
+// as there cannot be any view entries they would shadow. Check that the read
+// is skipped for those, and that view updates stay correct when the partition
+// exists in a memtable or in an sstable.
+SEASTAR_TEST_CASE(test_read_before_write_skipped_for_absent_partitions) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, p, c)").get();
+        auto skipped = [&e] {
+            return e.db().map_reduce0([] (database& db) {
+                return db.find_column_family("ks", "cf").cf_stats()->total_view_update_reads_skipped;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto initial = skipped();
+
+        e.execute_cql("insert into cf (p, c, v) values (1, 1, 10)").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+
+        // The partition is now in the memtable
+        e.execute_cql("insert into cf (p, c, v) values (1, 1, 20)").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+
+        // ...and now in an sstable
+        e.db().invoke_on_all([] (database& db) {
+            return db.flush_all_memtables();
+        }).get();
+        e.execute_cql("insert into cf (p, c, v) values (1, 1, 30)").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+
+        eventually([&] {
+            auto msg = e.execute_cql("select v, p, c from vcf").get0();
+            assert_that(msg).is_rows().with_rows({{ {int32_type->decompose(30)}, {int32_type->decompose(1)}, {int32_type->decompose(1)} }});
+        });
+    });
+}
+
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/semaphore.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/view/view_update_batcher.hh"
+#include "service/migration_manager.hh"
+#include "service/storage_proxy.hh"
+#include "utils/fb_utilities.hh"
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
+#include "test/lib/simple_schema.hh"
+
+using namespace db::view;
+
+namespace {
+
+std::vector<frozen_mutation_and_schema> make_updates(simple_schema& s, int nr, size_t value_size = 100) {
+    std::vector<frozen_mutation_and_schema> ret;
+    for (auto& dk : s.make_pkeys(nr)) {
+        mutation m(s.schema(), dk);
+        s.add_row(m, s.make_ckey(0), sstring(value_size, 'v'));
+        ret.push_back(frozen_mutation_and_schema{freeze(m), s.schema()});
+    }
+    return ret;
+}
+
+size_t size_of(const frozen_mutation_and_schema& mut) {
+    return mut.fm.representation().size();
+}
+
+} // anonymous namespace
+
+SEASTAR_THREAD_TEST_CASE(test_view_updates_are_batched_by_target_up_to_the_size_cap) {
+    simple_schema s;
+    auto updates = make_updates(s, 5);
+    db::timeout_semaphore sem(1000);
+    auto target_a = gms::inet_address("127.0.0.2");
+    auto target_b = gms::inet_address("127.0.0.3");
+
+    // Batches hold two updates each.
+    view_update_batcher batcher(2 * size_of(updates[0]) + size_of(updates[0]) / 2);
+    auto add = [&] (gms::inet_address target, size_t i) {
+        return batcher.add(target, updates[i], get_units(sem, 10).get0());
+    };
+    BOOST_REQUIRE(!add(target_a, 0));
+    BOOST_REQUIRE(!add(target_b, 1));
+    BOOST_REQUIRE(!add(target_a, 2));
+
+    // The third update for a target doesn't fit in its batch, which is handed back to be sent.
+    auto full = add(target_a, 3);
+    BOOST_REQUIRE(full);
+    BOOST_REQUIRE_EQUAL(full->mutations.size(), 2);
+    BOOST_REQUIRE(full->mutations[0].fm.key().equal(*s.schema(), updates[0].fm.key()));
+    BOOST_REQUIRE(full->mutations[1].fm.key().equal(*s.schema(), updates[2].fm.key()));
+    BOOST_REQUIRE_EQUAL(full->size, size_of(updates[0]) + size_of(updates[2]));
+    // The batch keeps the view update concurrency units of its updates until it's sent.
+    BOOST_REQUIRE_EQUAL(full->units.count(), 20);
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 1000 - 40);
+    full.reset();
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 1000 - 20);
+
+    BOOST_REQUIRE(!add(target_b, 4));
+    auto rest = batcher.release();
+    BOOST_REQUIRE_EQUAL(rest.size(), 2);
+    BOOST_REQUIRE_EQUAL(rest[target_a].mutations.size(), 1);
+    BOOST_REQUIRE(rest[target_a].mutations[0].fm.key().equal(*s.schema(), updates[3].fm.key()));
+    BOOST_REQUIRE_EQUAL(rest[target_b].mutations.size(), 2);
+    BOOST_REQUIRE_EQUAL(rest[target_b].units.count(), 20);
+    BOOST_REQUIRE(batcher.release().empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_larger_than_the_cap_is_sent_alone) {
+    simple_schema s;
+    auto small = make_updates(s, 2);
+    auto large = make_updates(s, 1, 10000);
+    db::timeout_semaphore sem(1000);
+    auto target = gms::inet_address("127.0.0.2");
+
+    view_update_batcher batcher(size_of(large[0]) / 2);
+    BOOST_REQUIRE(!batcher.add(target, large[0], get_units(sem, 1).get0()));
+    auto full = batcher.add(target, small[0], get_units(sem, 1).get0());
+    BOOST_REQUIRE(full);
+    BOOST_REQUIRE_EQUAL(full->mutations.size(), 1);
+    BOOST_REQUIRE_EQUAL(full->size, size_of(large[0]));
+    BOOST_REQUIRE(!batcher.add(target, small[1], get_units(sem, 1).get0()));
+    BOOST_REQUIRE_EQUAL(batcher.release()[target].mutations.size(), 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_batch_is_sent_in_one_message) {
+    simple_schema s;
+    auto updates = make_updates(s, 3);
+    db::timeout_semaphore sem(1000);
+    auto target = gms::inet_address("127.0.0.2");
+
+    view_update_batcher batcher(1024 * 1024);
+    for (auto& mut : updates) {
+        batcher.add(target, mut, get_units(sem, 10).get0());
+    }
+    auto batch = std::move(batcher.release()[target]);
+
+    promise<> sent;
+    std::vector<frozen_mutation> sent_mutations;
+    unsigned sent_one = 0;
+    auto f = send_view_update_batch(target, std::move(batch), [&] (gms::inet_address to, std::vector<frozen_mutation> fms) {
+        BOOST_REQUIRE_EQUAL(to, target);
+        sent_mutations = std::move(fms);
+        return sent.get_future();
+    }, [&] (gms::inet_address, frozen_mutation_and_schema&) {
+        ++sent_one;
+        return make_ready_future<>();
+    });
+    BOOST_REQUIRE_EQUAL(sent_mutations.size(), updates.size());
+    // The units are held until the replica acknowledges the batch.
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 1000 - 30);
+    sent.set_value();
+    f.get();
+    BOOST_REQUIRE_EQUAL(sent_one, 0);
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 1000);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_failed_view_update_batch_is_resent_per_mutation) {
+    simple_schema s;
+    auto updates = make_updates(s, 3);
+    db::timeout_semaphore sem(1000);
+    auto target = gms::inet_address("127.0.0.2");
+
+    auto make_batch = [&] {
+        view_update_batcher batcher(1024 * 1024);
+        for (auto& mut : updates) {
+            batcher.add(target, mut, get_units(sem, 10).get0());
+        }
+        return std::move(batcher.release()[target]);
+    };
+    auto failing_batch = [] (gms::inet_address, std::vector<frozen_mutation>) {
+        return make_exception_future<>(std::runtime_error("batch failed"));
+    };
+
+    // Every update of the failed batch is sent again on its own.
+    {
+        std::vector<partition_key> resent;
+        send_view_update_batch(target, make_batch(), failing_batch, [&] (gms::inet_address to, frozen_mutation_and_schema& mut) {
+            BOOST_REQUIRE_EQUAL(to, target);
+            resent.push_back(mut.fm.key());
+            return make_ready_future<>();
+        }).get();
+        BOOST_REQUIRE_EQUAL(resent.size(), updates.size());
+        for (size_t i = 0; i < updates.size(); ++i) {
+            BOOST_REQUIRE(resent[i].equal(*s.schema(), updates[i].fm.key()));
+        }
+        BOOST_REQUIRE_EQUAL(sem.available_units(), 1000);
+    }
+
+    // A failure of one of the resent updates fails the batch, but doesn't stop the others from being sent.
+    {
+        unsigned resent = 0;
+        auto f = send_view_update_batch(target, make_batch(), failing_batch, [&] (gms::inet_address, frozen_mutation_and_schema& mut) {
+            ++resent;
+            if (mut.fm.key().equal(*s.schema(), updates[1].fm.key())) {
+                return make_exception_future<>(std::runtime_error("update failed"));
+            }
+            return make_ready_future<>();
+        });
+        BOOST_REQUIRE_THROW(f.get(), std::runtime_error);
+        BOOST_REQUIRE_EQUAL(resent, updates.size());
+        BOOST_REQUIRE_EQUAL(sem.available_units(), 1000);
+    }
+}
+
+SEASTAR_TEST_CASE(test_view_update_batch_reply_carries_the_backlog) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.t (p int primary key, c int);").get();
+        e.execute_cql("create materialized view ks.mv as select * from ks.t where c is not null and p is not null primary key (c, p);").get();
+        auto vs = e.local_db().find_schema("ks", "mv");
+
+        mutation m(vs, partition_key::from_single_value(*vs, int32_type->decompose(1)));
+        m.partition().apply_insert(*vs, clustering_key::from_singular(*vs, 2), api::new_timestamp());
+        std::vector<frozen_mutation> fms;
+        fms.push_back(freeze(m));
+
+        // The receiving side applies the batch and replies with its backlog.
+        auto& proxy = service::get_local_storage_proxy();
+        auto me = utils::fb_utilities::get_broadcast_address();
+        auto backlog = proxy.apply_view_update_batch(netw::msg_addr{me, 0}, std::move(fms), service::storage_proxy::clock_type::time_point::max(),
+                nullptr, e.migration_manager().local()).get0();
+        BOOST_REQUIRE(backlog == proxy.get_view_update_backlog());
+        assert_that(e.execute_cql("select c, p from ks.mv;").get0()).is_rows().with_rows({
+            {int32_type->decompose(1), int32_type->decompose(2)},
+        });
+
+        // The sending side throttles the updates to the replica by the backlog it replied with.
+        auto replica = gms::inet_address("127.0.0.2");
+        BOOST_REQUIRE(proxy.get_backlog_of(replica) == db::view::update_backlog::no_backlog());
+        auto replied = db::view::update_backlog{10, 100};
+        proxy.got_view_update_batch_response(replica, replied);
+        BOOST_REQUIRE(proxy.get_backlog_of(replica) == replied);
+    });
+}
@@ -147,6 +147,7 @@ class single_node_cql_env : public cql_test_env {
     sharded<auth::service>& _auth_service;
     sharded<db::view::view_builder>& _view_builder;
     sharded<db::view::view_update_generator>& _view_update_generator;
+    sharded<db::system_distributed_keyspace>& _sys_dist_ks;
     sharded<service::migration_notifier>& _mnotifier;
     sharded<qos::service_level_controller>& _sl_controller;
     sharded<service::migration_manager>& _mm;
@@ -179,6 +180,7 @@ class single_node_cql_env : public cql_test_env {
             sharded<auth::service>& auth_service,
             sharded<db::view::view_builder>& view_builder,
             sharded<db::view::view_update_generator>& view_update_generator,
+            sharded<db::system_distributed_keyspace>& sys_dist_ks,
             sharded<service::migration_notifier>& mnotifier,
             sharded<service::migration_manager>& mm,
             sharded<qos::service_level_controller> &sl_controller)
@@ -187,6 +189,7 @@ class single_node_cql_env : public cql_test_env {
             , _auth_service(auth_service)
             , _view_builder(view_builder)
             , _view_update_generator(view_update_generator)
+            , _sys_dist_ks(sys_dist_ks)
             , _mnotifier(mnotifier)
             , _sl_controller(sl_controller)
             , _mm(mm)
@@ -377,6 +380,14 @@ class single_node_cql_env : public cql_test_env {
         return _view_update_generator.local();
     }
 
+    virtual sharded<db::view::view_update_generator>& view_update_generator() override {
+        return _view_update_generator;
+    }
+
+    virtual sharded<db::system_distributed_keyspace>& sys_dist_ks() override {
+        return _sys_dist_ks;
+    }
+
     virtual service::migration_notifier& local_mnotifier() override {
         return _mnotifier.local();
     }
@@ -730,7 +741,7 @@ class single_node_cql_env : public cql_test_env {
                 // The default user may already exist if this `cql_test_env` is starting with previously populated data.
             }
 
-            single_node_cql_env env(db, qp, auth_service, view_builder, view_update_generator, mm_notif, mm, std::ref(sl_controller));
+            single_node_cql_env env(db, qp, auth_service, view_builder, view_update_generator, sys_dist_ks, mm_notif, mm, std::ref(sl_controller));
             env.start().get();
             auto stop_env = defer([&env] { env.stop().get(); });
 
@@ -367,6 +367,50 @@ class flat_reader_assertions {
         return *this;
     }
 
+    // Checks that the next partition is emitted in reverse clustering order,
+    // in the format of make_reversing_reader(), and is equal to m.
+    flat_reader_assertions& produces_reversed(const mutation& m, const std::optional<query::clustering_row_ranges>& ck_ranges = {}) {
+        const schema& s = *_reader.schema();
+        auto mfo = read_next();
+        if (!mfo) {
+            BOOST_FAIL(format("Expected {}, but got end of stream, at: {}", m, seastar::current_backtrace()));
+        }
+        if (!mfo->is_partition_start()) {
+            BOOST_FAIL(format("Expected partition start, got {}", mutation_fragment::printer(s, *mfo)));
+        }
+        mutation result(m.schema(), mfo->as_partition_start().key());
+        result.partition().apply(mfo->as_partition_start().partition_tombstone());
+        position_in_partition::less_compare less(s);
+        std::optional<position_in_partition> last_row;
+        std::optional<position_in_partition> last_rt_end;
+        for (mfo = read_next(); mfo && !mfo->is_end_of_partition(); mfo = read_next()) {
+            if (mfo->is_clustering_row()) {
+                if (last_row && !less(mfo->position(), *last_row)) {
+                    BOOST_FAIL(format("Row {} is not below the previous row {}", mfo->position(), *last_row));
+                }
+                last_row = position_in_partition(mfo->position());
+            } else if (mfo->is_range_tombstone()) {
+                auto end = mfo->as_range_tombstone().end_position();
+                if (last_rt_end && less(*last_rt_end, end)) {
+                    BOOST_FAIL(format("Range tombstone ending at {} follows one ending at {}", end, *last_rt_end));
+                }
+                if (last_row && !less(end, *last_row)) {
+                    BOOST_FAIL(format("Range tombstone ending at {} follows a row it covers at {}", end, *last_row));
+                }
+                last_rt_end = position_in_partition(end);
+            } else if (!mfo->is_static_row() || last_row || last_rt_end) {
+                BOOST_FAIL(format("Unexpected fragment {}", mutation_fragment::printer(s, *mfo)));
+            }
+            result.apply(*mfo);
+        }
+        if (!mfo) {
+            BOOST_FAIL(format("Expected partition end, got end of stream"));
+        }
+        memory::scoped_critical_alloc_section dfg;
+        assert_that(result).is_equal_to(m, ck_ranges);
+        return *this;
+    }
+
     flat_reader_assertions& produces(const dht::decorated_key& dk) {
         produces_partition_start(dk);
         next_partition();
@@ -62,6 +62,19 @@ int main(int argc, char* argv[]) {
             m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
             mt.apply(std::move(m));
         });
+
+        std::cout << "Timing insertion of distinct partitions...\n";
+
+        memtable mt2(s);
+        const column_definition& col = *s->get_column_definition(to_bytes(cnames[0]));
+        uint64_t nr = 0;
+
+        time_it([&] {
+            auto pk = partition_key::from_exploded(*s, {to_bytes(fmt::format("key{}", nr++))});
+            mutation m(s, pk);
+            m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
+            mt2.apply(std::move(m));
+        });
         engine().exit(0);
     });
 }
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+
+#include "test/lib/simple_schema.hh"
+
+#include "range_tombstone_list.hh"
+
+namespace tests {
+
+// Many overlapping range deletions within a single partition.
+class overlapping_range_tombstones {
+    static constexpr uint32_t count = 1000;
+
+    simple_schema _schema;
+    std::vector<clustering_key> _keys;
+    // Nested deletions, innermost first, each older than the ones it covers.
+    // Applied one by one, every deletion has to fill the gaps between
+    // all of the previous ones.
+    std::vector<range_tombstone> _nested;
+    // Deletions of equal width sliding over the keys, each newer than the
+    // previous one. Every row is covered by `count` of them.
+    std::vector<range_tombstone> _sliding;
+public:
+    overlapping_range_tombstones() {
+        for (uint32_t i = 0; i < 3 * count; ++i) {
+            _keys.push_back(_schema.make_ckey(i));
+        }
+        auto now = gc_clock::now();
+        for (uint32_t i = 0; i < count; ++i) {
+            auto range = _schema.make_ckey_range(count - i, count + i);
+            _nested.push_back(_schema.make_range_tombstone(range, tombstone(api::timestamp_type(count - i), now)));
+        }
+        for (uint32_t i = 0; i < 2 * count; ++i) {
+            auto range = _schema.make_ckey_range(i, i + count - 1);
+            _sliding.push_back(_schema.make_range_tombstone(range, tombstone(api::timestamp_type(i + 1), now)));
+        }
+    }
+
+    const schema& s() const { return *_schema.schema(); }
+    const std::vector<clustering_key>& keys() const { return _keys; }
+    const std::vector<range_tombstone>& nested() const { return _nested; }
+    const std::vector<range_tombstone>& sliding() const { return _sliding; }
+};
+
+PERF_TEST_F(overlapping_range_tombstones, apply_nested_one_by_one)
+{
+    range_tombstone_list l(s());
+    for (auto&& rt : nested()) {
+        l.apply(s(), rt);
+    }
+    perf_tests::do_not_optimize(l);
+}
+
+PERF_TEST_F(overlapping_range_tombstones, apply_nested_in_bulk)
+{
+    range_tombstone_list l(s());
+    l.apply(s(), nested());
+    perf_tests::do_not_optimize(l);
+}
+
+PERF_TEST_F(overlapping_range_tombstones, accumulate_sliding)
+{
+    range_tombstone_accumulator acc(s(), false);
+    // The i-th sliding deletion starts at the i-th key.
+    for (size_t i = 0; i < keys().size(); ++i) {
+        if (i < sliding().size()) {
+            acc.apply(sliding()[i]);
+        }
+        perf_tests::do_not_optimize(acc.tombstone_for_row(keys()[i]));
+    }
+}
+
+}
@@ -293,6 +293,52 @@ BOOST_AUTO_TEST_CASE(test_log_last_conf_idx) {
     BOOST_CHECK_EQUAL(log.in_memory_size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(test_log_memory_usage) {
+    // memory_usage() is maintained by appends, truncation and
+    // snapshots, and bounds the entries left after a snapshot
+    server_id id1 = id();
+    raft::configuration cfg({id1});
+    raft::log log{raft::snapshot{.config = cfg}};
+    BOOST_CHECK_EQUAL(log.memory_usage(), 0);
+    size_t expected = 0;
+    for (int i = 0; i < 10; i++) {
+        add_entry(log, create_command(i));
+        expected += raft::log_entry_size(*log[log.in_memory_size() - 1]);
+        BOOST_CHECK_EQUAL(log.memory_usage(), expected);
+    }
+    auto entry_size = raft::log_entry_size(*log[0]);
+    // Replace the last 2 entries with entries from a newer term
+    std::vector<raft::log_entry_ptr> entries;
+    auto term = log.last_term() + term_t{1};
+    auto idx = log.last_idx() - index_t{1};
+    for (int i = 0; i < 2; i++, idx++) {
+        entries.push_back(make_lw_shared<raft::log_entry>(raft::log_entry{term, idx, create_command(i)}));
+    }
+    log.maybe_append(std::move(entries));
+    BOOST_CHECK_EQUAL(log.in_memory_size(), 10);
+    BOOST_CHECK_EQUAL(log.memory_usage(), 10 * entry_size);
+    // The count limit keeps 5 entries
+    log.apply_snapshot(log_snapshot(log, log.last_idx()), 5);
+    BOOST_CHECK_EQUAL(log.in_memory_size(), 5);
+    BOOST_CHECK_EQUAL(log.memory_usage(), 5 * entry_size);
+    // The memory limit keeps 2 of the 6 entries allowed by count
+    add_entry(log, create_command(10));
+    log.apply_snapshot(log_snapshot(log, log.last_idx()), 6, 2 * entry_size + entry_size / 2);
+    BOOST_CHECK_EQUAL(log.in_memory_size(), 2);
+    BOOST_CHECK_EQUAL(log.memory_usage(), 2 * entry_size);
+    // An entry larger than the limit is not kept
+    add_entry(log, create_command(11));
+    log.apply_snapshot(log_snapshot(log, log.last_idx()), 6, entry_size - 1);
+    BOOST_CHECK(log.empty());
+    BOOST_CHECK_EQUAL(log.memory_usage(), 0);
+    // Entries after the snapshot index are kept regardless of the limit
+    add_entry(log, create_command(12));
+    add_entry(log, create_command(13));
+    log.apply_snapshot(log_snapshot(log, log.last_idx() - index_t{1}), 0, 0);
+    BOOST_CHECK_EQUAL(log.in_memory_size(), 1);
+    BOOST_CHECK_EQUAL(log.memory_usage(), entry_size);
+}
+
 void test_election_single_node_helper(raft::fsm_config fcfg) {
 
     server_id id1 = id();
@@ -1549,3 +1595,90 @@ BOOST_AUTO_TEST_CASE(test_reordered_reject) {
     raft::logger.trace("delivering second reject");
     deliver(routes, fsm2.id(), std::move(reject_2.messages));
 }
+
+// Elect id1 leader of a two node cluster and replicate everything.
+static void elect_and_replicate(raft::fsm& leader, raft::fsm& follower) {
+    election_timeout(leader);
+    communicate(leader, follower);
+    BOOST_REQUIRE(leader.is_leader());
+}
+
+static const raft::append_request* find_append_request(const raft::fsm_output& output, raft::server_id to) {
+    for (auto& m : output.messages) {
+        if (m.first == to) {
+            if (auto append = std::get_if<raft::append_request>(&m.second)) {
+                return append;
+            }
+        }
+    }
+    return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_persistence_sends_entries_before_stable) {
+    for (bool parallel : {false, true}) {
+        server_id id1 = id(), id2 = id();
+        raft::configuration cfg({{id1}, {id2}});
+        auto fcfg = fsm_cfg;
+        fcfg.enable_parallel_persistence = parallel;
+        raft::fsm leader(id1, term_t{}, server_id{}, raft::log(raft::snapshot{.config = cfg}), trivial_failure_detector, fcfg);
+        auto follower = create_follower(id2, raft::log(raft::snapshot{.config = cfg}));
+        elect_and_replicate(leader, follower);
+
+        leader.add_entry(create_command(1));
+        auto output = leader.get_output();
+        BOOST_REQUIRE_EQUAL(output.log_entries.size(), 1);
+        auto idx = output.log_entries.back()->idx;
+        BOOST_CHECK_EQUAL(output.parallel_persistence, parallel);
+        auto append = find_append_request(output, id2);
+        if (!parallel) {
+            // The entry is sent only once it is persisted, i.e. by the next output.
+            BOOST_CHECK(!append || append->entries.empty());
+            output = leader.get_output();
+            append = find_append_request(output, id2);
+        }
+        // With parallel persistence the entry goes out together with
+        // the request to persist it.
+        BOOST_REQUIRE(append);
+        BOOST_REQUIRE(!append->entries.empty());
+        BOOST_CHECK_EQUAL(append->entries.back()->idx, idx);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_persistence_commits_after_persisted) {
+    server_id id1 = id(), id2 = id();
+    raft::configuration cfg({{id1}, {id2}});
+    auto fcfg = fsm_cfg;
+    fcfg.enable_parallel_persistence = true;
+    raft::fsm leader(id1, term_t{}, server_id{}, raft::log(raft::snapshot{.config = cfg}), trivial_failure_detector, fcfg);
+    auto follower = create_follower(id2, raft::log(raft::snapshot{.config = cfg}));
+    raft_routing_map routes{{id1, &leader}, {id2, &follower}};
+    elect_and_replicate(leader, follower);
+
+    leader.add_entry(create_command(1));
+    auto output = leader.get_output();
+    BOOST_REQUIRE_EQUAL(output.log_entries.size(), 1);
+    auto idx = output.log_entries.back()->idx;
+    BOOST_CHECK(output.committed.empty());
+    auto append = find_append_request(output, id2);
+    BOOST_REQUIRE(append);
+    // The commit index sent does not cover the entry being persisted.
+    BOOST_CHECK(append->leader_commit_idx < idx);
+
+    // The follower accepts the entry while the leader is still persisting it.
+    deliver(routes, id1, std::move(output.messages));
+    auto follower_output = follower.get_output();
+    deliver(routes, id2, std::move(follower_output.messages));
+
+    // The entry is committed, and so applied, only by the output polled after
+    // the one which carried it was persisted.
+    output = leader.get_output();
+    BOOST_CHECK(output.log_entries.empty());
+    BOOST_REQUIRE_EQUAL(output.committed.size(), 1);
+    BOOST_CHECK_EQUAL(output.committed.back()->idx, idx);
+
+    // The follower learns about the commit from the following requests.
+    append = find_append_request(output, id2);
+    if (append) {
+        BOOST_CHECK_EQUAL(append->leader_commit_idx, idx);
+    }
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures the commit throughput and latency of a Raft group whose
+// servers talk over an in-memory network and persist to an in-memory
+// log with a configurable write latency.
+//
+// Each configuration is run twice: with the leader persisting its log
+// before replicating it, and in parallel with replication. Snapshot
+// thresholds can be lowered to measure the cost of log truncation.
+//
+//   replication_bench --nodes 3 --entries 100000 --concurrency 64 \
+//       --persistence-latency-us 200 --network-latency-us 50
+
+#include <algorithm>
+#include <boost/range/irange.hpp>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/timer.hh>
+#include "raft/server.hh"
+#include "serializer.hh"
+#include "serializer_impl.hh"
+
+using namespace std::chrono_literals;
+
+struct bench_config {
+    size_t nodes;
+    size_t entries;
+    size_t concurrency;
+    size_t entry_size;
+    std::chrono::microseconds persistence_latency;
+    std::chrono::microseconds network_latency;
+    size_t snapshot_threshold;
+    size_t snapshot_threshold_log_size;
+    bool parallel_persistence;
+};
+
+// Raft uses UUID 0 as special case.
+static raft::server_id to_raft_id(size_t local_id) {
+    return raft::server_id{utils::UUID(0, local_id + 1)};
+}
+
+// Delivers a message after the network latency, if the destination
+// still exists.
+template <typename Func>
+static void deliver(std::chrono::microseconds latency, Func&& func) {
+    if (latency.count() == 0) {
+        func();
+        return;
+    }
+    (void)seastar::sleep(latency).then(std::forward<Func>(func));
+}
+
+class bench_rpc : public raft::rpc {
+public:
+    // Shared with messages still being delivered, which may outlive the servers.
+    using network = lw_shared_ptr<std::unordered_map<raft::server_id, bench_rpc*>>;
+private:
+    network _net;
+    raft::server_id _id;
+    std::chrono::microseconds _latency;
+
+    template <typename Func>
+    void send(raft::server_id to, Func&& func) {
+        deliver(_latency, [net = _net, to, func = std::forward<Func>(func)] () mutable {
+            auto it = net->find(to);
+            if (it != net->end()) {
+                func(*it->second->_client);
+            }
+        });
+    }
+public:
+    bench_rpc(network net, raft::server_id id, std::chrono::microseconds latency)
+        : _net(std::move(net)), _id(id), _latency(latency) {
+        (*_net)[_id] = this;
+    }
+    ~bench_rpc() {
+        _net->erase(_id);
+    }
+    future<raft::snapshot_reply> send_snapshot(raft::server_id id, const raft::install_snapshot& snap, seastar::abort_source& as) override {
+        auto it = _net->find(id);
+        if (it == _net->end()) {
+            throw std::runtime_error("trying to send a snapshot to an unknown node");
+        }
+        return it->second->_client->apply_snapshot(_id, snap);
+    }
+    future<> send_append_entries(raft::server_id id, const raft::append_request& append_request) override {
+        send(id, [from = _id, req = append_request] (raft::rpc_server& s) mutable {
+            s.append_entries(from, std::move(req));
+        });
+        return make_ready_future<>();
+    }
+    void send_append_entries_reply(raft::server_id id, const raft::append_reply& reply) override {
+        send(id, [from = _id, reply] (raft::rpc_server& s) mutable {
+            s.append_entries_reply(from, std::move(reply));
+        });
+    }
+    void send_vote_request(raft::server_id id, const raft::vote_request& vote_request) override {
+        send(id, [from = _id, vote_request] (raft::rpc_server& s) mutable {
+            s.request_vote(from, std::move(vote_request));
+        });
+    }
+    void send_vote_reply(raft::server_id id, const raft::vote_reply& vote_reply) override {
+        send(id, [from = _id, vote_reply] (raft::rpc_server& s) mutable {
+            s.request_vote_reply(from, std::move(vote_reply));
+        });
+    }
+    void send_timeout_now(raft::server_id id, const raft::timeout_now& timeout_now) override {
+        send(id, [from = _id, timeout_now] (raft::rpc_server& s) mutable {
+            s.timeout_now_request(from, std::move(timeout_now));
+        });
+    }
+    void add_server(raft::server_id id, raft::server_info info) override {}
+    void remove_server(raft::server_id id) override {}
+    future<> abort() override { return make_ready_future<>(); }
+};
+
+class bench_persistence : public raft::persistence {
+    raft::snapshot _snapshot;
+    std::chrono::microseconds _latency;
+public:
+    bench_persistence(raft::snapshot snapshot, std::chrono::microseconds latency)
+        : _snapshot(std::move(snapshot)), _latency(latency) {}
+    future<> store_term_and_vote(raft::term_t term, raft::server_id vote) override {
+        return seastar::sleep(_latency);
+    }
+    future<std::pair<raft::term_t, raft::server_id>> load_term_and_vote() override {
+        return make_ready_future<std::pair<raft::term_t, raft::server_id>>(raft::term_t(1), raft::server_id{});
+    }
+    future<> store_snapshot(const raft::snapshot& snap, size_t preserve_log_entries) override {
+        return make_ready_future<>();
+    }
+    future<raft::snapshot> load_snapshot() override {
+        return make_ready_future<raft::snapshot>(_snapshot);
+    }
+    future<> store_log_entries(const std::vector<raft::log_entry_ptr>& entries) override {
+        return seastar::sleep(_latency);
+    }
+    future<raft::log_entries> load_log() override {
+        return make_ready_future<raft::log_entries>();
+    }
+    future<> truncate_log(raft::index_t idx) override {
+        return make_ready_future<>();
+    }
+    future<> abort() override { return make_ready_future<>(); }
+};
+
+// The state machine only counts applied commands, snapshots carry no state.
+class bench_state_machine : public raft::state_machine {
+public:
+    size_t applied = 0;
+
+    future<> apply(std::vector<raft::command_cref> commands) override {
+        applied += commands.size();
+        return make_ready_future<>();
+    }
+    future<raft::snapshot_id> take_snapshot() override {
+        return make_ready_future<raft::snapshot_id>(raft::snapshot_id::create_random_id());
+    }
+    void drop_snapshot(raft::snapshot_id id) override {}
+    future<> load_snapshot(raft::snapshot_id id) override { return make_ready_future<>(); }
+    future<> abort() override { return make_ready_future<>(); }
+};
+
+struct always_alive : public raft::failure_detector {
+    bool is_alive(raft::server_id server) override {
+        return true;
+    }
+};
+
+struct bench_result {
+    std::chrono::duration<double> elapsed;
+    std::vector<std::chrono::duration<double>> latencies;
+};
+
+static future<> add_entries(raft::server& leader, const bench_config& cfg, size_t& next, bench_result& result) {
+    while (next < cfg.entries) {
+        ++next;
+        raft::command cmd;
+        ser::serialize(cmd, bytes(bytes::initialized_later(), cfg.entry_size));
+        auto start = std::chrono::steady_clock::now();
+        co_await leader.add_entry(std::move(cmd), raft::wait_type::committed);
+        result.latencies.push_back(std::chrono::steady_clock::now() - start);
+    }
+}
+
+static future<bench_result> run(bench_config cfg) {
+    auto net = make_lw_shared<std::unordered_map<raft::server_id, bench_rpc*>>();
+    raft::configuration config;
+    for (size_t i = 0; i < cfg.nodes; ++i) {
+        config.current.emplace(raft::server_address{to_raft_id(i)});
+    }
+
+    auto fd = seastar::make_shared<always_alive>();
+    std::vector<std::unique_ptr<raft::server>> servers;
+    std::vector<timer<lowres_clock>> tickers(cfg.nodes);
+    for (size_t i = 0; i < cfg.nodes; ++i) {
+        auto id = to_raft_id(i);
+        auto server = raft::create_server(id,
+                std::make_unique<bench_rpc>(net, id, cfg.network_latency),
+                std::make_unique<bench_state_machine>(),
+                std::make_unique<bench_persistence>(raft::snapshot{.config = config}, cfg.persistence_latency),
+                fd, raft::server::configuration{
+                    .snapshot_threshold = cfg.snapshot_threshold,
+                    .snapshot_threshold_log_size = cfg.snapshot_threshold_log_size,
+                    .enable_parallel_persistence = cfg.parallel_persistence,
+                });
+        co_await server->start();
+        servers.push_back(std::move(server));
+    }
+
+    // Elect the first server before the others start ticking,
+    // so that there is no competition.
+    auto& leader = *servers[0];
+    do {
+        leader.wait_until_candidate();
+        co_await leader.wait_election_done();
+    } while (!leader.is_leader());
+    for (size_t i = 0; i < cfg.nodes; ++i) {
+        tickers[i].set_callback([s = servers[i].get()] { s->tick(); });
+        tickers[i].arm_periodic(1ms);
+    }
+
+    bench_result result;
+    result.latencies.reserve(cfg.entries);
+    size_t next = 0;
+    auto start = std::chrono::steady_clock::now();
+    co_await parallel_for_each(boost::irange<size_t>(0, cfg.concurrency), [&] (size_t) {
+        return add_entries(leader, cfg, next, result);
+    });
+    result.elapsed = std::chrono::steady_clock::now() - start;
+
+    for (auto& t : tickers) {
+        t.cancel();
+    }
+    for (auto& s : servers) {
+        co_await s->abort();
+    }
+    co_return result;
+}
+
+static void report(const bench_config& cfg, bench_result& result) {
+    auto& l = result.latencies;
+    std::sort(l.begin(), l.end());
+    auto percentile = [&] (double p) {
+        return l.empty() ? 0.0 : std::chrono::duration<double, std::micro>(l[std::min(l.size() - 1, size_t(p * l.size()))]).count();
+    };
+    fmt::print("{:>21}: {:10.0f} commits/s, latency [us] p50 {:8.0f} p90 {:8.0f} p99 {:8.0f} max {:8.0f}\n",
+            cfg.parallel_persistence ? "parallel persistence" : "persist then send",
+            l.size() / result.elapsed.count(),
+            percentile(0.5), percentile(0.9), percentile(0.99), percentile(1));
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("nodes", bpo::value<size_t>()->default_value(3), "number of servers in the group")
+        ("entries", bpo::value<size_t>()->default_value(100000), "number of entries to commit")
+        ("concurrency", bpo::value<size_t>()->default_value(64), "number of entries being committed at a time")
+        ("entry-size", bpo::value<size_t>()->default_value(128), "size of an entry in bytes")
+        ("persistence-latency-us", bpo::value<unsigned>()->default_value(200), "time it takes to persist a batch of log entries")
+        ("network-latency-us", bpo::value<unsigned>()->default_value(50), "time it takes to deliver a message")
+        ("snapshot-threshold", bpo::value<size_t>()->default_value(1024), "number of applied entries after which a snapshot is taken")
+        ("snapshot-threshold-log-size", bpo::value<size_t>()->default_value(2 * 1024 * 1024), "size in bytes of applied entries after which a snapshot is taken")
+        ;
+
+    return app.run(argc, argv, [&app] () -> future<> {
+        auto& opts = app.configuration();
+        bench_config cfg{
+            .nodes = opts["nodes"].as<size_t>(),
+            .entries = opts["entries"].as<size_t>(),
+            .concurrency = opts["concurrency"].as<size_t>(),
+            .entry_size = opts["entry-size"].as<size_t>(),
+            .persistence_latency = std::chrono::microseconds(opts["persistence-latency-us"].as<unsigned>()),
+            .network_latency = std::chrono::microseconds(opts["network-latency-us"].as<unsigned>()),
+            .snapshot_threshold = opts["snapshot-threshold"].as<size_t>(),
+            .snapshot_threshold_log_size = opts["snapshot-threshold-log-size"].as<size_t>(),
+        };
+        fmt::print("nodes {}, entries {} of {} bytes, concurrency {}, persistence latency {}us, network latency {}us, "
+                "snapshot every {} entries or {} bytes\n",
+                cfg.nodes, cfg.entries, cfg.entry_size, cfg.concurrency,
+                cfg.persistence_latency.count(), cfg.network_latency.count(),
+                cfg.snapshot_threshold, cfg.snapshot_threshold_log_size);
+        for (bool parallel : {false, true}) {
+            cfg.parallel_persistence = parallel;
+            auto result = co_await run(cfg);
+            report(cfg, result);
+        }
+    });
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <snappy.h>
+#include <snappy-sinksource.h>
+
+#include <seastar/core/print.hh>
+
+#include "transport/frame_compression.hh"
+#include "utils/fragment_range.hh"
+
+namespace cql_transport {
+
+namespace snappy_fragmented {
+
+namespace {
+
+// Feeds a fragmented buffer to snappy without linearizing it.
+template<FragmentRange Range>
+class fragment_source final : public snappy::Source {
+    using iterator = decltype(std::declval<const Range&>().begin());
+    iterator _it;
+    iterator _end;
+    bytes_view _current;
+    size_t _available;
+public:
+    explicit fragment_source(const Range& range)
+        : _it(range.begin())
+        , _end(range.end())
+        , _available(range.size_bytes()) {
+        next_fragment();
+    }
+    virtual size_t Available() const override {
+        return _available;
+    }
+    virtual const char* Peek(size_t* len) override {
+        *len = _current.size();
+        return reinterpret_cast<const char*>(_current.data());
+    }
+    virtual void Skip(size_t n) override {
+        _available -= n;
+        while (n) {
+            auto this_size = std::min(n, _current.size());
+            _current.remove_prefix(this_size);
+            n -= this_size;
+            next_fragment();
+        }
+    }
+private:
+    void next_fragment() {
+        while (_current.empty() && _it != _end) {
+            _current = *_it++;
+        }
+    }
+};
+
+// Collects snappy output into a fragmented_temporary_buffer.
+//
+// Outputs which fit in a single fragment are decompressed directly into it.
+// Larger ones are left to snappy's scattered writer, which produces 64kB
+// blocks that we adopt as fragments, so no large contiguous allocation is
+// ever made regardless of the frame size.
+class fragmented_temporary_buffer_sink final : public snappy::Sink {
+    std::vector<temporary_buffer<char>> _fragments;
+    temporary_buffer<char> _flat;
+    size_t _size = 0;
+public:
+    virtual void Append(const char* bytes, size_t n) override {
+        if (_flat && bytes == _flat.get()) {
+            _flat.trim(n);
+            _fragments.emplace_back(std::move(_flat));
+        } else if (n) {
+            _fragments.emplace_back(bytes, n);
+        }
+        _size += n;
+    }
+    virtual char* GetAppendBuffer(size_t length, char* scratch) override {
+        return scratch;
+    }
+    virtual char* GetAppendBufferVariable(size_t min_size, size_t desired_size_hint, char* scratch,
+            size_t scratch_size, size_t* allocated_size) override {
+        if (desired_size_hint && desired_size_hint <= fragmented_temporary_buffer::default_fragment_size) {
+            _flat = temporary_buffer<char>(desired_size_hint);
+            *allocated_size = desired_size_hint;
+            return _flat.get_write();
+        }
+        *allocated_size = scratch_size;
+        return scratch;
+    }
+    virtual void AppendAndTakeOwnership(char* bytes, size_t n, void (*deleter)(void*, const char*, size_t),
+            void* deleter_arg) override {
+        _fragments.emplace_back(bytes, n, make_deleter([bytes, n, deleter, deleter_arg] {
+            deleter(deleter_arg, bytes, n);
+        }));
+        _size += n;
+    }
+
+    fragmented_temporary_buffer release() && {
+        return fragmented_temporary_buffer(std::move(_fragments), _size);
+    }
+};
+
+// Appends snappy output to a bytes_ostream, which is fragmented by design.
+class bytes_ostream_sink final : public snappy::Sink {
+    bytes_ostream& _out;
+public:
+    explicit bytes_ostream_sink(bytes_ostream& out) : _out(out) { }
+    virtual void Append(const char* bytes, size_t n) override {
+        _out.write(bytes_view(reinterpret_cast<const int8_t*>(bytes), n));
+    }
+};
+
+}
+
+using fragmented_view = fragmented_temporary_buffer::view;
+
+uint32_t uncompressed_length(const fragmented_temporary_buffer& in) {
+    uint32_t uncomp_len;
+    auto source = fragment_source<fragmented_view>(fragmented_view(in));
+    if (!snappy::GetUncompressedLength(&source, &uncomp_len)) {
+        throw std::runtime_error("CQL frame Snappy uncompressed size is unknown");
+    }
+    return uncomp_len;
+}
+
+fragmented_temporary_buffer uncompress(const fragmented_temporary_buffer& in) {
+    auto source = fragment_source<fragmented_view>(fragmented_view(in));
+    auto sink = fragmented_temporary_buffer_sink();
+    if (!snappy::Uncompress(&source, &sink)) {
+        throw std::runtime_error("CQL frame Snappy uncompression failure");
+    }
+    return std::move(sink).release();
+}
+
+bytes_ostream compress(const bytes_ostream& in) {
+    // Snappy compresses its input in independent 64kB blocks, so the body
+    // can be streamed through it fragment by fragment.
+    auto source = fragment_source<bytes_ostream>(in);
+    bytes_ostream output;
+    auto sink = bytes_ostream_sink(output);
+    snappy::Compress(&source, &sink);
+    return output;
+}
+
+}
+
+future<> reserve_decompression_memory(semaphore& memory_available, semaphore_units<>& mem_permit,
+        size_t length, size_t uncomp_len, size_t max_request_size, bool allow_shedding, uint64_t& requests_blocked_memory) {
+    // The permit taken before reading the frame is based on its compressed
+    // length only. Replace it with one covering the decompressed body too,
+    // before it is allocated.
+    auto mem_estimate = length + uncomp_len + 8000;
+    if (mem_estimate > max_request_size) {
+        return make_exception_future<>(decompressed_frame_too_large(format("request uncompressed size too large (frame size {:d}; uncompressed size {:d}; allowed {:d})",
+                length, uncomp_len, max_request_size)));
+    }
+    if (mem_estimate <= mem_permit.count()) {
+        return make_ready_future<>();
+    }
+    // Waiting for more memory while holding the permit could deadlock with
+    // other connections doing the same, so give it back and wait for the
+    // whole estimate at once.
+    mem_permit.return_all();
+    if (memory_available.current() < mem_estimate) {
+        ++requests_blocked_memory;
+    }
+    const auto shedding_timeout = std::chrono::milliseconds(50);
+    auto fut = allow_shedding
+            ? get_units(memory_available, mem_estimate, shedding_timeout)
+            : get_units(memory_available, mem_estimate);
+    return fut.then([&mem_permit] (semaphore_units<> units) {
+        mem_permit = std::move(units);
+    });
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdexcept>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/semaphore.hh>
+
+#include "bytes_ostream.hh"
+#include "utils/fragmented_temporary_buffer.hh"
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+// Thrown when a compressed frame would decompress to more than the request
+// size limit. The frame has been consumed already, so the connection can go
+// on after the request is answered with an error.
+class decompressed_frame_too_large : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Snappy (de)compression of fragmented buffers, which never linearizes its
+// input nor allocates its output contiguously.
+namespace snappy_fragmented {
+
+// Reads the decompressed size of a snappy compressed buffer from its header.
+// Throws if the header is malformed.
+uint32_t uncompressed_length(const fragmented_temporary_buffer& in);
+
+// Throws if the input is not valid snappy compressed data.
+fragmented_temporary_buffer uncompress(const fragmented_temporary_buffer& in);
+
+bytes_ostream compress(const bytes_ostream& in);
+
+}
+
+// Makes mem_permit cover the decompression of a frame of the given compressed
+// and decompressed lengths, waiting for memory if needed.
+//
+// The permit is given back before waiting for the larger one: waiting while
+// holding it could deadlock with other connections doing the same.
+//
+// Fails with decompressed_frame_too_large if the frame is larger than
+// max_request_size, and with semaphore_timed_out if allow_shedding is set and
+// the memory is not available soon enough.
+future<> reserve_decompression_memory(semaphore& memory_available, semaphore_units<>& mem_permit,
+        size_t length, size_t uncomp_len, size_t max_request_size, bool allow_shedding, uint64_t& requests_blocked_memory);
+
+}
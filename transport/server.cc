@@ -59,7 +59,6 @@
 #include <cassert>
 #include <string>
 
-#include <snappy-c.h>
 #include <lz4.h>
 
 #include "response.hh"
@@ -68,6 +67,7 @@
 #include "types/user.hh"
 
 #include "transport/cql_protocol_extension.hh"
+#include "transport/frame_compression.hh"
 #include "utils/bit_cast.hh"
 #include "db/config.hh"
 
@@ -642,14 +642,27 @@ future<> cql_server::connection::process_request() {
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (auto mem_permit_fut) {
+        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested, allow_shedding] (auto mem_permit_fut) {
           if (mem_permit_fut.failed()) {
               // Ignore semaphore errors - they are expected if load shedding took place
               mem_permit_fut.ignore_ready_future();
               return make_ready_future<>();
           }
-          semaphore_units<> mem_permit = mem_permit_fut.get0();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          return do_with(mem_permit_fut.get0(), [this, length, flags, op, stream, tracing_requested, allow_shedding] (semaphore_units<>& mem_permit) {
+          return this->read_and_decompress_frame(length, flags, mem_permit, allow_shedding).then_wrapped([this, op, stream, tracing_requested, &mem_permit] (future<fragmented_temporary_buffer> buf_fut) mutable {
+            fragmented_temporary_buffer buf;
+            try {
+                buf = buf_fut.get0();
+            } catch (const decompressed_frame_too_large& e) {
+                write_response(make_error(stream, exceptions::exception_code::INVALID, e.what(), tracing::trace_state_ptr()));
+                return make_ready_future<>();
+            } catch (const semaphore_timed_out&) {
+                ++_server._stats.requests_shed;
+                write_response(make_error(stream, exceptions::exception_code::OVERLOADED,
+                        "not enough memory to decompress the request", tracing::trace_state_ptr()));
+                return make_ready_future<>();
+            }
+            auto permit = make_service_permit(std::move(mem_permit));
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
@@ -661,10 +674,10 @@ future<> cql_server::connection::process_request() {
                 _pending_requests_gate.leave();
             });
             auto istream = buf.get_istream();
-            (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
-                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, permit)
+                    .then_wrapped([this, buf = std::move(buf), permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                 try {
-                    write_response(std::move(response_f.get0()), std::move(mem_permit), _compression);
+                    write_response(std::move(response_f.get0()), std::move(permit), _compression);
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
                 } catch (...) {
                     clogger.error("request processing failed: {}", std::current_exception());
@@ -673,6 +686,7 @@ future<> cql_server::connection::process_request() {
 
             return make_ready_future<>();
           });
+          });
         });
     });
 }
@@ -696,7 +710,13 @@ void on_compression_buffer_use() {
 
 }
 
-future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags)
+future<> cql_server::connection::reserve_decompression_memory(semaphore_units<>& mem_permit, size_t length, size_t uncomp_len, bool allow_shedding)
+{
+    return cql_transport::reserve_decompression_memory(_server._memory_available, mem_permit, length, uncomp_len,
+            _server._max_request_size, allow_shedding, _server._stats.requests_blocked_memory);
+}
+
+future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags, semaphore_units<>& mem_permit, bool allow_shedding)
 {
     using namespace compression_buffers;
     if (flags & cql_frame_flags::compression) {
@@ -704,41 +724,35 @@ future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_
             if (length < 4) {
                 throw std::runtime_error("Truncated frame");
             }
-            return _buffer_reader.read_exactly(_read_buf, length).then([this] (fragmented_temporary_buffer buf) {
+            return _buffer_reader.read_exactly(_read_buf, length).then([this, length, &mem_permit, allow_shedding] (fragmented_temporary_buffer buf) {
                 auto linearization_buffer = bytes_ostream();
                 int32_t uncomp_len = request_reader(buf.get_istream(), linearization_buffer).read_int();
                 if (uncomp_len < 0) {
                     throw std::runtime_error("CQL frame uncompressed length is negative: " + std::to_string(uncomp_len));
                 }
-                buf.remove_prefix(4);
-                auto in = input_buffer.get_linearized_view(fragmented_temporary_buffer::view(buf));
-                auto uncomp = output_buffer.make_fragmented_temporary_buffer(uncomp_len, fragmented_temporary_buffer::default_fragment_size, [&] (bytes_mutable_view out) {
-                    auto ret = LZ4_decompress_safe(reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()),
-                                                   in.size(), out.size());
-                    if (ret < 0) {
-                        throw std::runtime_error("CQL frame LZ4 uncompression failure");
-                    }
-                    return out.size();
+                return reserve_decompression_memory(mem_permit, length, uncomp_len, allow_shedding).then([buf = std::move(buf), uncomp_len] () mutable {
+                    // LZ4 frames are a single block, which can only be
+                    // decompressed from and into contiguous memory.
+                    buf.remove_prefix(4);
+                    auto in = input_buffer.get_linearized_view(fragmented_temporary_buffer::view(buf));
+                    auto uncomp = output_buffer.make_fragmented_temporary_buffer(uncomp_len, fragmented_temporary_buffer::default_fragment_size, [&] (bytes_mutable_view out) {
+                        auto ret = LZ4_decompress_safe(reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()),
+                                                       in.size(), out.size());
+                        if (ret < 0) {
+                            throw std::runtime_error("CQL frame LZ4 uncompression failure");
+                        }
+                        return out.size();
+                    });
+                    on_compression_buffer_use();
+                    return uncomp;
                 });
-                on_compression_buffer_use();
-                return uncomp;
             });
         } else if (_compression == cql_compression::snappy) {
-            return _buffer_reader.read_exactly(_read_buf, length).then([this] (fragmented_temporary_buffer buf) {
-                auto in = input_buffer.get_linearized_view(fragmented_temporary_buffer::view(buf));
-                size_t uncomp_len;
-                if (snappy_uncompressed_length(reinterpret_cast<const char*>(in.data()), in.size(), &uncomp_len) != SNAPPY_OK) {
-                    throw std::runtime_error("CQL frame Snappy uncompressed size is unknown");
-                }
-                auto uncomp = output_buffer.make_fragmented_temporary_buffer(uncomp_len, fragmented_temporary_buffer::default_fragment_size, [&] (bytes_mutable_view out) {
-                    size_t output_len = out.size();
-                    if (snappy_uncompress(reinterpret_cast<const char*>(in.data()), in.size(), reinterpret_cast<char*>(out.data()), &output_len) != SNAPPY_OK) {
-                        throw std::runtime_error("CQL frame Snappy uncompression failure");
-                    }
-                    return output_len;
+            return _buffer_reader.read_exactly(_read_buf, length).then([this, length, &mem_permit, allow_shedding] (fragmented_temporary_buffer buf) {
+                auto uncomp_len = snappy_fragmented::uncompressed_length(buf);
+                return reserve_decompression_memory(mem_permit, length, uncomp_len, allow_shedding).then([buf = std::move(buf)] {
+                    return snappy_fragmented::uncompress(buf);
                 });
-                on_compression_buffer_use();
-                return uncomp;
             });
         } else {
             throw exceptions::protocol_exception(format("Unknown compression algorithm"));
@@ -1527,20 +1541,7 @@ void cql_server::response::compress_lz4()
 
 void cql_server::response::compress_snappy()
 {
-    using namespace compression_buffers;
-    auto view = input_buffer.get_linearized_view(_body);
-    const char* input = reinterpret_cast<const char*>(view.data());
-    size_t input_len = view.size();
-
-    size_t output_len = snappy_max_compressed_length(input_len);
-    _body = output_buffer.make_buffer(output_len, [&] (bytes_mutable_view output_view) {
-        char* output = reinterpret_cast<char*>(output_view.data());
-        if (snappy_compress(input, input_len, output, &output_len) != SNAPPY_OK) {
-            throw std::runtime_error("CQL frame Snappy compression failure");
-        }
-        return output_len;
-    });
-    on_compression_buffer_use();
+    _body = snappy_fragmented::compress(_body);
 }
 
 void cql_server::response::serialize(const event::schema_change& event, uint8_t version)
@@ -222,7 +222,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         unsigned frame_size() const;
         unsigned pick_request_cpu();
         cql_binary_frame_v3 parse_frame(temporary_buffer<char> buf) const;
-        future<fragmented_temporary_buffer> read_and_decompress_frame(size_t length, uint8_t flags);
+        future<> reserve_decompression_memory(semaphore_units<>& mem_permit, size_t length, size_t uncomp_len, bool allow_shedding);
+        future<fragmented_temporary_buffer> read_and_decompress_frame(size_t length, uint8_t flags, semaphore_units<>& mem_permit, bool allow_shedding);
         future<std::optional<cql_binary_frame_v3>> read_frame();
         future<std::unique_ptr<cql_server::response>> process_startup(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
         future<std::unique_ptr<cql_server::response>> process_auth_response(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
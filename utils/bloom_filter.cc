@@ -92,13 +92,17 @@ bool bloom_filter::is_present(hashed_key key) {
     return result;
 }
 
-void bloom_filter::add(const bytes_view& key) {
-    for_each_index(make_hashed_key(key), _hash_count, _bitset.size(), _format, [this] (auto i) {
+void bloom_filter::add(hashed_key key) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [this] (auto i) {
         _bitset.set(i);
         return stop_iteration::no;
     });
 }
 
+void bloom_filter::add(const bytes_view& key) {
+    add(make_hashed_key(key));
+}
+
 bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
@@ -74,6 +74,8 @@ class bloom_filter: public i_filter {
 
     virtual void add(const bytes_view& key) override;
 
+    virtual void add(hashed_key key) override;
+
     virtual bool is_present(const bytes_view& key) override;
 
     virtual bool is_present(hashed_key key) override;
@@ -112,6 +114,8 @@ struct always_present_filter: public i_filter {
 
     virtual void add(const bytes_view& key) override { }
 
+    virtual void add(hashed_key key) override { }
+
     virtual void clear() override { }
 
     virtual void close() override { }
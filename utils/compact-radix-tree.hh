@@ -24,6 +24,8 @@
 #include <cassert>
 #include <algorithm>
 #include <bitset>
+#include <limits>
+#include <bit>
 #include <fmt/core.h>
 #include "utils/allocation_strategy.hh"
 #include "utils/array-search.hh"
@@ -204,7 +206,7 @@ class tree {
          * This won't work if k1 == k2 (clz is undefined for full
          * zeroes value), but we don't get here in this case
          */
-        return (__builtin_clz(k1 ^ k2) + round_up_delta) / radix_bits;
+        return (std::countl_zero(k1 ^ k2) + round_up_delta) / radix_bits;
     }
 
     /*
@@ -1945,7 +1947,13 @@ class tree {
         key_t key() const noexcept { return _key; }
 
         iterator_base() noexcept = default;
-        iterator_base(const tree* t) noexcept : _tree(t) {
+        iterator_base(const tree* t) noexcept : iterator_base(t, 0) {}
+
+        /*
+         * Points to the element with the smallest key not less
+         * than the given one
+         */
+        iterator_base(const tree* t, key_t key) noexcept : _key(key), _tree(t) {
             lower_bound_res res = _tree->_root->lower_bound(_key, 0);
             _leaf = res.leaf;
             _value = const_cast<pointer>(res.elem);
@@ -1958,6 +1966,12 @@ class tree {
                 return *this;
             }
 
+            if (_key == std::numeric_limits<key_t>::max()) {
+                // The last possible key, don't wrap around
+                _value = nullptr;
+                return *this;
+            }
+
             _key++;
             if (node_index(_key, leaf_depth) != 0) {
                 /*
@@ -1980,6 +1994,11 @@ class tree {
                  * current leaf and keep the leaf's part zero.
                  */
 
+                 if ((_key | radix_mask) == std::numeric_limits<key_t>::max()) {
+                     // This was the last possible leaf
+                     _value = nullptr;
+                     return *this;
+                 }
                  _key += node_index_limit;
                  _key &= ~radix_mask;
             }
@@ -2015,6 +2034,13 @@ class tree {
     const_iterator begin() const noexcept { return cbegin(); }
     const_iterator end() const noexcept { return cend(); }
 
+    /*
+     * Like lower_bound(), but returns the iterator that can
+     * continue the walk from the found element
+     */
+    iterator lower_bound_iterator(key_t key) noexcept { return iterator(this, key); }
+    const_iterator lower_bound_iterator(key_t key) const noexcept { return const_iterator(this, key); }
+
     bool empty() const noexcept { return _root.is(nil_root); }
 
     template <typename Fn>
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+/// Approximate access frequency counter (a count-min sketch).
+///
+/// Keeps `depth` rows of small saturating counters. Each key maps to one
+/// counter per row and its frequency is estimated as the minimum of those
+/// counters, which may overestimate but never underestimates the true count.
+///
+/// To let the sketch follow changes in the workload, all counters are halved
+/// every `sample_size` recorded accesses ("aging"), so old popularity decays.
+/// This is the frequency estimator of the TinyLFU admission policy.
+class frequency_sketch {
+public:
+    static constexpr unsigned depth = 4;
+    static constexpr uint8_t max_count = 15;
+private:
+    static constexpr std::array<uint64_t, depth> seeds = {
+        0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull,
+    };
+    size_t _width;
+    size_t _sample_size;
+    std::unique_ptr<uint8_t[]> _counters;
+    size_t _additions = 0;
+private:
+    size_t index_of(unsigned row, uint64_t hash) const noexcept {
+        uint64_t h = (hash + seeds[row]) * seeds[row];
+        h += h >> 32;
+        return row * _width + (h & (_width - 1));
+    }
+public:
+    /// \param width number of counters in each row, rounded up to a power of two.
+    /// \param sample_size number of recorded accesses after which counters are halved.
+    explicit frequency_sketch(size_t width, size_t sample_size)
+        : _width(std::bit_ceil(std::max<size_t>(width, 1)))
+        , _sample_size(sample_size)
+        , _counters(std::make_unique<uint8_t[]>(depth * _width))
+    { }
+
+    explicit frequency_sketch(size_t width)
+        : frequency_sketch(width, width * 10)
+    { }
+
+    /// Returns the estimated number of recorded accesses of the given key,
+    /// saturated at max_count.
+    unsigned estimate(uint64_t hash) const noexcept {
+        unsigned ret = max_count;
+        for (unsigned row = 0; row < depth; ++row) {
+            ret = std::min<unsigned>(ret, _counters[index_of(row, hash)]);
+        }
+        return ret;
+    }
+
+    /// Records an access of the given key.
+    ///
+    /// Only the counters holding the current minimum are incremented
+    /// ("conservative update"), which reduces overestimation.
+    ///
+    /// Returns true iff the sketch was aged as a result of this call.
+    bool record(uint64_t hash) noexcept {
+        auto current = estimate(hash);
+        if (current < max_count) {
+            for (unsigned row = 0; row < depth; ++row) {
+                auto& c = _counters[index_of(row, hash)];
+                if (c == current) {
+                    ++c;
+                }
+            }
+        }
+        if (++_additions >= _sample_size) {
+            age();
+            return true;
+        }
+        return false;
+    }
+
+    /// Halves all counters.
+    void age() noexcept {
+        for (size_t i = 0; i < depth * _width; ++i) {
+            _counters[i] >>= 1;
+        }
+        _additions = 0;
+    }
+
+    void clear() noexcept {
+        std::fill_n(_counters.get(), depth * _width, 0);
+        _additions = 0;
+    }
+
+    size_t width() const noexcept { return _width; }
+    size_t sample_size() const noexcept { return _sample_size; }
+};
+
+}
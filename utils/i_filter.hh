@@ -69,6 +69,7 @@ struct i_filter {
     virtual ~i_filter() {}
 
     virtual void add(const bytes_view& key) = 0;
+    virtual void add(hashed_key key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
     virtual void clear() = 0;
@@ -0,0 +1,441 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <limits>
+#include <seastar/util/concepts.hh>
+#include "utils/compact-radix-tree.hh"
+#include "utils/intrusive-array.hh"
+#include "utils/collection-concepts.hh"
+#include "utils/allocation_strategy.hh"
+#include "utils/bptree.hh"
+
+/*
+ * The radix-decker is the sibling of the double-decker for the case
+ * when the outer key is the raw 64-bit token. The outer level is the
+ * compact radix tree indexed by the token bits, so the lookup costs a
+ * handful of node hops regardless of the number of elements and does
+ * no key comparisons at all. Elements with colliding tokens are kept
+ * in the sorted intrusive array, just like the double-decker does.
+ *
+ * The API mimics the double-decker one, but the iterators are forward
+ * only and any emplace or erase invalidates all of them except the one
+ * returned, as radix nodes grow and shrink by moving their slots to a
+ * new node and erasing from a bucket shifts the elements after it.
+ */
+
+template <typename T, typename Less, typename Compare>
+requires Comparable<T, T, Compare> && std::is_nothrow_move_constructible_v<T>
+class radix_decker {
+public:
+    using key_type = int64_t;
+    using inner_array = intrusive_array<T>;
+
+private:
+    class bucket;
+
+    /*
+     * The radix tree slot. It owns the bucket and the bucket points
+     * back to it, so that both can be independently moved around by
+     * the tree itself or by the LSA compaction.
+     */
+    class bucket_ptr {
+        friend class bucket;
+        bucket* _b;
+
+    public:
+        explicit bucket_ptr(bucket* b) noexcept : _b(b) {
+            _b->_backref = this;
+        }
+
+        bucket_ptr(const bucket_ptr&) = delete;
+        bucket_ptr(bucket_ptr&& o) noexcept : _b(std::exchange(o._b, nullptr)) {
+            if (_b != nullptr) {
+                _b->_backref = this;
+            }
+        }
+
+        ~bucket_ptr() {
+            if (_b != nullptr) {
+                bucket::destroy(_b);
+            }
+        }
+
+        inner_array& operator*() const noexcept { return _b->array; }
+        inner_array* operator->() const noexcept { return &_b->array; }
+
+        void reset(bucket* b) noexcept {
+            bucket* old = std::exchange(_b, b);
+            _b->_backref = this;
+            bucket::destroy(old);
+        }
+    };
+
+    class bucket {
+        friend class bucket_ptr;
+        bucket_ptr* _backref = nullptr;
+
+    public:
+        // Must be the last member, the array grows beyond the object
+        inner_array array;
+
+        static size_t storage_size_for(size_t nr_elements) noexcept {
+            return sizeof(bucket) - sizeof(inner_array) + nr_elements * sizeof(T);
+        }
+
+        template <typename... Args>
+        static bucket* create(size_t nr_elements, Args&&... args) {
+            size_t size = storage_size_for(nr_elements);
+            void* ptr = current_allocator().alloc<bucket>(size);
+            try {
+                return new (ptr) bucket(std::forward<Args>(args)...);
+            } catch (...) {
+                current_allocator().free(ptr, size);
+                throw;
+            }
+        }
+
+        static void destroy(bucket* b) noexcept {
+            current_allocator().destroy(b);
+        }
+
+        template <typename... Args>
+        bucket(Args&&... args) : array(std::forward<Args>(args)...) {}
+
+        bucket(const bucket&) = delete;
+        bucket(bucket&& o) noexcept : _backref(std::exchange(o._backref, nullptr)), array(std::move(o.array)) {
+            if (_backref != nullptr) {
+                _backref->_b = this;
+            }
+        }
+
+        size_t storage_size() const noexcept {
+            return sizeof(bucket) - sizeof(inner_array) + array.storage_size();
+        }
+    };
+
+    using outer_tree = compact_radix_tree::tree<bucket_ptr, uint64_t>;
+    using outer_iterator = typename outer_tree::iterator;
+    using outer_const_iterator = typename outer_tree::const_iterator;
+
+    /*
+     * Tokens are signed, the radix tree keys are not. Flipping the
+     * sign bit keeps the ordering.
+     */
+    static uint64_t radix_key(key_type k) noexcept {
+        return uint64_t(k) ^ (uint64_t(1) << 63);
+    }
+
+    outer_tree _tree;
+    [[no_unique_address]] Less _less;
+
+public:
+    template <bool Const>
+    class iterator_base {
+        friend class radix_decker;
+        using outer_iterator = std::conditional_t<Const, typename radix_decker::outer_const_iterator, typename radix_decker::outer_iterator>;
+
+    protected:
+        outer_iterator _bucket;
+        int _idx = 0;
+
+    public:
+        iterator_base() = default;
+        iterator_base(outer_iterator bkt, int idx) noexcept : _bucket(bkt), _idx(idx) {}
+
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = ssize_t;
+        using value_type = std::conditional_t<Const, const T, T>;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        reference operator*() const noexcept { return (**_bucket)[_idx]; }
+        pointer operator->() const noexcept { return &((**_bucket)[_idx]); }
+
+        iterator_base& operator++() noexcept {
+            if ((**_bucket)[_idx++].is_tail()) {
+                _bucket++;
+                _idx = 0;
+            }
+
+            return *this;
+        }
+
+        iterator_base operator++(int) noexcept {
+            iterator_base cur = *this;
+            operator++();
+            return cur;
+        }
+
+        bool operator==(const iterator_base& o) const noexcept { return _bucket == o._bucket && _idx == o._idx; }
+        bool operator!=(const iterator_base& o) const noexcept { return !(*this == o); }
+    };
+
+    using const_iterator = iterator_base<true>;
+
+    class iterator final : public iterator_base<false> {
+        friend class radix_decker;
+        using super = iterator_base<false>;
+
+        outer_tree* _tree = nullptr;
+
+    public:
+        iterator() noexcept : super() {}
+        iterator(outer_tree* t, outer_iterator bkt, int idx) noexcept : super(bkt, idx), _tree(t) {}
+
+        template <typename Func>
+        requires Disposer<Func, T>
+        iterator erase_and_dispose(Less, Func&& disp) noexcept {
+            disp(&**this); // * to deref this, * to call operator*, & to get addr from ref
+
+            if ((*super::_bucket)->is_single_element()) {
+                uint64_t key = super::_bucket.key();
+                _tree->erase(key);
+                if (key == std::numeric_limits<uint64_t>::max()) {
+                    return iterator(_tree, _tree->end(), 0);
+                }
+                return iterator(_tree, _tree->lower_bound_iterator(key + 1), 0);
+            }
+
+            bool tail = (**super::_bucket)[super::_idx].is_tail();
+            (*super::_bucket)->erase(super::_idx);
+            if (tail) {
+                super::_bucket++;
+                super::_idx = 0;
+            }
+
+            return *this;
+        }
+
+        iterator erase(Less less) noexcept { return erase_and_dispose(less, bplus::default_dispose<T>); }
+    };
+
+    /*
+     * Same as double_decker::bound_hint
+     */
+    struct bound_hint {
+        bool match;
+        bool key_match;
+        bool key_tail;
+
+        /*
+         * Emplacing a new key may grow a radix node and a colliding
+         * key reconstructs the bucket, either way iterators become
+         * invalid.
+         */
+        bool emplace_keeps_iterators() const noexcept { return false; }
+    };
+
+    iterator begin() noexcept { return iterator(&_tree, _tree.begin(), 0); }
+    const_iterator begin() const noexcept { return const_iterator(_tree.begin(), 0); }
+    const_iterator cbegin() const noexcept { return const_iterator(_tree.cbegin(), 0); }
+
+    iterator end() noexcept { return iterator(&_tree, _tree.end(), 0); }
+    const_iterator end() const noexcept { return const_iterator(_tree.end(), 0); }
+    const_iterator cend() const noexcept { return const_iterator(_tree.cend(), 0); }
+
+    explicit radix_decker(Less less = Less{}) noexcept : _less(less) { }
+
+    radix_decker(const radix_decker& other) = delete;
+    radix_decker(radix_decker&& other) noexcept : _tree(std::move(other._tree)), _less(other._less) {}
+
+    template <typename... Args>
+    iterator emplace_before(iterator i, key_type k, const bound_hint& hint, Args&&... args) {
+        assert(!hint.match);
+        uint64_t rk = radix_key(k);
+
+        if (!hint.key_match) {
+            /*
+             * No key conflict -- just put a new single-element
+             * bucket into the tree.
+             */
+            bucket* b = bucket::create(1, std::forward<Args>(args)...);
+            try {
+                _tree.emplace(rk, b);
+            } catch (...) {
+                bucket::destroy(b);
+                throw;
+            }
+            return iterator(&_tree, _tree.lower_bound_iterator(rk), 0);
+        }
+
+        /*
+         * Key conflict, need to grow the bucket. If the lower bound
+         * overflew into the next bucket the new element is appended
+         * to the tail of k's one.
+         */
+        bucket_ptr& bp = *_tree.get(rk);
+        int idx = hint.key_tail ? bp->size() : i._idx;
+
+        bucket* nb = bucket::create(bp->size() + 1, *bp,
+                typename inner_array::grow_tag{idx}, std::forward<Args>(args)...);
+        bp.reset(nb);
+        return iterator(&_tree, _tree.lower_bound_iterator(rk), idx);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    const_iterator find(const K& key, Compare cmp) const {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        const bucket_ptr* bp = _tree.get(rk);
+        if (bp == nullptr) {
+            return end();
+        }
+
+        bool match = false;
+        int idx = (*bp)->index_of((*bp)->lower_bound(key, cmp, match));
+        if (!match) {
+            return end();
+        }
+
+        return const_iterator(_tree.lower_bound_iterator(rk), idx);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    iterator find(const K& key, Compare cmp) {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        bucket_ptr* bp = _tree.get(rk);
+        if (bp == nullptr) {
+            return end();
+        }
+
+        bool match = false;
+        int idx = (*bp)->index_of((*bp)->lower_bound(key, cmp, match));
+        if (!match) {
+            return end();
+        }
+
+        return iterator(&_tree, _tree.lower_bound_iterator(rk), idx);
+    }
+
+private:
+    template <typename OuterIterator, typename K>
+    static std::pair<OuterIterator, int> do_lower_bound(OuterIterator bkt, uint64_t rk, const K& key, Compare& cmp, bound_hint& hint) {
+        hint.key_tail = false;
+        hint.match = false;
+        hint.key_match = bkt != OuterIterator() && bkt.key() == rk;
+
+        if (!hint.key_match) {
+            return { bkt, 0 };
+        }
+
+        int i = (*bkt)->index_of((*bkt)->lower_bound(key, cmp, hint.match));
+        if (i != 0 && (**bkt)[i - 1].is_tail()) {
+            /*
+             * The lower_bound is after the last element -- shift
+             * to the next bucket's 0'th one.
+             */
+            bkt++;
+            i = 0;
+            hint.key_tail = true;
+        }
+
+        return { bkt, i };
+    }
+
+    template <typename OuterIterator, typename K>
+    static std::pair<OuterIterator, int> do_upper_bound(OuterIterator bkt, uint64_t rk, const K& key, Compare& cmp) {
+        if (bkt == OuterIterator() || bkt.key() != rk) {
+            return { bkt, 0 };
+        }
+
+        int i = (*bkt)->index_of((*bkt)->upper_bound(key, cmp));
+        if (i != 0 && (**bkt)[i - 1].is_tail()) {
+            // Beyond the end() boundary
+            bkt++;
+            i = 0;
+        }
+
+        return { bkt, i };
+    }
+
+public:
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    const_iterator lower_bound(const K& key, Compare cmp, bound_hint& hint) const {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        auto [ bkt, i ] = do_lower_bound(_tree.lower_bound_iterator(rk), rk, key, cmp, hint);
+        return const_iterator(bkt, i);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    iterator lower_bound(const K& key, Compare cmp, bound_hint& hint) {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        auto [ bkt, i ] = do_lower_bound(_tree.lower_bound_iterator(rk), rk, key, cmp, hint);
+        return iterator(&_tree, bkt, i);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    const_iterator lower_bound(const K& key, Compare cmp) const {
+        bound_hint hint;
+        return lower_bound(key, cmp, hint);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    iterator lower_bound(const K& key, Compare cmp) {
+        bound_hint hint;
+        return lower_bound(key, cmp, hint);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    const_iterator upper_bound(const K& key, Compare cmp) const {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        auto [ bkt, i ] = do_upper_bound(_tree.lower_bound_iterator(rk), rk, key, cmp);
+        return const_iterator(bkt, i);
+    }
+
+    template <typename K = key_type>
+    requires Comparable<K, T, Compare>
+    iterator upper_bound(const K& key, Compare cmp) {
+        uint64_t rk = radix_key(_less.simplify_key(key));
+        auto [ bkt, i ] = do_upper_bound(_tree.lower_bound_iterator(rk), rk, key, cmp);
+        return iterator(&_tree, bkt, i);
+    }
+
+    template <typename Func>
+    requires Disposer<Func, T>
+    void clear_and_dispose(Func&& disp) noexcept {
+        _tree.walk([&disp] (uint64_t, bucket_ptr& bp) noexcept {
+            bp->for_each(disp);
+            return true;
+        });
+        _tree.clear();
+    }
+
+    void clear() noexcept { clear_and_dispose(bplus::default_dispose<T>); }
+
+    bool empty() const noexcept { return _tree.empty(); }
+
+    static size_t estimated_object_memory_size_in_allocator(allocation_strategy& allocator, const T* obj) noexcept {
+        /*
+         * Like in double_decker, T-s live in arrays so there's no way
+         * to tell the exact size. Count the bucket and the radix slot.
+         */
+        return sizeof(bucket) + sizeof(bucket_ptr);
+    }
+};